@@ -199,24 +199,16 @@ public:
 	bool Editor_ParseUser(const std::vector<SString> &tokens);
 	void Editor_WriteUser(std::ostream &os) const;
 	void MapStuff_NotifyBegin();
-	void MapStuff_NotifyChange(ObjType type, int objnum, int field);
-	void MapStuff_NotifyDelete(ObjType type, int objnum);
-	void MapStuff_NotifyEnd();
-	void MapStuff_NotifyInsert(ObjType type, int objnum);
+	void MapStuff_NotifyEnd(const ChangeSet &changes);
 	void ObjectBox_NotifyBegin();
-	void ObjectBox_NotifyChange(ObjType type, int objnum, int field);
-	void ObjectBox_NotifyDelete(ObjType type, int objnum);
-	void ObjectBox_NotifyEnd() const;
-	void ObjectBox_NotifyInsert(ObjType type, int objnum);
+	void ObjectBox_NotifyEnd(const ChangeSet &changes);
 	bool RecUsed_ParseUser(const std::vector<SString> &tokens);
 	void RecUsed_WriteUser(std::ostream &os) const;
 	void RedrawMap();
 	void Selection_Clear(bool no_save = false);
 	void Selection_InvalidateLast();
 	void Selection_NotifyBegin();
-	void Selection_NotifyDelete(ObjType type, int objnum);
-	void Selection_NotifyEnd();
-	void Selection_NotifyInsert(ObjType type, int objnum);
+	void Selection_NotifyEnd(const ChangeSet &changes);
 	void Selection_Push();
 	void UpdateHighlight();
 	void ZoomWholeMap();
@@ -281,6 +273,7 @@ public:
 	void ValidateSidedefRefs(LineDef *ld, int num);
 	
 	// M_NODES
+	build_result_e BuildNodesBatch(int lev_idx, int *warnings);
 	void BuildNodesAfterSave(int lev_idx);
 	void GB_PrintMsg(EUR_FORMAT_STRING(const char *str), ...) const EUR_PRINTF(2, 3);
 
@@ -23,13 +23,18 @@
 #include "im_img.h"
 #include "m_strings.h"
 #include "sys_type.h"
+#include "w_imgcache.h"
 
+#include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class Img_c;
 class Lump_c;
+class crc32_c;
 class Palette;
 class Wad_file;
 struct ConfigData;
@@ -37,6 +42,35 @@ struct ConfigData;
 // maps type number to an image
 typedef std::map<int, Img_c *> sprite_map_t;
 
+//
+// A texture or flat.  Its size is known once the resources are loaded,
+// but the pixels are only made the first time it gets used, and they
+// may be dropped again later (see ImageSet::trimDecodedImages).
+//
+struct ImageEntry
+{
+	int width = 0;
+	int height = 0;
+
+	// makes the image, returns NULL on failure
+	std::function<Img_c *(const ConfigData &config)> decode;
+
+	// adds up everything the pixels are made from, which keys them in
+	// the disk cache.  Left empty for images quicker to decode again.
+	std::function<void(const ConfigData &config, crc32_c &sum)> source;
+
+	// the decoded image, NULL until it is needed
+	mutable std::unique_ptr<Img_c> img;
+	mutable bool failed = false;
+	mutable unsigned long long lastUse = 0;
+
+	// key of the pixels in the disk cache, 0 if none
+	mutable uint64_t cacheKey = 0;
+};
+
+// maps a texture or flat name to its entry
+typedef std::map<SString, ImageEntry> image_map_t;
+
 //
 // Wad image set
 //
@@ -55,22 +89,22 @@ public:
 	void IM_UnloadDummyTextures() const;
 	void IM_ResetDummyTextures();
 
-	void W_AddTexture(const SString &name, Img_c *img, bool is_medusa);
+	void W_AddTexture(const SString &name, ImageEntry &&entry, bool is_medusa);
 	Img_c *getTexture(const ConfigData &config, const SString &name, bool try_uppercase = false) const;
 	int W_GetTextureHeight(const ConfigData &config, const SString &name) const;
 	bool W_TextureCausesMedusa(const SString &name) const;
 	bool W_TextureIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearTextures();
-	const std::map<SString, Img_c *> &getTextures() const
+	const image_map_t &getTextures() const
 	{
 		return textures;
 	}
 
-	void W_AddFlat(const SString &name, Img_c *img);
+	void W_AddFlat(const SString &name, ImageEntry &&entry);
 	Img_c *W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase = false) const;
 	bool W_FlatIsKnown(const ConfigData &config, const SString &name) const;
 	void W_ClearFlats();
-	const std::map<SString, Img_c *> &getFlats() const
+	const image_map_t &getFlats() const
 	{
 		return flats;
 	}
@@ -79,11 +113,47 @@ public:
 
 	void W_UnloadAllTextures() const;
 
+	// decodes the named textures and flats not decoded yet, spread over
+	// the worker threads.  Unknown names are skipped.
+	void decodeNamed(const ConfigData &config, const std::vector<SString> &tex_names,
+					 const std::vector<SString> &flat_names) const;
+
+	// drops the least recently used textures and flats until the decoded
+	// ones fit in the configured memory.  No pointers from getTexture()
+	// or W_GetFlat() may be kept over this call.
+	void trimDecodedImages() const;
+
+	// like getTexture() and W_GetFlat(), but the image is passed to 'func'
+	// (NULL when there is none) and may only be used during that call.
+	// Can be called by any thread, except while the textures and flats
+	// are being loaded.  Messages are printed by the calling thread.
+	void useTexture(const ConfigData &config, const SString &name,
+					const std::function<void(const Img_c *img)> &func) const;
+	void useFlat(const ConfigData &config, const SString &name,
+				 const std::function<void(const Img_c *img)> &func) const;
+
+	// the memory used by the decoded textures and flats
+	size_t decodedBytes() const
+	{
+		std::lock_guard<std::mutex> lock(mDecodeMutex);
+		return mDecodedBytes;
+	}
+
+	// makes the pixels of an entry, from the disk cache when they are in
+	// it, without storing them in the entry.  'key' gets the disk cache
+	// key.  Can be called by any thread.
+	Img_c *makeImage(const ConfigData &config, const ImageEntry &entry, uint64_t *key) const;
+
+	// uses the given file as the disk cache of this resource set.
+	// saveDiskCache() writes the images made since then and closes it.
+	void openDiskCache(const SString &filename);
+	void saveDiskCache();
+
 public:	// TODO: make private
-	std::map<SString, Img_c *> textures;
+	image_map_t textures;
 	// textures which can cause the Medusa Effect in vanilla/chocolate DOOM
 	std::map<SString, int> medusa_textures;
-	std::map<SString, Img_c *> flats;
+	image_map_t flats;
 	sprite_map_t sprites;
 
 	int missing_tex_color = 0;
@@ -103,6 +173,28 @@ public:	// TODO: make private
 
 	Img_c *digit_font_11x14 = nullptr;
 	Img_c *digit_font_14x19 = nullptr;
+
+private:
+	const ImageEntry *findTexture(const ConfigData &config, const SString &name, bool try_uppercase) const;
+	const ImageEntry *findFlat(const ConfigData &config, const SString &name, bool try_uppercase) const;
+
+	Img_c *decodeImage(const ConfigData &config, const ImageEntry &entry) const;
+	void decodeEntries(const ConfigData &config, const std::vector<const ImageEntry *> &entries) const;
+	void useImage(const ConfigData &config, const ImageEntry *entry,
+				  const std::function<void(const Img_c *img)> &func) const;
+
+	// stores an image made without holding the lock, mDecodeMutex
+	// must be locked.
+	void keepImage(const ImageEntry &entry, std::unique_ptr<Img_c> &&img, uint64_t key) const;
+
+	// guards the decoded images, which can be wanted by several threads
+	mutable std::mutex mDecodeMutex;
+	mutable size_t mDecodedBytes = 0;
+	mutable unsigned long long mUseClock = 0;
+
+	ImageDiskCache mDiskCache;
+	// whether images were made which are not in the disk cache yet
+	mutable std::atomic<bool> mDiskCacheChanged{ false };
 };
 
 //
@@ -136,12 +228,20 @@ public:
 		return trans_replace;
 	}
 
+	// the OpenGL (BGRA) colour of every possible pixel value, with
+	// TRANS_PIXEL being fully transparent.  Indexed by img_pixel_t.
+	const u32_t *getGLColors() const
+	{
+		return gl_colors.data();
+	}
+
 private:
 	// this palette has the gamma setting applied
 	rgb_color_t palette[256] = {};
 	rgb_color_t palette_medium[256] = {};
 	byte rgb555_gamma[32];
 	byte rgb555_medium[32];
+	std::vector<u32_t> gl_colors;
 	byte bright_map[256] = {};
 	byte raw_palette[256][3] = {};
 	byte raw_colormap[32][256] = {};
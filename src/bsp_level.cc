@@ -615,39 +615,12 @@ static void Reject_Free()
 
 
 //
-// Algorithm: Initially all sectors are in individual groups.
-// Now we scan the linedef list.  For each two-sectored line,
-// merge the two sector groups into one.  That's it!
+// The groups are the sets of sectors connected by two-sectored
+// lines, which the sector graph already knows.
 //
 static void Reject_GroupSectors(const Document &doc)
 {
-	for(const LineDef *L : doc.linedefs)
-	{
-		if (L->right < 0 || L->left < 0)
-			continue;
-
-		int sec1 = L->Right(doc)->sector;
-		int sec2 = L->Left(doc) ->sector;
-
-		if (sec1 < 0 || sec2 < 0 || sec1 == sec2)
-			continue;
-
-		// already in the same group ?
-		int group1 = rej_sector_groups[sec1];
-		int group2 = rej_sector_groups[sec2];
-
-		if (group1 == group2)
-			continue;
-
-		// prefer the group numbers to become lower
-		if (group1 > group2)
-			std::swap(group1, group2);
-
-		// merge the groups
-		for (int s = 0 ; s < doc.numSectors() ; s++)
-			if (rej_sector_groups[s] == group2)
-				rej_sector_groups[s] =  group1;
-	}
+	doc.secmod.graph().findComponents(rej_sector_groups);
 }
 
 
@@ -933,6 +906,7 @@ static void PutVertices(const Instance &inst, const char *name, int do_gl)
 	int count, i;
 
 	Lump_c *lump = CreateLevelLump(inst, name);
+	lump->reserve(num_vertices * (int)sizeof(raw_vertex_t));
 
 	for (i=0, count=0 ; i < num_vertices ; i++)
 	{
@@ -970,6 +944,7 @@ static void PutGLVertices(const Instance &inst, int do_v5)
 	int count, i;
 
 	Lump_c *lump = CreateLevelLump(inst, "GL_VERT");
+	lump->reserve(4 + num_vertices * (int)sizeof(raw_v2_vertex_t));
 
 	if (do_v5)
 		lump->Write(lev_v5_magic, 4);
@@ -1030,6 +1005,7 @@ static void PutSegs(const Instance &inst)
 	int i, count;
 
 	Lump_c *lump = CreateLevelLump(inst, "SEGS");
+	lump->reserve(num_segs * (int)sizeof(raw_seg_t));
 
 	for (i=0, count=0 ; i < num_segs ; i++)
 	{
@@ -1073,6 +1049,7 @@ static void PutGLSegs(const Instance &inst)
 	int i, count;
 
 	Lump_c *lump = CreateLevelLump(inst, "GL_SEGS");
+	lump->reserve(num_segs * (int)sizeof(raw_gl_seg_t));
 
 	for (i=0, count=0 ; i < num_segs ; i++)
 	{
@@ -1119,6 +1096,7 @@ static void PutGLSegs_V5(const Instance &inst)
 	int i, count;
 
 	Lump_c *lump = CreateLevelLump(inst, "GL_SEGS");
+	lump->reserve(num_segs * (int)sizeof(raw_v5_seg_t));
 
 	for (i=0, count=0 ; i < num_segs ; i++)
 	{
@@ -1163,6 +1141,7 @@ static void PutSubsecs(const Instance &inst, const char *name, int do_gl)
 	int i;
 
 	Lump_c * lump = CreateLevelLump(inst, name);
+	lump->reserve(num_subsecs * (int)sizeof(raw_subsec_t));
 
 	for (i=0 ; i < num_subsecs ; i++)
 	{
@@ -1194,6 +1173,7 @@ static void PutGLSubsecs_V5(const Instance &inst)
 	int i;
 
 	Lump_c *lump = CreateLevelLump(inst, "GL_SSECT");
+	lump->reserve(num_subsecs * (int)sizeof(raw_v5_subsec_t));
 
 	for (i=0 ; i < num_subsecs ; i++)
 	{
@@ -1324,6 +1304,7 @@ static void PutOneNode_V5(node_t *node, Lump_c *lump)
 void PutNodes(const Instance &inst, const char *name, int do_v5, node_t *root)
 {
 	Lump_c *lump = CreateLevelLump(inst, name);
+	lump->reserve(num_nodes * (int)(do_v5 ? sizeof(raw_v5_node_t) : sizeof(raw_node_t)));
 
 	node_cur_index = 0;
 
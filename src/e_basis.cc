@@ -82,6 +82,148 @@ FFixedPoint MakeValidCoord(MapFormat format, double x)
 
 
 //------------------------------------------------------------------------
+//  CHANGE SET
+//------------------------------------------------------------------------
+
+//
+// Forget everything recorded so far
+//
+void ChangeSet::clear()
+{
+	for(Entry &entry : mEntries)
+		entry = Entry();
+}
+
+//
+// An object is about to be inserted at objnum
+//
+void ChangeSet::recordInsert(ObjType type, int objnum)
+{
+	Entry &entry = mEntries[static_cast<int>(type)];
+	entry.inserted.push_back(objnum);
+	entry.minInserted = std::min(entry.minInserted, objnum);
+	if(!entry.changed.empty())
+		entry.renumbered = true;
+}
+
+//
+// The object at objnum is about to be deleted
+//
+void ChangeSet::recordDelete(ObjType type, int objnum)
+{
+	Entry &entry = mEntries[static_cast<int>(type)];
+	entry.deleted.push_back(objnum);
+	entry.minDeleted = std::min(entry.minDeleted, objnum);
+	if(!entry.changed.empty())
+		entry.renumbered = true;
+}
+
+//
+// A field of objnum got changed
+//
+void ChangeSet::recordChange(ObjType type, int objnum, int field)
+{
+	Entry &entry = mEntries[static_cast<int>(type)];
+	// e.g. moving an object changes both X and Y in a row
+	if(entry.changed.empty() || entry.changed.back() != objnum)
+		entry.changed.push_back(objnum);
+	entry.fields |= 1u << field;
+}
+
+//
+// Works out where the objects went after the inserts and deletes:
+// old_to_new[old] is the new number (-1 if deleted) and is_new[num] is
+// set for the inserted ones.  Returns false if it cannot tell, e.g. when
+// there were both inserts and deletes, since their order is not recorded.
+//
+bool ChangeSet::Entry::calcRenumbering(int new_count, std::vector<int> &old_to_new,
+									   std::vector<byte> &is_new) const
+{
+	if(!inserted.empty() && !deleted.empty())
+		return false;
+
+	int old_count = new_count + (int)deleted.size() - (int)inserted.size();
+	if(old_count < 0)
+		return false;
+
+	// old number of each object, in the new order (-1 when inserted)
+	std::vector<int> ids(old_count);
+	for(int i = 0; i < old_count; ++i)
+		ids[i] = i;
+
+	if(!deleted.empty())
+	{
+		// when deleted from the top down (the usual way), each number is
+		// also the old one and it can be done in a single pass.
+		if(std::is_sorted(deleted.rbegin(), deleted.rend()) &&
+		   std::adjacent_find(deleted.begin(), deleted.end()) == deleted.end())
+		{
+			if(deleted.front() >= old_count || deleted.back() < 0)
+				return false;
+
+			for(int n : deleted)
+				ids[n] = -1;
+
+			ids.erase(std::remove(ids.begin(), ids.end(), -1), ids.end());
+		}
+		else
+		{
+			for(int n : deleted)
+			{
+				if(n < 0 || n >= (int)ids.size())
+					return false;
+
+				ids.erase(ids.begin() + n);
+			}
+		}
+	}
+	else
+	{
+		for(int n : inserted)
+		{
+			if(n < 0 || n > (int)ids.size())
+				return false;
+
+			ids.insert(ids.begin() + n, -1);
+		}
+	}
+
+	old_to_new.assign(old_count, -1);
+	is_new.assign(new_count, 0);
+
+	for(int i = 0; i < new_count; ++i)
+	{
+		if(ids[i] < 0)
+			is_new[i] = 1;
+		else
+			old_to_new[ids[i]] = i;
+	}
+	return true;
+}
+
+//
+// Whether the numbers in 'changed' are still valid after the edit
+//
+bool ChangeSet::Entry::changedNumbersValid() const
+{
+	if(!renumbered || changed.empty())
+		return true;
+
+	// only the objects above the lowest insert/delete were moved
+	int highest = *std::max_element(changed.begin(), changed.end());
+	return highest < lowestMoved();
+}
+
+//
+// Whether nothing got recorded
+//
+bool ChangeSet::isEmpty() const
+{
+	for(const Entry &entry : mEntries)
+		if(entry.hasStructural() || !entry.changed.empty())
+			return false;
+	return true;
+}
 
 //------------------------------------------------------------------------
 //  BASIS API IMPLEMENTATION
@@ -431,6 +573,8 @@ bool Basis::redo()
 //
 void Basis::clearAll()
 {
+	doc.checks.liveReset();
+
 	for(Thing *thing : doc.things)
 		delete thing;
 	for(Vertex *vertex : doc.vertices)
@@ -462,6 +606,11 @@ void Basis::clearAll()
 
 	// TODO: other modules
 	Clipboard_ClearLocals();
+	doc.hover.invalidateSectorLocator();
+	doc.secmod.invalidateGraph();
+
+	// the level gets loaded without the Basis knowing
+	mConnectivityVersion++;
 }
 
 //
@@ -543,12 +692,10 @@ void Basis::EditUnit::rawChange(Basis &basis)
 	std::swap(pos[field], value);
 	basis.mDidMakeChanges = true;
 
-	// TODO: their modules
-	Clipboard_NotifyChange(objtype, objnum, field);
-	Selection_NotifyChange(objtype, objnum, field);
-	basis.inst.MapStuff_NotifyChange(objtype, objnum, field);
-	Render3D_NotifyChange(objtype, objnum, field);
-	basis.inst.ObjectBox_NotifyChange(objtype, objnum, field);
+	if(objtype == ObjType::linedefs && (field == LineDef::F_START || field == LineDef::F_END))
+		basis.mConnectivityVersion++;
+
+	basis.mChanges.recordChange(objtype, objnum, field);
 }
 
 //
@@ -558,12 +705,13 @@ void *Basis::EditUnit::rawDelete(Basis &basis) const
 {
 	basis.mDidMakeChanges = true;
 
-	// TODO: their own modules
+	if(objtype == ObjType::linedefs || objtype == ObjType::vertices)
+		basis.mConnectivityVersion++;
+
+	// the clipboard renumbers its sector references right away, since
+	// it has to see each deletion in order.
 	Clipboard_NotifyDelete(objtype, objnum);
-	basis.inst.Selection_NotifyDelete(objtype, objnum);
-	basis.inst.MapStuff_NotifyDelete(objtype, objnum);
-	Render3D_NotifyDelete(basis.doc, objtype, objnum);
-	basis.inst.ObjectBox_NotifyDelete(objtype, objnum);
+	basis.mChanges.recordDelete(objtype, objnum);
 
 	switch(objtype)
 	{
@@ -705,12 +853,11 @@ void Basis::EditUnit::rawInsert(Basis &basis) const
 {
 	basis.mDidMakeChanges = true;
 
-	// TODO: their module
+	if(objtype == ObjType::linedefs || objtype == ObjType::vertices)
+		basis.mConnectivityVersion++;
+
 	Clipboard_NotifyInsert(basis.doc, objtype, objnum);
-	basis.inst.Selection_NotifyInsert(objtype, objnum);
-	basis.inst.MapStuff_NotifyInsert(objtype, objnum);
-	Render3D_NotifyInsert(objtype, objnum);
-	basis.inst.ObjectBox_NotifyInsert(objtype, objnum);
+	basis.mChanges.recordInsert(objtype, objnum);
 
 	switch(objtype)
 	{
@@ -900,18 +1047,20 @@ void Basis::UndoGroup::reapply(Basis &basis)
 //
 void Basis::doClearChangeStatus()
 {
+	// the live checks may still be reading the map
+	doc.checks.liveWait();
+
 	mDidMakeChanges = false;
+	mChanges.clear();
 
 	// TODO: these shall go to other modules
-	Clipboard_NotifyBegin();
 	inst.Selection_NotifyBegin();
 	inst.MapStuff_NotifyBegin();
-	Render3D_NotifyBegin();
 	inst.ObjectBox_NotifyBegin();
 }
 
 //
-// If we made changes, notify the others
+// If we made changes, notify the others, all at once
 //
 void Basis::doProcessChangeStatus() const
 {
@@ -922,11 +1071,16 @@ void Basis::doProcessChangeStatus() const
 		inst.RedrawMap();
 	}
 
-	Clipboard_NotifyEnd();
-	inst.Selection_NotifyEnd();
-	inst.MapStuff_NotifyEnd();
-	Render3D_NotifyEnd(inst);
-	inst.ObjectBox_NotifyEnd();
+	// before the others, since they may need to locate sectors
+	doc.hover.notifyChanges(mChanges);
+	doc.secmod.notifyChanges(mChanges);
+
+	inst.Selection_NotifyEnd(mChanges);
+	inst.MapStuff_NotifyEnd(mChanges);
+	Render3D_NotifyEnd(inst, mChanges);
+	inst.ObjectBox_NotifyEnd(mChanges);
+
+	doc.checks.liveNotifyChanges(mChanges);
 }
 
 //
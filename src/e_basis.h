@@ -31,7 +31,10 @@
 #include "FixedPoint.h"
 #include "m_strings.h"
 #include "objid.h"
+#include <algorithm>
+#include <limits.h>
 #include <stack>
+#include <vector>
 
 #define DEFAULT_UNDO_GROUP_MESSAGE "[something]"
 
@@ -80,6 +83,69 @@ enum class MapFormat
 
 FFixedPoint MakeValidCoord(MapFormat format, double x);
 
+//
+// Summary of everything touched by one edit operation (or one undo or
+// redo step). It gets filled while the edit units are applied, and the
+// listeners receive it once, when the operation ends.
+//
+class ChangeSet
+{
+public:
+	//
+	// What happened to one kind of object
+	//
+	struct Entry
+	{
+		// object numbers at the time of insertion/deletion, in order
+		std::vector<int> inserted;
+		std::vector<int> deleted;
+
+		// objects with changed fields (consecutive repeats are merged)
+		std::vector<int> changed;
+		unsigned fields = 0;	// bit N set if field N was changed
+
+		int minInserted = INT_MAX;
+		int minDeleted = INT_MAX;
+
+		// objects got inserted or deleted after some were listed in
+		// 'changed', so those numbers may no longer be accurate.
+		bool renumbered = false;
+
+		bool hasStructural() const
+		{
+			return !inserted.empty() || !deleted.empty();
+		}
+		bool changedField(int field) const
+		{
+			return (fields & (1u << field)) != 0;
+		}
+		int lowestMoved() const
+		{
+			return std::min(minInserted, minDeleted);
+		}
+
+		bool calcRenumbering(int new_count, std::vector<int> &old_to_new,
+							 std::vector<byte> &is_new) const;
+		bool changedNumbersValid() const;
+	};
+
+	void clear();
+
+	void recordInsert(ObjType type, int objnum);
+	void recordDelete(ObjType type, int objnum);
+	void recordChange(ObjType type, int objnum, int field);
+
+	const Entry &operator[](ObjType type) const
+	{
+		return mEntries[static_cast<int>(type)];
+	}
+
+	bool isEmpty() const;
+
+private:
+	Entry mEntries[static_cast<int>(ObjType::sectors) + 1];
+};
+
 //
 // Editor command manager, handles undo/redo
 //
@@ -94,6 +160,25 @@ public:
 	bool redo();
 	void clearAll();
 
+	//
+	// Changes of the operation in progress (or of the last finished one)
+	//
+	const ChangeSet &changes() const
+	{
+		return mChanges;
+	}
+
+	//
+	// Goes up each time linedefs or vertices are added or removed, or
+	// the vertices of a linedef change (even in the middle of an
+	// operation), so caches of how things connect can tell they are out
+	// of date.
+	//
+	unsigned connectivityVersion() const
+	{
+		return mConnectivityVersion;
+	}
+
 private:
 	//
 	// Edit change
@@ -256,12 +341,14 @@ private:
 	void doClearChangeStatus();
 	void doProcessChangeStatus() const;
 
+	ChangeSet mChanges;
 	UndoGroup mCurrentGroup;
 	// FIXME: use a better data type here
 	std::stack<UndoGroup> mUndoHistory;
 	std::stack<UndoGroup> mRedoFuture;
 
 	bool mDidMakeChanges = false;
+	unsigned mConnectivityVersion = 0;
 };
 
 //
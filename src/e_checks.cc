@@ -29,6 +29,7 @@
 #include "main.h"
 
 #include <algorithm>
+#include <atomic>
 
 #include "e_checks.h"
 #include "e_cutpaste.h"
@@ -36,6 +37,9 @@
 #include "e_main.h"
 #include "e_path.h"
 #include "e_vertex.h"
+#include "lib_threads.h"
+#include "m_blockgrid.h"
+#include "m_config.h"
 #include "LineDef.h"
 #include "m_game.h"
 #include "e_objects.h"
@@ -54,6 +58,8 @@
 
 #define CAMERA_PEST  32000
 
+bool config::live_map_checks = true;
+
 //------------------------------------------------------------------------
 
 class UI_Check_base : public UI_Escapable_Window
@@ -306,114 +312,38 @@ static void Vertex_ShowDanglers(Instance &inst)
 }
 
 
-struct vertex_X_CMP_pred
-{
-	const Document &doc;
-	explicit vertex_X_CMP_pred(const Document &doc) : doc(doc)
-	{
-	}
-
-	inline bool operator() (int A, int B) const
-	{
-		const Vertex *V1 = doc.vertices[A];
-		const Vertex *V2 = doc.vertices[B];
-
-		return V1->raw_x < V2->raw_x;
-	}
-};
-
-
-void Vertex_FindOverlaps(selection_c& sel, const Document &doc)
+static void Vertex_FindOverlaps(selection_c& sel, const Document &doc)
 {
 	// NOTE: when two or more vertices share the same coordinates,
 	//       only the second and subsequent ones are stored in 'sel'.
 
-	sel.change_type(ObjType::vertices);
-
-	if (doc.numVertices() < 2)
-		return;
-
-	// sort the vertices into order of the 'X' value.
-	// hence any overlapping vertices will be near each other.
-
-	std::vector<int> sorted_list(doc.numVertices(), 0);
-
-	for (int i = 0 ; i < doc.numVertices(); i++)
-		sorted_list[i] = i;
-
-	std::sort(sorted_list.begin(), sorted_list.end(), vertex_X_CMP_pred(doc));
-
-#define VERT_K  doc.vertices[sorted_list[k]]
-#define VERT_N  doc.vertices[sorted_list[n]]
-
-	for (int k = 0 ; k < doc.numVertices(); k++)
-	{
-		for (int n = k + 1 ; n < doc.numVertices() && VERT_N->raw_x == VERT_K->raw_x ; n++)
-		{
-			if (VERT_N->raw_y == VERT_K->raw_y)
-			{
-				sel.set(sorted_list[k]);
-			}
-		}
-	}
-
-#undef VERT_K
-#undef VERT_N
-}
-
-
-static void Vertex_MergeOne(EditOperation &op, int idx, selection_c& merge_verts, Document &doc)
-{
-	const Vertex *V = doc.vertices[idx];
-
-	// find the base vertex (the one V is sitting on)
-	for (int n = 0 ; n < doc.numVertices(); n++)
-	{
-		if (n == idx)
-			continue;
-
-		// skip any in the merge list
-		if (merge_verts.get(n))
-			continue;
-
-		const Vertex *N = doc.vertices[n];
-
-		if (*N != *V)
-			continue;
-
-		// Ok, found it, so update linedefs
-
-		for (int ld = 0 ; ld < doc.numLinedefs(); ld++)
-		{
-			LineDef *L = doc.linedefs[ld];
-
-			if (L->start == idx)
-				op.changeLinedef(ld, LineDef::F_START, n);
-
-			if (L->end == idx)
-				op.changeLinedef(ld, LineDef::F_END, n);
-		}
-
-		return;
-	}
-
-	// SHOULD NOT GET HERE
-	gLog.printf("VERTEX MERGE FAILURE.\n");
+	doc.vertmod.findOverlaps(sel);
 }
 
 
 static void Vertex_MergeOverlaps(Instance &inst)
 {
+	const Document &doc = inst.level;
+
 	selection_c verts;
-	Vertex_FindOverlaps(verts, inst.level);
+	std::vector<int> bases;
+
+	doc.vertmod.findOverlaps(verts, &bases);
 
 	{
 		EditOperation op(inst.level.basis);
 		op.setMessage("merged overlapping vertices");
 
-		for (sel_iter_c it(verts) ; !it.done() ; it.next())
+		// move the linedefs onto the vertex each one is sitting on
+		for (int ld = 0 ; ld < doc.numLinedefs(); ld++)
 		{
-			Vertex_MergeOne(op, *it, verts, inst.level);
+			const LineDef *L = doc.linedefs[ld];
+
+			if (bases[L->start] >= 0)
+				op.changeLinedef(ld, LineDef::F_START, bases[L->start]);
+
+			if (bases[L->end] >= 0)
+				op.changeLinedef(ld, LineDef::F_END, bases[L->end]);
 		}
 
 		// nothing should reference these vertices now
@@ -524,83 +454,108 @@ private:
 	Instance &inst;
 };
 
+//------------------------------------------------------------------------
 
-CheckResult ChecksModule::checkVertices(int min_severity) const
+//
+// Returns the sector on one side of a line, or -1 when there is none
+// (or the reference is bad).
+//
+static int LineDef_SideSector(const Document &doc, int sd)
 {
-	UI_Check_Vertices *dialog = new UI_Check_Vertices(min_severity > 0, inst);
+	if (sd < 0 || sd >= doc.numSidedefs())
+		return -1;
 
-	selection_c  sel;
+	int sec = doc.sidedefs[sd]->sector;
 
-	SString check_message;
+	if (sec < 0 || sec >= doc.numSectors())
+		return -1;
 
-	for (;;)
-	{
-		Vertex_FindOverlaps(sel, doc);
+	return sec;
+}
 
-		if (sel.empty())
-			dialog->AddLine("No overlapping vertices");
-		else
-		{
-			check_message = SString::printf("%d overlapping vertices", sel.count_obj());
 
-			dialog->AddLine(check_message.c_str(), 2, 210,
-			                "Show",  &UI_Check_Vertices::action_highlight,
-			                "Merge", &UI_Check_Vertices::action_merge);
-		}
+//
+// Collects the lines touching each sector.  When 'wanted' is given,
+// only the sectors marked in it get their lines collected.
+//
+static void Sectors_CollectLines(std::vector<std::vector<int>>& sec_lines,
+								 const Document &doc, const std::vector<byte> *wanted)
+{
+	sec_lines.assign(doc.numSectors(), std::vector<int>());
 
+	for (int n = 0 ; n < doc.numLinedefs(); n++)
+	{
+		const LineDef *L = doc.linedefs[n];
 
-		Vertex_FindDanglers(sel, doc);
+		int front = LineDef_SideSector(doc, L->right);
+		int back  = LineDef_SideSector(doc, L->left);
 
-		if (sel.empty())
-			dialog->AddLine("No dangling vertices");
-		else
-		{
-			check_message = SString::printf("%d dangling vertices", sel.count_obj());
+		if (front >= 0 && (! wanted || (*wanted)[front]))
+			sec_lines[front].push_back(n);
 
-			dialog->AddLine(check_message, 2, 210,
-			                "Show",  &UI_Check_Vertices::action_show_danglers);
-		}
+		if (back >= 0 && back != front && (! wanted || (*wanted)[back]))
+			sec_lines[back].push_back(n);
+	}
+}
 
 
-		Vertex_FindUnused(sel, doc);
+//
+// Checks whether the lines touching a sector form closed loops around it.
+// The 'ends' array has an entry per vertex, and must be all zero (it is
+// left that way).  The bad vertices are added to 'verts', when given.
+//
+static bool Sector_IsUnclosed(const Document &doc, int s, const std::vector<int>& lines,
+							  std::vector<byte>& ends, selection_c *verts)
+{
+	// for each sidedef bound to the Sector, store a "1" in the "ends"
+	// array for its starting vertex, and a "2" for its ending vertex.
+	for (int n : lines)
+	{
+		const LineDef *L = doc.linedefs[n];
+
+		// ignore lines with same sector on both sides
+		if (L->left >= 0 && L->right >= 0 &&
+		    L->Left(doc)->sector == L->Right(doc)->sector)
+			continue;
 
-		if (sel.empty())
-			dialog->AddLine("No unused vertices");
-		else
+		if (L->right >= 0 && L->Right(doc)->sector == s)
 		{
-			check_message = SString::printf("%d unused vertices", sel.count_obj());
-
-			dialog->AddLine(check_message, 1, 210,
-			                "Show",   &UI_Check_Vertices::action_show_unused,
-			                "Remove", &UI_Check_Vertices::action_remove);
+			ends[L->start] |= 1;
+			ends[L->end]   |= 2;
 		}
 
-
-		// in "ALL" mode, just continue if not too severe
-		if (dialog->WorstSeverity() < min_severity)
+		if (L->left >= 0 && L->Left(doc)->sector == s)
 		{
-			delete dialog;
-
-			return CheckResult::ok;
+			ends[L->start] |= 2;
+			ends[L->end]   |= 1;
 		}
+	}
 
-		CheckResult result = dialog->Run();
+	// every entry in the "ends" array should be 0 or 3
 
-		if (result == CheckResult::tookAction)
+	bool unclosed = false;
+
+	for (int n : lines)
+	{
+		const LineDef *L = doc.linedefs[n];
+
+		for (int v : { L->start, L->end })
 		{
-			// repeat the tests
-			dialog->Reset();
-			continue;
-		}
+			if (ends[v] == 1 || ends[v] == 2)
+			{
+				unclosed = true;
 
-		delete dialog;
+				if (verts)
+					verts->set(v);
+			}
 
-		return result;
+			ends[v] = 0;
+		}
 	}
-}
 
+	return unclosed;
+}
 
-//------------------------------------------------------------------------
 
 static void Sectors_FindUnclosed(selection_c& secs, selection_c& verts, const Document &doc)
 {
@@ -610,53 +565,17 @@ static void Sectors_FindUnclosed(selection_c& secs, selection_c& verts, const Do
 	if (doc.numVertices() == 0 || doc.numSectors() == 0)
 		return;
 
-	byte *ends = new byte[doc.numVertices()];
-	int v;
+	std::vector<std::vector<int>> sec_lines;
 
-	for (int s = 0 ; s < doc.numSectors(); s++)
-	{
-		// clear the "ends" array
-		for (v = 0 ; v < doc.numVertices(); v++)
-			ends[v] = 0;
-
-		// for each sidedef bound to the Sector, store a "1" in the "ends"
-		// array for its starting vertex, and a "2" for its ending vertex.
-		for (const LineDef *L : doc.linedefs)
-		{
-			if (! L->TouchesSector(s, doc))
-				continue;
-
-			// ignore lines with same sector on both sides
-			if (L->left >= 0 && L->right >= 0 &&
-			    L->Left(doc)->sector == L->Right(doc)->sector)
-				continue;
+	Sectors_CollectLines(sec_lines, doc, NULL);
 
-			if (L->right >= 0 && L->Right(doc)->sector == s)
-			{
-				ends[L->start] |= 1;
-				ends[L->end]   |= 2;
-			}
-
-			if (L->left >= 0 && L->Left(doc)->sector == s)
-			{
-				ends[L->start] |= 2;
-				ends[L->end]   |= 1;
-			}
-		}
+	std::vector<byte> ends(doc.numVertices(), 0);
 
-		// every entry in the "ends" array should be 0 or 3
-
-		for (v = 0 ; v < doc.numVertices(); v++)
-		{
-			if (ends[v] == 1 || ends[v] == 2)
-			{
-				 secs.set(s);
-				verts.set(v);
-			}
-		}
+	for (int s = 0 ; s < doc.numSectors(); s++)
+	{
+		if (Sector_IsUnclosed(doc, s, sec_lines[s], ends, &verts))
+			secs.set(s);
 	}
-
-	delete[] ends;
 }
 
 
@@ -676,7 +595,10 @@ static void Sectors_ShowUnclosed(ObjType what, Instance &inst)
 }
 
 
-static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, Document &doc)
+//
+// Can be sped up by calling doc.hover.fastOpposite_begin() beforehand.
+//
+static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, const Document &doc)
 {
 	//
 	// Note from RQ:
@@ -700,8 +622,6 @@ static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, Docume
 	if (doc.numLinedefs() == 0 || doc.numSectors() == 0)
 		return;
 
-	doc.hover.fastOpposite_begin();
-
 	for (int n = 0 ; n < doc.numLinedefs(); n++)
 	{
 		const LineDef *L = doc.linedefs[n];
@@ -728,8 +648,6 @@ static void Sectors_FindMismatches(selection_c& secs, selection_c& lines, Docume
 			}
 		}
 	}
-
-	doc.hover.fastOpposite_finish();
 }
 
 
@@ -740,11 +658,15 @@ static void Sectors_ShowMismatches(ObjType what, Instance &inst)
 
 	selection_c other;
 
+	inst.level.hover.fastOpposite_begin();
+
 	if (what == ObjType::sectors)
 		Sectors_FindMismatches(*inst.edit.Selected, other, inst.level);
 	else
 		Sectors_FindMismatches(other, *inst.edit.Selected, inst.level);
 
+	inst.level.hover.fastOpposite_finish();
+
 	inst.GoToErrors();
 }
 
@@ -1199,145 +1121,16 @@ private:
 	Instance &inst;
 };
 
+//------------------------------------------------------------------------
 
-CheckResult ChecksModule::checkSectors(int min_severity) const
+static bool Thing_IsUnknown(const Instance &inst, const Thing *T)
 {
-	UI_Check_Sectors *dialog = new UI_Check_Sectors(min_severity > 0, inst);
-
-	selection_c  sel, other;
-
-	std::map<int, int> types;
-	SString check_message;
-
-	for (;;)
-	{
-		Sectors_FindUnclosed(sel, other, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No unclosed sectors");
-		else
-		{
-			check_message = SString::printf("%d unclosed sectors", sel.count_obj());
-
-			dialog->AddLine(check_message, 2, 220,
-			                "Show",  &UI_Check_Sectors::action_show_unclosed,
-			                "Verts", &UI_Check_Sectors::action_show_un_verts);
-		}
-
-
-		Sectors_FindMismatches(sel, other, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No mismatched sectors");
-		else
-		{
-			check_message = SString::printf("%d mismatched sectors", sel.count_obj());
-
-			dialog->AddLine(check_message, 2, 220,
-			                "Show",  &UI_Check_Sectors::action_show_mismatch,
-			                "Lines", &UI_Check_Sectors::action_show_mis_lines);
-		}
-
-
-		Sectors_FindBadCeil(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No sectors with ceil < floor");
-		else
-		{
-			check_message = SString::printf("%d sectors with ceil < floor", sel.count_obj());
-
-			dialog->AddLine(check_message, 2, 220,
-			                "Show", &UI_Check_Sectors::action_show_ceil,
-			                "Fix",  &UI_Check_Sectors::action_fix_ceil);
-		}
-
-		dialog->AddGap(10);
-
-
-		Sectors_FindUnknown(sel, types, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No unknown sector types");
-		else
-		{
-			check_message = SString::printf("%d unknown sector types", (int)types.size());
-
-			dialog->AddLine(check_message, 2, 220,
-			                "Show",   &UI_Check_Sectors::action_show_unknown,
-			                "Log",    &UI_Check_Sectors::action_log_unknown,
-			                "Clear",  &UI_Check_Sectors::action_clear_unknown);
-		}
-
-
-		SideDefs_FindPacking(sel, other, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No shared sidedefs");
-		else
-		{
-			int approx_num = sel.count_obj();
-
-			check_message = SString::printf("%d shared sidedefs", approx_num);
-
-			dialog->AddLine(check_message, 1, 200,
-			                "Show",   &UI_Check_Sectors::action_show_packed,
-			                "Unpack", &UI_Check_Sectors::action_unpack);
-		}
-
-
-		Sectors_FindUnused(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No unused sectors");
-		else
-		{
-			check_message = SString::printf("%d unused sectors", sel.count_obj());
-
-			dialog->AddLine(check_message, 1, 170,
-			                "Remove", &UI_Check_Sectors::action_remove);
-		}
+	const thingtype_t &info = M_GetThingType(inst.conf, T->type);
 
-
-		SideDefs_FindUnused(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No unused sidedefs");
-		else
-		{
-			check_message = SString::printf("%d unused sidedefs", sel.count_obj());
-
-			dialog->AddLine(check_message, 1, 170,
-			                "Remove", &UI_Check_Sectors::action_remove_sidedefs);
-		}
-
-
-		// in "ALL" mode, just continue if not too severe
-		if (dialog->WorstSeverity() < min_severity)
-		{
-			delete dialog;
-
-			return CheckResult::ok;
-		}
-
-		CheckResult result = dialog->Run();
-
-		if (result == CheckResult::tookAction)
-		{
-			// repeat the tests
-			dialog->Reset();
-			continue;
-		}
-
-		delete dialog;
-
-		return result;
-	}
+	return info.desc.startsWith("UNKNOWN");
 }
 
 
-//------------------------------------------------------------------------
-
 void Things_FindUnknown(selection_c& list, std::map<int, int>& types, const Instance &inst)
 {
 	types.clear();
@@ -1346,9 +1139,7 @@ void Things_FindUnknown(selection_c& list, std::map<int, int>& types, const Inst
 
 	for (int n = 0 ; n < inst.level.numThings() ; n++)
 	{
-		const thingtype_t &info = M_GetThingType(inst.conf, inst.level.things[n]->type);
-
-		if (info.desc.startsWith("UNKNOWN"))
+		if (Thing_IsUnknown(inst, inst.level.things[n]))
 		{
 			bump_unknown_type(types, inst.level.things[n]->type);
 
@@ -1438,15 +1229,23 @@ static void Things_FindInVoid(selection_c& list, const Instance &inst)
 {
 	list.change_type(ObjType::things);
 
+	const SectorLocator &locator = inst.level.hover.sectorLocator();
+
+	std::vector<v2double_t> positions(inst.level.numThings());
+	std::vector<int> sectors;
+
 	for (int n = 0 ; n < inst.level.numThings() ; n++)
-	{
-		v2double_t pos = inst.level.things[n]->xy();
+		positions[n] = inst.level.things[n]->xy();
 
-		Objid obj = hover::getNearestSector(inst.level, pos);
+	locator.locate(positions, sectors);
 
-		if (! obj.is_nil())
+	for (int n = 0 ; n < inst.level.numThings() ; n++)
+	{
+		if (sectors[n] >= 0)
 			continue;
 
+		const v2double_t &pos = positions[n];
+
 		// allow certain things in the void (Heretic sounds)
 		const thingtype_t &info = M_GetThingType(inst.conf, inst.level.things[n]->type);
 
@@ -1460,9 +1259,7 @@ static void Things_FindInVoid(selection_c& list, const Instance &inst)
 		{
 			v2double_t pos2 = pos + v2double_t{ corner & 1 ? -4.0 : +4.0, corner & 2 ? -4.0 : +4.0 };
 
-			obj = hover::getNearestSector(inst.level, pos2);
-
-			if (obj.is_nil())
+			if (locator.locate(pos2).is_nil())
 				out_count++;
 		}
 
@@ -1632,7 +1429,7 @@ void Things_FixDuds(Instance &inst)
 //------------------------------------------------------------------------
 
 static void CollectBlockingThings(std::vector<int>& list,
-                                  std::vector<int>& sizes, const Instance &inst)
+                                  std::vector<const thingtype_t *>& infos, const Instance &inst)
 {
 	for (int n = 0 ; n < inst.level.numThings() ; n++)
 	{
@@ -1650,7 +1447,7 @@ static void CollectBlockingThings(std::vector<int>& list,
 		// TODO: config option: treat ceiling things as non-blocking
 
 		 list.push_back(n);
-		sizes.push_back(info.radius);
+		infos.push_back(&info);
 	}
 }
 
@@ -1762,7 +1559,8 @@ static inline bool LD_is_blocking(const LineDef *L, const Document &doc)
 }
 
 
-static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &doc)
+static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &doc,
+							 const BlockGrid &blocking_lines, std::vector<int> &nearby)
 {
 	// only check players and monsters
 	if (! (group == 'p' || group == 'm'))
@@ -1780,13 +1578,11 @@ static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &
 	double x2 = T->x() + r;
 	double y2 = T->y() + r;
 
-	for (int n = 0 ; n < doc.numLinedefs(); n++)
-	{
-		const LineDef *L = doc.linedefs[n];
-
-		if (! LD_is_blocking(L, doc))
-			continue;
+	nearby.clear();
+	blocking_lines.query(x1, y1, x2, y2, nearby);
 
+	for (int n : nearby)
+	{
 		if (doc.objects.lineTouchesBox(n, x1, y1, x2, y2))
 			return true;
 	}
@@ -1795,36 +1591,98 @@ static bool ThingStuckInWall(const Thing *T, int r, char group, const Document &
 }
 
 
-static void Things_FindStuckies(selection_c& list, const Instance &inst)
+void Things_FindStuckies(selection_c& list, const Instance &inst)
 {
 	list.change_type(ObjType::things);
 
+	const Document &doc = inst.level;
+
 	std::vector<int> blockers;
-	std::vector<int> sizes;
+	std::vector<const thingtype_t *> infos;
+
+	CollectBlockingThings(blockers, infos, inst);
+
+	if (blockers.empty())
+		return;
 
-	CollectBlockingThings(blockers, sizes, inst);
+	// put the blocking things and lines into a grid, so that only the
+	// nearby ones need to be tested.  Comparing everything with
+	// everything takes ages on maps with many thousands of monsters.
+
+	double min_x, min_y, max_x, max_y;
+	int max_radius = 0;
+
+	min_x = max_x = doc.things[blockers[0]]->x();
+	min_y = max_y = doc.things[blockers[0]]->y();
 
 	for (int n = 0 ; n < (int)blockers.size() ; n++)
 	{
-		const Thing *T = inst.level.things[blockers[n]];
+		const Thing *T = doc.things[blockers[n]];
 
-		const thingtype_t &info = M_GetThingType(inst.conf, T->type);
+		min_x = std::min(min_x, T->x());  max_x = std::max(max_x, T->x());
+		min_y = std::min(min_y, T->y());  max_y = std::max(max_y, T->y());
 
-		if (ThingStuckInWall(T, info.radius, info.group, inst.level))
-			list.set(blockers[n]);
+		max_radius = std::max(max_radius, (int)infos[n]->radius);
+	}
 
-		for (int n2 = n + 1 ; n2 < (int)blockers.size() ; n2++)
-		{
-			const Thing *T2 = inst.level.things[blockers[n2]];
+	BlockGrid blocking_things(min_x, min_y, max_x, max_y);
+	BlockGrid blocking_lines (min_x, min_y, max_x, max_y);
 
-			const thingtype_t &info2 = M_GetThingType(inst.conf, T2->type);
+	for (int n = 0 ; n < (int)blockers.size() ; n++)
+	{
+		const Thing *T = doc.things[blockers[n]];
 
-			if (ThingStuckInThing(inst, T, &info, T2, &info2))
-				list.set(blockers[n]);
-		}
+		blocking_things.insertPoint(n, T->x(), T->y());
 	}
-}
-
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const LineDef *L = doc.linedefs[n];
+
+		if (! LD_is_blocking(L, doc))
+			continue;
+
+		blocking_lines.insertBox(n, L->Start(doc)->x(), L->Start(doc)->y(),
+		                            L->End(doc)->x(),   L->End(doc)->y());
+	}
+
+	std::vector<int> nearby;
+
+	for (int n = 0 ; n < (int)blockers.size() ; n++)
+	{
+		const Thing *T = doc.things[blockers[n]];
+
+		const thingtype_t &info = *infos[n];
+
+		if (ThingStuckInWall(T, info.radius, info.group, doc, blocking_lines, nearby))
+		{
+			list.set(blockers[n]);
+			continue;
+		}
+
+		// any thing which can overlap this one is within both radii
+		double dist = info.radius + max_radius;
+
+		nearby.clear();
+		blocking_things.query(T->x() - dist, T->y() - dist, T->x() + dist, T->y() + dist, nearby);
+
+		for (int n2 : nearby)
+		{
+			// each pair is tested once, marking the first thing
+			if (n2 <= n)
+				continue;
+
+			const Thing *T2 = doc.things[blockers[n2]];
+
+			if (ThingStuckInThing(inst, T, &info, T2, infos[n2]))
+			{
+				list.set(blockers[n]);
+				break;
+			}
+		}
+	}
+}
+
 
 static void Things_ShowStuckies(Instance &inst)
 {
@@ -1909,144 +1767,6 @@ private:
 	Instance &inst;
 };
 
-
-CheckResult ChecksModule::checkThings(int min_severity) const
-{
-	UI_Check_Things *dialog = new UI_Check_Things(min_severity > 0, inst);
-
-	selection_c  sel;
-
-	std::map<int, int> types;
-	SString check_message;
-
-	for (;;)
-	{
-		Things_FindUnknown(sel, types, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No unknown thing types");
-		else
-		{
-			check_message = SString::printf("%d unknown things", (int)types.size());
-
-			dialog->AddLine(check_message, 2, 200,
-			                "Show",   &UI_Check_Things::action_show_unknown,
-			                "Log",    &UI_Check_Things::action_log_unknown,
-			                "Remove", &UI_Check_Things::action_remove_unknown);
-		}
-
-
-		Things_FindStuckies(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No stuck actors");
-		else
-		{
-			check_message = SString::printf("%d stuck actors", sel.count_obj());
-
-			dialog->AddLine(check_message, 2, 200,
-			                "Show",  &UI_Check_Things::action_show_stuck);
-		}
-
-
-		Things_FindInVoid(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No things in the void");
-		else
-		{
-			check_message = SString::printf("%d things in the void", sel.count_obj());
-
-			dialog->AddLine(check_message, 1, 200,
-			                "Show",   &UI_Check_Things::action_show_void,
-			                "Remove", &UI_Check_Things::action_remove_void);
-		}
-
-
-		Things_FindDuds(inst, sel);
-
-		if (sel.empty())
-			dialog->AddLine("No unspawnable things -- skill flags are OK");
-		else
-		{
-			check_message = SString::printf("%d unspawnable things", sel.count_obj());
-			dialog->AddLine(check_message, 1, 200,
-			                "Show", &UI_Check_Things::action_show_duds,
-			                "Fix",  &UI_Check_Things::action_fix_duds);
-		}
-
-
-		dialog->AddGap(10);
-
-
-		int dm_num, mask;
-
-		mask = Things_FindStarts(&dm_num, doc);
-
-		if (inst.conf.features.no_need_players)
-			dialog->AddLine("Player starts not needed, no check done");
-		else if (! (mask & 1))
-			dialog->AddLine("Player 1 start is missing!", 2);
-		else if (! (mask & 2))
-			dialog->AddLine("Player 2 start is missing", 1);
-		else if (! (mask & 4))
-			dialog->AddLine("Player 3 start is missing", 1);
-		else if (! (mask & 8))
-			dialog->AddLine("Player 4 start is missing", 1);
-		else
-			dialog->AddLine("Found all 4 player starts");
-
-		if (inst.conf.features.no_need_players)
-		{
-			// leave a blank space
-		}
-		else if (dm_num == 0)
-		{
-			dialog->AddLine("Map is missing deathmatch starts", 1);
-		}
-		else if (dm_num < inst.conf.miscInfo.min_dm_starts)
-		{
-			check_message = SString::printf("Found %d deathmatch starts -- need at least %d", dm_num,
-				inst.conf.miscInfo.min_dm_starts);
-			dialog->AddLine(check_message, 1);
-		}
-		else if (dm_num > inst.conf.miscInfo.max_dm_starts)
-		{
-			check_message = SString::printf("Found %d deathmatch starts -- maximum is %d", dm_num,
-				inst.conf.miscInfo.max_dm_starts);
-			dialog->AddLine(check_message, 2);
-		}
-		else
-		{
-			check_message = SString::printf("Found %d deathmatch starts -- OK", dm_num);
-			dialog->AddLine(check_message);
-		}
-
-
-		// in "ALL" mode, just continue if not too severe
-		if (dialog->WorstSeverity() < min_severity)
-		{
-			delete dialog;
-
-			return CheckResult::ok;
-		}
-
-		CheckResult result = dialog->Run();
-
-		if (result == CheckResult::tookAction)
-		{
-			// repeat the tests
-			dialog->Reset();
-			continue;
-		}
-
-		delete dialog;
-
-		return result;
-	}
-}
-
-
 //------------------------------------------------------------------------
 
 
@@ -2362,107 +2082,26 @@ static void LineDefs_ClearUnknown(Instance &inst)
 //------------------------------------------------------------------------
 
 
-static int linedef_pos_cmp(int A, int B, const Document &doc)
+//
+// whether two linedefs have exactly the same end points (either way)
+//
+static bool LineDefs_SamePosition(int A, int B, const Document &doc)
 {
-	const LineDef *AL = doc.linedefs[A];
-	const LineDef *BL = doc.linedefs[B];
-
-	int A_x1 = static_cast<int>(AL->Start(doc)->x());
-	int A_y1 = static_cast<int>(AL->Start(doc)->y());
-	int A_x2 = static_cast<int>(AL->End(doc)->x());
-	int A_y2 = static_cast<int>(AL->End(doc)->y());
-
-	int B_x1 = static_cast<int>(BL->Start(doc)->x());
-	int B_y1 = static_cast<int>(BL->Start(doc)->y());
-	int B_x2 = static_cast<int>(BL->End(doc)->x());
-	int B_y2 = static_cast<int>(BL->End(doc)->y());
-
-	if (A_x1 > A_x2 || (A_x1 == A_x2 && A_y1 > A_y2))
-	{
-		std::swap(A_x1, A_x2);
-		std::swap(A_y1, A_y2);
-	}
-
-	if (B_x1 > B_x2 || (B_x1 == B_x2 && B_y1 > B_y2))
-	{
-		std::swap(B_x1, B_x2);
-		std::swap(B_y1, B_y2);
-	}
+	const Vertex *A1 = doc.linedefs[A]->Start(doc);
+	const Vertex *A2 = doc.linedefs[A]->End(doc);
+	const Vertex *B1 = doc.linedefs[B]->Start(doc);
+	const Vertex *B2 = doc.linedefs[B]->End(doc);
 
-	// the "normalized" X1 coordinates is the most significant thing in
-	// this comparison function.
-
-	if (A_x1 != B_x1) return A_x1 - B_x1;
-	if (A_y1 != B_y1) return A_y1 - B_y1;
-
-	if (A_x2 != B_x2) return A_x2 - B_x2;
-	if (A_y2 != B_y2) return A_y2 - B_y2;
-
-	return 0;  // equal : lines are overlapping
+	return (*A1 == *B1 && *A2 == *B2) || (*A1 == *B2 && *A2 == *B1);
 }
 
 
-struct linedef_pos_CMP_pred
-{
-	const Document &doc;
-
-	inline bool operator() (int A, int B) const
-	{
-		return linedef_pos_cmp(A, B, doc) < 0;
-	}
-};
-
-
-struct linedef_minx_CMP_pred
-{
-	const Document &doc;
-
-	inline bool operator() (int A, int B) const
-	{
-		const LineDef *AL = doc.linedefs[A];
-		const LineDef *BL = doc.linedefs[B];
-
-		FFixedPoint A_x = std::min(AL->Start(doc)->raw_x, AL->End(doc)->raw_x);
-		FFixedPoint B_x = std::min(BL->Start(doc)->raw_x, BL->End(doc)->raw_x);
-
-		return A_x < B_x;
-	}
-};
-
-
 static void LineDefs_FindOverlaps(selection_c& lines, const Document &doc)
 {
-	// we only find directly overlapping linedefs here
-
-	lines.change_type(ObjType::linedefs);
-
-	if (doc.numLinedefs() < 2)
-		return;
-
-	int n;
-
-	// sort linedefs by their position.  overlapping lines will end up
-	// adjacent to each other after the sort.
-	std::vector<int> sorted_list(doc.numLinedefs(), 0);
-
-	for (n = 0 ; n < doc.numLinedefs(); n++)
-		sorted_list[n] = n;
-
-	std::sort(sorted_list.begin(), sorted_list.end(), linedef_pos_CMP_pred{ doc });
-
-	for (n = 0 ; n < doc.numLinedefs() - 1 ; n++)
-	{
-		int ld1 = sorted_list[n];
-		int ld2 = sorted_list[n + 1];
-
-		// ignore zero-length lines
-		if (doc.linedefs[ld2]->IsZeroLength(doc))
-			continue;
+	// we only find directly overlapping linedefs here.
+	// only the second (or third, etc) linedef is stored.
 
-		// only the second (or third, etc) linedef is stored
-		if (linedef_pos_cmp(ld1, ld2, doc) == 0)
-			lines.set(ld2);
-	}
+	doc.linemod.findOverlaps(lines);
 }
 
 
@@ -2493,7 +2132,7 @@ static void LineDefs_RemoveOverlaps(Document &doc)
 }
 
 
-static int CheckLinesCross(int A, int B, const Document &doc)
+int CheckLinesCross(int A, int B, const Document &doc)
 {
 	// return values:
 	//    0 : the lines do not cross
@@ -2515,26 +2154,12 @@ static int CheckLinesCross(int A, int B, const Document &doc)
 		return 0;
 
 	// ignore directly overlapping here
-	if (linedef_pos_cmp(A, B, doc) == 0)
+	if (LineDefs_SamePosition(A, B, doc))
 		return 0;
 
 
-	// bbox test
-	//
-	// the algorithm in LineDefs_FindCrossings() ensures that A and B
-	// already overlap on the X axis.  hence only check Y axis here.
-
-	if (std::min(AL->Start(doc)->raw_y, AL->End(doc)->raw_y) >
-		std::max(BL->Start(doc)->raw_y, BL->End(doc)->raw_y))
-	{
-		return 0;
-	}
-
-	if (std::min(BL->Start(doc)->raw_y, BL->End(doc)->raw_y) >
-		std::max(AL->Start(doc)->raw_y, AL->End(doc)->raw_y))
-	{
-		return 0;
-	}
+	// the algorithm in LineDefs_FindCrossings() ensures that the
+	// bounding boxes of A and B overlap.
 
 
 	// precise (but slower) intersection test
@@ -2614,53 +2239,19 @@ static int CheckLinesCross(int A, int B, const Document &doc)
 }
 
 
-static void LineDefs_FindCrossings(selection_c& lines, const Document &doc)
+void LineDefs_FindCrossings(selection_c& lines, const Document &doc)
 {
 	lines.change_type(ObjType::linedefs);
 
-	if (doc.numLinedefs() < 2)
-		return;
-
-	int n;
-
-	// sort linedefs by their position.  linedefs which cross will be
-	// near each other in this list.
-	std::vector<int> sorted_list(doc.numLinedefs(), 0);
-
-	for (n = 0 ; n < doc.numLinedefs(); n++)
-		sorted_list[n] = n;
-
-	std::sort(sorted_list.begin(), sorted_list.end(), linedef_minx_CMP_pred{ doc });
-
-	for (n = 0 ; n < doc.numLinedefs(); n++)
+	// only linedefs whose bounding boxes overlap can cross
+	linemod::forEachOverlappingBoxPair(doc, [&lines, &doc](int A, int B)
 	{
-		int n2 = sorted_list[n];
-
-		const LineDef *L1 = doc.linedefs[n2];
-
-		FFixedPoint max_x = std::max(L1->Start(doc)->raw_x, L1->End(doc)->raw_x);
-
-		for (int k = n + 1 ; k < doc.numLinedefs(); k++)
+		if (CheckLinesCross(A, B, doc))
 		{
-			int k2 = sorted_list[k];
-
-			const LineDef *L2 = doc.linedefs[k2];
-
-			FFixedPoint min_x = std::min(L2->Start(doc)->raw_x, L2->End(doc)->raw_x);
-
-			// stop when all remaining linedefs are to the right of L1
-			if (min_x > max_x)
-				break;
-
-			int res = CheckLinesCross(n2, k2, doc);
-
-			if (res)
-			{
-				lines.set(n2);
-				lines.set(k2);
-			}
+			lines.set(A);
+			lines.set(B);
 		}
-	}
+	});
 }
 
 
@@ -2800,235 +2391,85 @@ private:
 	Instance &inst;
 };
 
+//------------------------------------------------------------------------
 
-CheckResult ChecksModule::checkLinedefs(int min_severity) const
+void ChecksModule::tagsUsedRange(int *min_tag, int *max_tag) const
 {
-	UI_Check_LineDefs *dialog = new UI_Check_LineDefs(min_severity > 0, inst);
-
-	selection_c  sel, other;
-
-	std::map<int, int> types;
+	int i;
 
-	SString check_buffer;
+	*min_tag = INT_MAX;
+	*max_tag = INT_MIN;
 
-	for (;;)
+	for (i = 0 ; i < doc.numLinedefs(); i++)
 	{
-		LineDefs_FindZeroLen(sel, doc);
+		int tag = doc.linedefs[i]->tag;
 
-		if (sel.empty())
-			dialog->AddLine("No zero-length linedefs");
-		else
+		if (tag > 0)
 		{
-			check_buffer = SString::printf("%d zero-length linedefs", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 220,
-			                "Show",   &UI_Check_LineDefs::action_show_zero,
-			                "Remove", &UI_Check_LineDefs::action_remove_zero);
+			*min_tag = std::min(*min_tag, tag);
+			*max_tag = std::max(*max_tag, tag);
 		}
+	}
 
+	for (i = 0 ; i < doc.numSectors() ; i++)
+	{
+		int tag = doc.sectors[i]->tag;
 
-		LineDefs_FindOverlaps(sel, doc);
+		// ignore special tags
+		if (inst.conf.features.tag_666 != Tag666Rules::disabled && (tag == 666 || tag == 667))
+			continue;
 
-		if (sel.empty())
-			dialog->AddLine("No overlapping linedefs");
-		else
+		if (tag > 0)
 		{
-			check_buffer = SString::printf("%d overlapping linedefs", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 220,
-			                "Show",   &UI_Check_LineDefs::action_show_overlap,
-			                "Remove", &UI_Check_LineDefs::action_remove_overlap);
+			*min_tag = std::min(*min_tag, tag);
+			*max_tag = std::max(*max_tag, tag);
 		}
+	}
 
+	// none at all?
+	if (*min_tag > *max_tag)
+	{
+		*min_tag = *max_tag = 0;
+	}
+}
 
-		LineDefs_FindCrossings(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No criss-crossing linedefs");
-		else
-		{
-			check_buffer = SString::printf("%d criss-crossing linedefs", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 220,
-			                "Show", &UI_Check_LineDefs::action_show_crossing);
-		}
 
-		dialog->AddGap(10);
+void ChecksModule::tagsApplyNewValue(int new_tag)
+{
+	// uses the current selection (caller must set it up)
 
+	bool changed = false;
 
-		LineDefs_FindUnknown(sel, types, inst);
+	{
+		EditOperation op(doc.basis);
+		op.setMessageForSelection("new tag for", *inst.edit.Selected);
 
-		if (sel.empty())
-			dialog->AddLine("No unknown line types");
-		else
+		for (sel_iter_c it(inst.edit.Selected); !it.done(); it.next())
 		{
-			check_buffer = SString::printf("%d unknown line types", (int)types.size());
-
-			dialog->AddLine(check_buffer, 1, 210,
-			                "Show",   &UI_Check_LineDefs::action_show_unknown,
-			                "Log",    &UI_Check_LineDefs::action_log_unknown,
-			                "Clear",  &UI_Check_LineDefs::action_clear_unknown);
+			if (inst.edit.mode == ObjType::linedefs)
+			{
+				op.changeLinedef(*it, LineDef::F_TAG, new_tag);
+				changed = true;
+			}
+			else if (inst.edit.mode == ObjType::sectors)
+			{
+				op.changeSector(*it, Sector::F_TAG, new_tag);
+				changed = true;
+			}
 		}
+	}
+	if(changed)
+		mLastTag = new_tag;
+}
 
 
-		LineDefs_FindMissingRight(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No linedefs without a right side");
-		else
-		{
-			check_buffer = SString::printf("%d linedefs without right side", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 300,
-			                "Show", &UI_Check_LineDefs::action_show_mis_right);
-		}
-
-
-		LineDefs_FindManualDoors(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No manual doors on 1S linedefs");
-		else
-		{
-			check_buffer = SString::printf("%d manual doors on 1S linedefs", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 300,
-			                "Show", &UI_Check_LineDefs::action_show_manual_doors,
-			                "Fix",  &UI_Check_LineDefs::action_fix_manual_doors);
-		}
-
-
-		LineDefs_FindLackImpass(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No non-blocking one-sided linedefs");
-		else
-		{
-			check_buffer = SString::printf("%d non-blocking one-sided linedefs", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 1, 300,
-			                "Show", &UI_Check_LineDefs::action_show_lack_impass,
-			                "Fix",  &UI_Check_LineDefs::action_fix_lack_impass);
-		}
-
-
-		LineDefs_FindBad2SFlag(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No linedefs with wrong 2S flag");
-		else
-		{
-			check_buffer = SString::printf("%d linedefs with wrong 2S flag", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 1, 300,
-			                "Show", &UI_Check_LineDefs::action_show_bad_2s_flag,
-			                "Fix",  &UI_Check_LineDefs::action_fix_bad_2s_flag);
-		}
-
-
-		// in "ALL" mode, just continue if not too severe
-		if (dialog->WorstSeverity() < min_severity)
-		{
-			delete dialog;
-
-			return CheckResult::ok;
-		}
-
-		CheckResult result = dialog->Run();
-
-		if (result == CheckResult::tookAction)
-		{
-			// repeat the tests
-			dialog->Reset();
-			continue;
-		}
-
-		delete dialog;
-
-		return result;
-	}
-}
-
-
-//------------------------------------------------------------------------
-
-void ChecksModule::tagsUsedRange(int *min_tag, int *max_tag) const
-{
-	int i;
-
-	*min_tag = INT_MAX;
-	*max_tag = INT_MIN;
-
-	for (i = 0 ; i < doc.numLinedefs(); i++)
-	{
-		int tag = doc.linedefs[i]->tag;
-
-		if (tag > 0)
-		{
-			*min_tag = std::min(*min_tag, tag);
-			*max_tag = std::max(*max_tag, tag);
-		}
-	}
-
-	for (i = 0 ; i < doc.numSectors() ; i++)
-	{
-		int tag = doc.sectors[i]->tag;
-
-		// ignore special tags
-		if (inst.conf.features.tag_666 != Tag666Rules::disabled && (tag == 666 || tag == 667))
-			continue;
-
-		if (tag > 0)
-		{
-			*min_tag = std::min(*min_tag, tag);
-			*max_tag = std::max(*max_tag, tag);
-		}
-	}
-
-	// none at all?
-	if (*min_tag > *max_tag)
-	{
-		*min_tag = *max_tag = 0;
-	}
-}
-
-
-void ChecksModule::tagsApplyNewValue(int new_tag)
-{
-	// uses the current selection (caller must set it up)
-
-	bool changed = false;
-
-	{
-		EditOperation op(doc.basis);
-		op.setMessageForSelection("new tag for", *inst.edit.Selected);
-
-		for (sel_iter_c it(inst.edit.Selected); !it.done(); it.next())
-		{
-			if (inst.edit.mode == ObjType::linedefs)
-			{
-				op.changeLinedef(*it, LineDef::F_TAG, new_tag);
-				changed = true;
-			}
-			else if (inst.edit.mode == ObjType::sectors)
-			{
-				op.changeSector(*it, Sector::F_TAG, new_tag);
-				changed = true;
-			}
-		}
-	}
-	if(changed)
-		mLastTag = new_tag;
-}
-
-
-void Instance::CMD_ApplyTag()
-{
-	if (! (edit.mode == ObjType::sectors || edit.mode == ObjType::linedefs))
-	{
-		Beep("ApplyTag: wrong mode");
-		return;
-	}
+void Instance::CMD_ApplyTag()
+{
+	if (! (edit.mode == ObjType::sectors || edit.mode == ObjType::linedefs))
+	{
+		Beep("ApplyTag: wrong mode");
+		return;
+	}
 
 	bool do_last = false;
 
@@ -3329,116 +2770,6 @@ private:
 	Instance &inst;
 };
 
-
-CheckResult ChecksModule::checkTags(int min_severity) const
-{
-	UI_Check_Tags *dialog = new UI_Check_Tags(min_severity > 0, inst);
-
-	selection_c  sel;
-	SString check_buffer;
-
-	for (;;)
-	{
-		Tags_FindMissingTags(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No linedefs missing a needed tag");
-		else
-		{
-			check_buffer = SString::printf("%d linedefs missing a needed tag", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 320,
-			                "Show", &UI_Check_Tags::action_show_missing_tag);
-		}
-
-
-		Tags_FindUnmatchedLineDefs(sel, doc);
-
-		if (sel.empty())
-			dialog->AddLine("No tagged linedefs w/o a matching sector");
-		else
-		{
-			check_buffer = SString::printf("%d tagged linedefs w/o a matching sector", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 2, 350,
-			                "Show", &UI_Check_Tags::action_show_unmatch_line);
-		}
-
-
-		Tags_FindUnmatchedSectors(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No tagged sectors w/o a matching linedef");
-		else
-		{
-			check_buffer = SString::printf("%d tagged sectors w/o a matching linedef", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 1, 350,
-			                "Show", &UI_Check_Tags::action_show_unmatch_sec);
-		}
-
-
-		Tags_FindBeastMarks(sel, inst);
-
-		if (sel.empty())
-			dialog->AddLine("No sectors with tag 666 or 667 used on the wrong map");
-		else
-		{
-			check_buffer = SString::printf("%d sectors have an invalid 666/667 tag", sel.count_obj());
-
-			dialog->AddLine(check_buffer, 1, 350,
-			                "Show", &UI_Check_Tags::action_show_beast_marks);
-		}
-
-		dialog->AddGap(10);
-
-
-		int min_tag, max_tag;
-
-		tagsUsedRange(&min_tag, &max_tag);
-
-		if (max_tag <= 0)
-			dialog->AddLine("No tags are in use");
-		else
-		{
-			check_buffer = SString::printf("Lowest tag: %d   Highest tag: %d", min_tag, max_tag);
-			dialog->AddLine(check_buffer);
-		}
-
-		if ((inst.edit.mode == ObjType::linedefs || inst.edit.mode == ObjType::sectors) &&
-		    inst.edit.Selected->notempty())
-		{
-			// always assume sector beastmark tags here
-			dialog->fresh_tag = findFreeTag(inst, true);
-
-			dialog->AddGap(10);
-			dialog->AddLine("Apply a fresh tag to the selection", 0, 250, "Apply",
-			                &UI_Check_Tags::action_fresh_tag);
-		}
-
-		if (dialog->WorstSeverity() < min_severity)
-		{
-			delete dialog;
-
-			return CheckResult::ok;
-		}
-
-		CheckResult result = dialog->Run();
-
-		if (result == CheckResult::tookAction)
-		{
-			// repeat the tests
-			dialog->Reset();
-			continue;
-		}
-
-		delete dialog;
-
-		return result;
-	}
-}
-
-
 //------------------------------------------------------------------------
 
 
@@ -3454,43 +2785,47 @@ static void bump_unknown_name(std::map<SString, int>& list,
 }
 
 
-static void Textures_FindMissing(const Instance &inst, selection_c& lines)
+static bool LineDef_IsMissingTex(const Instance &inst, const LineDef *L)
 {
-	lines.change_type(ObjType::linedefs);
+	if (L->right < 0)
+		return false;
 
-	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
-	{
-		const LineDef *L = inst.level.linedefs[n];
+	if (L->OneSided())
+		return is_null_tex(L->Right(inst.level)->MidTex());
 
-		if (L->right < 0)
-			continue;
+	// Two Sided
 
-		if (L->OneSided())
-		{
-			if (is_null_tex(L->Right(inst.level)->MidTex()))
-				lines.set(n);
-		}
-		else  // Two Sided
-		{
-			const Sector *front = L->Right(inst.level)->SecRef(inst.level);
-			const Sector *back  = L->Left(inst.level) ->SecRef(inst.level);
+	const Sector *front = L->Right(inst.level)->SecRef(inst.level);
+	const Sector *back  = L->Left(inst.level) ->SecRef(inst.level);
 
-			if (front->floorh < back->floorh && is_null_tex(L->Right(inst.level)->LowerTex()))
-				lines.set(n);
+	if (front->floorh < back->floorh && is_null_tex(L->Right(inst.level)->LowerTex()))
+		return true;
 
-			if (back->floorh < front->floorh && is_null_tex(L->Left(inst.level)->LowerTex()))
-				lines.set(n);
+	if (back->floorh < front->floorh && is_null_tex(L->Left(inst.level)->LowerTex()))
+		return true;
 
-			// missing uppers are OK when between two sky ceilings
-			if (inst.is_sky(front->CeilTex()) && inst.is_sky(back->CeilTex()))
-				continue;
+	// missing uppers are OK when between two sky ceilings
+	if (inst.is_sky(front->CeilTex()) && inst.is_sky(back->CeilTex()))
+		return false;
 
-			if (front->ceilh > back->ceilh && is_null_tex(L->Right(inst.level)->UpperTex()))
-				lines.set(n);
+	if (front->ceilh > back->ceilh && is_null_tex(L->Right(inst.level)->UpperTex()))
+		return true;
 
-			if (back->ceilh > front->ceilh && is_null_tex(L->Left(inst.level)->UpperTex()))
-				lines.set(n);
-		}
+	if (back->ceilh > front->ceilh && is_null_tex(L->Left(inst.level)->UpperTex()))
+		return true;
+
+	return false;
+}
+
+
+static void Textures_FindMissing(const Instance &inst, selection_c& lines)
+{
+	lines.change_type(ObjType::linedefs);
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		if (LineDef_IsMissingTex(inst, inst.level.linedefs[n]))
+			lines.set(n);
 	}
 }
 
@@ -3796,38 +3131,75 @@ static void Textures_LogMedusa(const Instance &inst)
 }
 
 
-static void Textures_FindUnknownTex(selection_c& lines,
-                             std::map<SString, int>& names, const Instance &inst)
+//
+// Checks a line for unknown textures, and counts them in 'names'
+// (when given).
+//
+static bool LineDef_HasUnknownTex(const Instance &inst, const LineDef *L,
+								  std::map<SString, int> *names)
 {
-	lines.change_type(ObjType::linedefs);
+	bool found = false;
 
-	names.clear();
-
-	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	for (int side = 0 ; side < 2 ; side++)
 	{
-		const LineDef *L = inst.level.linedefs[n];
+		const SideDef *SD = side ? L->Left(inst.level) : L->Right(inst.level);
 
-		for (int side = 0 ; side < 2 ; side++)
-		{
-			const SideDef *SD = side ? L->Left(inst.level) : L->Right(inst.level);
+		if (! SD)
+			continue;
 
-			if (! SD)
-				continue;
+		for (int part = 0 ; part < 3 ; part++)
+		{
+			SString tex = (part == 0) ? SD->LowerTex() :
+						  (part == 1) ? SD->UpperTex() : SD->MidTex();
 
-			for (int part = 0 ; part < 3 ; part++)
+			if (! inst.wad.images.W_TextureIsKnown(inst.conf, tex))
 			{
-				SString tex = (part == 0) ? SD->LowerTex() :
-							  (part == 1) ? SD->UpperTex() : SD->MidTex();
-
-				if (! inst.wad.images.W_TextureIsKnown(inst.conf, tex))
-				{
-					bump_unknown_name(names, tex);
+				if (names)
+					bump_unknown_name(*names, tex);
 
-					lines.set(n);
-				}
+				found = true;
 			}
 		}
 	}
+
+	return found;
+}
+
+
+static bool Sector_HasUnknownFlat(const Instance &inst, const Sector *S,
+								  std::map<SString, int> *names)
+{
+	bool found = false;
+
+	for (int part = 0 ; part < 2 ; part++)
+	{
+		SString flat = part ? S->CeilTex() : S->FloorTex();
+
+		if (! inst.wad.images.W_FlatIsKnown(inst.conf, flat))
+		{
+			if (names)
+				bump_unknown_name(*names, flat);
+
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+
+static void Textures_FindUnknownTex(selection_c& lines,
+                             std::map<SString, int>& names, const Instance &inst)
+{
+	lines.change_type(ObjType::linedefs);
+
+	names.clear();
+
+	for (int n = 0 ; n < inst.level.numLinedefs(); n++)
+	{
+		if (LineDef_HasUnknownTex(inst, inst.level.linedefs[n], &names))
+			lines.set(n);
+	}
 }
 
 
@@ -3840,19 +3212,8 @@ static void Textures_FindUnknownFlat(selection_c& secs,
 
 	for (int s = 0 ; s < inst.level.numSectors(); s++)
 	{
-		const Sector *S = inst.level.sectors[s];
-
-		for (int part = 0 ; part < 2 ; part++)
-		{
-			SString flat = part ? S->CeilTex() : S->FloorTex();
-
-			if (! inst.wad.images.W_FlatIsKnown(inst.conf, flat))
-			{
-				bump_unknown_name(names, flat);
-
-				secs.set(s);
-			}
-		}
+		if (Sector_HasUnknownFlat(inst, inst.level.sectors[s], &names))
+			secs.set(s);
 	}
 }
 
@@ -4237,111 +3598,942 @@ private:
 	Instance &inst;
 };
 
+//------------------------------------------------------------------------
+//  CHECK ENGINE
+//------------------------------------------------------------------------
 
-CheckResult ChecksModule::checkTextures(int min_severity) const
+const char *checkGroupName(CheckGroup group)
 {
-	UI_Check_Textures *dialog = new UI_Check_Textures(min_severity > 0, inst);
+	switch (group)
+	{
+		case CheckGroup::vertices: return "vertices";
+		case CheckGroup::sectors:  return "sectors";
+		case CheckGroup::linedefs: return "linedefs";
+		case CheckGroup::things:   return "things";
+		case CheckGroup::textures: return "textures";
+		case CheckGroup::tags:     return "tags";
 
-	selection_c  sel;
+		default: return "???";
+	}
+}
 
-	std::map<SString, int> names;
-	SString check_buffer;
 
-	for (;;)
+//
+// Adds one result line, using the "ok" message when nothing was found
+//
+static void AddFinding(std::vector<CheckFinding> &list, CheckId id,
+					   int count, int severity, const char *ok_msg,
+					   const char *bad_fmt)
+{
+	CheckFinding finding;
+
+	finding.id = id;
+
+	if (count == 0)
+		finding.message = ok_msg;
+	else
 	{
-		Textures_FindUnknownTex(sel, names, inst);
+		finding.severity = severity;
+		finding.message = SString::printf(bad_fmt, count);
+	}
 
-		if (sel.empty())
-			dialog->AddLine("No unknown textures");
-		else
+	list.push_back(std::move(finding));
+}
+
+
+static void AddInfo(std::vector<CheckFinding> &list, CheckId id,
+					int severity, const SString &message)
+{
+	CheckFinding finding;
+
+	finding.id = id;
+	finding.severity = severity;
+	finding.message = message;
+
+	list.push_back(std::move(finding));
+}
+
+
+static void Things_CheckStarts(const Instance &inst, std::vector<CheckFinding> &list)
+{
+	if (inst.conf.features.no_need_players)
+	{
+		AddInfo(list, CheckId::thingPlayerStarts, 0, "Player starts not needed, no check done");
+		return;
+	}
+
+	int dm_num;
+	int mask = Things_FindStarts(&dm_num, inst.level);
+
+	if (! (mask & 1))
+		AddInfo(list, CheckId::thingPlayerStarts, 2, "Player 1 start is missing!");
+	else if (! (mask & 2))
+		AddInfo(list, CheckId::thingPlayerStarts, 1, "Player 2 start is missing");
+	else if (! (mask & 4))
+		AddInfo(list, CheckId::thingPlayerStarts, 1, "Player 3 start is missing");
+	else if (! (mask & 8))
+		AddInfo(list, CheckId::thingPlayerStarts, 1, "Player 4 start is missing");
+	else
+		AddInfo(list, CheckId::thingPlayerStarts, 0, "Found all 4 player starts");
+
+	if (dm_num == 0)
+	{
+		AddInfo(list, CheckId::thingDeathmatchStarts, 1, "Map is missing deathmatch starts");
+	}
+	else if (dm_num < inst.conf.miscInfo.min_dm_starts)
+	{
+		AddInfo(list, CheckId::thingDeathmatchStarts, 1,
+				SString::printf("Found %d deathmatch starts -- need at least %d", dm_num,
+				inst.conf.miscInfo.min_dm_starts));
+	}
+	else if (dm_num > inst.conf.miscInfo.max_dm_starts)
+	{
+		AddInfo(list, CheckId::thingDeathmatchStarts, 2,
+				SString::printf("Found %d deathmatch starts -- maximum is %d", dm_num,
+				inst.conf.miscInfo.max_dm_starts));
+	}
+	else
+	{
+		AddInfo(list, CheckId::thingDeathmatchStarts, 0,
+				SString::printf("Found %d deathmatch starts -- OK", dm_num));
+	}
+}
+
+
+static void Tags_CheckRange(const Instance &inst, std::vector<CheckFinding> &list)
+{
+	int min_tag, max_tag;
+
+	inst.level.checks.tagsUsedRange(&min_tag, &max_tag);
+
+	if (max_tag <= 0)
+		AddInfo(list, CheckId::tagRange, 0, "No tags are in use");
+	else
+		AddInfo(list, CheckId::tagRange, 0,
+				SString::printf("Lowest tag: %d   Highest tag: %d", min_tag, max_tag));
+}
+
+
+//
+// The map checks, in the order shown in the dialogs. They only read the
+// level and the game config, so they can run in parallel.
+//
+namespace
+{
+struct CheckTask
+{
+	CheckGroup group;
+	void (* run)(const Instance &inst, std::vector<CheckFinding> &list);
+};
+
+typedef std::map<int, int>     type_counts_t;
+typedef std::map<SString, int> name_counts_t;
+
+#define SELECTION_CHECK(group, id, finder, severity, ok_msg, bad_fmt)  \
+	{ CheckGroup::group, [](const Instance &inst, std::vector<CheckFinding> &list)  \
+		{  \
+			selection_c sel, other;  \
+			finder;  \
+			AddFinding(list, CheckId::id, sel.count_obj(), severity, ok_msg, bad_fmt);  \
+		} }
+
+// for the checks which count the distinct unknown types / names
+#define NAMES_CHECK(group, id, names_type, finder, severity, ok_msg, bad_fmt)  \
+	{ CheckGroup::group, [](const Instance &inst, std::vector<CheckFinding> &list)  \
+		{  \
+			selection_c sel;  \
+			names_type names;  \
+			finder;  \
+			AddFinding(list, CheckId::id, sel.empty() ? 0 : (int)names.size(), severity, ok_msg, bad_fmt);  \
+		} }
+
+const CheckTask check_tasks[] =
+{
+	SELECTION_CHECK(vertices, vertexOverlaps, Vertex_FindOverlaps(sel, inst.level), 2,
+			"No overlapping vertices", "%d overlapping vertices"),
+	SELECTION_CHECK(vertices, vertexDanglers, Vertex_FindDanglers(sel, inst.level), 2,
+			"No dangling vertices", "%d dangling vertices"),
+	SELECTION_CHECK(vertices, vertexUnused, Vertex_FindUnused(sel, inst.level), 1,
+			"No unused vertices", "%d unused vertices"),
+
+	SELECTION_CHECK(sectors, sectorUnclosed, Sectors_FindUnclosed(sel, other, inst.level), 2,
+			"No unclosed sectors", "%d unclosed sectors"),
+	SELECTION_CHECK(sectors, sectorMismatches, Sectors_FindMismatches(sel, other, inst.level), 2,
+			"No mismatched sectors", "%d mismatched sectors"),
+	SELECTION_CHECK(sectors, sectorBadCeil, Sectors_FindBadCeil(sel, inst.level), 2,
+			"No sectors with ceil < floor", "%d sectors with ceil < floor"),
+	NAMES_CHECK(sectors, sectorUnknown, type_counts_t, Sectors_FindUnknown(sel, names, inst), 2,
+			"No unknown sector types", "%d unknown sector types"),
+	SELECTION_CHECK(sectors, sidedefPacking, SideDefs_FindPacking(sel, other, inst.level), 1,
+			"No shared sidedefs", "%d shared sidedefs"),
+	SELECTION_CHECK(sectors, sectorUnused, Sectors_FindUnused(sel, inst.level), 1,
+			"No unused sectors", "%d unused sectors"),
+	SELECTION_CHECK(sectors, sidedefUnused, SideDefs_FindUnused(sel, inst.level), 1,
+			"No unused sidedefs", "%d unused sidedefs"),
+
+	SELECTION_CHECK(linedefs, lineZeroLen, LineDefs_FindZeroLen(sel, inst.level), 2,
+			"No zero-length linedefs", "%d zero-length linedefs"),
+	SELECTION_CHECK(linedefs, lineOverlaps, LineDefs_FindOverlaps(sel, inst.level), 2,
+			"No overlapping linedefs", "%d overlapping linedefs"),
+	SELECTION_CHECK(linedefs, lineCrossings, LineDefs_FindCrossings(sel, inst.level), 2,
+			"No criss-crossing linedefs", "%d criss-crossing linedefs"),
+	NAMES_CHECK(linedefs, lineUnknown, type_counts_t, LineDefs_FindUnknown(sel, names, inst), 1,
+			"No unknown line types", "%d unknown line types"),
+	SELECTION_CHECK(linedefs, lineMissingRight, LineDefs_FindMissingRight(sel, inst.level), 2,
+			"No linedefs without a right side", "%d linedefs without right side"),
+	SELECTION_CHECK(linedefs, lineManualDoors, LineDefs_FindManualDoors(sel, inst), 2,
+			"No manual doors on 1S linedefs", "%d manual doors on 1S linedefs"),
+	SELECTION_CHECK(linedefs, lineLackImpass, LineDefs_FindLackImpass(sel, inst.level), 1,
+			"No non-blocking one-sided linedefs", "%d non-blocking one-sided linedefs"),
+	SELECTION_CHECK(linedefs, lineBad2SFlag, LineDefs_FindBad2SFlag(sel, inst.level), 1,
+			"No linedefs with wrong 2S flag", "%d linedefs with wrong 2S flag"),
+
+	NAMES_CHECK(things, thingUnknown, type_counts_t, Things_FindUnknown(sel, names, inst), 2,
+			"No unknown thing types", "%d unknown things"),
+	SELECTION_CHECK(things, thingStuck, Things_FindStuckies(sel, inst), 2,
+			"No stuck actors", "%d stuck actors"),
+	SELECTION_CHECK(things, thingInVoid, Things_FindInVoid(sel, inst), 1,
+			"No things in the void", "%d things in the void"),
+	SELECTION_CHECK(things, thingDuds, Things_FindDuds(inst, sel), 1,
+			"No unspawnable things -- skill flags are OK", "%d unspawnable things"),
+	{ CheckGroup::things, Things_CheckStarts },
+
+	NAMES_CHECK(textures, textureUnknown, name_counts_t, Textures_FindUnknownTex(sel, names, inst), 2,
+			"No unknown textures", "%d unknown textures"),
+	NAMES_CHECK(textures, flatUnknown, name_counts_t, Textures_FindUnknownFlat(sel, names, inst), 2,
+			"No unknown flats", "%d unknown flats"),
+	{ CheckGroup::textures, [](const Instance &inst, std::vector<CheckFinding> &list)
 		{
-			check_buffer = SString::printf("%d unknown textures", (int)names.size());
+			if (inst.conf.features.medusa_fixed)
+				return;
 
-			dialog->AddLine(check_buffer, 2, 200,
-			                "Show", &UI_Check_Textures::action_show_unk_tex,
-			                "Log",  &UI_Check_Textures::action_log_unk_tex,
-			                "Fix",  &UI_Check_Textures::action_fix_unk_tex);
-		}
+			selection_c sel;
+			std::map<SString, int> names;
+			Textures_FindMedusa(sel, names, inst);
+			AddFinding(list, CheckId::textureMedusa, sel.empty() ? 0 : (int)names.size(), 2,
+					   "No textures causing Medusa Effect", "%d Medusa textures");
+		} },
+	SELECTION_CHECK(textures, textureMissing, Textures_FindMissing(inst, sel), 1,
+			"No missing textures on walls", "%d missing textures on walls"),
+	{ CheckGroup::textures, [](const Instance &inst, std::vector<CheckFinding> &list)
+		{
+			selection_c sel;
+			std::map<SString, int> names;
+			Textures_FindTransparent(inst, sel, names);
+			AddFinding(list, CheckId::textureTransparent, sel.count_obj(), 1,
+					   "No transparent textures on solids", "%d transparent textures on solids");
+		} },
+	SELECTION_CHECK(textures, textureDupSwitches, Textures_FindDupSwitches(sel, inst.level), 1,
+			"No non-animating switch textures", "%d non-animating switch textures"),
+
+	SELECTION_CHECK(tags, tagMissing, Tags_FindMissingTags(sel, inst), 2,
+			"No linedefs missing a needed tag", "%d linedefs missing a needed tag"),
+	SELECTION_CHECK(tags, tagUnmatchedLines, Tags_FindUnmatchedLineDefs(sel, inst.level), 2,
+			"No tagged linedefs w/o a matching sector", "%d tagged linedefs w/o a matching sector"),
+	SELECTION_CHECK(tags, tagUnmatchedSectors, Tags_FindUnmatchedSectors(sel, inst), 1,
+			"No tagged sectors w/o a matching linedef", "%d tagged sectors w/o a matching linedef"),
+	SELECTION_CHECK(tags, tagBeastMarks, Tags_FindBeastMarks(sel, inst), 1,
+			"No sectors with tag 666 or 667 used on the wrong map", "%d sectors have an invalid 666/667 tag"),
+	{ CheckGroup::tags, Tags_CheckRange },
+};
 
+#undef SELECTION_CHECK
+#undef NAMES_CHECK
+}
 
-		Textures_FindUnknownFlat(sel, names, inst);
 
-		if (sel.empty())
-			dialog->AddLine("No unknown flats");
-		else
+//
+// Decodes the textures on the walls, which the transparency checks look
+// at, so that no check job has to decode them (and print about it).
+//
+static void DecodeWallTextures(const Instance &inst)
+{
+	std::vector<int> texs;
+
+	for (const SideDef *SD : inst.level.sidedefs)
+	{
+		texs.push_back(SD->upper_tex);
+		texs.push_back(SD->mid_tex);
+		texs.push_back(SD->lower_tex);
+	}
+
+	std::sort(texs.begin(), texs.end());
+	texs.erase(std::unique(texs.begin(), texs.end()), texs.end());
+
+	std::vector<SString> names;
+
+	for (int tex : texs)
+	{
+		SString name = BA_GetString(tex);
+
+		if (! is_null_tex(name))
+			names.push_back(name);
+	}
+
+	inst.wad.images.decodeNamed(inst.conf, names, {});
+}
+
+
+//
+// Runs the map checks of the given groups (a mask of checkGroupBit()
+// values) on the thread pool, and returns their results in dialog order.
+// Every check adds a line, including the ones which found nothing.
+//
+void ChecksModule::collectFindings(std::vector<CheckFinding> &list, unsigned groups) const
+{
+	list.clear();
+
+	std::vector<const CheckTask *> tasks;
+
+	for (const CheckTask &task : check_tasks)
+		if (groups & checkGroupBit(task.group))
+			tasks.push_back(&task);
+
+	if (tasks.empty())
+		return;
+
+	std::vector<std::vector<CheckFinding>> results(tasks.size());
+	std::vector<std::vector<SString>> messages(tasks.size());
+
+	if (groups & checkGroupBit(CheckGroup::textures))
+		DecodeWallTextures(inst);
+
+	// the mismatched sectors check is much faster with this.  It must be
+	// set up here, since the checks themselves may not modify anything.
+	bool fast_opposite = (groups & checkGroupBit(CheckGroup::sectors)) != 0;
+
+	if (fast_opposite)
+		doc.hover.fastOpposite_begin();
+
+	try
+	{
+		const Instance &cinst = inst;
+
+		ThreadPool::shared().parallelFor((int)tasks.size(), [&](int i)
 		{
-			check_buffer = SString::printf("%d unknown flats", (int)names.size());
+			LogCapture capture;
+
+			tasks[i]->run(cinst, results[i]);
+
+			messages[i] = capture.messages();
+		});
+	}
+	catch (...)
+	{
+		if (fast_opposite)
+			doc.hover.fastOpposite_finish();
+		throw;
+	}
+
+	if (fast_opposite)
+		doc.hover.fastOpposite_finish();
+
+	// same order as running the checks one by one
+	for (const std::vector<SString> &task_messages : messages)
+		for (const SString &message : task_messages)
+			gLog.printf("%s", message.c_str());
 
-			dialog->AddLine(check_buffer, 2, 200,
-			                "Show", &UI_Check_Textures::action_show_unk_flat,
-			                "Log",  &UI_Check_Textures::action_log_unk_flat,
-			                "Fix",  &UI_Check_Textures::action_fix_unk_flat);
+	for (size_t i = 0 ; i < tasks.size() ; i++)
+	{
+		for (CheckFinding &finding : results[i])
+		{
+			finding.group = tasks[i]->group;
+			list.push_back(std::move(finding));
 		}
+	}
+}
+
+
+//------------------------------------------------------------------------
+//  LIVE CHECKS
+//------------------------------------------------------------------------
+
+static int CountBits(byte value)
+{
+	int count = 0;
+
+	for ( ; value ; value &= value - 1)
+		count++;
+
+	return count;
+}
+
+
+void LiveChecks::setBits(std::vector<byte> &bits, int n, byte value)
+{
+	mProblems += CountBits(value) - CountBits(bits[n]);
+
+	bits[n] = value;
+}
+
+
+//
+// Checks the whole map (after loading it, or new game definitions)
+//
+void LiveChecks::recheckAll()
+{
+	wait();
+
+	// never when running in batch mode
+	mActive = config::live_map_checks && inst.main_win;
+
+	if (! mActive)
+		return;
+
+	Job job;
+
+	job.all_lines = true;
+	job.all_things = true;
+
+	start(std::move(job));
+}
+
+
+void LiveChecks::notifyChanges(const ChangeSet &changes)
+{
+	if (! mActive || changes.isEmpty())
+		return;
+
+	Job job;
+
+	// when objects got added or removed, the numbers we have kept are
+	// useless, so just check everything of that kind again.
+	job.all_lines = changes[ObjType::vertices].hasStructural() ||
+					changes[ObjType::linedefs].hasStructural() ||
+					changes[ObjType::sidedefs].hasStructural() ||
+					changes[ObjType::sectors].hasStructural();
+
+	job.all_things = changes[ObjType::things].hasStructural();
+
+	if (! job.all_lines)
+	{
+		job.vertices = changes[ObjType::vertices].changed;
+		job.linedefs = changes[ObjType::linedefs].changed;
+		job.sidedefs = changes[ObjType::sidedefs].changed;
+		job.sectors  = changes[ObjType::sectors].changed;
+	}
+
+	// only the type of a thing gets checked
+	if (! job.all_things && changes[ObjType::things].changedField(Thing::F_TYPE))
+		job.things = changes[ObjType::things].changed;
+
+	start(std::move(job));
+}
+
+
+void LiveChecks::start(Job &&job)
+{
+	wait();
+
+	mJob = ThreadPool::shared().submit([this, job = std::move(job)]()
+	{
+		run(job);
+	});
+}
+
+
+//
+// Waits for the job in progress (if any)
+//
+void LiveChecks::wait()
+{
+	if (! mJob.valid())
+		return;
+
+	try
+	{
+		mJob.get();
+	}
+	catch (const std::exception &e)
+	{
+		// results are incomplete, but the next full check fixes them
+		gLog.printf("Live map checks failed: %s\n", e.what());
+	}
+
+	mFinished = true;
+}
+
+
+//
+// Forgets all results (the level is going away)
+//
+void LiveChecks::reset()
+{
+	wait();
+
+	mActive = false;
+	mFinished = true;
+
+	mLineBits.clear();
+	mSectorBits.clear();
+	mThingBits.clear();
+	mLineSectors.clear();
+
+	mProblems = 0;
+	mProblemCount = 0;
+}
+
+
+//
+// Returns true (once) when new results are available
+//
+bool LiveChecks::poll()
+{
+	if (mJob.valid() &&
+		mJob.wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+	{
+		wait();
+	}
 
+	bool result = mFinished;
 
-		if (! inst.conf.features.medusa_fixed)
+	mFinished = false;
+
+	return result;
+}
+
+
+void LiveChecks::run(const Job &job)
+{
+	const Document &doc = inst.level;
+
+	bool all_lines  = job.all_lines ||
+		mLineBits.size() != (size_t)doc.numLinedefs() ||
+		mSectorBits.size() != (size_t)doc.numSectors();
+
+	bool all_things = job.all_things ||
+		mThingBits.size() != (size_t)doc.numThings();
+
+	std::vector<byte> dirty_lines(doc.numLinedefs(), all_lines ? 1 : 0);
+	std::vector<byte> dirty_secs (doc.numSectors(),  all_lines ? 1 : 0);
+
+	if (all_lines)
+	{
+		mLineBits.assign(doc.numLinedefs(), 0);
+		mSectorBits.assign(doc.numSectors(), 0);
+		mLineSectors.assign(doc.numLinedefs(), std::make_pair(-1, -1));
+	}
+	else
+	{
+		for (int n : job.linedefs)
+			dirty_lines[n] = 1;
+
+		for (int s : job.sectors)
+			dirty_secs[s] = 1;
+
+		// find the lines using the changed vertices, sidedefs and sectors
+		if (! (job.vertices.empty() && job.sidedefs.empty() && job.sectors.empty()))
 		{
-			Textures_FindMedusa(sel, names, inst);
+			std::vector<byte> verts(doc.numVertices(), 0);
+			std::vector<byte> sides(doc.numSidedefs(), 0);
 
-			if (sel.empty())
-				dialog->AddLine("No textures causing Medusa Effect");
-			else
+			for (int v : job.vertices)
+				verts[v] = 1;
+
+			for (int sd : job.sidedefs)
+				sides[sd] = 1;
+
+			for (int n = 0 ; n < doc.numLinedefs(); n++)
 			{
-				check_buffer = SString::printf("%d Medusa textures", (int)names.size());
+				const LineDef *L = doc.linedefs[n];
+
+				int front = LineDef_SideSector(doc, L->right);
+				int back  = LineDef_SideSector(doc, L->left);
 
-				dialog->AddLine(check_buffer, 2, 200,
-								"Show", &UI_Check_Textures::action_show_medusa,
-								"Log",  &UI_Check_Textures::action_log_medusa,
-								"Fix",  &UI_Check_Textures::action_remove_medusa);
+				if (verts[L->start] || verts[L->end] ||
+					(L->right >= 0 && sides[L->right]) ||
+					(L->left  >= 0 && sides[L->left])  ||
+					(front >= 0 && dirty_secs[front]) ||
+					(back  >= 0 && dirty_secs[back]))
+				{
+					dirty_lines[n] = 1;
+				}
 			}
 		}
 
-		dialog->AddGap(10);
+		// a sector needs checking when one of its lines changed, and
+		// that includes the sectors those lines used to be part of.
+		for (int n = 0 ; n < doc.numLinedefs(); n++)
+		{
+			if (! dirty_lines[n])
+				continue;
 
+			const LineDef *L = doc.linedefs[n];
 
-		Textures_FindMissing(inst, sel);
+			int sectors[4] =
+			{
+				mLineSectors[n].first,
+				mLineSectors[n].second,
+				LineDef_SideSector(doc, L->right),
+				LineDef_SideSector(doc, L->left)
+			};
+
+			for (int s : sectors)
+				if (s >= 0 && s < doc.numSectors())
+					dirty_secs[s] = 1;
+		}
+	}
 
-		if (sel.empty())
-			dialog->AddLine("No missing textures on walls");
-		else
-		{
-			check_buffer = SString::printf("%d missing textures on walls", sel.count_obj());
+	checkLines(dirty_lines);
+	checkSectors(dirty_secs);
 
-			dialog->AddLine(check_buffer, 1, 275,
-			                "Show", &UI_Check_Textures::action_show_missing,
-			                "Fix",  &UI_Check_Textures::action_fix_missing);
-		}
+	if (all_things)
+	{
+		mThingBits.assign(doc.numThings(), 0);
 
+		for (int n = 0 ; n < doc.numThings(); n++)
+			checkThing(n);
+	}
+	else
+	{
+		for (int n : job.things)
+			checkThing(n);
+	}
 
-		Textures_FindTransparent(inst, sel, names);
+	// the bits were cleared without updating the count
+	if (all_lines || all_things)
+	{
+		mProblems = 0;
 
-		if (sel.empty())
-			dialog->AddLine("No transparent textures on solids");
-		else
-		{
-			check_buffer = SString::printf("%d transparent textures on solids", sel.count_obj());
+		for (const std::vector<byte> *bits : { &mLineBits, &mSectorBits, &mThingBits })
+			for (byte value : *bits)
+				mProblems += CountBits(value);
+	}
+
+	mProblemCount = mProblems;
+}
+
+
+void LiveChecks::checkLines(const std::vector<byte> &dirty)
+{
+	const Document &doc = inst.level;
+
+	for (int n = 0 ; n < doc.numLinedefs(); n++)
+	{
+		if (! dirty[n])
+			continue;
+
+		const LineDef *L = doc.linedefs[n];
+
+		byte bits = 0;
+
+		if (L->IsZeroLength(doc))
+			bits |= LINE_ZeroLength;
+
+		if (L->right < 0)
+			bits |= LINE_NoRight;
+
+		if (LineDef_IsMissingTex(inst, L))
+			bits |= LINE_MissingTex;
+
+		if (LineDef_HasUnknownTex(inst, L, NULL))
+			bits |= LINE_UnknownTex;
+
+		setBits(mLineBits, n, bits);
+
+		mLineSectors[n] = std::make_pair(LineDef_SideSector(doc, L->right),
+										 LineDef_SideSector(doc, L->left));
+	}
+}
+
+
+void LiveChecks::checkSectors(const std::vector<byte> &dirty)
+{
+	const Document &doc = inst.level;
+
+	if (doc.numSectors() == 0)
+		return;
+
+	std::vector<std::vector<int>> sec_lines;
+
+	Sectors_CollectLines(sec_lines, doc, &dirty);
+
+	std::vector<byte> ends(doc.numVertices(), 0);
+
+	for (int s = 0 ; s < doc.numSectors(); s++)
+	{
+		if (! dirty[s])
+			continue;
+
+		const Sector *S = doc.sectors[s];
+
+		byte bits = 0;
 
-			dialog->AddLine(check_buffer, 1, 275,
-			                "Show", &UI_Check_Textures::action_show_transparent,
-			                "Fix",  &UI_Check_Textures::action_fix_transparent,
-			                "Log",  &UI_Check_Textures::action_log_transparent);
+		if (Sector_IsUnclosed(doc, s, sec_lines[s], ends, NULL))
+			bits |= SEC_Unclosed;
+
+		if (S->ceilh < S->floorh)
+			bits |= SEC_BadCeil;
+
+		if (Sector_HasUnknownFlat(inst, S, NULL))
+			bits |= SEC_UnknownFlat;
+
+		setBits(mSectorBits, s, bits);
+	}
+}
+
+
+void LiveChecks::checkThing(int n)
+{
+	const Thing *T = inst.level.things[n];
+
+	setBits(mThingBits, n, Thing_IsUnknown(inst, T) ? THING_Unknown : 0);
+}
+
+
+ChecksModule::~ChecksModule()
+{
+}
+
+
+void ChecksModule::liveRecheckAll()
+{
+	if (! mLive)
+		mLive = std::make_unique<LiveChecks>(inst);
+
+	mLive->recheckAll();
+}
+
+
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
+{
+	if (mLive)
+		mLive->notifyChanges(changes);
+}
+
+
+void ChecksModule::liveWait()
+{
+	if (mLive)
+		mLive->wait();
+}
+
+
+void ChecksModule::liveReset()
+{
+	if (mLive)
+		mLive->reset();
+}
+
+
+bool ChecksModule::livePoll()
+{
+	return mLive ? mLive->poll() : false;
+}
+
+
+//
+// Number of problems found by the live checks, or -1 when they are off
+//
+int ChecksModule::liveProblemCount() const
+{
+	return mLive ? mLive->problemCount() : -1;
+}
+
+
+//------------------------------------------------------------------------
+//  CHECK DIALOGS
+//------------------------------------------------------------------------
+
+namespace
+{
+//
+// How a problem found by a check is shown in the dialogs
+//
+struct CheckRowLayout
+{
+	CheckId id;
+	bool gap_before;
+	int width;
+
+	const char *button1; Fl_Callback *cb1;
+	const char *button2; Fl_Callback *cb2;
+	const char *button3; Fl_Callback *cb3;
+};
+
+const CheckRowLayout check_rows[] =
+{
+	{ CheckId::vertexOverlaps, false, 210,
+		"Show",   &UI_Check_Vertices::action_highlight,
+		"Merge",  &UI_Check_Vertices::action_merge },
+	{ CheckId::vertexDanglers, false, 210,
+		"Show",   &UI_Check_Vertices::action_show_danglers },
+	{ CheckId::vertexUnused, false, 210,
+		"Show",   &UI_Check_Vertices::action_show_unused,
+		"Remove", &UI_Check_Vertices::action_remove },
+
+	{ CheckId::sectorUnclosed, false, 220,
+		"Show",   &UI_Check_Sectors::action_show_unclosed,
+		"Verts",  &UI_Check_Sectors::action_show_un_verts },
+	{ CheckId::sectorMismatches, false, 220,
+		"Show",   &UI_Check_Sectors::action_show_mismatch,
+		"Lines",  &UI_Check_Sectors::action_show_mis_lines },
+	{ CheckId::sectorBadCeil, false, 220,
+		"Show",   &UI_Check_Sectors::action_show_ceil,
+		"Fix",    &UI_Check_Sectors::action_fix_ceil },
+	{ CheckId::sectorUnknown, true, 220,
+		"Show",   &UI_Check_Sectors::action_show_unknown,
+		"Log",    &UI_Check_Sectors::action_log_unknown,
+		"Clear",  &UI_Check_Sectors::action_clear_unknown },
+	{ CheckId::sidedefPacking, false, 200,
+		"Show",   &UI_Check_Sectors::action_show_packed,
+		"Unpack", &UI_Check_Sectors::action_unpack },
+	{ CheckId::sectorUnused, false, 170,
+		"Remove", &UI_Check_Sectors::action_remove },
+	{ CheckId::sidedefUnused, false, 170,
+		"Remove", &UI_Check_Sectors::action_remove_sidedefs },
+
+	{ CheckId::lineZeroLen, false, 220,
+		"Show",   &UI_Check_LineDefs::action_show_zero,
+		"Remove", &UI_Check_LineDefs::action_remove_zero },
+	{ CheckId::lineOverlaps, false, 220,
+		"Show",   &UI_Check_LineDefs::action_show_overlap,
+		"Remove", &UI_Check_LineDefs::action_remove_overlap },
+	{ CheckId::lineCrossings, false, 220,
+		"Show",   &UI_Check_LineDefs::action_show_crossing },
+	{ CheckId::lineUnknown, true, 210,
+		"Show",   &UI_Check_LineDefs::action_show_unknown,
+		"Log",    &UI_Check_LineDefs::action_log_unknown,
+		"Clear",  &UI_Check_LineDefs::action_clear_unknown },
+	{ CheckId::lineMissingRight, false, 300,
+		"Show",   &UI_Check_LineDefs::action_show_mis_right },
+	{ CheckId::lineManualDoors, false, 300,
+		"Show",   &UI_Check_LineDefs::action_show_manual_doors,
+		"Fix",    &UI_Check_LineDefs::action_fix_manual_doors },
+	{ CheckId::lineLackImpass, false, 300,
+		"Show",   &UI_Check_LineDefs::action_show_lack_impass,
+		"Fix",    &UI_Check_LineDefs::action_fix_lack_impass },
+	{ CheckId::lineBad2SFlag, false, 300,
+		"Show",   &UI_Check_LineDefs::action_show_bad_2s_flag,
+		"Fix",    &UI_Check_LineDefs::action_fix_bad_2s_flag },
+
+	{ CheckId::thingUnknown, false, 200,
+		"Show",   &UI_Check_Things::action_show_unknown,
+		"Log",    &UI_Check_Things::action_log_unknown,
+		"Remove", &UI_Check_Things::action_remove_unknown },
+	{ CheckId::thingStuck, false, 200,
+		"Show",   &UI_Check_Things::action_show_stuck },
+	{ CheckId::thingInVoid, false, 200,
+		"Show",   &UI_Check_Things::action_show_void,
+		"Remove", &UI_Check_Things::action_remove_void },
+	{ CheckId::thingDuds, false, 200,
+		"Show",   &UI_Check_Things::action_show_duds,
+		"Fix",    &UI_Check_Things::action_fix_duds },
+	{ CheckId::thingPlayerStarts, true, -1 },
+	{ CheckId::thingDeathmatchStarts, false, -1 },
+
+	{ CheckId::textureUnknown, false, 200,
+		"Show",   &UI_Check_Textures::action_show_unk_tex,
+		"Log",    &UI_Check_Textures::action_log_unk_tex,
+		"Fix",    &UI_Check_Textures::action_fix_unk_tex },
+	{ CheckId::flatUnknown, false, 200,
+		"Show",   &UI_Check_Textures::action_show_unk_flat,
+		"Log",    &UI_Check_Textures::action_log_unk_flat,
+		"Fix",    &UI_Check_Textures::action_fix_unk_flat },
+	{ CheckId::textureMedusa, false, 200,
+		"Show",   &UI_Check_Textures::action_show_medusa,
+		"Log",    &UI_Check_Textures::action_log_medusa,
+		"Fix",    &UI_Check_Textures::action_remove_medusa },
+	{ CheckId::textureMissing, true, 275,
+		"Show",   &UI_Check_Textures::action_show_missing,
+		"Fix",    &UI_Check_Textures::action_fix_missing },
+	{ CheckId::textureTransparent, false, 275,
+		"Show",   &UI_Check_Textures::action_show_transparent,
+		"Fix",    &UI_Check_Textures::action_fix_transparent,
+		"Log",    &UI_Check_Textures::action_log_transparent },
+	{ CheckId::textureDupSwitches, false, 275,
+		"Show",   &UI_Check_Textures::action_show_dup_switch,
+		"Fix",    &UI_Check_Textures::action_fix_dup_switch },
+
+	{ CheckId::tagMissing, false, 320,
+		"Show",   &UI_Check_Tags::action_show_missing_tag },
+	{ CheckId::tagUnmatchedLines, false, 350,
+		"Show",   &UI_Check_Tags::action_show_unmatch_line },
+	{ CheckId::tagUnmatchedSectors, false, 350,
+		"Show",   &UI_Check_Tags::action_show_unmatch_sec },
+	{ CheckId::tagBeastMarks, false, 350,
+		"Show",   &UI_Check_Tags::action_show_beast_marks },
+	{ CheckId::tagRange, true, -1 },
+};
+}
+
+
+static void AddFindingRow(UI_Check_base *dialog, const CheckFinding &finding)
+{
+	const CheckRowLayout *row = NULL;
+
+	for (const CheckRowLayout &layout : check_rows)
+	{
+		if (layout.id == finding.id)
+		{
+			row = &layout;
+			break;
 		}
+	}
+	SYS_ASSERT(row);
 
+	if (row->gap_before)
+		dialog->AddGap(10);
 
-		Textures_FindDupSwitches(sel, doc);
+	// only offer the actions when there is a problem
+	if (finding.severity == 0 || row->width < 0)
+	{
+		dialog->AddLine(finding.message, finding.severity);
+		return;
+	}
 
-		if (sel.empty())
-			dialog->AddLine("No non-animating switch textures");
-		else
+	dialog->AddLine(finding.message, finding.severity, row->width,
+					row->button1, row->cb1,
+					row->button2, row->cb2,
+					row->button3, row->cb3);
+}
+
+
+static UI_Check_base *NewCheckDialog(CheckGroup group, bool all_mode, Instance &inst)
+{
+	switch (group)
+	{
+		case CheckGroup::vertices: return new UI_Check_Vertices(all_mode, inst);
+		case CheckGroup::sectors:  return new UI_Check_Sectors(all_mode, inst);
+		case CheckGroup::linedefs: return new UI_Check_LineDefs(all_mode, inst);
+		case CheckGroup::things:   return new UI_Check_Things(all_mode, inst);
+		case CheckGroup::textures: return new UI_Check_Textures(all_mode, inst);
+		case CheckGroup::tags:     return new UI_Check_Tags(all_mode, inst);
+
+		default:
+			BugError("NewCheckDialog: bad group %d\n", (int)group);
+	}
+}
+
+
+//
+// Shows the dialog for a group of checks.  The 'findings' are the initial
+// results for that group; when the user fixes something, the group gets
+// checked again.
+//
+CheckResult ChecksModule::checkGroup(CheckGroup group, int min_severity,
+									 std::vector<CheckFinding> findings) const
+{
+	UI_Check_base *dialog = NewCheckDialog(group, min_severity > 0, inst);
+
+	for (;;)
+	{
+		for (const CheckFinding &finding : findings)
+			AddFindingRow(dialog, finding);
+
+		if (group == CheckGroup::tags &&
+			(inst.edit.mode == ObjType::linedefs || inst.edit.mode == ObjType::sectors) &&
+		    inst.edit.Selected->notempty())
 		{
-			check_buffer = SString::printf("%d non-animating switch textures", sel.count_obj());
+			// always assume sector beastmark tags here
+			static_cast<UI_Check_Tags *>(dialog)->fresh_tag = findFreeTag(inst, true);
 
-			dialog->AddLine(check_buffer, 1, 275,
-			                "Show", &UI_Check_Textures::action_show_dup_switch,
-			                "Fix",  &UI_Check_Textures::action_fix_dup_switch);
+			dialog->AddGap(10);
+			dialog->AddLine("Apply a fresh tag to the selection", 0, 250, "Apply",
+			                &UI_Check_Tags::action_fresh_tag);
 		}
 
-
+		// in "ALL" mode, just continue if not too severe
 		if (dialog->WorstSeverity() < min_severity)
 		{
 			delete dialog;
@@ -4355,6 +4547,7 @@ CheckResult ChecksModule::checkTextures(int min_severity) const
 		{
 			// repeat the tests
 			dialog->Reset();
+			collectFindings(findings, checkGroupBit(group));
 			continue;
 		}
 
@@ -4365,6 +4558,16 @@ CheckResult ChecksModule::checkTextures(int min_severity) const
 }
 
 
+CheckResult ChecksModule::checkGroup(CheckGroup group, int min_severity) const
+{
+	std::vector<CheckFinding> findings;
+
+	collectFindings(findings, checkGroupBit(group));
+
+	return checkGroup(group, min_severity, std::move(findings));
+}
+
+
 //------------------------------------------------------------------------
 
 
@@ -4374,33 +4577,26 @@ void ChecksModule::checkAll(bool major_stuff) const
 
 	int min_severity = major_stuff ? 2 : 1;
 
-	CheckResult result;
-
+	// run every check at once, then show the dialogs one by one
+	std::vector<CheckFinding> all_findings;
 
-	result = checkVertices(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
+	collectFindings(all_findings);
 
-	result = checkSectors(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
-
-	result = checkLinedefs(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
+	for (int g = 0 ; g < (int)CheckGroup::count ; g++)
+	{
+		CheckGroup group = static_cast<CheckGroup>(g);
 
-	result = checkThings(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
+		std::vector<CheckFinding> findings;
 
-	result = checkTextures(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
+		for (const CheckFinding &finding : all_findings)
+			if (finding.group == group)
+				findings.push_back(finding);
 
-	result = checkTags(min_severity);
-	if (result == CheckResult::highlight) return;
-	if (result != CheckResult::ok) no_worries = false;
+		CheckResult result = checkGroup(group, min_severity, std::move(findings));
 
+		if (result == CheckResult::highlight) return;
+		if (result != CheckResult::ok) no_worries = false;
+	}
 
 	if (no_worries)
 	{
@@ -4429,38 +4625,38 @@ void Instance::CMD_MapCheck()
 	}
 	else if (what.noCaseEqual("vertices"))
 	{
-		level.checks.checkVertices(0);
+		level.checks.checkGroup(CheckGroup::vertices, 0);
 	}
 	else if (what.noCaseEqual("sectors"))
 	{
-		level.checks.checkSectors(0);
+		level.checks.checkGroup(CheckGroup::sectors, 0);
 	}
 	else if (what.noCaseEqual("linedefs"))
 	{
-		level.checks.checkLinedefs(0);
+		level.checks.checkGroup(CheckGroup::linedefs, 0);
 	}
 	else if (what.noCaseEqual("things"))
 	{
-		level.checks.checkThings(0);
+		level.checks.checkGroup(CheckGroup::things, 0);
 	}
 	else if (what.noCaseEqual("current"))  // current editing mode
 	{
 		switch (edit.mode)
 		{
 			case ObjType::vertices:
-				level.checks.checkVertices(0);
+				level.checks.checkGroup(CheckGroup::vertices, 0);
 				break;
 
 			case ObjType::sectors:
-				level.checks.checkSectors(0);
+				level.checks.checkGroup(CheckGroup::sectors, 0);
 				break;
 
 			case ObjType::linedefs:
-				level.checks.checkLinedefs(0);
+				level.checks.checkGroup(CheckGroup::linedefs, 0);
 				break;
 
 			case ObjType::things:
-				level.checks.checkThings(0);
+				level.checks.checkGroup(CheckGroup::things, 0);
 				break;
 
 			default:
@@ -4470,11 +4666,11 @@ void Instance::CMD_MapCheck()
 	}
 	else if (what.noCaseEqual("textures"))
 	{
-		level.checks.checkTextures(0);
+		level.checks.checkGroup(CheckGroup::textures, 0);
 	}
 	else if (what.noCaseEqual("tags"))
 	{
-		level.checks.checkTags(0);
+		level.checks.checkGroup(CheckGroup::tags, 0);
 	}
 	else
 	{
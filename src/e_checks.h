@@ -30,6 +30,96 @@
 #include "DocumentModule.h"
 #include "ui_window.h"
 
+#include <atomic>
+#include <future>
+#include <memory>
+#include <vector>
+
+class ChangeSet;
+class selection_c;
+
+//
+// The groups of map checks, each one having its own dialog
+//
+enum class CheckGroup
+{
+	vertices,
+	sectors,
+	linedefs,
+	things,
+	textures,
+	tags,
+
+	count
+};
+
+inline unsigned checkGroupBit(CheckGroup group)
+{
+	return 1u << static_cast<int>(group);
+}
+
+const unsigned kAllCheckGroups = (1u << static_cast<int>(CheckGroup::count)) - 1;
+
+const char *checkGroupName(CheckGroup group);
+
+//
+// The individual map checks
+//
+enum class CheckId
+{
+	vertexOverlaps,
+	vertexDanglers,
+	vertexUnused,
+
+	sectorUnclosed,
+	sectorMismatches,
+	sectorBadCeil,
+	sectorUnknown,
+	sidedefPacking,
+	sectorUnused,
+	sidedefUnused,
+
+	lineZeroLen,
+	lineOverlaps,
+	lineCrossings,
+	lineUnknown,
+	lineMissingRight,
+	lineManualDoors,
+	lineLackImpass,
+	lineBad2SFlag,
+
+	thingUnknown,
+	thingStuck,
+	thingInVoid,
+	thingDuds,
+	thingPlayerStarts,
+	thingDeathmatchStarts,
+
+	textureUnknown,
+	flatUnknown,
+	textureMedusa,
+	textureMissing,
+	textureTransparent,
+	textureDupSwitches,
+
+	tagMissing,
+	tagUnmatchedLines,
+	tagUnmatchedSectors,
+	tagBeastMarks,
+	tagRange
+};
+
+//
+// One line of a map check, as produced by ChecksModule::collectFindings()
+//
+struct CheckFinding
+{
+	CheckId id = CheckId::vertexOverlaps;
+	CheckGroup group = CheckGroup::vertices;
+	int severity = 0;		// 0 = OK, 1 = minor problem, 2 = major problem
+	SString message;
+};
+
 // the CHECK_xxx functions return the following values:
 enum class CheckResult
 {
@@ -40,6 +130,99 @@ enum class CheckResult
 	tookAction		// [internal use : user took some action]
 };
 
+//
+// Keeps the results of the per-object checks up to date while the map
+// gets edited.  After each edit, only the objects it touched (and the
+// ones next to them) are checked again, as a job on the thread pool.
+//
+// The job only reads the level, so the map must not be modified while
+// it runs: the Basis calls wait() before each change.
+//
+class LiveChecks
+{
+public:
+	explicit LiveChecks(const Instance &inst) : inst(inst)
+	{
+	}
+
+	~LiveChecks()
+	{
+		wait();
+	}
+
+	void recheckAll();
+	void notifyChanges(const ChangeSet &changes);
+	void wait();
+	void reset();
+	bool poll();
+
+	int problemCount() const
+	{
+		return mActive ? mProblemCount.load() : -1;
+	}
+
+private:
+	// the problems found, as bits per object
+	enum : byte
+	{
+		LINE_ZeroLength = (1 << 0),
+		LINE_NoRight    = (1 << 1),
+		LINE_MissingTex = (1 << 2),
+		LINE_UnknownTex = (1 << 3),
+
+		SEC_Unclosed    = (1 << 0),
+		SEC_BadCeil     = (1 << 1),
+		SEC_UnknownFlat = (1 << 2),
+
+		THING_Unknown   = (1 << 0)
+	};
+
+	//
+	// What to check again
+	//
+	struct Job
+	{
+		bool all_lines = false;		// also means all the sectors
+		bool all_things = false;
+
+		std::vector<int> vertices;
+		std::vector<int> linedefs;
+		std::vector<int> sidedefs;
+		std::vector<int> sectors;
+		std::vector<int> things;
+	};
+
+	void start(Job &&job);
+	void run(const Job &job);
+
+	void checkLines(const std::vector<byte> &dirty);
+	void checkSectors(const std::vector<byte> &dirty);
+	void checkThing(int n);
+
+	void setBits(std::vector<byte> &bits, int n, byte value);
+
+	const Instance &inst;
+
+	bool mActive = false;
+	bool mFinished = false;
+	std::future<void> mJob;
+
+	// everything below is only used by the job
+
+	std::vector<byte> mLineBits;
+	std::vector<byte> mSectorBits;
+	std::vector<byte> mThingBits;
+
+	// the sectors on each side of each line, when it was last checked
+	std::vector<std::pair<int, int>> mLineSectors;
+
+	int mProblems = 0;
+
+	// mProblems, for the main thread
+	std::atomic<int> mProblemCount{0};
+};
+
+
 //
 // The map checking module
 //
@@ -52,26 +235,42 @@ public:
 	ChecksModule(Document &doc) : DocumentModule(doc)
 	{
 	}
+	~ChecksModule();
 
 	void sidedefsUnpack(bool is_after_load) const;
 	void tagsApplyNewValue(int new_tag);
 	void tagsUsedRange(int *min_tag, int *max_tag) const;
 
+	void collectFindings(std::vector<CheckFinding> &list,
+						 unsigned groups = kAllCheckGroups) const;
+
+	// checking in the background while editing
+	void liveRecheckAll();
+	void liveNotifyChanges(const ChangeSet &changes);
+	void liveWait();
+	void liveReset();
+	bool livePoll();
+	int liveProblemCount() const;
+
 private:
 	void checkAll(bool majorStuff) const;
 
-	CheckResult checkVertices(int minSeverity) const;
-	CheckResult checkSectors(int minSeverity) const;
-	CheckResult checkThings(int minSeverity) const;
-	CheckResult checkLinedefs(int minSeverity) const;
-	CheckResult checkTags(int minSeverity) const;
-	CheckResult checkTextures(int minSeverity) const;
+	CheckResult checkGroup(CheckGroup group, int minSeverity) const;
+	CheckResult checkGroup(CheckGroup group, int minSeverity,
+						   std::vector<CheckFinding> findings) const;
 
 	int copySidedef(EditOperation &op, int num) const;
+
+	std::unique_ptr<LiveChecks> mLive;
 };
 
 int findFreeTag(const Instance &inst, bool forsector);
 
+void Things_FindStuckies(selection_c &list, const Instance &inst);
+
+int CheckLinesCross(int A, int B, const Document &doc);
+void LineDefs_FindCrossings(selection_c &lines, const Document &doc);
+
 #endif  /* __EUREKA_E_CHECKS_H__ */
 
 //--- editor settings ---
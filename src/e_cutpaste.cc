@@ -165,13 +165,6 @@ static bool Clipboard_HasStuff()
 }
 
 
-void Clipboard_NotifyBegin()
-{ }
-
-void Clipboard_NotifyEnd()
-{ }
-
-
 void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
 {
 	// this function notifies us that a new sector is about to be
@@ -210,12 +203,6 @@ void Clipboard_NotifyDelete(ObjType type, int objnum)
 }
 
 
-void Clipboard_NotifyChange(ObjType type, int objnum, int field)
-{
-	// field changes never affect the clipboard
-}
-
-
 //----------------------------------------------------------------------
 //  Texture Clipboard
 //----------------------------------------------------------------------
@@ -42,11 +42,8 @@ enum class EditCommand
 
 void Clipboard_ClearLocals();
 
-void Clipboard_NotifyBegin();
 void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum);
 void Clipboard_NotifyDelete(ObjType type, int objnum);
-void Clipboard_NotifyChange(ObjType type, int objnum, int field);
-void Clipboard_NotifyEnd();
 
 void UnusedVertices(const Document &doc, const selection_c &lines, selection_c &result);
 void UnusedSideDefs(const Document &doc, const selection_c &lines, const selection_c *secs, selection_c &result);
@@ -373,6 +373,77 @@ Objid hover::getNearbyObject(ObjType type, const Document &doc, const ConfigData
 	}
 }
 
+//
+// Checks whether a linedef crosses the horizontal line through pos, and
+// if so, gets the distance along it (negative for the left).
+//
+static inline bool castHorizAtLine(const Document &doc, int n, const v2double_t &pos, double *dist)
+{
+	v2double_t lpos1, lpos2;
+	lpos1.y = doc.linedefs[n]->Start(doc)->y();
+	lpos2.y = doc.linedefs[n]->End(doc)->y();
+
+	// ignore purely horizontal lines
+	if(lpos1.y == lpos2.y)
+		return false;
+
+	// does the linedef cross the horizontal ray?
+	if(std::min(lpos1.y, lpos2.y) >= pos.y || std::max(lpos1.y, lpos2.y) <= pos.y)
+		return false;
+
+	lpos1.x = doc.linedefs[n]->Start(doc)->x();
+	lpos2.x = doc.linedefs[n]->End(doc)->x();
+
+	*dist = lpos1.x - pos.x + (lpos2.x - lpos1.x) * (pos.y - lpos1.y) / (lpos2.y - lpos1.y);
+	return true;
+}
+
+static inline Side castHorizSide(const Document &doc, int n, double dist)
+{
+	if(fabs(dist) < 0.01)
+		return Side::neither;  // on the line
+
+	if((doc.linedefs[n]->Start(doc)->y() > doc.linedefs[n]->End(doc)->y()) == (dist > 0))
+		return Side::right;
+
+	return Side::left;
+}
+
+//
+// Same as castHorizAtLine, but vertically
+//
+static inline bool castVertAtLine(const Document &doc, int n, const v2double_t &pos, double *dist)
+{
+	v2double_t lpos1, lpos2;
+	lpos1.x = doc.linedefs[n]->Start(doc)->x();
+	lpos2.x = doc.linedefs[n]->End(doc)->x();
+
+	// ignore purely vertical lines
+	if(lpos1.x == lpos2.x)
+		return false;
+
+	// does the linedef cross the vertical ray?
+	if(std::min(lpos1.x, lpos2.x) >= pos.x || std::max(lpos1.x, lpos2.x) <= pos.x)
+		return false;
+
+	lpos1.y = doc.linedefs[n]->Start(doc)->y();
+	lpos2.y = doc.linedefs[n]->End(doc)->y();
+
+	*dist = lpos1.y - pos.y + (lpos2.y - lpos1.y) * (pos.x - lpos1.x) / (lpos2.x - lpos1.x);
+	return true;
+}
+
+static inline Side castVertSide(const Document &doc, int n, double dist)
+{
+	if(fabs(dist) < 0.01)
+		return Side::neither;  // on the line
+
+	if((doc.linedefs[n]->Start(doc)->x() > doc.linedefs[n]->End(doc)->x()) == (dist < 0))
+		return Side::right;
+
+	return Side::left;
+}
+
 //
 // Get the closest line, by casting horizontally
 //
@@ -380,6 +451,7 @@ int hover::getClosestLine_CastingHoriz(const Document &doc, v2double_t pos, Side
 {
 	int    best_match = -1;
 	double best_dist = 9e9;
+	double dist;
 
 	// most lines have integral X coords, so offset slightly to
 	// avoid hitting vertices.
@@ -387,37 +459,16 @@ int hover::getClosestLine_CastingHoriz(const Document &doc, v2double_t pos, Side
 
 	for(int n = 0; n < doc.numLinedefs(); n++)
 	{
-		v2double_t lpos1, lpos2;
-		lpos1.y = doc.linedefs[n]->Start(doc)->y();
-		lpos2.y = doc.linedefs[n]->End(doc)->y();
-
-		// ignore purely horizontal lines
-		if(lpos1.y == lpos2.y)
-			continue;
-
-		// does the linedef cross the horizontal ray?
-		if(std::min(lpos1.y, lpos2.y) >= pos.y || std::max(lpos1.y, lpos2.y) <= pos.y)
+		if(!castHorizAtLine(doc, n, pos, &dist))
 			continue;
 
-		lpos1.x = doc.linedefs[n]->Start(doc)->x();
-		lpos2.x = doc.linedefs[n]->End(doc)->x();
-
-		double dist = lpos1.x - pos.x + (lpos2.x - lpos1.x) * (pos.y - lpos1.y) / (lpos2.y - lpos1.y);
-
 		if(fabs(dist) < best_dist)
 		{
 			best_match = n;
 			best_dist = fabs(dist);
 
 			if(side)
-			{
-				if(best_dist < 0.01)
-					*side = Side::neither;  // on the line
-				else if((lpos1.y > lpos2.y) == (dist > 0))
-					*side = Side::right;  // right side
-				else
-					*side = Side::left; // left side
-			}
+				*side = castHorizSide(doc, n, dist);
 		}
 	}
 
@@ -431,6 +482,7 @@ static int getClosestLine_CastingVert(const Document &doc, v2double_t pos, Side
 {
 	int    best_match = -1;
 	double best_dist = 9e9;
+	double dist;
 
 	// most lines have integral X coords, so offset slightly to
 	// avoid hitting vertices.
@@ -438,37 +490,16 @@ static int getClosestLine_CastingVert(const Document &doc, v2double_t pos, Side
 
 	for(int n = 0; n < doc.numLinedefs(); n++)
 	{
-		v2double_t lpos1, lpos2;
-		lpos1.x = doc.linedefs[n]->Start(doc)->x();
-		lpos2.x = doc.linedefs[n]->End(doc)->x();
-
-		// ignore purely vertical lines
-		if(lpos1.x == lpos2.x)
-			continue;
-
-		// does the linedef cross the vertical ray?
-		if(std::min(lpos1.x, lpos2.x) >= pos.x || std::max(lpos1.x, lpos2.x) <= pos.x)
+		if(!castVertAtLine(doc, n, pos, &dist))
 			continue;
 
-		lpos1.y = doc.linedefs[n]->Start(doc)->y();
-		lpos2.y = doc.linedefs[n]->End(doc)->y();
-
-		double dist = lpos1.y - pos.y + (lpos2.y - lpos1.y) * (pos.x - lpos1.x) / (lpos2.x - lpos1.x);
-
 		if(fabs(dist) < best_dist)
 		{
 			best_match = n;
 			best_dist = fabs(dist);
 
 			if(side)
-			{
-				if(best_dist < 0.01)
-					*side = Side::neither;  // on the line
-				else if((lpos1.x > lpos2.x) == (dist < 0))
-					*side = Side::right;  // right side
-				else
-					*side = Side::left; // left side
-			}
+				*side = castVertSide(doc, n, dist);
 		}
 	}
 
@@ -947,22 +978,12 @@ static Objid getNearestLinedef(const Document &doc, const Grid_State_c &grid, co
 }
 
 //
-//  determine which sector is under the pointer
+// Picks the sector from the closest lines found by casting horizontally
+// and vertically.
 //
-Objid hover::getNearestSector(const Document &doc, const v2double_t &pos)
+static Objid pickNearestSector(const Document &doc, const v2double_t &pos,
+							   int line1, Side side1, int line2, Side side2)
 {
-	/* hack, hack...  I look for the first LineDef crossing
-	   an horizontal half-line drawn from the cursor */
-
-	   // -AJA- updated this to look in four directions (N/S/E/W) and
-	   //       grab the closest linedef.  Now it is possible to access
-	   //       self-referencing lines, even purely horizontal ones.
-
-	Side side1, side2;
-
-	int line1 = hover::getClosestLine_CastingHoriz(doc, pos, &side1);
-	int line2 = getClosestLine_CastingVert(doc, pos, &side2);
-
 	if(line2 < 0)
 	{
 		/* nothing needed */
@@ -989,6 +1010,245 @@ Objid hover::getNearestSector(const Document &doc, const v2double_t &pos)
 	return Objid();
 }
 
+//
+//  determine which sector is under the pointer
+//
+Objid hover::getNearestSector(const Document &doc, const v2double_t &pos)
+{
+	/* hack, hack...  I look for the first LineDef crossing
+	   an horizontal half-line drawn from the cursor */
+
+	   // -AJA- updated this to look in four directions (N/S/E/W) and
+	   //       grab the closest linedef.  Now it is possible to access
+	   //       self-referencing lines, even purely horizontal ones.
+
+	Side side1, side2;
+
+	int line1 = hover::getClosestLine_CastingHoriz(doc, pos, &side1);
+	int line2 = getClosestLine_CastingVert(doc, pos, &side2);
+
+	return pickNearestSector(doc, pos, line1, side1, line2, side2);
+}
+
+//------------------------------------------------------------------------
+
+static BlockGrid makeLinedefGrid(const Document &doc)
+{
+	if(doc.numVertices() == 0)
+		return BlockGrid(0, 0, 0, 0);
+
+	v2double_t lo = doc.vertices[0]->xy();
+	v2double_t hi = lo;
+
+	for(const Vertex *vertex : doc.vertices)
+	{
+		lo.x = std::min(lo.x, vertex->x());
+		lo.y = std::min(lo.y, vertex->y());
+		hi.x = std::max(hi.x, vertex->x());
+		hi.y = std::max(hi.y, vertex->y());
+	}
+
+	BlockGrid grid(lo.x, lo.y, hi.x, hi.y);
+
+	for(int n = 0; n < doc.numLinedefs(); n++)
+	{
+		v2double_t pos1 = doc.linedefs[n]->Start(doc)->xy();
+		v2double_t pos2 = doc.linedefs[n]->End(doc)->xy();
+
+		grid.insertBox(n, pos1.x, pos1.y, pos2.x, pos2.y);
+	}
+
+	return grid;
+}
+
+SectorLocator::SectorLocator(const Document &doc) : mDoc(doc), mGrid(makeLinedefGrid(doc))
+{
+}
+
+//
+// Same result as hover::getClosestLine_CastingHoriz.  The lines crossing
+// the ray are all in the row of blocks containing it, so look at the
+// blocks nearest to the point first, stopping once the remaining ones
+// are further away than the best line found.
+//
+int SectorLocator::castHoriz(v2double_t pos, Side *side, double *result_dist) const
+{
+	int    best_match = -1;
+	double best_dist = 9e9;
+	double best_signed = 0;
+	double dist;
+
+	pos.y += 0.04;
+
+	int by = mGrid.blockY(pos.y);
+	int left = mGrid.blockX(pos.x);
+	int right = left + 1;
+
+	for(;;)
+	{
+		double left_dist = 9e9;
+		double right_dist = 9e9;
+
+		if(left >= 0)
+			left_dist = std::max(0.0, pos.x - (mGrid.blockLeft(left) + mGrid.blockSize()));
+		if(right < mGrid.width())
+			right_dist = std::max(0.0, mGrid.blockLeft(right) - pos.x);
+
+		bool go_left = (left_dist <= right_dist);
+		double block_dist = go_left ? left_dist : right_dist;
+
+		if(block_dist > best_dist || block_dist >= 9e9)
+			break;
+
+		const std::vector<int> &block = mGrid.block(go_left ? left-- : right++, by);
+
+		for(int n : block)
+		{
+			if(!castHorizAtLine(mDoc, n, pos, &dist))
+				continue;
+
+			// on a tie, the lowest numbered line wins (like a plain search)
+			if(fabs(dist) < best_dist || (fabs(dist) == best_dist && n < best_match))
+			{
+				best_match = n;
+				best_dist = fabs(dist);
+				best_signed = dist;
+			}
+		}
+	}
+
+	if(best_match >= 0)
+		*side = castHorizSide(mDoc, best_match, best_signed);
+
+	*result_dist = best_dist;
+	return best_match;
+}
+
+int SectorLocator::castVert(v2double_t pos, Side *side, double *result_dist) const
+{
+	int    best_match = -1;
+	double best_dist = 9e9;
+	double best_signed = 0;
+	double dist;
+
+	pos.x += 0.04;
+
+	int bx = mGrid.blockX(pos.x);
+	int down = mGrid.blockY(pos.y);
+	int up = down + 1;
+
+	for(;;)
+	{
+		double down_dist = 9e9;
+		double up_dist = 9e9;
+
+		if(down >= 0)
+			down_dist = std::max(0.0, pos.y - (mGrid.blockBottom(down) + mGrid.blockSize()));
+		if(up < mGrid.height())
+			up_dist = std::max(0.0, mGrid.blockBottom(up) - pos.y);
+
+		bool go_down = (down_dist <= up_dist);
+		double block_dist = go_down ? down_dist : up_dist;
+
+		if(block_dist > best_dist || block_dist >= 9e9)
+			break;
+
+		const std::vector<int> &block = mGrid.block(bx, go_down ? down-- : up++);
+
+		for(int n : block)
+		{
+			if(!castVertAtLine(mDoc, n, pos, &dist))
+				continue;
+
+			if(fabs(dist) < best_dist || (fabs(dist) == best_dist && n < best_match))
+			{
+				best_match = n;
+				best_dist = fabs(dist);
+				best_signed = dist;
+			}
+		}
+	}
+
+	if(best_match >= 0)
+		*side = castVertSide(mDoc, best_match, best_signed);
+
+	*result_dist = best_dist;
+	return best_match;
+}
+
+//
+// Same result as hover::getNearestSector().  Also tells what decided it
+// when 'hit' is given.
+//
+Objid SectorLocator::locate(const v2double_t &pos, Hit *hit) const
+{
+	Side side1 = Side::neither;
+	Side side2 = Side::neither;
+	double dist1, dist2;
+
+	int line1 = castHoriz(pos, &side1, &dist1);
+	int line2 = castVert(pos, &side2, &dist2);
+
+	if(hit)
+	{
+		hit->horizLine = line1;
+		hit->vertLine = line2;
+		hit->horizDist = dist1;
+		hit->vertDist = dist2;
+	}
+
+	return pickNearestSector(mDoc, pos, line1, side1, line2, side2);
+}
+
+//
+// Locates many points at once, giving the sector numbers (-1 for none)
+//
+void SectorLocator::locate(const std::vector<v2double_t> &points, std::vector<int> &sectors) const
+{
+	sectors.resize(points.size());
+
+	for(size_t i = 0; i < points.size(); i++)
+		sectors[i] = locate(points[i]).num;
+}
+
+//
+// Gets the sector locator, building it if needed.  Safe to call from
+// several threads, but the level must not be edited meanwhile.
+//
+const SectorLocator &Hover::sectorLocator() const
+{
+	std::lock_guard<std::mutex> lock(m_locator_mutex);
+
+	if(!m_locator)
+		m_locator.reset(new SectorLocator(doc));
+
+	return *m_locator;
+}
+
+void Hover::invalidateSectorLocator()
+{
+	std::lock_guard<std::mutex> lock(m_locator_mutex);
+
+	m_locator.reset();
+}
+
+//
+// Called after each edit operation, and after undo/redo
+//
+void Hover::notifyChanges(const ChangeSet &changes)
+{
+	const ChangeSet::Entry &verts = changes[ObjType::vertices];
+	const ChangeSet::Entry &lines = changes[ObjType::linedefs];
+
+	// only the geometry matters, sidedefs and sectors are looked up
+	// when locating.
+	if(verts.hasStructural() || !verts.changed.empty() || lines.hasStructural() ||
+	   lines.changedField(LineDef::F_START) || lines.changedField(LineDef::F_END))
+	{
+		invalidateSectorLocator();
+	}
+}
+
 //
 // Gets an approximate distance from a point to a linedef
 //
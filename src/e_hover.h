@@ -28,8 +28,13 @@
 #define __EUREKA_X_HOVER_H__
 
 #include "DocumentModule.h"
+#include "m_blockgrid.h"
+
+#include <memory>
+#include <mutex>
 
 class bitvec_c;
+class ChangeSet;
 class crossing_state_c;
 class fastopp_node_c;
 class Grid_State_c;
@@ -54,6 +59,43 @@ Objid getNearestSector(const Document &doc, const v2double_t &pos);
 bool isPointOutsideOfMap(const Document &doc, const v2double_t &v);
 }
 
+//
+// Finds the sector at a map position, with the same result as
+// hover::getNearestSector(), but only testing the linedefs near it.
+// It becomes invalid when vertices or linedefs change.
+//
+class SectorLocator
+{
+public:
+	//
+	// What a located sector came from: the lines hit by the horizontal
+	// and vertical rays (-1 for none) and how far along the rays they
+	// are.  Only a change to those lines, or a line crossing one of the
+	// rays within that distance, can change the result.
+	//
+	struct Hit
+	{
+		int horizLine = -1;
+		int vertLine = -1;
+		double horizDist = 9e9;
+		double vertDist = 9e9;
+	};
+
+	explicit SectorLocator(const Document &doc);
+
+	Objid locate(const v2double_t &pos, Hit *hit = nullptr) const;
+	void locate(const std::vector<v2double_t> &points, std::vector<int> &sectors) const;
+
+private:
+	int castHoriz(v2double_t pos, Side *side, double *dist) const;
+	int castVert(v2double_t pos, Side *side, double *dist) const;
+
+	const Document &mDoc;
+
+	// the linedefs, by their bounding box
+	BlockGrid mGrid;
+};
+
 //
 // The hover module
 //
@@ -64,6 +106,10 @@ public:
 	{
 	}
 
+	const SectorLocator &sectorLocator() const;
+	void invalidateSectorLocator();
+	void notifyChanges(const ChangeSet &changes);
+
 	int getOppositeLinedef(int ld, Side ld_side, Side *result_side, const bitvec_c *ignore_lines) const;
 	int getOppositeSector(int ld, Side ld_side) const;
 	void fastOpposite_begin();
@@ -78,6 +124,9 @@ private:
 
 	fastopp_node_c *m_fastopp_X_tree = nullptr;
 	fastopp_node_c *m_fastopp_Y_tree = nullptr;
+
+	mutable std::unique_ptr<SectorLocator> m_locator;
+	mutable std::mutex m_locator_mutex;
 };
 
 // result: -1 for back, +1 for front, 0 for _exactly_on_ the line
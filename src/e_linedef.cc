@@ -33,6 +33,7 @@
 #include "e_main.h"
 #include "im_img.h"
 #include "LineDef.h"
+#include "m_blockgrid.h"
 #include "m_config.h"
 #include "m_game.h"
 #include "e_objects.h"
@@ -42,6 +43,8 @@
 #include "w_rawdef.h"
 #include "w_texture.h"
 
+#include <unordered_set>
+
 
 // config items
 bool config::leave_offsets_alone = true;
@@ -63,6 +66,69 @@ bool LinedefModule::linedefAlreadyExists(int v1, int v2) const
 	return false;
 }
 
+namespace
+{
+//
+// The end points of a linedef, lowest first, for finding overlaps
+//
+struct line_pos_t
+{
+	int x1, y1, x2, y2;
+
+	bool operator == (const line_pos_t &other) const
+	{
+		return x1 == other.x1 && y1 == other.y1 && x2 == other.x2 && y2 == other.y2;
+	}
+};
+
+struct line_pos_hash_t
+{
+	size_t operator() (const line_pos_t &pos) const
+	{
+		uint64_t h = static_cast<uint32_t>(pos.x1);
+
+		h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(pos.y1);
+		h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(pos.x2);
+		h = h * 0x9E3779B97F4A7C15ULL + static_cast<uint32_t>(pos.y2);
+
+		return static_cast<size_t>(h ^ (h >> 32));
+	}
+};
+}
+
+//
+// Finds the linedefs lying exactly on a lower numbered linedef (either
+// way around).  The lowest one at each spot is left out, and so are
+// zero-length linedefs.
+//
+void LinedefModule::findOverlaps(selection_c &sel) const
+{
+	sel.change_type(ObjType::linedefs);
+
+	std::unordered_set<line_pos_t, line_pos_hash_t> seen;
+	seen.reserve(doc.numLinedefs());
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const Vertex *V1 = doc.linedefs[n]->Start(doc);
+		const Vertex *V2 = doc.linedefs[n]->End(doc);
+
+		line_pos_t pos = { V1->raw_x.raw(), V1->raw_y.raw(), V2->raw_x.raw(), V2->raw_y.raw() };
+
+		if (pos.x1 == pos.x2 && pos.y1 == pos.y2)
+			continue;
+
+		if (pos.x1 > pos.x2 || (pos.x1 == pos.x2 && pos.y1 > pos.y2))
+		{
+			std::swap(pos.x1, pos.x2);
+			std::swap(pos.y1, pos.y2);
+		}
+
+		if (! seen.insert(pos).second)
+			sel.set(n);
+	}
+}
+
 
 //------------------------------------------------------------------------
 
@@ -1271,6 +1337,97 @@ void linemod::moveCoordOntoLinedef(const Document &doc, int ld, v2double_t &v)
 	v = v1 + dv * along / len_squared;
 }
 
+//
+// Calls func(A, B), where A < B, once for every pair of linedefs whose
+// bounding boxes overlap or touch (compared exactly, on the fixed-point
+// coordinates).  Only lines in the same blocks of a grid get compared,
+// so this is fast even for huge maps, unlike testing every pair.
+//
+void linemod::forEachOverlappingBoxPair(const Document &doc, const std::function<void(int, int)> &func)
+{
+	if (doc.numLinedefs() < 2)
+		return;
+
+	struct line_box_t
+	{
+		FFixedPoint x1, y1, x2, y2;
+	};
+
+	std::vector<line_box_t> boxes(doc.numLinedefs());
+
+	FFixedPoint min_x, min_y, max_x, max_y;
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const Vertex *V1 = doc.linedefs[n]->Start(doc);
+		const Vertex *V2 = doc.linedefs[n]->End(doc);
+
+		line_box_t &box = boxes[n];
+
+		box.x1 = std::min(V1->raw_x, V2->raw_x);
+		box.y1 = std::min(V1->raw_y, V2->raw_y);
+		box.x2 = std::max(V1->raw_x, V2->raw_x);
+		box.y2 = std::max(V1->raw_y, V2->raw_y);
+
+		if (n == 0)
+		{
+			min_x = box.x1;  min_y = box.y1;
+			max_x = box.x2;  max_y = box.y2;
+		}
+		else
+		{
+			min_x = std::min(min_x, box.x1);  min_y = std::min(min_y, box.y1);
+			max_x = std::max(max_x, box.x2);  max_y = std::max(max_y, box.y2);
+		}
+	}
+
+	BlockGrid grid(static_cast<double>(min_x), static_cast<double>(min_y),
+				   static_cast<double>(max_x), static_cast<double>(max_y));
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const line_box_t &box = boxes[n];
+
+		grid.insertBox(n, static_cast<double>(box.x1), static_cast<double>(box.y1),
+					   static_cast<double>(box.x2), static_cast<double>(box.y2));
+	}
+
+	for (int by = 0 ; by < grid.height() ; by++)
+	for (int bx = 0 ; bx < grid.width()  ; bx++)
+	{
+		const std::vector<int> &block = grid.block(bx, by);
+
+		for (size_t i = 0 ; i < block.size() ; i++)
+		{
+			const line_box_t &A = boxes[block[i]];
+
+			for (size_t k = i + 1 ; k < block.size() ; k++)
+			{
+				const line_box_t &B = boxes[block[k]];
+
+				if (A.x1 > B.x2 || B.x1 > A.x2 ||
+					A.y1 > B.y2 || B.y1 > A.y2)
+				{
+					continue;
+				}
+
+				// a pair of lines can share several blocks, so only visit
+				// it in the block where their overlap begins.
+				FFixedPoint ox = std::max(A.x1, B.x1);
+				FFixedPoint oy = std::max(A.y1, B.y1);
+
+				if (grid.blockX(static_cast<double>(ox)) != bx ||
+					grid.blockY(static_cast<double>(oy)) != by)
+				{
+					continue;
+				}
+
+				func(block[i], block[k]);
+			}
+		}
+	}
+}
+
 //
 // Linedef start will be moved
 //
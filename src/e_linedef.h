@@ -29,11 +29,14 @@
 
 #include "DocumentModule.h"
 
+#include <functional>
+
 class selection_c;
 
 namespace linemod
 {
 void moveCoordOntoLinedef(const Document &doc, int ld, v2double_t &v);
+void forEachOverlappingBoxPair(const Document &doc, const std::function<void(int, int)> &func);
 }
 
 class LinedefModule : public DocumentModule
@@ -50,6 +53,7 @@ public:
 	void setLinedefsLength(int new_len) const;
 
 	bool linedefAlreadyExists(int v1, int v2) const;
+	void findOverlaps(selection_c &sel) const;
 
 	int splitLinedefAtVertex(EditOperation &op, int ld, int v_idx) const;
 
@@ -409,61 +409,67 @@ void Instance::MapStuff_NotifyBegin()
 	sound_propagation_invalid = true;
 }
 
-void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
 {
-	if (type == ObjType::vertices)
-	{
-		if (new_vertex_minimum < 0 || objnum < new_vertex_minimum)
-			new_vertex_minimum = objnum;
-	}
-}
+	const ChangeSet::Entry &verts = changes[ObjType::vertices];
 
-void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
-{
-	if (type == ObjType::vertices)
+	if (verts.minInserted != INT_MAX)
+		new_vertex_minimum = verts.minInserted;
+
+	if (!verts.deleted.empty())
 	{
 		recalc_map_bounds = true;
 
 		if (edit.action == EditorAction::drawLine &&
-			edit.drawLine.from.num == objnum)
+			std::find(verts.deleted.begin(), verts.deleted.end(),
+					  edit.drawLine.from.num) != verts.deleted.end())
 		{
 			Editor_ClearAction();
 		}
 	}
-}
 
-void Instance::MapStuff_NotifyChange(ObjType type, int objnum, int field)
-{
-	if (type == ObjType::vertices)
+	if (!verts.changed.empty())
 	{
 		// NOTE: for performance reasons we don't recalculate the
 		//       map bounds when only moving a few vertices.
-		moved_vertex_count++;
+		moved_vertex_count = static_cast<int>(verts.changed.size());
 
-		const Vertex * V = level.vertices[objnum];
+		if (verts.renumbered)
+			recalc_map_bounds = true;
+		else if (moved_vertex_count <= 10)
+		{
+			for (int objnum : verts.changed)
+			{
+				const Vertex * V = level.vertices[objnum];
 
-		if (V->x() < Map_bound1.x) Map_bound1.x = V->x();
-		if (V->y() < Map_bound1.y) Map_bound1.y = V->y();
+				if (V->x() < Map_bound1.x) Map_bound1.x = V->x();
+				if (V->y() < Map_bound1.y) Map_bound1.y = V->y();
 
-		if (V->x() > Map_bound2.x) Map_bound2.x = V->x();
-		if (V->y() > Map_bound2.y) Map_bound2.y = V->y();
+				if (V->x() > Map_bound2.x) Map_bound2.x = V->x();
+				if (V->y() > Map_bound2.y) Map_bound2.y = V->y();
+			}
+		}
 
 		// TODO: only invalidate sectors touching vertex
 		Subdiv_InvalidateAll();
 	}
 
-	if (type == ObjType::sidedefs && field == SideDef::F_SECTOR)
+	if (changes[ObjType::sidedefs].changedField(SideDef::F_SECTOR))
 		Subdiv_InvalidateAll();
 
-	if (type == ObjType::linedefs && (field == LineDef::F_LEFT || field == LineDef::F_RIGHT || field == LineDef::F_START || field == LineDef::F_END))
+	const ChangeSet::Entry &lines = changes[ObjType::linedefs];
+
+	if (lines.changedField(LineDef::F_LEFT) || lines.changedField(LineDef::F_RIGHT) ||
+		lines.changedField(LineDef::F_START) || lines.changedField(LineDef::F_END))
+	{
 		Subdiv_InvalidateAll();
+	}
 
-	if (type == ObjType::sectors && (field == Sector::F_FLOORH || field == Sector::F_CEILH))
+	const ChangeSet::Entry &secs = changes[ObjType::sectors];
+
+	if (secs.changedField(Sector::F_FLOORH) || secs.changedField(Sector::F_CEILH))
 		Subdiv_InvalidateAll();
-}
 
-void Instance::MapStuff_NotifyEnd()
-{
 	if (recalc_map_bounds || moved_vertex_count > 10)  // TODO: CONFIG
 	{
 		CalculateLevelBounds();
@@ -489,48 +495,28 @@ void Instance::ObjectBox_NotifyBegin()
 }
 
 
-void Instance::ObjectBox_NotifyInsert(ObjType type, int objnum)
-{
-	invalidated_totals = true;
-
-	if (type != edit.mode)
-		return;
-
-	if (objnum > main_win->GetPanelObjNum())
-		return;
-
-	invalidated_panel_obj = true;
-}
-
-
-void Instance::ObjectBox_NotifyDelete(ObjType type, int objnum)
-{
-	invalidated_totals = true;
-
-	if (type != edit.mode)
-		return;
-
-	if (objnum > main_win->GetPanelObjNum())
-		return;
-
-	invalidated_panel_obj = true;
-}
-
-
-void Instance::ObjectBox_NotifyChange(ObjType type, int objnum, int field)
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
 {
-	if (type != edit.mode)
-		return;
+	for (int i = 0 ; i <= static_cast<int>(ObjType::sectors) ; i++)
+		if (changes[static_cast<ObjType>(i)].hasStructural())
+			invalidated_totals = true;
 
-	if (objnum != main_win->GetPanelObjNum())
-		return;
-
-	changed_panel_obj = true;
-}
+	const ChangeSet::Entry &current = changes[edit.mode];
+	int panel_obj = main_win->GetPanelObjNum();
 
+	if (current.lowestMoved() <= panel_obj)
+	{
+		invalidated_panel_obj = true;
+	}
+	else if (!current.changed.empty())
+	{
+		if (current.renumbered ||
+			std::find(current.changed.begin(), current.changed.end(), panel_obj) != current.changed.end())
+		{
+			changed_panel_obj = true;
+		}
+	}
 
-void Instance::ObjectBox_NotifyEnd() const
-{
 	if (invalidated_totals)
 		main_win->UpdateTotals();
 
@@ -559,46 +545,25 @@ void Instance::Selection_NotifyBegin()
 	invalidated_last_sel  = false;
 }
 
-void Instance::Selection_NotifyInsert(ObjType type, int objnum)
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
 {
-	if (type == edit.Selected->what_type() &&
-		objnum <= edit.Selected->max_obj())
-	{
+	int sel_max = edit.Selected->max_obj();
+
+	if (changes[edit.Selected->what_type()].minInserted <= sel_max)
 		invalidated_selection = true;
-	}
 
-	if (last_Sel &&
-		type == last_Sel->what_type() &&
-		objnum <= last_Sel->max_obj())
-	{
-		invalidated_last_sel = true;
-	}
-}
+	for (int i = 0 ; i <= static_cast<int>(ObjType::sectors) ; i++)
+		if (changes[static_cast<ObjType>(i)].minDeleted <= sel_max)
+			invalidated_selection = true;
 
-void Instance::Selection_NotifyDelete(ObjType type, int objnum)
-{
-	if (objnum <= edit.Selected->max_obj())
+	if (last_Sel)
 	{
-		invalidated_selection = true;
-	}
+		const ChangeSet::Entry &last = changes[last_Sel->what_type()];
 
-	if (last_Sel &&
-		type == last_Sel->what_type() &&
-		objnum <= last_Sel->max_obj())
-	{
-		invalidated_last_sel = true;
+		if (last.lowestMoved() <= last_Sel->max_obj())
+			invalidated_last_sel = true;
 	}
-}
-
-
-void Selection_NotifyChange(ObjType type, int objnum, int field)
-{
-	// field changes never affect the current selection
-}
 
-
-void Instance::Selection_NotifyEnd()
-{
 	if (invalidated_selection)
 	{
 		// this clears AND RESIZES the selection_c object
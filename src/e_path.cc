@@ -44,6 +44,7 @@
 #include "ui_misc.h"
 
 #include <assert.h>
+#include <deque>
 
 typedef enum
 {
@@ -231,12 +232,8 @@ void Instance::CMD_LIN_SelectPath()
 
 #define PLAYER_STEP_H	24
 
-static bool GrowContiguousSectors(const Instance &inst, selection_c &seen)
+static void GrowContiguousSectors(const Instance &inst, selection_c &seen)
 {
-	// returns TRUE when some new sectors got added
-
-	bool changed = false;
-
 	bool can_walk    = inst.Exec_HasFlag("/can_walk");
 	bool allow_doors = inst.Exec_HasFlag("/doors");
 
@@ -249,32 +246,25 @@ static bool GrowContiguousSectors(const Instance &inst, selection_c &seen)
 	bool do_tag     = inst.Exec_HasFlag("/tag");
 	bool do_special = inst.Exec_HasFlag("/special");
 
-	for (const LineDef *L : inst.level.linedefs)
+	auto can_grow = [&](int line, int sec1, int sec2)
 	{
-		if (! L->TwoSided())
-			continue;
-
-		int sec1 = L->Right(inst.level)->sector;
-		int sec2 = L-> Left(inst.level)->sector;
+		const LineDef *L = inst.level.linedefs[line];
 
-		if (sec1 == sec2)
-			continue;
-
-		Sector *S1 = inst.level.sectors[sec1];
-		Sector *S2 = inst.level.sectors[sec2];
+		const Sector *S1 = inst.level.sectors[sec1];
+		const Sector *S2 = inst.level.sectors[sec2];
 
 		// skip closed doors
 		if (! allow_doors && (S1->floorh >= S1->ceilh || S2->floorh >= S2->ceilh))
-			continue;
+			return false;
 
 		if (can_walk)
 		{
 			if (L->flags & MLF_Blocking)
-				continue;
+				return false;
 
 			// too big a step?
 			if (abs(S1->floorh - S2->floorh) > PLAYER_STEP_H)
-				continue;
+				return false;
 
 			// player wouldn't fit vertically?
 			int f_max = std::max(S1->floorh, S2->floorh);
@@ -284,36 +274,26 @@ static bool GrowContiguousSectors(const Instance &inst, selection_c &seen)
 			{
 				// ... but allow doors
 				if (! (allow_doors && (S1->floorh == S1->ceilh || S2->floorh == S2->ceilh)))
-					continue;
+					return false;
 			}
 		}
 
 		/* perform match */
 
-		if (do_floor_h && (S1->floorh != S2->floorh)) continue;
-		if (do_ceil_h  && (S1->ceilh  != S2->ceilh))  continue;
-
-		if (do_floor_tex && (S1->floor_tex != S2->floor_tex)) continue;
-		if (do_ceil_tex  && (S1->ceil_tex  != S2->ceil_tex))  continue;
+		if (do_floor_h && (S1->floorh != S2->floorh)) return false;
+		if (do_ceil_h  && (S1->ceilh  != S2->ceilh))  return false;
 
-		if (do_light   && (S1->light != S2->light)) continue;
-		if (do_tag     && (S1->tag   != S2->tag  )) continue;
-		if (do_special && (S1->type  != S2->type))  continue;
-
-		// check if only one of the sectors is part of current set
-		// (doing this _AFTER_ the matches since this can be a bit slow)
-		bool got1 = seen.get(sec1);
-		bool got2 = seen.get(sec2);
-
-		if (got1 == got2)
-			continue;
+		if (do_floor_tex && (S1->floor_tex != S2->floor_tex)) return false;
+		if (do_ceil_tex  && (S1->ceil_tex  != S2->ceil_tex))  return false;
 
-		seen.set(got1 ? sec2 : sec1);
+		if (do_light   && (S1->light != S2->light)) return false;
+		if (do_tag     && (S1->tag   != S2->tag  )) return false;
+		if (do_special && (S1->type  != S2->type))  return false;
 
-		changed = true;
-	}
+		return true;
+	};
 
-	return changed;
+	inst.level.secmod.graph().growGroup(seen, can_grow);
 }
 
 
@@ -342,8 +322,7 @@ void Instance::CMD_SEC_SelectGroup()
 
 	seen.set(start_sec);
 
-	while (GrowContiguousSectors(*this, seen))
-	{ }
+	GrowContiguousSectors(*this, seen);
 
 
 	Editor_ClearErrorMode();
@@ -513,58 +492,60 @@ void Instance::CMD_PruneUnused()
 
 //------------------------------------------------------------------------
 
+//
+// Sound starts at level 2 in the start sector, and loses a level for
+// each sound blocking line it crosses.  This is a 0-1 breadth-first
+// search over the sector graph: sectors reached without crossing a
+// blocking line go to the front of the queue, the others to the back.
+//
 static void CalcPropagation(const Instance &inst, std::vector<byte>& vec, bool ignore_doors)
 {
-	bool changes;
+	const SectorGraph &graph = inst.level.secmod.graph();
 
-	for (int k = 0 ; k < inst.level.numSectors(); k++)
-		vec[k] = 0;
+	std::fill(vec.begin(), vec.end(), 0);
 
 	vec[inst.sound_start_sec] = 2;
 
-	do
+	std::deque<int> queue;
+
+	queue.push_back(inst.sound_start_sec);
+
+	while (! queue.empty())
 	{
-		changes = false;
+		int sec = queue.front();
+		queue.pop_front();
 
-		for (const LineDef *L : inst.level.linedefs)
-		{
-			if (! L->TwoSided())
-				continue;
+		const Sector *S1 = inst.level.sectors[sec];
 
-			int sec1 = L->WhatSector(Side::right, inst.level);
-			int sec2 = L->WhatSector(Side::left, inst.level);
+		int val = vec[sec];
 
-			SYS_ASSERT(sec1 >= 0);
-			SYS_ASSERT(sec2 >= 0);
+		for (const SectorGraph::Edge &edge : graph.edges(sec))
+		{
+			const Sector *S2 = inst.level.sectors[edge.sector];
 
 			// check for doors
 			if (!ignore_doors &&
-				(std::min(inst.level.sectors[sec1]->ceilh, inst.level.sectors[sec2]->ceilh) <=
-				 std::max(inst.level.sectors[sec1]->floorh, inst.level.sectors[sec2]->floorh)))
+				(std::min(S1->ceilh, S2->ceilh) <= std::max(S1->floorh, S2->floorh)))
 			{
 				continue;
 			}
 
-			int val1 = vec[sec1];
-			int val2 = vec[sec2];
+			int new_val = val;
 
-			int new_val = std::max(val1, val2);
-
-			if (L->flags & MLF_SoundBlock)
+			if (inst.level.linedefs[edge.line]->flags & MLF_SoundBlock)
 				new_val -= 1;
 
-			if (new_val > val1 || new_val > val2)
-			{
-				if (new_val > val1)
-                    vec[sec1] = static_cast<byte>(new_val);
-				if (new_val > val2)
-                    vec[sec2] = static_cast<byte>(new_val);
+			if (new_val <= vec[edge.sector])
+				continue;
 
-				changes = true;
-			}
-		}
+			vec[edge.sector] = static_cast<byte>(new_val);
 
-	} while (changes);
+			if (new_val == val)
+				queue.push_front(edge.sector);
+			else
+				queue.push_back(edge.sector);
+		}
+	}
 }
 
 
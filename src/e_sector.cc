@@ -29,6 +29,7 @@
 #include "main.h"
 
 #include <map>
+#include <unordered_set>
 
 #include "LineDef.h"
 #include "m_bitvec.h"
@@ -267,24 +268,6 @@ void Instance::CMD_SEC_SwapFlats()
 }
 
 
-void SectorModule::linedefsBetweenSectors(selection_c *list, int sec1, int sec2) const
-{
-	for (int i = 0 ; i < doc.numLinedefs() ; i++)
-	{
-		const LineDef * L = doc.linedefs[i];
-
-		if (! (L->Left(doc) && L->Right(doc)))
-			continue;
-
-		if ((L->Left(doc)->sector == sec1 && L->Right(doc)->sector == sec2) ||
-		    (L->Left(doc)->sector == sec2 && L->Right(doc)->sector == sec1))
-		{
-			list->set(i);
-		}
-	}
-}
-
-
 void SectorModule::replaceSectorRefs(EditOperation &op, int old_sec, int new_sec) const
 {
 	for (int i = 0 ; i < doc.numSidedefs() ; i++)
@@ -329,6 +312,9 @@ void Instance::commandSectorMerge()
 	selection_c common_lines(ObjType::linedefs);
 	selection_c unused_secs (ObjType::sectors);
 
+	// must be done before changing any sidedefs
+	level.secmod.graph().linesWithin(common_lines, *edit.Selected);
+
 	{
 		EditOperation op(level.basis);
 		op.setMessageForSelection("merged", *edit.Selected);
@@ -355,8 +341,6 @@ void Instance::commandSectorMerge()
 			if (old_sec == new_sec)
 				continue;
 
-			level.secmod.linedefsBetweenSectors(&common_lines, old_sec, new_sec);
-
 			level.secmod.replaceSectorRefs(op, old_sec, new_sec);
 
 			unused_secs.set(old_sec);
@@ -418,6 +402,16 @@ bool lineloop_c::get(int ld, Side side) const
 }
 
 
+void lineloop_c::MarkSides(std::vector<byte> &marks) const
+{
+	for (unsigned int k = 0 ; k < lines.size() ; k++)
+		marks[lines[k] * 2 + (sides[k] == Side::left ? 1 : 0)] = 1;
+
+	for (unsigned int i = 0 ; i < islands.size() ; i++)
+		islands[i]->MarkSides(marks);
+}
+
+
 bool lineloop_c::get_just_line(int ld) const
 {
 	for (unsigned int k = 0 ; k < lines.size() ; k++)
@@ -635,17 +629,23 @@ bool SectorModule::traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignor
 	gLog.debugPrintf("TRACE PATH: line:%d  side:%d  cur_vert:%d\n", ld, side, cur_vert);
 #endif
 
+	const VertexLinks &links = doc.vertmod.links();
+
 	// check for an isolated line
-	if (doc.vertmod.howManyLinedefs( cur_vert) == 1 &&
-		doc.vertmod.howManyLinedefs(prev_vert) == 1)
+	if (links.links( cur_vert).size() == 1 &&
+		links.links(prev_vert).size() == 1)
 		return false;
 
+	// the line/side pairs already in the loop
+	std::unordered_set<int> in_loop;
+
 	// compute the average angle over all the lines
 	double average_angle = 0;
 
 	for (;;)
 	{
 		loop.push_back(ld, side);
+		in_loop.insert(ld * 2 + (side == Side::left ? 1 : 0));
 
 		int next_line = -1;
 		int next_vert = -1;
@@ -658,42 +658,27 @@ bool SectorModule::traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignor
 		// it *can* be the exact same linedef (when hitting a dangling
 		// vertex).
 
-		for (int n = 0 ; n < doc.numLinedefs() ; n++)
+		for (const VertexLinks::Link &link : links.links(cur_vert))
 		{
-			const LineDef * N = doc.linedefs[n];
+			int n = link.line;
 
-			if (! N->TouchesVertex(cur_vert))
-				continue;
+			const LineDef * N = doc.linedefs[n];
 
 			if (ignore_bare && !N->Left(doc) && !N->Right(doc))
 				continue;
 
-			int other_vert;
-			Side which_side;
-
-			if (N->start == cur_vert)
-			{
-				other_vert = N->end;
-				which_side = Side::right;
-			}
-			else  /* (N->end == cur_vert) */
-			{
-				other_vert = N->start;
-				which_side = Side::left;
-			}
-
 			double angle;
 
 			if (n == ld)
 				angle = 361.0;
 			else
-				angle = doc.linemod.angleBetweenLines(prev_vert, cur_vert, other_vert);
+				angle = doc.linemod.angleBetweenLines(prev_vert, cur_vert, link.other);
 
 			if (next_line < 0 || angle < best_angle)
 			{
 				next_line = n;
-				next_vert = other_vert;
-				next_side = which_side;
+				next_vert = link.other;
+				next_side = link.side;
 
 				best_angle = angle;
 			}
@@ -714,7 +699,7 @@ bool SectorModule::traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignor
 
 		// this won't happen under normal circumstances, but it *can*
 		// happen and indicates a non-closed structure.
-		if (loop.get(next_line, next_side))
+		if (in_loop.count(next_line * 2 + (next_side == Side::left ? 1 : 0)))
 			return false;
 
 		// OK
@@ -763,6 +748,12 @@ bool lineloop_c::LookForIsland()
 
 	int count = 0;
 
+	// which line/sides are in the current path (including islands)
+	std::vector<byte> in_path(doc.numLinedefs() * 2, 0);
+	MarkSides(in_path);
+
+	const VertexLinks &links = doc.vertmod.links();
+
 	for (int ld = 0 ; ld < doc.numLinedefs() ; ld++)
 	{
 		const LineDef * L = doc.linedefs[ld];
@@ -788,8 +779,8 @@ bool lineloop_c::LookForIsland()
 			if (opp < 0)
 				continue;
 
-			bool  ld_in_path = get(ld,   ld_side);
-			bool opp_in_path = get(opp, opp_side);
+			bool  ld_in_path = in_path[ ld * 2 + ( ld_side == Side::left ? 1 : 0)] != 0;
+			bool opp_in_path = in_path[opp * 2 + (opp_side == Side::left ? 1 : 0)] != 0;
 
 			// need one in the current loop, and the other NOT in it
 			if (ld_in_path == opp_in_path)
@@ -804,13 +795,14 @@ ld, ld_side, opp, opp_side, ld_in_path?1:0, opp_in_path?1:0);
 
 			// treat isolated linedefs like islands
 			if (! ld_in_path &&
-				doc.vertmod.howManyLinedefs(doc.linedefs[ld]->start) == 1 &&
-				doc.vertmod.howManyLinedefs(doc.linedefs[ld]->end)   == 1)
+				links.links(L->start).size() == 1 &&
+				links.links(L->end).size()   == 1)
 			{
 				island->push_back(ld, Side::right);
 				island->push_back(ld, Side::left);
 
 				islands.push_back(island);
+				island->MarkSides(in_path);
 				count++;
 
 				continue;
@@ -826,6 +818,7 @@ ld, ld_side, opp, opp_side, ld_in_path?1:0, opp_in_path?1:0);
 			if (ok && island->faces_outward)
 			{
 				islands.push_back(island);
+				island->MarkSides(in_path);
 				count++;
 			}
 			else
@@ -1243,5 +1236,204 @@ bool SectorModule::assignSectorToSpace(EditOperation &op, const v2double_t &map,
 	return true;
 }
 
+
+//------------------------------------------------------------------------
+//  SECTOR GRAPH
+//------------------------------------------------------------------------
+
+SectorGraph::SectorGraph(const Document &doc)
+{
+	int num_secs = doc.numSectors();
+
+	mFirst.assign(num_secs + 1, 0);
+
+	// count the edges of each sector first
+	for (const LineDef *L : doc.linedefs)
+	{
+		int sec1 = L->WhatSector(Side::right, doc);
+		int sec2 = L->WhatSector(Side::left,  doc);
+
+		if (sec1 >= 0 && sec2 >= 0 && sec1 != sec2)
+		{
+			mFirst[sec1 + 1]++;
+			mFirst[sec2 + 1]++;
+		}
+	}
+
+	for (int s = 0 ; s < num_secs ; s++)
+		mFirst[s + 1] += mFirst[s];
+
+	mEdges.resize(mFirst[num_secs]);
+
+	std::vector<int> pos(mFirst.begin(), mFirst.end() - 1);
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const LineDef *L = doc.linedefs[n];
+
+		int sec1 = L->WhatSector(Side::right, doc);
+		int sec2 = L->WhatSector(Side::left,  doc);
+
+		if (sec1 >= 0 && sec2 >= 0 && sec1 != sec2)
+		{
+			mEdges[pos[sec1]++] = { n, sec2 };
+			mEdges[pos[sec2]++] = { n, sec1 };
+		}
+	}
+}
+
+
+bool SectorGraph::areNeighbors(int sec1, int sec2) const
+{
+	for (const Edge &edge : edges(sec1))
+		if (edge.sector == sec2)
+			return true;
+
+	return false;
+}
+
+
+//
+// Adds the lines between two sectors
+//
+void SectorGraph::linesBetween(selection_c &lines, int sec1, int sec2) const
+{
+	for (const Edge &edge : edges(sec1))
+		if (edge.sector == sec2)
+			lines.set(edge.line);
+}
+
+
+//
+// Adds the lines between any two (different) sectors of a group
+//
+void SectorGraph::linesWithin(selection_c &lines, const selection_c &secs) const
+{
+	for (sel_iter_c it(secs) ; !it.done() ; it.next())
+	{
+		for (const Edge &edge : edges(*it))
+			if (secs.get(edge.sector))
+				lines.set(edge.line);
+	}
+}
+
+
+//
+// Adds all the sectors which can be reached from the group, going
+// through the lines which pass the filter (all lines when null)
+//
+void SectorGraph::growGroup(selection_c &secs, const edge_filter_t &filter) const
+{
+	std::vector<int> stack;
+
+	for (sel_iter_c it(secs) ; !it.done() ; it.next())
+		stack.push_back(*it);
+
+	while (! stack.empty())
+	{
+		int sec = stack.back();
+		stack.pop_back();
+
+		for (const Edge &edge : edges(sec))
+		{
+			if (secs.get(edge.sector))
+				continue;
+
+			if (filter && ! filter(edge.line, sec, edge.sector))
+				continue;
+
+			secs.set(edge.sector);
+			stack.push_back(edge.sector);
+		}
+	}
+}
+
+
+//
+// Numbers the groups of connected sectors, storing the group of each
+// sector in 'comp'.  Returns the number of groups.  The filter must not
+// depend on which way a line gets crossed.
+//
+int SectorGraph::findComponents(std::vector<int> &comp, const edge_filter_t &filter) const
+{
+	comp.assign(numSectors(), -1);
+
+	int count = 0;
+
+	std::vector<int> stack;
+
+	for (int start = 0 ; start < numSectors() ; start++)
+	{
+		if (comp[start] >= 0)
+			continue;
+
+		comp[start] = count;
+		stack.push_back(start);
+
+		while (! stack.empty())
+		{
+			int sec = stack.back();
+			stack.pop_back();
+
+			for (const Edge &edge : edges(sec))
+			{
+				if (comp[edge.sector] >= 0)
+					continue;
+
+				if (filter && ! filter(edge.line, sec, edge.sector))
+					continue;
+
+				comp[edge.sector] = count;
+				stack.push_back(edge.sector);
+			}
+		}
+
+		count++;
+	}
+
+	return count;
+}
+
+
+//
+// Gets the sector graph, building it when needed
+//
+const SectorGraph &SectorModule::graph() const
+{
+	std::lock_guard<std::mutex> lock(m_graph_mutex);
+
+	if (!m_graph)
+		m_graph.reset(new SectorGraph(doc));
+
+	return *m_graph;
+}
+
+
+void SectorModule::invalidateGraph()
+{
+	std::lock_guard<std::mutex> lock(m_graph_mutex);
+
+	m_graph.reset();
+}
+
+
+//
+// Called after each edit operation, and after undo/redo
+//
+void SectorModule::notifyChanges(const ChangeSet &changes)
+{
+	const ChangeSet::Entry &lines = changes[ObjType::linedefs];
+	const ChangeSet::Entry &sides = changes[ObjType::sidedefs];
+
+	// only which sectors are on each side of the lines matters
+	if (lines.hasStructural() || sides.hasStructural() ||
+		changes[ObjType::sectors].hasStructural() ||
+		lines.changedField(LineDef::F_RIGHT) || lines.changedField(LineDef::F_LEFT) ||
+		sides.changedField(SideDef::F_SECTOR))
+	{
+		invalidateGraph();
+	}
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -29,6 +29,13 @@
 
 #include "DocumentModule.h"
 
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ChangeSet;
+
 class lineloop_c
 {
 public:
@@ -109,9 +116,69 @@ public:
 private:
 	bool LookForIsland();
 
+	// set marks[ld*2 + (left ? 1 : 0)] for each line/side in the loop,
+	// including the islands.  'marks' must be large enough.
+	void MarkSides(std::vector<byte> &marks) const;
+
 	void CalcBounds(double *x1, double *y1, double *x2, double *y2) const;
 };
 
+//
+// Which sectors border each other, and through which linedefs.  Only the
+// lines with a different sector on each side are part of it.
+//
+class SectorGraph
+{
+public:
+	struct Edge
+	{
+		int line;
+		int sector;		// the sector on the other side of the line
+	};
+
+	struct EdgeRange
+	{
+		const Edge *first;
+		const Edge *last;
+
+		const Edge *begin() const { return first; }
+		const Edge *end() const { return last; }
+		bool empty() const { return first == last; }
+	};
+
+	explicit SectorGraph(const Document &doc);
+
+	int numSectors() const
+	{
+		return static_cast<int>(mFirst.size()) - 1;
+	}
+
+	// the edges of a sector, in linedef order
+	EdgeRange edges(int sec) const
+	{
+		const Edge *base = mEdges.data();
+		return { base + mFirst[sec], base + mFirst[sec + 1] };
+	}
+
+	// decides whether a group may grow from sector 'sec1' into the
+	// neighbouring sector 'sec2' through the given line
+	typedef std::function<bool(int line, int sec1, int sec2)> edge_filter_t;
+
+	bool areNeighbors(int sec1, int sec2) const;
+
+	void linesBetween(selection_c &lines, int sec1, int sec2) const;
+	void linesWithin(selection_c &lines, const selection_c &secs) const;
+
+	void growGroup(selection_c &secs, const edge_filter_t &filter = nullptr) const;
+	int findComponents(std::vector<int> &comp, const edge_filter_t &filter = nullptr) const;
+
+private:
+	// where the edges of each sector begin in mEdges (with an extra
+	// entry at the end)
+	std::vector<int> mFirst;
+	std::vector<Edge> mEdges;
+};
+
 //
 // Sector module
 //
@@ -123,6 +190,10 @@ public:
 	{
 	}
 
+	const SectorGraph &graph() const;
+	void invalidateGraph();
+	void notifyChanges(const ChangeSet &changes);
+
 	bool traceLineLoop(int ld, Side side, lineloop_c& loop, bool ignore_bare = false) const;
 	bool assignSectorToSpace(EditOperation &op, const v2double_t &map, int new_sec = -1, int model = -1) const;
 	void sectorsAdjustLight(int delta) const;
@@ -131,7 +202,6 @@ public:
 private:
 	friend class lineloop_c;
 
-	void linedefsBetweenSectors(selection_c *list, int sec1, int sec2) const;
 	void replaceSectorRefs(EditOperation &op, int old_sec, int new_sec) const;
 	inline bool willBeTwoSided(int ld, Side side) const;
 	void determineNewTextures(lineloop_c& loop,
@@ -141,6 +211,9 @@ private:
 							   int new_lower, int new_upper,
 						selection_c &flip) const;
 	bool getLoopForSpace(const v2double_t &map, lineloop_c& loop) const;
+
+	mutable std::unique_ptr<SectorGraph> m_graph;
+	mutable std::mutex m_graph_mutex;
 };
 
 
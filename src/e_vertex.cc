@@ -45,6 +45,7 @@
 #include "w_rawdef.h"
 
 #include <algorithm>
+#include <unordered_map>
 
 
 int VertexModule::findExact(FFixedPoint fx, FFixedPoint fy) const
@@ -58,6 +59,40 @@ int VertexModule::findExact(FFixedPoint fx, FFixedPoint fy) const
 	return -1;  // not found
 }
 
+//
+// Finds the vertices sitting exactly on a lower numbered vertex (the
+// lowest one at each spot is left out).  When 'bases' is given, it gets
+// that lowest vertex for each one found, and -1 for the others.
+//
+void VertexModule::findOverlaps(selection_c &sel, std::vector<int> *bases) const
+{
+	sel.change_type(ObjType::vertices);
+
+	if (bases)
+		bases->assign(doc.numVertices(), -1);
+
+	std::unordered_map<uint64_t, int> seen;
+	seen.reserve(doc.numVertices());
+
+	for (int n = 0 ; n < doc.numVertices() ; n++)
+	{
+		const Vertex *V = doc.vertices[n];
+
+		uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(V->raw_x.raw())) << 32) |
+		                static_cast<uint32_t>(V->raw_y.raw());
+
+		auto result = seen.emplace(key, n);
+
+		if (result.second)
+			continue;
+
+		sel.set(n);
+
+		if (bases)
+			(*bases)[n] = result.first->second;
+	}
+}
+
 
 int VertexModule::findDragOther(int v_num) const
 {
@@ -83,17 +118,64 @@ int VertexModule::findDragOther(int v_num) const
 
 int VertexModule::howManyLinedefs(int v_num) const
 {
-	int count = 0;
+	return links().links(v_num).size();
+}
+
+
+VertexLinks::VertexLinks(const Document &doc) :
+	mVersion(doc.basis.connectivityVersion()), mNumLines(doc.numLinedefs())
+{
+	int num_verts = doc.numVertices();
+
+	mFirst.assign(num_verts + 1, 0);
+
+	for (const LineDef *L : doc.linedefs)
+	{
+		mFirst[L->start + 1]++;
+
+		if (L->end != L->start)
+			mFirst[L->end + 1]++;
+	}
+
+	for (int v = 0 ; v < num_verts ; v++)
+		mFirst[v + 1] += mFirst[v];
+
+	mLinks.resize(mFirst[num_verts]);
+
+	std::vector<int> pos(mFirst.begin(), mFirst.end() - 1);
 
 	for (int n = 0 ; n < doc.numLinedefs() ; n++)
 	{
 		const LineDef *L = doc.linedefs[n];
 
-		if (L->start == v_num || L->end == v_num)
-			count++;
+		mLinks[pos[L->start]++] = { n, L->end, Side::right };
+
+		if (L->end != L->start)
+			mLinks[pos[L->end]++] = { n, L->start, Side::left };
 	}
+}
+
+
+bool VertexLinks::isCurrent(const Document &doc) const
+{
+	return mVersion == doc.basis.connectivityVersion() &&
+		   mNumLines == doc.numLinedefs() &&
+		   static_cast<int>(mFirst.size()) == doc.numVertices() + 1;
+}
+
+
+//
+// Gets the linedefs at each vertex, rebuilding them when the map has
+// changed (this may happen in the middle of an operation).
+//
+const VertexLinks &VertexModule::links() const
+{
+	std::lock_guard<std::mutex> lock(m_links_mutex);
+
+	if (!m_links || !m_links->isCurrent(doc))
+		m_links.reset(new VertexLinks(doc));
 
-	return count;
+	return *m_links;
 }
 
 
@@ -28,9 +28,59 @@
 #define __EUREKA_E_VERTEX_H__
 
 #include "DocumentModule.h"
+#include "Side.h"
+
+#include <memory>
+#include <mutex>
+#include <vector>
 
 struct vert_along_t;
 
+//
+// The linedefs at each vertex, a half-edge view of the map.  Only how
+// things connect is stored, so moving vertices does not affect it.
+//
+class VertexLinks
+{
+public:
+	struct Link
+	{
+		int line;
+		int other;	// vertex at the other end of the line
+		Side side;	// right when the line starts at the vertex, left when it ends there
+	};
+
+	struct LinkRange
+	{
+		const Link *first;
+		const Link *last;
+
+		const Link *begin() const { return first; }
+		const Link *end() const { return last; }
+		int size() const { return static_cast<int>(last - first); }
+	};
+
+	explicit VertexLinks(const Document &doc);
+
+	// the lines at a vertex, in linedef order
+	LinkRange links(int v_num) const
+	{
+		const Link *base = mLinks.data();
+		return { base + mFirst[v_num], base + mFirst[v_num + 1] };
+	}
+
+	bool isCurrent(const Document &doc) const;
+
+private:
+	// where the links of each vertex begin in mLinks (with an extra
+	// entry at the end)
+	std::vector<int> mFirst;
+	std::vector<Link> mLinks;
+
+	unsigned mVersion;
+	int mNumLines;
+};
+
 class VertexModule : public DocumentModule
 {
 	friend class Instance;
@@ -39,7 +89,10 @@ public:
 	{
 	}
 
+	const VertexLinks &links() const;
+
 	int findExact(FFixedPoint fx, FFixedPoint fy) const;
+	void findOverlaps(selection_c &sel, std::vector<int> *bases = nullptr) const;
 	int findDragOther(int v_num) const;
 	int howManyLinedefs(int v_num) const;
 	void mergeList(EditOperation &op, selection_c &list) const;
@@ -59,6 +112,9 @@ private:
 		unsigned int start_idx, double arc_rad,
 		double ang_offset /* radians */,
 		bool move_vertices = false) const;
+
+	mutable std::unique_ptr<VertexLinks> m_links;
+	mutable std::mutex m_links_mutex;
 };
 
 #endif  /* __EUREKA_E_VERTEX_H__ */
@@ -67,6 +67,21 @@ void Palette::updateGamma()
 		rgb555_gamma [d] = static_cast<byte>(gammatable[config::usegamma][i]);
 		rgb555_medium[d] = static_cast<byte>(gammatable[config::panel_gamma][i]);
 	}
+
+	// a table for every pixel value lets images be converted for OpenGL
+	// without any branching on the kind of pixel.
+	gl_colors.assign(1 << 16, 0);
+
+	for (int p = 0 ; p < (1 << 16) ; p++)
+	{
+		if (p == TRANS_PIXEL || (p >= 256 && ! (p & IS_RGB_PIXEL)))
+			continue;
+
+		byte r, g, b;
+		decodePixel(static_cast<img_pixel_t>(p), r, g, b);
+
+		gl_colors[p] = 0xFF000000u | ((u32_t)r << 16) | ((u32_t)g << 8) | b;
+	}
 }
 
 void Palette::loadPalette(Lump_c *lump)
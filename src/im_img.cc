@@ -29,7 +29,12 @@
 #include "main.h"
 
 #include "im_img.h"
+#include "lib_threads.h"
 #include "m_game.h"
+#include "Sector.h"
+#include "SideDef.h"
+
+#include <algorithm>
 
 #ifndef NO_OPENGL
 // need this for GL_UNSIGNED_INT_8_8_8_8_REV
@@ -97,6 +102,10 @@ const img_pixel_t *Img_c::buf() const
 //
 img_pixel_t *Img_c::wbuf()
 {
+	// the caller may change anything
+	trans_known = -1;
+	mips.clear();
+
 	return pixels;
 }
 
@@ -108,11 +117,10 @@ void Img_c::clear()
 {
 	if (pixels)
 	{
-		img_pixel_t *dest = pixels;
-		img_pixel_t *dest_end = dest + (w * h);
+		std::fill(pixels, pixels + (w * h), TRANS_PIXEL);
 
-		for ( ; dest < dest_end ; dest++)
-			*dest = TRANS_PIXEL;
+		trans_known = 1;
+		mips.clear();
 	}
 }
 
@@ -126,6 +134,9 @@ void Img_c::resize(int new_width, int new_height)
 	if (new_width == w && new_height == h)
 		return;
 
+	trans_known = -1;
+	mips.clear();
+
 	// unallocate old buffer
 	if (pixels)
 	{
@@ -158,6 +169,13 @@ void Img_c::compose(Img_c *other, int x, int y)
 	int OW = other->width();
 	int OH = other->height();
 
+	// clip the columns once, rather than checking every pixel
+	int ox1 = std::max(0, -x);
+	int ox2 = std::min(OW, W - x);
+
+	if (ox1 >= ox2)
+		return;
+
 	for (int oy = 0 ; oy < OH ; oy++)
 	{
 		int iy = y + oy;
@@ -167,15 +185,7 @@ void Img_c::compose(Img_c *other, int x, int y)
 		const img_pixel_t *src = other->buf() + oy * OW;
 		img_pixel_t *dest = wbuf() + iy * W;
 
-		for (int ox = 0 ; ox < OW ; ox++, src++)
-		{
-			int ix = x + ox;
-			if (ix < 0 || ix >= W)
-				continue;
-
-			if (*src != TRANS_PIXEL)
-				dest[ix] = *src;
-		}
+		IM_ComposeRow(dest + x + ox1, src + ox1, ox2 - ox1);
 	}
 }
 
@@ -200,15 +210,14 @@ Img_c * Img_c::spectrify(const ConfigData &config) const
 
 	img_pixel_t *dest = omg->wbuf();
 
-	for (int y = 0 ; y < H ; y++)
-	for (int x = 0 ; x < W ; x++)
+	for (int i = 0 ; i < W * H ; i++)
 	{
-		img_pixel_t pix = src[y * W + x];
+		img_pixel_t pix = src[i];
 
 		if (pix != TRANS_PIXEL)
 			pix = static_cast<img_pixel_t>(invis_start + (rand() >> 4) % invis_len);
 
-		dest[y * W + x] = pix;
+		dest[i] = pix;
 	}
 
 	return omg;
@@ -274,19 +283,20 @@ Img_c * Img_c::color_remap(int src1, int src2, int targ1, int targ2) const
 
 	img_pixel_t *dest = omg->wbuf();
 
-	for (int y = 0 ; y < H ; y++)
-	for (int x = 0 ; x < W ; x++)
+	// work out the new colors once, not per pixel
+	std::vector<img_pixel_t> remap(src2 - src1 + 1);
+
+	for (int diff = 0 ; diff <= src2 - src1 ; diff++)
+		remap[diff] = static_cast<img_pixel_t>(targ1 + diff * (targ2 - targ1 + 1) / (src2 - src1 + 1));
+
+	for (int i = 0 ; i < W * H ; i++)
 	{
-		img_pixel_t pix = src[y * W + x];
+		img_pixel_t pix = src[i];
 
 		if (src1 <= pix && pix <= src2)
-		{
-			int diff = pix - src1;
-
-			pix = static_cast<img_pixel_t>(targ1 + diff * (targ2 - targ1 + 1) / (src2 - src1 + 1));
-		}
+			pix = remap[pix - src1];
 
-		dest[y * W + x] = pix;
+		dest[i] = pix;
 	}
 
 	return omg;
@@ -295,19 +305,95 @@ Img_c * Img_c::color_remap(int src1, int src2, int targ1, int targ2) const
 
 bool Img_c::has_transparent() const
 {
-	int W = width();
-	int H = height();
+	int known = trans_known;
 
-	const img_pixel_t *src = buf();
+	if (known >= 0)
+		return known != 0;
+
+	bool result = IM_HasTransPixel(buf(), w * h);
+
+	trans_known = result ? 1 : 0;
+
+	return result;
+}
+
+
+const Img_c * Img_c::mip_level(const Palette &pal, int level) const
+{
+	const Img_c *img = this;
+
+	for (int i = 0 ; i < level ; i++)
+	{
+		if (img->w < 2 && img->h < 2)
+			break;
+
+		if ((int)mips.size() <= i)
+			mips.emplace_back(img->halve(pal));
+
+		img = mips[i].get();
+	}
+
+	return img;
+}
+
+
+Img_c * Img_c::halve(const Palette &pal) const
+{
+	// an odd last column or row gets blocks of its own
+	int W = (w + 1) / 2;
+	int H = (h + 1) / 2;
+
+	Img_c *omg = new Img_c(W, H);
+
+	img_pixel_t *dest = omg->wbuf();
 
 	for (int y = 0 ; y < H ; y++)
 	for (int x = 0 ; x < W ; x++)
 	{
-		if (src[y * W + x] == TRANS_PIXEL)
-			return true;
+		int r = 0, g = 0, b = 0;
+		int opaque = 0;
+		int total  = 0;
+
+		for (int dy = 0 ; dy < 2 ; dy++)
+		for (int dx = 0 ; dx < 2 ; dx++)
+		{
+			int ix = x * 2 + dx;
+			int iy = y * 2 + dy;
+
+			if (ix >= w || iy >= h)
+				continue;
+
+			total++;
+
+			img_pixel_t pix = pixels[iy * w + ix];
+
+			if (pix == TRANS_PIXEL)
+				continue;
+
+			rgb_color_t col = pal.pixelToRGB(pix);
+
+			r += RGB_RED(col);
+			g += RGB_GREEN(col);
+			b += RGB_BLUE(col);
+
+			opaque++;
+		}
+
+		// mostly transparent blocks stay transparent
+		if (opaque * 2 < total || opaque == 0)
+		{
+			dest[y * W + x] = TRANS_PIXEL;
+			continue;
+		}
+
+		r = r / opaque;
+		g = g / opaque;
+		b = b / opaque;
+
+		dest[y * W + x] = static_cast<img_pixel_t>(IMG_PIXEL_MAKE_RGB(r >> 3, g >> 3, b >> 3));
 	}
 
-	return false;
+	return omg;
 }
 
 
@@ -343,79 +429,84 @@ void Img_c::load_gl() {}
 void Img_c::unload_gl(bool can_delete) {}
 void Img_c::bind_gl() {}
 
+void IM_LoadImagesGL(const WadData &wad, const std::vector<Img_c *> &images) {}
+void IM_PrepareLevelImages(Instance &inst, bool want_textures, bool want_flats) {}
+
 #else
 
 void Img_c::load_gl(const WadData &wad)
 {
-	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+	// only the main thread uploads, so one buffer does for all images
+	static std::vector<u32_t> rgba;
+
+	int tw, th;
+
+	convert_gl(wad.palette, rgba, &tw, &th);
+	upload_gl(rgba, tw, th);
+}
 
-	glGenTextures(1, &gl_tex);
-	glBindTexture(GL_TEXTURE_2D, gl_tex);
 
+void Img_c::convert_gl(const Palette &pal, std::vector<u32_t> &rgba, int *tw, int *th) const
+{
 	// construct a power-of-two sized bottom-up RGBA image
-	int tw, th;
 	if (global::use_npot_textures)
 	{
-		tw = w;
-		th = h;
+		*tw = w;
+		*th = h;
 	}
 	else
 	{
-		tw = RoundPOW2(w);
-		th = RoundPOW2(h);
+		*tw = RoundPOW2(w);
+		*th = RoundPOW2(h);
 	}
 
-	byte *rgba = new byte[tw * th * 4];
+	rgba.assign((size_t)*tw * *th, 0);
 
-	memset(rgba, 0, (size_t)(tw * th * 4));
+	const u32_t *colors = pal.getGLColors();
 
+	// opaque images get repeated into the padding, so they tile properly
 	bool has_trans = has_transparent();
 
-	int ex = has_trans ? w : tw;
-	int ey = has_trans ? h : th;
+	int ex = has_trans ? w : *tw;
+	int ey = has_trans ? h : *th;
 
-	int x, y;
-
-	for (y = 0 ; y < ey ; y++)
+	for (int y = 0 ; y < ey ; y++)
 	{
 		// invert source Y for OpenGL
 		int sy = h - 1 - y;
 		if (sy < 0)
 			sy += h;
 
-		for (x = 0 ; x < ex ; x++)
-		{
-			int sx = x;
-			if (sx >= w)
-				sx = x - w;
+		const img_pixel_t *src = buf() + sy * w;
+		u32_t *dest = rgba.data() + (size_t)y * *tw;
 
-			// convert pixel to RGBA
-			const img_pixel_t pix = buf()[sy*w + sx];
+		int x = 0;
 
-			if (pix != TRANS_PIXEL)
-			{
-				byte r, g, b;
+		for (; x < std::min(ex, w) ; x++)
+			dest[x] = colors[src[x]];
 
-				wad.palette.decodePixel(pix, r, g, b);
+		for (; x < ex ; x++)
+			dest[x] = colors[src[x - w]];
+	}
+}
 
-				byte *dest = rgba + (y*tw + x) * 4;
 
-				dest[0] = b;
-				dest[1] = g;
-				dest[2] = r;
-				dest[3] = 255;
-			}
-		}
-	}
+void Img_c::upload_gl(const std::vector<u32_t> &rgba, int tw, int th)
+{
+	glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+	glGenTextures(1, &gl_tex);
+	glBindTexture(GL_TEXTURE_2D, gl_tex);
 
-	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	// mipmaps stop distant or zoomed out textures from shimmering, the
+	// nearest level is used to keep the blocky look of the game.
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+	glTexParameteri(GL_TEXTURE_2D, GL_GENERATE_MIPMAP, GL_TRUE);
 
 	glTexImage2D(GL_TEXTURE_2D, 0 /* mip */,
 		GL_RGBA8, tw, th, 0 /* border */,
-		GL_BGRA_EXT, GL_UNSIGNED_INT_8_8_8_8_REV, rgba);
-
-	delete[] rgba;
+		GL_BGRA_EXT, GL_UNSIGNED_INT_8_8_8_8_REV, rgba.data());
 }
 
 
@@ -443,6 +534,96 @@ void Img_c::bind_gl(const WadData &wad)
 	glBindTexture(GL_TEXTURE_2D, gl_tex);
 }
 
+
+//
+// Uploads the images which are not in OpenGL yet, with the pixels of a
+// batch being converted by the worker threads before uploading it.
+//
+void IM_LoadImagesGL(const WadData &wad, const std::vector<Img_c *> &images)
+{
+	std::vector<Img_c *> todo;
+
+	for (Img_c *img : images)
+		if (img && img->gl_texture() == 0)
+			todo.push_back(img);
+
+	std::sort(todo.begin(), todo.end());
+	todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+
+	// limits the memory used for the converted pixels
+	const int batch_size = 64;
+
+	struct converted_t
+	{
+		std::vector<u32_t> rgba;
+		int tw, th;
+	};
+
+	std::vector<converted_t> batch(std::min((int)todo.size(), batch_size));
+
+	for (int start = 0 ; start < (int)todo.size() ; start += batch_size)
+	{
+		int count = std::min((int)todo.size() - start, batch_size);
+
+		ThreadPool::shared().parallelFor(count, [&](int i)
+		{
+			converted_t &C = batch[i];
+			todo[start + i]->convert_gl(wad.palette, C.rgba, &C.tw, &C.th);
+		});
+
+		for (int i = 0 ; i < count ; i++)
+			todo[start + i]->upload_gl(batch[i].rgba, batch[i].tw, batch[i].th);
+	}
+}
+
+
+//
+// Uploads all the textures and/or flats used by the level in one go,
+// rather than one at a time as each first comes into view.
+//
+void IM_PrepareLevelImages(Instance &inst, bool want_textures, bool want_flats)
+{
+	std::vector<SString> tex_names;
+	std::vector<SString> flat_names;
+
+	if (want_textures)
+	{
+		for (const SideDef *side : inst.level.sidedefs)
+		{
+			tex_names.push_back(side->UpperTex());
+			tex_names.push_back(side->MidTex());
+			tex_names.push_back(side->LowerTex());
+		}
+	}
+
+	if (want_flats)
+	{
+		for (const Sector *sector : inst.level.sectors)
+		{
+			flat_names.push_back(sector->FloorTex());
+			flat_names.push_back(sector->CeilTex());
+		}
+	}
+
+	for (std::vector<SString> *names : { &tex_names, &flat_names })
+	{
+		std::sort(names->begin(), names->end());
+		names->erase(std::unique(names->begin(), names->end()), names->end());
+	}
+
+	inst.wad.images.decodeNamed(inst.conf, tex_names, flat_names);
+
+	std::vector<Img_c *> images;
+
+	for (const SString &name : tex_names)
+		images.push_back(inst.wad.images.getTexture(inst.conf, name));
+
+	for (const SString &name : flat_names)
+		images.push_back(inst.wad.images.W_GetFlat(inst.conf, name));
+
+	IM_LoadImagesGL(inst.wad, images);
+}
+
 #endif
 
 //------------------------------------------------------------------------
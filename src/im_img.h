@@ -29,6 +29,13 @@
 
 #include "im_color.h"
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include <string.h>
+
 #ifdef NO_OPENGL
 typedef unsigned int GLuint;
 #else
@@ -53,6 +60,39 @@ const img_pixel_t IS_RGB_PIXEL = 0x8000;
 // the color number used to represent transparent pixels in an Img_c.
 const img_pixel_t TRANS_PIXEL = 255;
 
+// copies a row of pixels, skipping the transparent ones.  The pixels go
+// through small local blocks, which compilers vectorize even at -O2
+// since they cannot overlap and have a fixed size.
+inline void IM_ComposeRow(img_pixel_t *dest, const img_pixel_t *src, int count)
+{
+	const int block = 8;
+
+	int i = 0;
+
+	for ( ; i + block <= count ; i += block)
+	{
+		img_pixel_t s[block];
+		img_pixel_t d[block];
+
+		memcpy(s, src  + i, sizeof(s));
+		memcpy(d, dest + i, sizeof(d));
+
+		for (int k = 0 ; k < block ; k++)
+			d[k] = (s[k] != TRANS_PIXEL) ? s[k] : d[k];
+
+		memcpy(dest + i, d, sizeof(d));
+	}
+
+	for ( ; i < count ; i++)
+		if (src[i] != TRANS_PIXEL)
+			dest[i] = src[i];
+}
+
+inline bool IM_HasTransPixel(const img_pixel_t *src, int count)
+{
+	return std::find(src, src + count, TRANS_PIXEL) != src + count;
+}
+
 class Fl_RGB_Image;
 class Instance;
 class Palette;
@@ -70,6 +110,14 @@ private:
 	// texture identifier for OpenGL, 0 if not uploaded yet
 	GLuint gl_tex = 0;
 
+	// result of has_transparent(), -1 when not known.  Reset whenever
+	// the pixels may change, i.e. by wbuf() and the editing methods.
+	mutable std::atomic<int> trans_known { -1 };
+
+	// smaller copies for drawing zoomed out, made by mip_level() when
+	// first needed.  Entry N is the image halved N+1 times.
+	mutable std::vector<std::unique_ptr<Img_c>> mips;
+
 public:
 	 Img_c() = default;
 	 Img_c(int width, int height, bool _dummy = false);
@@ -117,11 +165,24 @@ public:
 
 	Img_c * color_remap(int src1, int src2, int targ1, int targ2) const;
 
+	// the result is remembered until the pixels are changed.
 	bool has_transparent() const;
 
+	// the image halved 'level' times (0 is this image), stopping at a
+	// single pixel.  Each 2x2 block (less at odd edges) is averaged into
+	// an RGB pixel.  The copies are kept until the pixels change.  Main
+	// thread only.
+	const Img_c * mip_level(const Palette &pal, int level) const;
+
 	// upload to OpenGL, overwriting 'gl_tex' field.
 	void load_gl(const WadData &wad);
 
+	// the two halves of load_gl().  convert_gl() makes the pixels for
+	// OpenGL and can be called by any thread, upload_gl() must be called
+	// by the main thread.
+	void convert_gl(const Palette &pal, std::vector<u32_t> &rgba, int *tw, int *th) const;
+	void upload_gl(const std::vector<u32_t> &rgba, int tw, int th);
+
 	// invalidate the 'gl_tex' field, deleting old texture if possible.
 	void unload_gl(bool can_delete);
 
@@ -131,6 +192,8 @@ public:
 	void test_make_RGB(const WadData &wad);
 
 private:
+	Img_c * halve(const Palette &pal) const;
+
 	Img_c            (const Img_c&);  // No need to implement it
 	Img_c& operator= (const Img_c&);  // No need to implement it
 };
@@ -141,6 +204,9 @@ Img_c *IM_CreateMapSpotSprite(const Palette &pal, int base_r, int base_g, int ba
 Img_c *IM_ConvertRGBImage(Fl_RGB_Image *src);
 Img_c *IM_ConvertTGAImage(const rgba_color_t *data, int W, int H);
 
+void IM_LoadImagesGL(const WadData &wad, const std::vector<Img_c *> &images);
+void IM_PrepareLevelImages(Instance &inst, bool want_textures, bool want_flats);
+
 #endif  /* __EUREKA_IM_IMG_H__*/
 
 //--- editor settings ---
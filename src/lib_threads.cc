@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------
+//  THREAD POOL
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "lib_threads.h"
+
+ThreadPool::ThreadPool(int numThreads)
+{
+	if (numThreads <= 0)
+		numThreads = (int)std::thread::hardware_concurrency();
+	if (numThreads <= 0)
+		numThreads = 1;
+
+	mWorkers.reserve(numThreads);
+
+	for (int i = 0 ; i < numThreads ; i++)
+		mWorkers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mStopping = true;
+	}
+	mWakeUp.notify_all();
+
+	for (std::thread &worker : mWorkers)
+		worker.join();
+}
+
+
+ThreadPool &ThreadPool::shared()
+{
+	static ThreadPool pool;
+	return pool;
+}
+
+
+std::future<void> ThreadPool::submit(std::function<void()> job)
+{
+	std::packaged_task<void()> task(std::move(job));
+	std::future<void> result = task.get_future();
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mQueue.push_back(std::move(task));
+	}
+	mWakeUp.notify_one();
+
+	return result;
+}
+
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)> &job)
+{
+	if (count <= 0)
+		return;
+
+	// not worth the hand-over
+	if (count == 1)
+	{
+		job(0);
+		return;
+	}
+
+	std::vector<std::future<void>> results;
+	results.reserve(count);
+
+	for (int i = 0 ; i < count ; i++)
+		results.push_back(submit([&job, i]() { job(i); }));
+
+	// wait for everything before rethrowing, since the jobs reference 'job'
+	for (std::future<void> &result : results)
+		result.wait();
+
+	for (std::future<void> &result : results)
+		result.get();
+}
+
+
+void ThreadPool::workerLoop()
+{
+	for (;;)
+	{
+		std::packaged_task<void()> task;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mWakeUp.wait(lock, [this]() { return mStopping || !mQueue.empty(); });
+
+			if (mQueue.empty())
+				return;  // stopping
+
+			task = std::move(mQueue.front());
+			mQueue.pop_front();
+		}
+
+		task();
+	}
+}
+
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
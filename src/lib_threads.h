@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------
+//  THREAD POOL
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_LIB_THREADS_H__
+#define __EUREKA_LIB_THREADS_H__
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//
+// A fixed set of worker threads running queued jobs. Jobs must not touch
+// the GUI, and must not wait on other jobs of the same pool.
+//
+class ThreadPool
+{
+public:
+	// 0 threads means one per CPU core
+	explicit ThreadPool(int numThreads = 0);
+	~ThreadPool();
+
+	// the pool shared by the whole program
+	static ThreadPool &shared();
+
+	int numThreads() const
+	{
+		return (int)mWorkers.size();
+	}
+
+	// queue a job. Exceptions thrown by it are passed on by the future.
+	std::future<void> submit(std::function<void()> job);
+
+	// run job(0) .. job(count - 1) on the pool and wait for all of them.
+	// The first exception thrown by a job gets rethrown here.
+	void parallelFor(int count, const std::function<void(int)> &job);
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> mWorkers;
+	std::deque<std::packaged_task<void()>> mQueue;
+
+	std::mutex mMutex;
+	std::condition_variable mWakeUp;
+	bool mStopping = false;
+
+	// deliberately don't implement these
+	ThreadPool(const ThreadPool &other);
+	ThreadPool &operator = (const ThreadPool &other);
+};
+
+#endif  /* __EUREKA_LIB_THREADS_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
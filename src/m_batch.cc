@@ -0,0 +1,192 @@
+//------------------------------------------------------------------------
+//  BATCH (HEADLESS) MODE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Errors.h"
+#include "Instance.h"
+#include "main.h"
+#include "m_batch.h"
+
+#include "bsp.h"
+#include "e_checks.h"
+#include "SafeOutFile.h"
+#include "w_wad.h"
+
+bool global::batch_nodes;
+SString global::batch_check;
+SString global::batch_report;
+
+namespace
+{
+
+//
+// The machine-readable results of a batch run. Each line has these
+// tab-separated fields:
+//
+//    level   task   status   message
+//
+// where task is "nodes" or the check group (e.g. "vertices"), and status
+// is one of "ok", "minor", "major" or "failed".
+//
+class BatchReport
+{
+public:
+	void add(const SString &level, const char *task, const char *status,
+			 const SString &message)
+	{
+		mText += SString::printf("%s\t%s\t%s\t%s\n", level.c_str(), task,
+								 status, message.c_str());
+	}
+
+	void write(const SString &path) const noexcept(false)
+	{
+		auto check = [&path](const ReportedResult &result)
+		{
+			if(!result.success)
+				ThrowException("Failed writing report to '%s': %s\n",
+							   path.c_str(), result.message.c_str());
+		};
+
+		SafeOutFile sof(path);
+		check(sof.openForWriting());
+		check(sof.write(mText.c_str(), mText.length()));
+		check(sof.commit());
+	}
+
+private:
+	SString mText = "# level\ttask\tstatus\tmessage\n";
+};
+
+const char *const severity_names[3] = { "ok", "minor", "major" };
+
+}
+
+
+//
+// Parses the --check value, returns the minimum severity to report or
+// 0 when no checks were asked for.
+//
+static int Batch_CheckSeverity()
+{
+	if (global::batch_check.empty())
+		return 0;
+	if (global::batch_check.noCaseEqual("all"))
+		return 1;
+	if (global::batch_check.noCaseEqual("major"))
+		return 2;
+
+	ThrowException("Unknown --check mode '%s' (use 'all' or 'major')\n",
+				   global::batch_check.c_str());
+}
+
+
+//
+// Runs the requested tasks over every level of the edit wad, without any
+// GUI. The edit wad, IWAD and port must already be set up.
+//
+// Returns the process exit code.
+//
+int Batch_Run(Instance &inst)
+{
+	Wad_file *wad = inst.wad.master.edit_wad.get();
+	SYS_ASSERT(wad);
+
+	int min_severity = Batch_CheckSeverity();
+
+	if (! global::batch_nodes && min_severity == 0)
+		ThrowException("Batch mode needs --nodes and/or --check\n");
+
+	if (global::batch_nodes && wad->IsReadOnly())
+		ThrowException("Cannot build nodes on a read-only file: %s\n",
+					   wad->PathName().c_str());
+
+	int num_levels = wad->LevelCount();
+	if (num_levels == 0)
+		ThrowException("No levels found in %s\n", wad->PathName().c_str());
+
+	BatchReport report;
+	int exit_code = BATCH_OK;
+
+	std::vector<CheckFinding> findings;
+
+	for (int n = 0 ; n < num_levels ; n++)
+	{
+		SString level_name = wad->GetLump(wad->LevelHeader(n))->Name();
+
+		inst.LoadLevelNum(wad, n);
+		inst.loaded.levelName = level_name.asUpper();
+
+		// config parsing can depend on the map format, hence the
+		// resources are loaded after the first level
+		if (n == 0)
+			inst.Main_LoadResources(inst.loaded);
+
+		gLog.printf("Batch: processing %s (%d/%d)\n", level_name.c_str(),
+					n + 1, num_levels);
+
+		if (global::batch_nodes)
+		{
+			int warnings;
+			build_result_e ret = inst.BuildNodesBatch(n, &warnings);
+
+			if (ret == BUILD_OK)
+			{
+				report.add(level_name, "nodes", warnings > 0 ? "minor" : "ok",
+						   SString::printf("%d warnings", warnings));
+			}
+			else
+			{
+				report.add(level_name, "nodes", "failed",
+						   ret == BUILD_LumpOverflow ? "lumps overflowed" :
+						   "build error");
+				exit_code = BATCH_Problems;
+			}
+		}
+
+		if (min_severity > 0)
+		{
+			inst.level.checks.collectFindings(findings);
+
+			for (const CheckFinding &finding : findings)
+			{
+				if (finding.severity < min_severity)
+					continue;
+
+				report.add(level_name, checkGroupName(finding.group),
+						   severity_names[finding.severity], finding.message);
+				exit_code = BATCH_Problems;
+			}
+		}
+	}
+
+	if (! global::batch_report.empty())
+	{
+		report.write(global::batch_report);
+		gLog.printf("Batch: wrote report to %s\n", global::batch_report.c_str());
+	}
+
+	gLog.printf("Batch: finished, %s\n", exit_code == BATCH_OK ?
+				"no problems" : "problems were found");
+
+	return exit_code;
+}
+
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
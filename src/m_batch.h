@@ -0,0 +1,50 @@
+//------------------------------------------------------------------------
+//  BATCH (HEADLESS) MODE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_M_BATCH_H__
+#define __EUREKA_M_BATCH_H__
+
+#include "m_strings.h"
+
+class Instance;
+
+namespace global
+{
+	extern bool batch_nodes;		// --nodes : build nodes of every level
+	extern SString batch_check;		// --check : "all" or "major"
+	extern SString batch_report;	// --report : where to write the results
+}
+
+//
+// Batch mode exit codes
+//
+enum
+{
+	BATCH_OK = 0,			// everything built, nothing bad found
+	BATCH_Problems = 1,		// some levels failed, or checks found problems
+	// fatal errors exit with 2, see FatalError()
+};
+
+int Batch_Run(Instance &inst);
+
+#endif  /* __EUREKA_M_BATCH_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
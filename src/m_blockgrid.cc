@@ -0,0 +1,120 @@
+//------------------------------------------------------------------------
+//  BLOCK GRID
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Errors.h"
+
+#include "sys_debug.h"
+
+#include "m_blockgrid.h"
+
+#include <algorithm>
+#include <math.h>
+
+// keep memory sane on huge (or bogus) maps, by using bigger blocks
+static const int MAX_BLOCKS = 1 << 20;
+
+
+BlockGrid::BlockGrid(double x1, double y1, double x2, double y2, int blockSize) :
+	mOriginX(std::min(x1, x2)), mOriginY(std::min(y1, y2)), mBlockSize(blockSize)
+{
+	SYS_ASSERT(blockSize > 0);
+
+	double map_w = fabs(x2 - x1);
+	double map_h = fabs(y2 - y1);
+
+	for (;;)
+	{
+		mWidth  = (int)(map_w / mBlockSize) + 1;
+		mHeight = (int)(map_h / mBlockSize) + 1;
+
+		if ((double)mWidth * mHeight <= MAX_BLOCKS)
+			break;
+
+		mBlockSize *= 2;
+	}
+
+	mBlocks.resize(mWidth * mHeight);
+}
+
+
+int BlockGrid::blockX(double x) const
+{
+	int bx = (int)floor((x - mOriginX) / mBlockSize);
+
+	return std::max(0, std::min(mWidth - 1, bx));
+}
+
+
+int BlockGrid::blockY(double y) const
+{
+	int by = (int)floor((y - mOriginY) / mBlockSize);
+
+	return std::max(0, std::min(mHeight - 1, by));
+}
+
+
+void BlockGrid::insertPoint(int index, double x, double y)
+{
+	mBlocks[blockY(y) * mWidth + blockX(x)].push_back(index);
+}
+
+
+void BlockGrid::insertBox(int index, double x1, double y1, double x2, double y2)
+{
+	int bx1 = blockX(std::min(x1, x2));
+	int by1 = blockY(std::min(y1, y2));
+	int bx2 = blockX(std::max(x1, x2));
+	int by2 = blockY(std::max(y1, y2));
+
+	if (bx1 != bx2 || by1 != by2)
+		mHasBoxes = true;
+
+	for (int by = by1 ; by <= by2 ; by++)
+	for (int bx = bx1 ; bx <= bx2 ; bx++)
+		mBlocks[by * mWidth + bx].push_back(index);
+}
+
+
+void BlockGrid::query(double x1, double y1, double x2, double y2, std::vector<int> &result) const
+{
+	size_t first = result.size();
+
+	int bx1 = blockX(std::min(x1, x2));
+	int by1 = blockY(std::min(y1, y2));
+	int bx2 = blockX(std::max(x1, x2));
+	int by2 = blockY(std::max(y1, y2));
+
+	for (int by = by1 ; by <= by2 ; by++)
+	for (int bx = bx1 ; bx <= bx2 ; bx++)
+	{
+		const std::vector<int> &block = mBlocks[by * mWidth + bx];
+
+		result.insert(result.end(), block.begin(), block.end());
+	}
+
+	std::sort(result.begin() + first, result.end());
+
+	// an object spanning several blocks will have been added once per block
+	if (mHasBoxes)
+		result.erase(std::unique(result.begin() + first, result.end()), result.end());
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
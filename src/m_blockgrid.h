@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------
+//  BLOCK GRID
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_M_BLOCKGRID_H__
+#define __EUREKA_M_BLOCKGRID_H__
+
+#include <vector>
+
+//
+// A uniform grid of buckets over a map area, similar to the DOOM
+// blockmap. Objects are stored by index, either at a point or over
+// a bounding box, and can then be looked up by area so only nearby
+// objects need to be tested.
+//
+// Coordinates outside of the grid's bounds are clamped to the edge
+// blocks, so objects never get lost (just less well sorted).
+//
+class BlockGrid
+{
+public:
+	BlockGrid(double x1, double y1, double x2, double y2, int blockSize = 128);
+
+	int width() const
+	{
+		return mWidth;
+	}
+	int height() const
+	{
+		return mHeight;
+	}
+	int blockSize() const
+	{
+		return mBlockSize;
+	}
+
+	// the block containing a coordinate (clamped to the grid)
+	int blockX(double x) const;
+	int blockY(double y) const;
+
+	// map coordinates of a block's lower left corner
+	double blockLeft(int bx) const
+	{
+		return mOriginX + (double)bx * mBlockSize;
+	}
+	double blockBottom(int by) const
+	{
+		return mOriginY + (double)by * mBlockSize;
+	}
+
+	// the objects in a single block
+	const std::vector<int> &block(int bx, int by) const
+	{
+		return mBlocks[by * mWidth + bx];
+	}
+
+	void insertPoint(int index, double x, double y);
+	void insertBox(int index, double x1, double y1, double x2, double y2);
+
+	// appends the objects which may touch the given box, each object at
+	// most once, in increasing index order.
+	void query(double x1, double y1, double x2, double y2, std::vector<int> &result) const;
+
+private:
+	double mOriginX;
+	double mOriginY;
+
+	int mBlockSize;
+	int mWidth;
+	int mHeight;
+
+	// whether any object covers more than one block
+	bool mHasBoxes = false;
+
+	std::vector<std::vector<int>> mBlocks;
+};
+
+#endif  /* __EUREKA_M_BLOCKGRID_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
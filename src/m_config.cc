@@ -27,6 +27,7 @@
 #include "Instance.h"
 
 #include "lib_adler.h"
+#include "m_batch.h"
 #include "m_config.h"
 #include "m_parse.h"
 #include "m_streams.h"
@@ -218,6 +219,42 @@ static const opt_desc_t options[] =
 		&gInstance.loaded.levelName	// TODO: this will need to work only for first instance
 	},
 
+	{	"batch",
+		0,
+		OptType::boolean,
+		0,
+		"Process the wad without a window, then exit",
+		NULL,
+		&global::batch_mode
+	},
+
+	{	"nodes",
+		0,
+		OptType::boolean,
+		0,
+		"Batch mode: build the nodes of every level",
+		NULL,
+		&global::batch_nodes
+	},
+
+	{	"check",
+		0,
+		OptType::string,
+		0,
+		"Batch mode: run the map checks (all or major)",
+		"<what>",
+		&global::batch_check
+	},
+
+	{	"report",
+		0,
+		OptType::string,
+		OptFlag_helpNewline,
+		"Batch mode: write the results to a file",
+		"<file>",
+		&global::batch_report
+	},
+
 	{	"udmftest",
 		0,
         OptType::boolean,
@@ -571,6 +608,24 @@ static const opt_desc_t options[] =
 		&config::highlight_line_info
 	},
 
+	{	"image_cache_mb",
+		0,
+        OptType::integer,
+		OptFlag_preference,
+		"Memory kept for decoded textures and flats (in MB)",
+		NULL,
+		&config::image_cache_mb
+	},
+
+	{	"image_disk_cache_mb",
+		0,
+        OptType::integer,
+		OptFlag_preference,
+		"Disk space kept for decoded textures between runs (in MB, 0 = off)",
+		NULL,
+		&config::image_disk_cache_mb
+	},
+
 	{	"leave_offsets_alone",
 		0,
         OptType::boolean,
@@ -607,6 +662,15 @@ static const opt_desc_t options[] =
 		&config::light_bump_large
 	},
 
+	{	"live_map_checks",
+		0,
+        OptType::boolean,
+		OptFlag_preference,
+		"Check the map for problems in the background while editing",
+		NULL,
+		&config::live_map_checks
+	},
+
 	{	"map_scroll_bars",
 		0,
         OptType::boolean,
@@ -40,6 +40,7 @@ extern bool auto_load_recent;
 extern bool begin_maximized;
 
 extern bool map_scroll_bars;
+extern bool live_map_checks;
 
 extern bool leave_offsets_alone;
 extern bool same_mode_clears_selection;
@@ -87,6 +88,9 @@ extern int backup_max_space;
 extern bool browser_small_tex;
 extern bool browser_combine_tex;
 
+extern int image_cache_mb;
+extern int image_disk_cache_mb;
+
 extern int floor_bump_small;
 extern int floor_bump_medium;
 extern int floor_bump_large;
@@ -130,6 +130,8 @@ void Instance::FreshLevel()
 	ZoomWholeMap();
 
 	Editor_DefaultState();
+
+	level.checks.liveRecheckAll();
 }
 
 
@@ -1001,6 +1003,8 @@ void Instance::LoadLevelNum(Wad_file *wad, int lev_num)
 	Subdiv_InvalidateAll();
 
 	MadeChanges = false;
+
+	level.checks.liveRecheckAll();
 }
 
 
@@ -1332,6 +1336,7 @@ void Instance::SaveScripts()
 void Instance::SaveVertices()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("VERTEXES");
+	lump->reserve((int)(level.vertices.size() * sizeof(raw_vertex_t)));
 
 	for (const Vertex *vert : level.vertices)
 	{
@@ -1348,6 +1353,7 @@ void Instance::SaveVertices()
 void Instance::SaveSectors()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("SECTORS");
+	lump->reserve((int)(level.sectors.size() * sizeof(raw_sector_t)));
 
 	for (const Sector *sec : level.sectors)
 	{
@@ -1371,6 +1377,7 @@ void Instance::SaveSectors()
 void Instance::SaveThings()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("THINGS");
+	lump->reserve((int)(level.things.size() * sizeof(raw_thing_t)));
 
 	for (const Thing *th : level.things)
 	{
@@ -1392,6 +1399,7 @@ void Instance::SaveThings()
 void Instance::SaveThings_Hexen()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("THINGS");
+	lump->reserve((int)(level.things.size() * sizeof(raw_hexen_thing_t)));
 
 	for (const Thing *th : level.things)
 	{
@@ -1422,6 +1430,7 @@ void Instance::SaveThings_Hexen()
 void Instance::SaveSideDefs()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("SIDEDEFS");
+	lump->reserve((int)(level.sidedefs.size() * sizeof(raw_sidedef_t)));
 
 	for (const SideDef *side : level.sidedefs)
 	{
@@ -1444,6 +1453,7 @@ void Instance::SaveSideDefs()
 void Instance::SaveLineDefs()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("LINEDEFS");
+	lump->reserve((int)(level.linedefs.size() * sizeof(raw_linedef_t)));
 
 	for (const LineDef *ld : level.linedefs)
 	{
@@ -1468,6 +1478,7 @@ void Instance::SaveLineDefs()
 void Instance::SaveLineDefs_Hexen()
 {
 	Lump_c *lump = wad.master.edit_wad->AddLump("LINEDEFS");
+	lump->reserve((int)(level.linedefs.size() * sizeof(raw_hexen_linedef_t)));
 
 	for (const LineDef *ld : level.linedefs)
 	{
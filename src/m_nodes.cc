@@ -395,6 +395,29 @@ void Instance::BuildNodesAfterSave(int lev_idx)
 }
 
 
+//
+// Builds the nodes of the given level without any GUI, for the batch
+// mode. The level must already be loaded.
+//
+build_result_e Instance::BuildNodesBatch(int lev_idx, int *warnings)
+{
+	nodebuildinfo_t info;
+
+	PrepareInfo(&info);
+
+	nodeialog = NULL;
+	nb_info = &info;
+
+	build_result_e ret = AJBSP_BuildLevel(&info, lev_idx, *this);
+
+	nb_info = NULL;
+
+	*warnings = info.total_warnings;
+
+	return ret;
+}
+
+
 void Instance::CMD_BuildAllNodes()
 {
 	if (!wad.master.edit_wad)
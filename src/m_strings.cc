@@ -23,6 +23,7 @@
 #include "sys_debug.h"
 #include <assert.h>
 #include <stdarg.h>
+#include <mutex>
 #ifdef _WIN32
 #include <Windows.h>
 #endif
@@ -397,6 +398,7 @@ size_t SString::findDigit() const
 //
 int StringTable::add(const SString &text)
 {
+	std::unique_lock<std::shared_mutex> lock(mMutex);
 	int index = 0;
 	for(const SString &string : mStrings)
 	{
@@ -413,6 +415,8 @@ int StringTable::add(const SString &text)
 //
 SString StringTable::get(int offset) const
 {
+	std::shared_lock<std::shared_mutex> lock(mMutex);
+
 	// this should never happen
 	// [ but handle it gracefully, for the sake of robustness ]
 	if(offset < 0 || offset >= (int)mStrings.size())
@@ -26,6 +26,7 @@
 #include <string.h>
 
 #include <ostream>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 
@@ -423,7 +424,8 @@ inline static long strtol(const SString &string, char **endptr, int radix)
 }
 
 //
-// String storage table
+// String storage table. Safe to read from other threads (e.g. the live
+// map checks) while strings get added.
 //
 class StringTable
 {
@@ -433,6 +435,7 @@ public:
 private:
 	// Must start with an empty string, so get(0) gets "".
 	std::vector<SString> mStrings = { "" };	
+	mutable std::shared_mutex mMutex;
 };
 
 #ifdef _WIN32
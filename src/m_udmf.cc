@@ -23,6 +23,7 @@
 
 #include "LineDef.h"
 #include "m_game.h"
+#include "m_udmf.h"
 #include "Sector.h"
 #include "SideDef.h"
 #include "Thing.h"
@@ -33,292 +34,132 @@
 
 #include "ui_window.h"
 
-class Udmf_Token
-{
-private:
-	// empty means EOF
-	SString text;
-
-	Instance &inst;
-
-public:
-	Udmf_Token(Instance &inst, const char *str) : text(str), inst(inst)
-	{ }
-
-	Udmf_Token(Instance &inst, const char *str, int len) : text(str, len), inst(inst)
-	{ }
-
-	const char *c_str()
-	{
-		return text.c_str();
-	}
-
-	bool IsEOF() const
-	{
-		return text.empty();
-	}
-
-	bool IsIdentifier() const
-	{
-		if (text.size() == 0)
-			return false;
+#include <string_view>
 
-		char ch = text[0];
 
-		return isalpha(ch) || ch == '_';
-	}
+//
+// texture names are strings, only the first 8 characters are kept
+//
+static int UDMF_DecodeTexture(const Udmf_Token &value)
+{
+	SString buffer;
 
-	bool IsString() const
+	if (! value.IsString())
 	{
-		return text.size() > 0 && text[0] == '"';
+		// TODO warning
+		buffer = "-";
 	}
-
-	bool Match(const char *name) const
+	else
 	{
-		return y_stricmp(text.c_str(), name) == 0;
-	}
+		int use_len = 8;
 
-	int DecodeInt() const
-	{
-		return atoi(text);
+		if (value.Length() < 10)
+			use_len = std::max(value.Length() - 2, 0);
+		buffer = SString(value.View().data() + 1, use_len);
 	}
 
-	double DecodeFloat() const
-	{
-		return atof(text);
-	}
+	return BA_InternaliseString(NormalizeTex(buffer));
+}
 
-	SString DecodeString() const
-	{
-		if (! IsString() || text.size() < 2)
-		{
-			// TODO warning
-			return SString();
-		}
 
-		SString string = text;
-		string.erase(0, 1);
-		string.pop_back();
-		return string;
-	}
+//
+// Known UDMF field names. Matching happens once per field, by length
+// first, instead of comparing against every name in turn.
+//
+enum class UdmfField : byte
+{
+	unknown,
 
-	FFixedPoint DecodeCoord() const
-	{
-		return MakeValidCoord(inst.loaded.levelFormat, DecodeFloat());
-	}
+	x, y, height, type, angle, id, special,
+	arg0, arg1, arg2, arg3, arg4,
+	skill2, skill3, skill4, ambush, friend_, single, coop, dm,
 
-	int DecodeTexture() const
-	{
-		SString buffer;
+	v1, v2, sidefront, sideback,
+	blocking, blockmonsters, twosided, dontpegtop, dontpegbottom,
+	secret, blocksound, dontdraw, mapped, passuse,
 
-		if (! IsString())
-		{
-			// TODO warning
-			buffer = "-";
-		}
-		else
-		{
-			int use_len = 8;
-
-			if (text.size() < 10)
-				use_len = (int)text.size() - 2;
-			buffer = text;
-			buffer.erase(0, 1);
-			buffer.erase(use_len, SString::npos);
-		}
+	sector, texturetop, texturebottom, texturemiddle, offsetx, offsety,
 
-		return BA_InternaliseString(NormalizeTex(buffer));
-	}
+	heightfloor, heightceiling, texturefloor, textureceiling, lightlevel
 };
 
-
-// since UDMF lumps can be very large, we read chunks of it
-// as-needed instead of loading the whole thing into memory.
-// the buffer size should be over 2x maximum token length.
-#define U_BUF_SIZE  16384
-
-class Udmf_Parser
+static UdmfField UDMF_LookupField(const Udmf_Token &field)
 {
-private:
-	Lump_c *lump;
-
-	// reached EOF or a file read error
-	bool done = false;
-
-	// we have seen a "/*" but not the closing "*/"
-	bool in_comment = false;
-
-	// number of remaining bytes
-	int remaining;
-
-	// read buffer
-	char buffer[U_BUF_SIZE];
-
-	// position in buffer and used size of buffer
-	int b_pos = 0;
-	int b_size = 0;
-
-	Instance &inst;
-
-public:
-	Udmf_Parser(Instance &inst, Lump_c *_lump) : lump(_lump), inst(inst)
-	{
-		remaining = lump->Length();
-	}
-
-	Udmf_Token Next()
-	{
-		for (;;)
-		{
-			if (done)
-				return Udmf_Token(inst, "");
-
-			// when position reaches half-way point, shift buffer down
-			if (b_pos >= U_BUF_SIZE/2)
-			{
-				memmove(buffer, buffer + U_BUF_SIZE/2, U_BUF_SIZE/2);
-
-				b_pos  -= U_BUF_SIZE/2;
-				b_size -= U_BUF_SIZE/2;
-			}
-
-			// top up the buffer
-			if (remaining > 0 && b_size < U_BUF_SIZE)
-			{
-				int want = U_BUF_SIZE - b_size;
-				if (want > remaining)
-					want = remaining;
-
-				if (! lump->Read(buffer + b_size, want))
-				{
-					// TODO mark error somewhere, show dialog later
-					done = true;
-					continue;
-				}
-
-				remaining -= want;
-				b_size    += want;
-			}
-
-			// end of file?
-			if (remaining <= 0 && b_pos >= b_size)
-			{
-				done = true;
-				continue;
-			}
-
-			if (in_comment)
-			{
-				// end of multi-line comment?
-				if (b_pos+2 <= b_size &&
-					buffer[b_pos] == '*' &&
-					buffer[b_pos+1] == '/')
-				{
-					in_comment = false;
-					b_pos += 2;
-					continue;
-				}
-
-				b_pos++;
-				continue;
-			}
-
-			// check for multi-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '*')
-			{
-				in_comment = true;
-				b_pos += 2;
-				continue;
-			}
-
-			// check for single-line comment
-			if (b_pos+2 <= b_size &&
-				buffer[b_pos] == '/' &&
-				buffer[b_pos+1] == '/')
-			{
-				SkipToEOLN();
-				continue;
-			}
-
-			// skip whitespace (assumes ASCII)
-			int start = b_pos;
-			unsigned char ch = buffer[b_pos];
-
-			if ((ch <= 32) || (ch >= 127 && ch <= 160))
-			{
-				b_pos++;
-				continue;
-			}
-
-			// an actual token, yay!
-
-			// is it a string?
-			if (ch == '"')
-			{
-				b_pos++;
-
-				while (b_pos < b_size)
-				{
-					// skip escapes
-					if (buffer[b_pos] == '\\' && b_pos+1 < b_size)
-					{
-						b_pos += 2;
-						continue;
-					}
-
-					if (buffer[b_pos] == '"')
-					{
-						// include trailing double quote
-						b_pos++;
-						break;
-					}
-
-					b_pos++;
-				}
-
-				return Udmf_Token(inst, buffer+start, b_pos - start);
-			}
-
-			// is it a identifier or number?
-			if (isalnum(ch) || ch == '_' || ch == '-' || ch == '+')
-			{
-				b_pos++;
-
-				while (b_pos < b_size)
-				{
-					char ch = buffer[b_pos];
-					if (isalnum(ch) || ch == '_' || ch == '-' || ch == '+' || ch == '.')
-					{
-						b_pos++;
-						continue;
-					}
-					break;
-				}
-
-				return Udmf_Token(inst, buffer+start, b_pos - start);
-			}
-
-			// it must be a symbol, such as '{' or '}'
-			b_pos++;
-
-			return Udmf_Token(inst, buffer+start, 1);
-		}
+	// UDMF keys are case-insensitive
+	char name[16];
+	int len = field.Length();
+
+	if (len >= (int)sizeof(name))
+		return UdmfField::unknown;
+
+	for (int i = 0 ; i < len ; i++)
+		name[i] = static_cast<char>(tolower((unsigned char)field.View()[i]));
+
+	std::string_view key(name, len);
+
+	struct Entry
+	{
+		std::string_view name;
+		UdmfField field;
+	};
+
+	auto find = [&key](std::initializer_list<Entry> entries)
+	{
+		for (const Entry &entry : entries)
+			if (entry.name == key)
+				return entry.field;
+		return UdmfField::unknown;
+	};
+
+	switch (len)
+	{
+	case 1:
+		return find({ { "x", UdmfField::x }, { "y", UdmfField::y } });
+	case 2:
+		return find({ { "id", UdmfField::id }, { "dm", UdmfField::dm },
+					  { "v1", UdmfField::v1 }, { "v2", UdmfField::v2 } });
+	case 4:
+		return find({ { "type", UdmfField::type }, { "arg0", UdmfField::arg0 },
+					  { "arg1", UdmfField::arg1 }, { "arg2", UdmfField::arg2 },
+					  { "arg3", UdmfField::arg3 }, { "arg4", UdmfField::arg4 },
+					  { "coop", UdmfField::coop } });
+	case 5:
+		return find({ { "angle", UdmfField::angle } });
+	case 6:
+		return find({ { "height", UdmfField::height }, { "skill2", UdmfField::skill2 },
+					  { "skill3", UdmfField::skill3 }, { "skill4", UdmfField::skill4 },
+					  { "ambush", UdmfField::ambush }, { "friend", UdmfField::friend_ },
+					  { "single", UdmfField::single }, { "secret", UdmfField::secret },
+					  { "mapped", UdmfField::mapped }, { "sector", UdmfField::sector } });
+	case 7:
+		return find({ { "special", UdmfField::special }, { "passuse", UdmfField::passuse },
+					  { "offsetx", UdmfField::offsetx }, { "offsety", UdmfField::offsety } });
+	case 8:
+		return find({ { "sideback", UdmfField::sideback }, { "blocking", UdmfField::blocking },
+					  { "twosided", UdmfField::twosided }, { "dontdraw", UdmfField::dontdraw } });
+	case 9:
+		return find({ { "sidefront", UdmfField::sidefront } });
+	case 10:
+		return find({ { "dontpegtop", UdmfField::dontpegtop },
+					  { "blocksound", UdmfField::blocksound },
+					  { "texturetop", UdmfField::texturetop },
+					  { "lightlevel", UdmfField::lightlevel } });
+	case 11:
+		return find({ { "heightfloor", UdmfField::heightfloor } });
+	case 12:
+		return find({ { "texturefloor", UdmfField::texturefloor } });
+	case 13:
+		return find({ { "blockmonsters", UdmfField::blockmonsters },
+					  { "dontpegbottom", UdmfField::dontpegbottom },
+					  { "texturebottom", UdmfField::texturebottom },
+					  { "texturemiddle", UdmfField::texturemiddle },
+					  { "heightceiling", UdmfField::heightceiling } });
+	case 14:
+		return find({ { "textureceiling", UdmfField::textureceiling } });
+	default:
+		return UdmfField::unknown;
 	}
-
-	bool Expect(const char *name)
-	{
-		Udmf_Token tok = Next();
-		return tok.Match(name);
-	}
-
-	void SkipToEOLN()
-	{
-		while (b_pos < b_size && buffer[b_pos] != '\n')
-			b_pos++;
-	}
-};
+}
 
 
 static void UDMF_ParseGlobalVar(Instance &inst, Udmf_Parser& parser, Udmf_Token& name)
@@ -349,7 +190,7 @@ static void UDMF_ParseGlobalVar(Instance &inst, Udmf_Parser& parser, Udmf_Token&
 	}
 	else
 	{
-		gLog.printf("skipping unknown global '%s' in UDMF\n", name.c_str());
+		gLog.printf("skipping unknown global '%.*s' in UDMF\n", name.Length(), name.View().data());
 	}
 }
 
@@ -364,64 +205,47 @@ static void UDMF_ParseThingField(const Document &doc, Thing *T, Udmf_Token& fiel
 
 	// TODO strife options
 
-	if (field.Match("x"))
-		T->raw_x = value.DecodeCoord();
-	else if (field.Match("y"))
-		T->raw_y = value.DecodeCoord();
-	else if (field.Match("height"))
-		T->raw_h = value.DecodeCoord();
-	else if (field.Match("type"))
-		T->type = value.DecodeInt();
-	else if (field.Match("angle"))
-		T->angle = value.DecodeInt();
-
-	else if (field.Match("id"))
-		T->tid = value.DecodeInt();
-	else if (field.Match("special"))
-		T->special = value.DecodeInt();
-	else if (field.Match("arg0"))
-		T->arg1 = value.DecodeInt();
-	else if (field.Match("arg1"))
-		T->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		T->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		T->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		T->arg5 = value.DecodeInt();
-
-	else if (field.Match("skill2"))
-		T->options |= MTF_Easy;
-	else if (field.Match("skill3"))
-		T->options |= MTF_Medium;
-	else if (field.Match("skill4"))
-		T->options |= MTF_Hard;
-	else if (field.Match("ambush"))
-		T->options |= MTF_Ambush;
-	else if (field.Match("friend"))
-		T->options |= MTF_Friend;
-	else if (field.Match("single"))
-		T->options &= ~MTF_Not_SP;
-	else if (field.Match("coop"))
-		T->options &= ~MTF_Not_COOP;
-	else if (field.Match("dm"))
-		T->options &= ~MTF_Not_DM;
-
-	else
-	{
-		gLog.debugPrintf("thing #%d: unknown field '%s'\n", doc.numThings()-1, field.c_str());
+	switch (UDMF_LookupField(field))
+	{
+	case UdmfField::x:       T->raw_x = value.DecodeCoord(); break;
+	case UdmfField::y:       T->raw_y = value.DecodeCoord(); break;
+	case UdmfField::height:  T->raw_h = value.DecodeCoord(); break;
+	case UdmfField::type:    T->type = value.DecodeInt(); break;
+	case UdmfField::angle:   T->angle = value.DecodeInt(); break;
+
+	case UdmfField::id:      T->tid = value.DecodeInt(); break;
+	case UdmfField::special: T->special = value.DecodeInt(); break;
+	case UdmfField::arg0:    T->arg1 = value.DecodeInt(); break;
+	case UdmfField::arg1:    T->arg2 = value.DecodeInt(); break;
+	case UdmfField::arg2:    T->arg3 = value.DecodeInt(); break;
+	case UdmfField::arg3:    T->arg4 = value.DecodeInt(); break;
+	case UdmfField::arg4:    T->arg5 = value.DecodeInt(); break;
+
+	case UdmfField::skill2:  T->options |= MTF_Easy; break;
+	case UdmfField::skill3:  T->options |= MTF_Medium; break;
+	case UdmfField::skill4:  T->options |= MTF_Hard; break;
+	case UdmfField::ambush:  T->options |= MTF_Ambush; break;
+	case UdmfField::friend_: T->options |= MTF_Friend; break;
+	case UdmfField::single:  T->options &= ~MTF_Not_SP; break;
+	case UdmfField::coop:    T->options &= ~MTF_Not_COOP; break;
+	case UdmfField::dm:      T->options &= ~MTF_Not_DM; break;
+
+	default:
+		gLog.debugPrintf("thing #%d: unknown field '%.*s'\n", doc.numThings()-1, field.Length(), field.View().data());
+		break;
 	}
 }
 
 static void UDMF_ParseVertexField(const Document &doc, Vertex *V, Udmf_Token& field, Udmf_Token& value)
 {
-	if (field.Match("x"))
-		V->raw_x = value.DecodeCoord();
-	else if (field.Match("y"))
-		V->raw_y = value.DecodeCoord();
-	else
+	switch (UDMF_LookupField(field))
 	{
-		gLog.debugPrintf("vertex #%d: unknown field '%s'\n", doc.numVertices()-1, field.c_str());
+	case UdmfField::x: V->raw_x = value.DecodeCoord(); break;
+	case UdmfField::y: V->raw_y = value.DecodeCoord(); break;
+
+	default:
+		gLog.debugPrintf("vertex #%d: unknown field '%.*s'\n", doc.numVertices()-1, field.Length(), field.View().data());
+		break;
 	}
 }
 
@@ -437,53 +261,35 @@ static void UDMF_ParseLinedefField(const Document &doc, LineDef *LD, Udmf_Token&
 
 	// TODO strife flags
 
-	if (field.Match("v1"))
-		LD->start = value.DecodeInt();
-	else if (field.Match("v2"))
-		LD->end = value.DecodeInt();
-	else if (field.Match("sidefront"))
-		LD->right = value.DecodeInt();
-	else if (field.Match("sideback"))
-		LD->left = value.DecodeInt();
-	else if (field.Match("special"))
-		LD->type = value.DecodeInt();
-
-	else if (field.Match("arg0"))
-		LD->tag = value.DecodeInt();
-	else if (field.Match("arg1"))
-		LD->arg2 = value.DecodeInt();
-	else if (field.Match("arg2"))
-		LD->arg3 = value.DecodeInt();
-	else if (field.Match("arg3"))
-		LD->arg4 = value.DecodeInt();
-	else if (field.Match("arg4"))
-		LD->arg5 = value.DecodeInt();
-
-	else if (field.Match("blocking"))
-		LD->flags |= MLF_Blocking;
-	else if (field.Match("blockmonsters"))
-		LD->flags |= MLF_BlockMonsters;
-	else if (field.Match("twosided"))
-		LD->flags |= MLF_TwoSided;
-	else if (field.Match("dontpegtop"))
-		LD->flags |= MLF_UpperUnpegged;
-	else if (field.Match("dontpegbottom"))
-		LD->flags |= MLF_LowerUnpegged;
-	else if (field.Match("secret"))
-		LD->flags |= MLF_Secret;
-	else if (field.Match("blocksound"))
-		LD->flags |= MLF_SoundBlock;
-	else if (field.Match("dontdraw"))
-		LD->flags |= MLF_DontDraw;
-	else if (field.Match("mapped"))
-		LD->flags |= MLF_Mapped;
-
-	else if (field.Match("passuse"))
-		LD->flags |= MLF_Boom_PassThru;
-
-	else
+	switch (UDMF_LookupField(field))
 	{
-		gLog.debugPrintf("linedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfField::v1:        LD->start = value.DecodeInt(); break;
+	case UdmfField::v2:        LD->end = value.DecodeInt(); break;
+	case UdmfField::sidefront: LD->right = value.DecodeInt(); break;
+	case UdmfField::sideback:  LD->left = value.DecodeInt(); break;
+	case UdmfField::special:   LD->type = value.DecodeInt(); break;
+
+	case UdmfField::arg0: LD->tag = value.DecodeInt(); break;
+	case UdmfField::arg1: LD->arg2 = value.DecodeInt(); break;
+	case UdmfField::arg2: LD->arg3 = value.DecodeInt(); break;
+	case UdmfField::arg3: LD->arg4 = value.DecodeInt(); break;
+	case UdmfField::arg4: LD->arg5 = value.DecodeInt(); break;
+
+	case UdmfField::blocking:      LD->flags |= MLF_Blocking; break;
+	case UdmfField::blockmonsters: LD->flags |= MLF_BlockMonsters; break;
+	case UdmfField::twosided:      LD->flags |= MLF_TwoSided; break;
+	case UdmfField::dontpegtop:    LD->flags |= MLF_UpperUnpegged; break;
+	case UdmfField::dontpegbottom: LD->flags |= MLF_LowerUnpegged; break;
+	case UdmfField::secret:        LD->flags |= MLF_Secret; break;
+	case UdmfField::blocksound:    LD->flags |= MLF_SoundBlock; break;
+	case UdmfField::dontdraw:      LD->flags |= MLF_DontDraw; break;
+	case UdmfField::mapped:        LD->flags |= MLF_Mapped; break;
+
+	case UdmfField::passuse: LD->flags |= MLF_Boom_PassThru; break;
+
+	default:
+		gLog.debugPrintf("linedef #%d: unknown field '%.*s'\n", doc.numVertices() -1, field.Length(), field.View().data());
+		break;
 	}
 }
 
@@ -493,43 +299,36 @@ static void UDMF_ParseSidedefField(const Document &doc, SideDef *SD, Udmf_Token&
 
 	// TODO: consider how to handle "offsetx_top" (etc), if at all
 
-	if (field.Match("sector"))
-		SD->sector = value.DecodeInt();
-	else if (field.Match("texturetop"))
-		SD->upper_tex = value.DecodeTexture();
-	else if (field.Match("texturebottom"))
-		SD->lower_tex = value.DecodeTexture();
-	else if (field.Match("texturemiddle"))
-		SD->mid_tex = value.DecodeTexture();
-	else if (field.Match("offsetx"))
-		SD->x_offset = value.DecodeInt();
-	else if (field.Match("offsety"))
-		SD->y_offset = value.DecodeInt();
-	else
+	switch (UDMF_LookupField(field))
 	{
-		gLog.debugPrintf("sidedef #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfField::sector:        SD->sector = value.DecodeInt(); break;
+	case UdmfField::texturetop:    SD->upper_tex = UDMF_DecodeTexture(value); break;
+	case UdmfField::texturebottom: SD->lower_tex = UDMF_DecodeTexture(value); break;
+	case UdmfField::texturemiddle: SD->mid_tex = UDMF_DecodeTexture(value); break;
+	case UdmfField::offsetx:       SD->x_offset = value.DecodeInt(); break;
+	case UdmfField::offsety:       SD->y_offset = value.DecodeInt(); break;
+
+	default:
+		gLog.debugPrintf("sidedef #%d: unknown field '%.*s'\n", doc.numVertices() -1, field.Length(), field.View().data());
+		break;
 	}
 }
 
 static void UDMF_ParseSectorField(const Document &doc, Sector *S, Udmf_Token& field, Udmf_Token& value)
 {
-	if (field.Match("heightfloor"))
-		S->floorh = value.DecodeInt();
-	else if (field.Match("heightceiling"))
-		S->ceilh = value.DecodeInt();
-	else if (field.Match("texturefloor"))
-		S->floor_tex = value.DecodeTexture();
-	else if (field.Match("textureceiling"))
-		S->ceil_tex = value.DecodeTexture();
-	else if (field.Match("lightlevel"))
-		S->light = value.DecodeInt();
-	else if (field.Match("special"))
-		S->type = value.DecodeInt();
-	else if (field.Match("id"))
-		S->tag = value.DecodeInt();
-	else
+	switch (UDMF_LookupField(field))
 	{
-		gLog.debugPrintf("sector #%d: unknown field '%s'\n", doc.numVertices() -1, field.c_str());
+	case UdmfField::heightfloor:    S->floorh = value.DecodeInt(); break;
+	case UdmfField::heightceiling:  S->ceilh = value.DecodeInt(); break;
+	case UdmfField::texturefloor:   S->floor_tex = UDMF_DecodeTexture(value); break;
+	case UdmfField::textureceiling: S->ceil_tex = UDMF_DecodeTexture(value); break;
+	case UdmfField::lightlevel:     S->light = value.DecodeInt(); break;
+	case UdmfField::special:        S->type = value.DecodeInt(); break;
+	case UdmfField::id:             S->tag = value.DecodeInt(); break;
+
+	default:
+		gLog.debugPrintf("sector #%d: unknown field '%.*s'\n", doc.numVertices() -1, field.Length(), field.View().data());
+		break;
 	}
 }
 
@@ -583,7 +382,7 @@ static void UDMF_ParseObject(Document &doc, Udmf_Parser& parser, Udmf_Token& nam
 	if (!kind.valid())
 	{
 		// unknown object kind
-		gLog.printf("skipping unknown block '%s' in UDMF\n", name.c_str());
+		gLog.printf("skipping unknown block '%.*s' in UDMF\n", name.Length(), name.View().data());
 	}
 
 	for (;;)
@@ -655,8 +454,7 @@ void Instance::UDMF_LoadLevel(const Wad_file *load_wad)
 	if (! lump)
 		return;
 
-	// TODO: reduce stack!!
-	Udmf_Parser parser(*this, lump);
+	Udmf_Parser parser(static_cast<const char *>(lump->getData()), lump->Length());
 
 	for (;;)
 	{
@@ -698,52 +496,44 @@ void Instance::UDMF_LoadLevel(const Wad_file *load_wad)
 
 //----------------------------------------------------------------------
 
-static inline void WrFlag(Lump_c *lump, int flags, const char *name, int mask)
-{
-	if ((flags & mask) != 0)
-	{
-		lump->Printf("%s = true;\n", name);
-	}
-}
-
-static void UDMF_WriteInfo(const Instance &inst, Lump_c *lump)
+static void UDMF_WriteInfo(const Instance &inst, Udmf_Writer &out)
 {
-	lump->Printf("namespace = \"%s\";\n\n", inst.loaded.udmfNamespace.c_str());
+	out.Field("namespace", inst.loaded.udmfNamespace);
+	out.Raw("\n");
 }
 
-static void UDMF_WriteThings(const Instance &inst, Lump_c *lump)
+static void UDMF_WriteThings(const Instance &inst, Udmf_Writer &out)
 {
 	for (int i = 0 ; i < inst.level.numThings() ; i++)
 	{
-		lump->Printf("thing // %d\n", i);
-		lump->Printf("{\n");
+		out.Begin("thing", i);
 
 		const Thing *th = inst.level.things[i];
 
-		lump->Printf("x = %1.3f;\n", th->x());
-		lump->Printf("y = %1.3f;\n", th->y());
+		out.Field("x", th->raw_x);
+		out.Field("y", th->raw_y);
 
 		if (th->raw_h != FFixedPoint{})
-			lump->Printf("height = %1.3f;\n", th->h());
+			out.Field("height", th->raw_h);
 
-		lump->Printf("angle = %d;\n", th->angle);
-		lump->Printf("type = %d;\n", th->type);
+		out.Field("angle", th->angle);
+		out.Field("type", th->type);
 
 		// thing options
-		WrFlag(lump, th->options, "skill1", MTF_Easy);
-		WrFlag(lump, th->options, "skill2", MTF_Easy);
-		WrFlag(lump, th->options, "skill3", MTF_Medium);
-		WrFlag(lump, th->options, "skill4", MTF_Hard);
-		WrFlag(lump, th->options, "skill5", MTF_Hard);
+		out.Flag(th->options, "skill1", MTF_Easy);
+		out.Flag(th->options, "skill2", MTF_Easy);
+		out.Flag(th->options, "skill3", MTF_Medium);
+		out.Flag(th->options, "skill4", MTF_Hard);
+		out.Flag(th->options, "skill5", MTF_Hard);
 
-		WrFlag(lump, ~ th->options, "single", MTF_Not_SP);
-		WrFlag(lump, ~ th->options, "coop",   MTF_Not_COOP);
-		WrFlag(lump, ~ th->options, "dm",     MTF_Not_DM);
+		out.Flag(~ th->options, "single", MTF_Not_SP);
+		out.Flag(~ th->options, "coop",   MTF_Not_COOP);
+		out.Flag(~ th->options, "dm",     MTF_Not_DM);
 
-		WrFlag(lump, th->options, "ambush", MTF_Ambush);
+		out.Flag(th->options, "ambush", MTF_Ambush);
 
 		if (inst.conf.features.friend_flag)
-			WrFlag(lump, th->options, "friend", MTF_Friend);
+			out.Flag(th->options, "friend", MTF_Friend);
 
 		// TODO Hexen flags
 
@@ -751,73 +541,71 @@ static void UDMF_WriteThings(const Instance &inst, Lump_c *lump)
 
 		// TODO Hexen special and args
 
-		lump->Printf("}\n\n");
+		out.End();
 	}
 }
 
-static void UDMF_WriteVertices(const Document &doc, Lump_c *lump)
+static void UDMF_WriteVertices(const Document &doc, Udmf_Writer &out)
 {
 	for (int i = 0 ; i < doc.numVertices(); i++)
 	{
-		lump->Printf("vertex // %d\n", i);
-		lump->Printf("{\n");
+		out.Begin("vertex", i);
 
 		const Vertex *vert = doc.vertices[i];
 
-		lump->Printf("x = %1.3f;\n", vert->x());
-		lump->Printf("y = %1.3f;\n", vert->y());
+		out.Field("x", vert->raw_x);
+		out.Field("y", vert->raw_y);
 
-		lump->Printf("}\n\n");
+		out.End();
 	}
 }
 
-static void UDMF_WriteLineDefs(const Instance &inst, Lump_c *lump)
+static void UDMF_WriteLineDefs(const Instance &inst, Udmf_Writer &out)
 {
 	for (int i = 0 ; i < inst.level.numLinedefs(); i++)
 	{
-		lump->Printf("linedef // %d\n", i);
-		lump->Printf("{\n");
+		out.Begin("linedef", i);
 
 		const LineDef *ld = inst.level.linedefs[i];
 
-		lump->Printf("v1 = %d;\n", ld->start);
-		lump->Printf("v2 = %d;\n", ld->end);
+		out.Field("v1", ld->start);
+		out.Field("v2", ld->end);
 
 		if (ld->right >= 0)
-			lump->Printf("sidefront = %d;\n", ld->right);
+			out.Field("sidefront", ld->right);
 		if (ld->left >= 0)
-			lump->Printf("sideback = %d;\n", ld->left);
+			out.Field("sideback", ld->left);
 
 		if (ld->type != 0)
-			lump->Printf("special = %d;\n", ld->type);
+			out.Field("special", ld->type);
 
 		if (ld->tag != 0)
-			lump->Printf("arg0 = %d;\n", ld->tag);
+			out.Field("arg0", ld->tag);
 		if (ld->arg2 != 0)
-			lump->Printf("arg1 = %d;\n", ld->arg2);
+			out.Field("arg1", ld->arg2);
 		if (ld->arg3 != 0)
-			lump->Printf("arg2 = %d;\n", ld->arg3);
+			out.Field("arg2", ld->arg3);
 		if (ld->arg4 != 0)
-			lump->Printf("arg3 = %d;\n", ld->arg4);
+			out.Field("arg3", ld->arg4);
 		if (ld->arg5 != 0)
-			lump->Printf("arg4 = %d;\n", ld->arg5);
+			out.Field("arg4", ld->arg5);
 
 		// linedef flags
-		WrFlag(lump, ld->flags, "blocking",      MLF_Blocking);
-		WrFlag(lump, ld->flags, "blockmonsters", MLF_BlockMonsters);
-		WrFlag(lump, ld->flags, "twosided",      MLF_TwoSided);
-		WrFlag(lump, ld->flags, "dontpegtop",    MLF_UpperUnpegged);
-		WrFlag(lump, ld->flags, "dontpegbottom", MLF_LowerUnpegged);
-		WrFlag(lump, ld->flags, "secret",        MLF_Secret);
-		WrFlag(lump, ld->flags, "blocksound",    MLF_SoundBlock);
-		WrFlag(lump, ld->flags, "dontdraw",      MLF_DontDraw);
-		WrFlag(lump, ld->flags, "mapped",        MLF_Mapped);
+		out.Flag(ld->flags, "blocking",      MLF_Blocking);
+		out.Flag(ld->flags, "blockmonsters", MLF_BlockMonsters);
+		out.Flag(ld->flags, "twosided",      MLF_TwoSided);
+		out.Flag(ld->flags, "dontpegtop",    MLF_UpperUnpegged);
+		out.Flag(ld->flags, "dontpegbottom", MLF_LowerUnpegged);
+		out.Flag(ld->flags, "secret",        MLF_Secret);
+		out.Flag(ld->flags, "blocksound",    MLF_SoundBlock);
+		out.Flag(ld->flags, "dontdraw",      MLF_DontDraw);
+		out.Flag(ld->flags, "mapped",        MLF_Mapped);
 
 		if (inst.conf.features.pass_through)
-			WrFlag(lump, ld->flags, "passuse", MLF_Boom_PassThru);
+			out.Flag(ld->flags, "passuse", MLF_Boom_PassThru);
 
 		if (inst.conf.features.midtex_3d)
-			WrFlag(lump, ld->flags, "midtex3d", MLF_Eternity_3DMidTex);
+			out.Flag(ld->flags, "midtex3d", MLF_Eternity_3DMidTex);
 
 		// TODO : hexen stuff (SPAC flags, etc)
 
@@ -825,76 +613,82 @@ static void UDMF_WriteLineDefs(const Instance &inst, Lump_c *lump)
 
 		// TODO : zdoom stuff
 
-		lump->Printf("}\n\n");
+		out.End();
 	}
 }
 
-static void UDMF_WriteSideDefs(const Document &doc, Lump_c *lump)
+static void UDMF_WriteSideDefs(const Document &doc, Udmf_Writer &out)
 {
 	for (int i = 0 ; i < doc.numSidedefs(); i++)
 	{
-		lump->Printf("sidedef // %d\n", i);
-		lump->Printf("{\n");
+		out.Begin("sidedef", i);
 
 		const SideDef *side = doc.sidedefs[i];
 
-		lump->Printf("sector = %d;\n", side->sector);
+		out.Field("sector", side->sector);
 
 		if (side->x_offset != 0)
-			lump->Printf("offsetx = %d;\n", side->x_offset);
+			out.Field("offsetx", side->x_offset);
 		if (side->y_offset != 0)
-			lump->Printf("offsety = %d;\n", side->y_offset);
+			out.Field("offsety", side->y_offset);
 
 		// use NormalizeTex to ensure no double quote
 
 		if (side->UpperTex() != "-")
-			lump->Printf("texturetop = \"%s\";\n", NormalizeTex(side->UpperTex()).c_str());
+			out.Field("texturetop", NormalizeTex(side->UpperTex()));
 		if (side->LowerTex() != "-")
-			lump->Printf("texturebottom = \"%s\";\n", NormalizeTex(side->LowerTex()).c_str());
+			out.Field("texturebottom", NormalizeTex(side->LowerTex()));
 		if (side->MidTex() != "-")
-			lump->Printf("texturemiddle = \"%s\";\n", NormalizeTex(side->MidTex()).c_str());
+			out.Field("texturemiddle", NormalizeTex(side->MidTex()));
 
-		lump->Printf("}\n\n");
+		out.End();
 	}
 }
 
-static void UDMF_WriteSectors(const Document &doc, Lump_c *lump)
+static void UDMF_WriteSectors(const Document &doc, Udmf_Writer &out)
 {
 	for (int i = 0 ; i < doc.numSectors(); i++)
 	{
-		lump->Printf("sector // %d\n", i);
-		lump->Printf("{\n");
+		out.Begin("sector", i);
 
 		const Sector *sec = doc.sectors[i];
 
-		lump->Printf("heightfloor = %d;\n", sec->floorh);
-		lump->Printf("heightceiling = %d;\n", sec->ceilh);
+		out.Field("heightfloor", sec->floorh);
+		out.Field("heightceiling", sec->ceilh);
 
 		// use NormalizeTex to ensure no double quote
 
-		lump->Printf("texturefloor = \"%s\";\n", NormalizeTex(sec->FloorTex()).c_str());
-		lump->Printf("textureceiling = \"%s\";\n", NormalizeTex(sec->CeilTex()).c_str());
+		out.Field("texturefloor", NormalizeTex(sec->FloorTex()));
+		out.Field("textureceiling", NormalizeTex(sec->CeilTex()));
 
-		lump->Printf("lightlevel = %d;\n", sec->light);
+		out.Field("lightlevel", sec->light);
 		if (sec->type != 0)
-			lump->Printf("special = %d;\n", sec->type);
+			out.Field("special", sec->type);
 		if (sec->tag != 0)
-			lump->Printf("id = %d;\n", sec->tag);
+			out.Field("id", sec->tag);
 
-		lump->Printf("}\n\n");
+		out.End();
 	}
 }
 
 void Instance::UDMF_SaveLevel() const
 {
-	Lump_c *lump = wad.master.edit_wad->AddLump("TEXTMAP");
+	Udmf_Writer out;
+
+	// rough upper bounds of the text for each kind of object
+	out.Reserve(256 + 192 * (size_t)level.numThings() + 48 * (size_t)level.numVertices() +
+				224 * (size_t)level.numLinedefs() + 112 * (size_t)level.numSidedefs() +
+				192 * (size_t)level.numSectors());
 
-	UDMF_WriteInfo(*this, lump);
-	UDMF_WriteThings(*this, lump);
-	UDMF_WriteVertices(level, lump);
-	UDMF_WriteLineDefs(*this, lump);
-	UDMF_WriteSideDefs(level, lump);
-	UDMF_WriteSectors(level, lump);
+	UDMF_WriteInfo(*this, out);
+	UDMF_WriteThings(*this, out);
+	UDMF_WriteVertices(level, out);
+	UDMF_WriteLineDefs(*this, out);
+	UDMF_WriteSideDefs(level, out);
+	UDMF_WriteSectors(level, out);
+
+	Lump_c *lump = wad.master.edit_wad->AddLump("TEXTMAP");
+	lump->Write(out.Text().data(), (int)out.Text().size());
 
 	lump = wad.master.edit_wad->AddLump("ENDMAP");
 }
@@ -0,0 +1,384 @@
+//------------------------------------------------------------------------
+//  UDMF TOKENIZER / WRITER
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2019 Andrew Apted
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_M_UDMF_H__
+#define __EUREKA_M_UDMF_H__
+
+#include "FixedPoint.h"
+#include "m_strings.h"
+#include "sys_type.h"
+
+#include <charconv>
+#include <string.h>
+#include <string_view>
+#include <vector>
+
+class Udmf_Token
+{
+private:
+	// points straight into the lump data. empty means EOF
+	std::string_view text;
+
+public:
+	explicit Udmf_Token(std::string_view str) : text(str)
+	{ }
+
+	std::string_view View() const
+	{
+		return text;
+	}
+
+	int Length() const
+	{
+		return (int)text.size();
+	}
+
+	bool IsEOF() const
+	{
+		return text.empty();
+	}
+
+	bool IsIdentifier() const
+	{
+		if (text.size() == 0)
+			return false;
+
+		unsigned char ch = (unsigned char)text[0];
+
+		return isalpha(ch) || ch == '_';
+	}
+
+	bool IsString() const
+	{
+		return text.size() > 0 && text[0] == '"';
+	}
+
+	bool Match(const char *name) const
+	{
+		size_t len = strlen(name);
+
+		return text.size() == len && y_strnicmp(text.data(), name, len) == 0;
+	}
+
+	int DecodeInt() const
+	{
+		// same as atoi(), but the token is not NUL-terminated
+		const char *pos = text.data();
+		const char *end = pos + text.size();
+
+		if (pos < end && *pos == '+')
+			pos++;
+
+		int result = 0;
+		std::from_chars(pos, end, result);
+		return result;
+	}
+
+	double DecodeFloat() const
+	{
+		char buffer[64];
+
+		size_t len = std::min(text.size(), sizeof(buffer) - 1);
+		memcpy(buffer, text.data(), len);
+		buffer[len] = 0;
+
+		return atof(buffer);
+	}
+
+	SString DecodeString() const
+	{
+		if (! IsString() || text.size() < 2)
+		{
+			// TODO warning
+			return SString();
+		}
+
+		return SString(text.data() + 1, (int)text.size() - 2);
+	}
+
+	// UDMF coordinates keep their fractional part
+	FFixedPoint DecodeCoord() const
+	{
+		return FFixedPoint(DecodeFloat());
+	}
+};
+
+
+//
+// Character classes for the tokenizer, looked up once per byte
+//
+enum
+{
+	UCH_SPACE = 1,
+	UCH_WORD  = 2,	// may start an identifier or number
+	UCH_WORD_REST = 4	// may continue one
+};
+
+struct Udmf_CharClasses
+{
+	byte flags[256] = {};
+
+	Udmf_CharClasses()
+	{
+		for (int ch = 0 ; ch < 256 ; ch++)
+		{
+			// (assumes ASCII)
+			if (ch <= 32 || (ch >= 127 && ch <= 160))
+				flags[ch] |= UCH_SPACE;
+
+			if ((ch >= '0' && ch <= '9') || (ch >= 'A' && ch <= 'Z') ||
+				(ch >= 'a' && ch <= 'z') || ch == '_' || ch == '-' || ch == '+')
+			{
+				flags[ch] |= UCH_WORD | UCH_WORD_REST;
+			}
+		}
+		flags[(byte)'.'] |= UCH_WORD_REST;
+	}
+
+	bool Is(char ch, byte what) const
+	{
+		return (flags[(byte)ch] & what) != 0;
+	}
+};
+
+// one shared table for every file which includes this header
+inline const Udmf_CharClasses udmf_chars;
+
+
+//
+// Tokenizer working directly on the TEXTMAP lump data, which is already
+// completely in memory. Tokens are views into that data.
+//
+class Udmf_Parser
+{
+private:
+	const char *pos;
+	const char *end;
+
+public:
+	Udmf_Parser(const char *data, size_t length) : pos(data), end(data + length)
+	{
+	}
+
+	Udmf_Token Next()
+	{
+		SkipSpaceAndComments();
+
+		if (pos >= end)
+			return Udmf_Token(std::string_view());
+
+		// an actual token, yay!
+		const char *start = pos;
+		char ch = *pos++;
+
+		// is it a string?
+		if (ch == '"')
+		{
+			while (pos < end)
+			{
+				// skip escapes
+				if (*pos == '\\' && pos+1 < end)
+				{
+					pos += 2;
+					continue;
+				}
+
+				if (*pos++ == '"')
+				{
+					// include trailing double quote
+					break;
+				}
+			}
+		}
+		// is it a identifier or number?
+		else if (udmf_chars.Is(ch, UCH_WORD))
+		{
+			while (pos < end && udmf_chars.Is(*pos, UCH_WORD_REST))
+				pos++;
+		}
+		// otherwise it must be a symbol, such as '{' or '}'
+
+		return Udmf_Token(std::string_view(start, pos - start));
+	}
+
+	bool Expect(const char *name)
+	{
+		Udmf_Token tok = Next();
+		return tok.Match(name);
+	}
+
+	void SkipToEOLN()
+	{
+		const void *eoln = memchr(pos, '\n', end - pos);
+
+		pos = eoln ? static_cast<const char *>(eoln) : end;
+	}
+
+private:
+	void SkipSpaceAndComments()
+	{
+		for (;;)
+		{
+			while (pos < end && udmf_chars.Is(*pos, UCH_SPACE))
+				pos++;
+
+			if (pos+2 > end || pos[0] != '/')
+				return;
+
+			if (pos[1] == '/')
+			{
+				SkipToEOLN();
+			}
+			else if (pos[1] == '*')
+			{
+				// find the closing "*/", or give up at EOF
+				const char *p = pos + 2;
+
+				for (;;)
+				{
+					p = static_cast<const char *>(memchr(p, '*', end - p));
+
+					if (! p || p+1 >= end)
+					{
+						pos = end;
+						return;
+					}
+					if (p[1] == '/')
+						break;
+					p++;
+				}
+
+				pos = p + 2;
+			}
+			else
+				return;
+		}
+	}
+};
+
+
+//
+// Text buffer for writing the TEXTMAP lump. All the fields get formatted
+// here and the result is handed to the lump with a single write.
+//
+class Udmf_Writer
+{
+private:
+	std::vector<char> text;
+
+public:
+	void Reserve(size_t size)
+	{
+		text.reserve(size);
+	}
+
+	void Raw(std::string_view str)
+	{
+		text.insert(text.end(), str.begin(), str.end());
+	}
+
+	void Number(int value)
+	{
+		char buffer[16];
+		char *end = std::to_chars(buffer, buffer + sizeof(buffer), value).ptr;
+		text.insert(text.end(), buffer, end);
+	}
+
+	// same output as printf("%1.3f") of the coordinate
+	void Number(FFixedPoint value)
+	{
+		int64_t raw = value.raw();
+
+		if (raw < 0)
+		{
+			text.push_back('-');
+			raw = -raw;
+		}
+
+		// thousandths are raw * 1000 / kFracUnit, rounded half to even
+		int64_t scaled = raw * 1000;
+		int64_t thousandths = scaled / kFracUnit;
+		int64_t rem = scaled % kFracUnit;
+
+		if (rem * 2 > kFracUnit || (rem * 2 == kFracUnit && (thousandths & 1)))
+			thousandths++;
+
+		char buffer[24];
+		char *end = std::to_chars(buffer, buffer + sizeof(buffer), thousandths / 1000).ptr;
+		int frac = (int)(thousandths % 1000);
+
+		*end++ = '.';
+		*end++ = (char)('0' + frac / 100);
+		*end++ = (char)('0' + frac / 10 % 10);
+		*end++ = (char)('0' + frac % 10);
+
+		text.insert(text.end(), buffer, end);
+	}
+
+	// e.g. "thing // 12\n{\n"
+	void Begin(std::string_view kind, int index)
+	{
+		Raw(kind);
+		Raw(" // ");
+		Number(index);
+		Raw("\n{\n");
+	}
+
+	void End()
+	{
+		Raw("}\n\n");
+	}
+
+	template<typename T>
+	void Field(std::string_view name, T value)
+	{
+		Raw(name);
+		Raw(" = ");
+		Number(value);
+		Raw(";\n");
+	}
+
+	void Field(std::string_view name, const SString &value)
+	{
+		Raw(name);
+		Raw(" = \"");
+		Raw(std::string_view(value.c_str(), value.length()));
+		Raw("\";\n");
+	}
+
+	void Flag(int flags, std::string_view name, int mask)
+	{
+		if ((flags & mask) != 0)
+		{
+			Raw(name);
+			Raw(" = true;\n");
+		}
+	}
+
+	const std::vector<char> &Text() const
+	{
+		return text;
+	}
+};
+
+#endif  /* __EUREKA_M_UDMF_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -33,6 +33,8 @@
 #include <stdexcept>
 
 #include "im_color.h"
+#include "lib_adler.h"
+#include "m_batch.h"
 #include "m_config.h"
 #include "m_game.h"
 #include "m_files.h"
@@ -123,6 +125,8 @@ static ProgressStatus init_progress;
 int global::show_help     = 0;
 int global::show_version  = 0;
 
+bool global::batch_mode = false;
+
 
 static void RemoveSingleNewlines(SString &buffer)
 {
@@ -821,6 +825,12 @@ void Main_Loop()
 
 		gInstance.main_win->scroll->UpdateBounds();
 
+		if (gInstance.level.checks.livePoll())
+			gInstance.main_win->status_bar->redraw();
+
+		// nothing holds on to the images between events
+		gInstance.wad.images.trimDecodedImages();
+
 		if (gInstance.edit.Selected->empty())
 			gInstance.edit.error_mode = false;
 	}
@@ -903,6 +913,18 @@ void readPortInfo(LoadingData &loading, ConfigData &config) noexcept(false)
 }
 
 
+//
+// the disk cache of decoded images, one for each IWAD
+//
+static SString ImageCacheFilename(const Wad_file &iwad)
+{
+	crc32_c crc;
+	crc += iwad.PathName();
+
+	return SString::printf("%s/cache/images_%08X%08X.dat", global::cache_dir.c_str(), crc.extra, crc.raw);
+}
+
+
 //
 // load all game/port definitions (*.ugh).
 // open all wads in the master directory.
@@ -955,10 +977,20 @@ void Instance::Main_LoadResources(LoadingData &loading)
 		throw;
 	}
 
+	// the live checks use the definitions and textures
+	level.checks.liveWait();
+
+	// and so do the browser thumbnails
+	if (main_win)
+		main_win->browser->WaitThumbnails();
+
 	// Commit it
 	conf = config;
 	loaded = loading;
 
+	// keep what got decoded from the old resources
+	wad.images.saveDiskCache();
+
 	// reset the master directory
 	if (wad.master.edit_wad)
 		wad.master.MasterDir_Remove(wad.master.edit_wad);
@@ -975,6 +1007,9 @@ void Instance::Main_LoadResources(LoadingData &loading)
 	if (wad.master.edit_wad)
 		wad.master.MasterDir_Add(wad.master.edit_wad);
 
+	if (wad.master.game_wad)
+		wad.images.openDiskCache(ImageCacheFilename(*wad.master.game_wad));
+
 	// finally, load textures and stuff...
 	wad.W_LoadPalette();
 	wad.W_LoadColormap();
@@ -1002,6 +1037,8 @@ void Instance::Main_LoadResources(LoadingData &loading)
 		// TODO: only call this when the IWAD has changed
 		Props_LoadValues(*this);
 	}
+
+	level.checks.liveRecheckAll();
 }
 
 
@@ -1067,6 +1104,60 @@ static void ShowTime()
 }
 
 
+//
+// Headless startup for --batch : no FLTK, no window, and the given wad is
+// processed then we exit.  Mirrors the startup in main() below.
+//
+static int Main_Batch(Instance &inst)
+{
+	if (global::Pwad_list.empty())
+		ThrowException("Batch mode needs a wad file to process\n");
+
+	M_LoadRecent();
+	M_LookForIWADs();
+
+	M_ValidateGivenFiles();
+
+	inst.wad.master.Pwad_name = global::Pwad_list[0];
+	inst.wad.master.edit_wad = Wad_file::Open(inst.wad.master.Pwad_name,
+											  global::batch_nodes ?
+											  WadOpenMode::append :
+											  WadOpenMode::read);
+	if (!inst.wad.master.edit_wad)
+		ThrowException("Cannot load pwad: %s\n", inst.wad.master.Pwad_name.c_str());
+
+	inst.wad.master.MasterDir_Add(inst.wad.master.edit_wad);
+
+	if (! inst.M_ParseEurekaLump(inst.wad.master.edit_wad.get(), true /* keep_cmd_line_args */))
+		ThrowException("Bad EUREKA_LUMP in %s\n", inst.wad.master.Pwad_name.c_str());
+
+	if (inst.loaded.iwadName.empty())
+	{
+		inst.loaded.iwadName = inst.M_PickDefaultIWAD();
+
+		// there is no "Missing IWAD!" dialog in batch mode
+		if (inst.loaded.iwadName.empty())
+			ThrowException("Cannot find an IWAD, use --iwad\n");
+	}
+
+	if (! DetermineIWAD(inst))
+		return 2;
+
+	DeterminePort(inst);
+
+	inst.Main_LoadIWAD();
+
+	int result = Batch_Run(inst);
+
+	gLog.printf("Quit\n");
+
+	inst.wad.master.MasterDir_CloseAll();
+	gLog.close();
+
+	return result;
+}
+
+
 //
 //  the program starts here
 //
@@ -1125,6 +1216,9 @@ int main(int argc, char *argv[])
 		// TODO: create a new instance
 		gInstance.Editor_Init();
 
+		if (global::batch_mode)
+			return Main_Batch(gInstance);
+
 		Main_SetupFLTK();
 
 		init_progress = ProgressStatus::loaded;
@@ -1228,6 +1322,7 @@ int main(int argc, char *argv[])
 		global::app_has_focus = false;
 
 		// TODO: all instances
+		gInstance.wad.images.saveDiskCache();
 		gInstance.wad.master.MasterDir_CloseAll();
 		gLog.close();
 
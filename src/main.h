@@ -146,6 +146,8 @@ namespace global
 {
 	extern int   show_help;		// Print usage message and exit.
 	extern int   show_version;	// Print version info and exit.
+
+	extern bool  batch_mode;	// Process the wad without any GUI, then exit.
 }
 
 
@@ -100,6 +100,9 @@ public:
 private:
 	Instance &inst;
 
+	// whether the level's textures and flats were uploaded this frame
+	bool prepared_images = false;
+
 public:
 	explicit RendInfo3D(Instance &inst) : seen_sectors(inst.level.numSectors() + 1), inst(inst)
 	{ }
@@ -145,6 +148,20 @@ public:
 		return x;
 	}
 
+	// when an image is not in OpenGL yet, all the others of the level
+	// are most likely missing too (e.g. on the first frame), so upload
+	// them together rather than one by one.
+	void BindImage(Img_c *img)
+	{
+		if (img->gl_texture() == 0 && ! prepared_images)
+		{
+			prepared_images = true;
+			IM_PrepareLevelImages(inst, true, true);
+		}
+
+		img->bind_gl(inst.wad);
+	}
+
 	Img_c *FindFlat(const SString &fname, byte& r, byte& g, byte& b, bool& fullbright)
 	{
 		fullbright = false;
@@ -181,7 +198,7 @@ public:
 			fullbright = config::render_unknown_bright;
 		}
 
-		img->bind_gl(inst.wad);
+		BindImage(img);
 
 		r = g = b = 255;
 		return img;
@@ -229,7 +246,7 @@ public:
 			}
 		}
 
-		img->bind_gl(inst.wad);
+		BindImage(img);
 
 		r = g = b = 255;
 		return img;
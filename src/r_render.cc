@@ -36,8 +36,10 @@
 #include "e_hover.h"
 #include "e_linedef.h"
 #include "e_sector.h"
+#include "e_vertex.h"
 #include "e_main.h"
 #include "LineDef.h"
+#include "m_bitvec.h"
 #include "m_config.h"
 #include "m_game.h"
 #include "m_events.h"
@@ -67,28 +69,42 @@ int  config::render_pixel_aspect = 83;  //  100 * width / height
 
 bool global::use_npot_textures;
 
+//
+// The sector of each thing, kept in Render_View_t::thing_sectors.  After
+// an edit only the things which moved, or whose sector the changed
+// lines could affect, are located again.
+//
 namespace thing_sec_cache
 {
-	int invalid_low, invalid_high;
+	// what located each thing, parallel to thing_sectors
+	std::vector<SectorLocator::Hit> hits;
 
-	void ResetRange()
-	{
-		invalid_low  = 999999999;
-		invalid_high = -1;
-	}
+	// things needing to be located again
+	std::vector<byte> dirty;
+	bool any_dirty;
 
-	void InvalidateThing(int th)
+	// set until the things are first located, e.g. the 3D view has not
+	// been used yet, so edits need not be tracked.
+	bool all_dirty = true;
+
+	void InvalidateAll(Instance &inst)
 	{
-		invalid_low  = std::min(invalid_low,  th);
-		invalid_high = std::max(invalid_high, th);
+		int num = inst.level.numThings();
+
+		inst.r_view.thing_sectors.assign(num, -1);
+		hits.assign(num, SectorLocator::Hit());
+		dirty.assign(num, 1);
+		any_dirty = true;
+		all_dirty = true;
 	}
 
-	void InvalidateAll(const Document &doc)
+	void InvalidateThing(int th)
 	{
-		invalid_low  = 0;
-		invalid_high = doc.numThings() - 1;
+		dirty[th] = 1;
+		any_dirty = true;
 	}
 
+	void ApplyChanges(Instance &inst, const ChangeSet &changes);
 	void Update(Instance &inst);
 };
 
@@ -113,13 +129,15 @@ void Render_View_t::FindGroundZ()
 	double max_floor = -9e9;
 	bool hit_something = false;
 
+	const SectorLocator &locator = inst.level.hover.sectorLocator();
+
 	for (int dx = -2 ; dx <= 2 ; dx++)
 	for (int dy = -2 ; dy <= 2 ; dy++)
 	{
 		double test_x = x + dx * 8;
 		double test_y = y + dy * 8;
 
-		Objid o = hover::getNearestSector(inst.level, { test_x, test_y });
+		Objid o = locator.locate({ test_x, test_y });
 
 		if (o.num >= 0)
 		{
@@ -210,60 +228,338 @@ static Thing *FindPlayer(const Document &doc, int typenum)
 
 namespace thing_sec_cache
 {
-	void Update(Instance &inst)
+	static bool RemapThings(Instance &inst, const ChangeSet::Entry &entry)
 	{
-		// guarantee that thing_sectors has the correct size.
-		// [ prevent a potential crash ]
-		if (inst.level.numThings() != (int)inst.r_view.thing_sectors.size())
+		std::vector<int> old_to_new;
+		std::vector<byte> is_new;
+
+		if (!entry.calcRenumbering(inst.level.numThings(), old_to_new, is_new) ||
+			old_to_new.size() != dirty.size())
+			return false;
+
+		std::vector<int> &sectors = inst.r_view.thing_sectors;
+
+		std::vector<int> new_sectors(is_new.size(), -1);
+		std::vector<SectorLocator::Hit> new_hits(is_new.size());
+		std::vector<byte> new_dirty(is_new.size(), 1);
+
+		for (size_t i = 0 ; i < old_to_new.size() ; i++)
 		{
-			inst.r_view.thing_sectors.resize(inst.level.numThings());
-			thing_sec_cache::InvalidateAll(inst.level);
+			int n = old_to_new[i];
+
+			if (n >= 0)
+			{
+				new_sectors[n] = sectors[i];
+				new_hits[n]    = hits[i];
+				new_dirty[n]   = dirty[i];
+			}
 		}
 
-		// nothing changed?
-		if (invalid_low > invalid_high)
-			return;
+		sectors.swap(new_sectors);
+		hits.swap(new_hits);
+		dirty.swap(new_dirty);
 
-		for (int i = invalid_low ; i <= invalid_high ; i++)
+		if (!entry.inserted.empty())
+			any_dirty = true;
+
+		return true;
+	}
+
+	static bool RemapSectors(Instance &inst, const ChangeSet::Entry &entry)
+	{
+		std::vector<int> old_to_new;
+		std::vector<byte> is_new;
+
+		if (!entry.calcRenumbering(inst.level.numSectors(), old_to_new, is_new))
+			return false;
+
+		std::vector<int> &sectors = inst.r_view.thing_sectors;
+
+		for (size_t i = 0 ; i < sectors.size() ; i++)
 		{
-			Objid obj = hover::getNearestSector(inst.level, inst.level.things[i]->xy());
+			if (dirty[i] || sectors[i] < 0)
+				continue;
 
-			inst.r_view.thing_sectors[i] = obj.num;
+			if (sectors[i] >= (int)old_to_new.size() || old_to_new[sectors[i]] < 0)
+				InvalidateThing((int)i);
+			else
+				sectors[i] = old_to_new[sectors[i]];
 		}
 
-		thing_sec_cache::ResetRange();
+		return true;
 	}
-}
 
-void Render3D_NotifyBegin()
-{
-	thing_sec_cache::ResetRange();
-}
+	static bool RemapLines(Instance &inst, const ChangeSet::Entry &entry, bitvec_c &touched)
+	{
+		std::vector<int> old_to_new;
+		std::vector<byte> is_new;
 
-void Render3D_NotifyInsert(ObjType type, int objnum)
-{
-	if (type == ObjType::things)
-		thing_sec_cache::InvalidateThing(objnum);
-}
+		if (!entry.calcRenumbering(inst.level.numLinedefs(), old_to_new, is_new))
+			return false;
 
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum)
-{
-	if (type == ObjType::things || type == ObjType::sectors)
-		thing_sec_cache::InvalidateAll(doc);
-}
+		auto remap = [&](int &line)
+		{
+			if (line < 0)
+				return true;
 
-void Render3D_NotifyChange(ObjType type, int objnum, int field)
-{
-	if (type == ObjType::things &&
-		(field == Thing::F_X || field == Thing::F_Y))
+			if (line >= (int)old_to_new.size() || old_to_new[line] < 0)
+				return false;
+
+			line = old_to_new[line];
+			return true;
+		};
+
+		for (size_t i = 0 ; i < hits.size() ; i++)
+		{
+			if (dirty[i])
+				continue;
+
+			if (!remap(hits[i].horizLine) || !remap(hits[i].vertLine))
+				InvalidateThing((int)i);
+		}
+
+		for (int n = 0 ; n < (int)is_new.size() ; n++)
+			if (is_new[n])
+				touched.set(n);
+
+		return true;
+	}
+
+	//
+	// Marks the linedefs whose geometry, sidedefs or sectors may have
+	// changed.  Returns false if that cannot be worked out.
+	//
+	static bool FindTouchedLines(const Document &doc, const ChangeSet &changes, bitvec_c &touched)
+	{
+		const ChangeSet::Entry &lines = changes[ObjType::linedefs];
+		const ChangeSet::Entry &verts = changes[ObjType::vertices];
+		const ChangeSet::Entry &sides = changes[ObjType::sidedefs];
+
+		if (!lines.changed.empty())
+		{
+			if (!lines.changedNumbersValid())
+				return false;
+
+			for (int n : lines.changed)
+				if (n < doc.numLinedefs())
+					touched.set(n);
+		}
+
+		if (!verts.changed.empty())
+		{
+			if (!verts.changedNumbersValid())
+				return false;
+
+			const VertexLinks &links = doc.vertmod.links();
+
+			for (int v : verts.changed)
+			{
+				if (v >= doc.numVertices())
+					continue;
+
+				for (const VertexLinks::Link &link : links.links(v))
+					touched.set(link.line);
+			}
+		}
+
+		// sidedef renumbering shows up as linedef changes, so only a
+		// changed sector reference matters here.
+		if (sides.changedField(SideDef::F_SECTOR))
+		{
+			if (!sides.changedNumbersValid())
+				return false;
+
+			bitvec_c changed_sides(doc.numSidedefs());
+
+			for (int sd : sides.changed)
+				if (sd < doc.numSidedefs())
+					changed_sides.set(sd);
+
+			for (int n = 0 ; n < doc.numLinedefs() ; n++)
+			{
+				const LineDef *L = doc.linedefs[n];
+
+				if ((L->right >= 0 && changed_sides.get(L->right)) ||
+					(L->left  >= 0 && changed_sides.get(L->left)))
+					touched.set(n);
+			}
+		}
+
+		return true;
+	}
+
+	//
+	// Whether a line's bounding box reaches one of the rays which
+	// located a thing, so it may now be hit before the old line.
+	//
+	static bool CrossesRays(const v2double_t &pos, const SectorLocator::Hit &hit,
+							double x1, double y1, double x2, double y2)
 	{
-		thing_sec_cache::InvalidateThing(objnum);
+		double ray_y = pos.y + 0.04;
+
+		if (y1 <= ray_y && ray_y <= y2 &&
+			x2 >= pos.x - hit.horizDist && x1 <= pos.x + hit.horizDist)
+			return true;
+
+		double ray_x = pos.x + 0.04;
+
+		if (x1 <= ray_x && ray_x <= x2 &&
+			y2 >= pos.y - hit.vertDist && y1 <= pos.y + hit.vertDist)
+			return true;
+
+		return false;
+	}
+
+	void ApplyChanges(Instance &inst, const ChangeSet &changes)
+	{
+		const Document &doc = inst.level;
+
+		if (all_dirty)
+			return;
+
+		// out of step
+		if (dirty.size() != inst.r_view.thing_sectors.size() ||
+			hits.size()  != inst.r_view.thing_sectors.size())
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		const ChangeSet::Entry &things = changes[ObjType::things];
+
+		if (things.hasStructural() && !RemapThings(inst, things))
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		if (things.changedField(Thing::F_X) || things.changedField(Thing::F_Y))
+		{
+			if (!things.changedNumbersValid())
+			{
+				InvalidateAll(inst);
+				return;
+			}
+
+			for (int objnum : things.changed)
+				if (objnum < (int)dirty.size())
+					InvalidateThing(objnum);
+		}
+
+		if (changes[ObjType::sectors].hasStructural() &&
+			!RemapSectors(inst, changes[ObjType::sectors]))
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		bitvec_c touched(std::max(1, doc.numLinedefs()));
+
+		if (changes[ObjType::linedefs].hasStructural() &&
+			!RemapLines(inst, changes[ObjType::linedefs], touched))
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		if (!FindTouchedLines(doc, changes, touched))
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		struct bbox_t { double x1, y1, x2, y2; };
+
+		std::vector<bbox_t> boxes;
+
+		for (int n = 0 ; n < doc.numLinedefs() ; n++)
+		{
+			if (!touched.get(n))
+				continue;
+
+			const LineDef *L = doc.linedefs[n];
+
+			v2double_t a = L->Start(doc)->xy();
+			v2double_t b = L->End(doc)->xy();
+
+			boxes.push_back({ std::min(a.x, b.x), std::min(a.y, b.y),
+							  std::max(a.x, b.x), std::max(a.y, b.y) });
+		}
+
+		if (boxes.empty())
+			return;
+
+		// with a lot of lines changed, testing each thing against them
+		// costs more than just locating them all again.
+		if ((double)boxes.size() * (double)dirty.size() > 4e6)
+		{
+			InvalidateAll(inst);
+			return;
+		}
+
+		for (int i = 0 ; i < (int)dirty.size() ; i++)
+		{
+			if (dirty[i])
+				continue;
+
+			const SectorLocator::Hit &hit = hits[i];
+
+			if ((hit.horizLine >= 0 && touched.get(hit.horizLine)) ||
+				(hit.vertLine  >= 0 && touched.get(hit.vertLine)))
+			{
+				InvalidateThing(i);
+				continue;
+			}
+
+			v2double_t pos = doc.things[i]->xy();
+
+			for (const bbox_t &box : boxes)
+			{
+				if (CrossesRays(pos, hit, box.x1, box.y1, box.x2, box.y2))
+				{
+					InvalidateThing(i);
+					break;
+				}
+			}
+		}
+	}
+
+	void Update(Instance &inst)
+	{
+		// guarantee that thing_sectors has the correct size.
+		// [ prevent a potential crash ]
+		if (inst.level.numThings() != (int)inst.r_view.thing_sectors.size() ||
+			inst.level.numThings() != (int)dirty.size())
+		{
+			InvalidateAll(inst);
+		}
+
+		// nothing changed?
+		if (!any_dirty)
+			return;
+
+		const SectorLocator &locator = inst.level.hover.sectorLocator();
+
+		for (int i = 0 ; i < (int)dirty.size() ; i++)
+		{
+			if (!dirty[i])
+				continue;
+
+			Objid obj = locator.locate(inst.level.things[i]->xy(), &hits[i]);
+
+			inst.r_view.thing_sectors[i] = obj.num;
+			dirty[i] = 0;
+		}
+
+		any_dirty = false;
+		all_dirty = false;
 	}
 }
 
-void Render3D_NotifyEnd(Instance &inst)
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
 {
-	thing_sec_cache::Update(inst);
+	// the things get located when the 3D view is next drawn
+	thing_sec_cache::ApplyChanges(inst, changes);
 }
 
 
@@ -649,8 +945,7 @@ static bool Render3D_Query(Instance &inst, Objid& hl, int sx, int sy)
 
 void Instance::Render3D_Setup()
 {
-	thing_sec_cache::InvalidateAll(level);
-	r_view.thing_sectors.resize(0);
+	thing_sec_cache::InvalidateAll(*this);
 
 	if (! r_view.p_type)
 	{
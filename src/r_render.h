@@ -29,6 +29,7 @@
 
 #include "im_img.h"
 
+class ChangeSet;
 
 struct Render_View_t
 {
@@ -107,11 +108,7 @@ void Render3D_ScrollMap(Instance &inst, v2int_t dpos = {}, keycode_t mod = 0);
 void Render3D_DragThings(Instance &inst);
 void Render3D_DragSectors(Instance &inst);
 
-void Render3D_NotifyBegin();
-void Render3D_NotifyInsert(ObjType type, int objnum);
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum);
-void Render3D_NotifyChange(ObjType type, int objnum, int field);
-void Render3D_NotifyEnd(Instance &inst);
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes);
 
 
 /* API for rendering a scene (etc) */
@@ -35,6 +35,9 @@ Log gLog;
 // hack here to avoid bringing in ui_window.h and FLTK headers
 extern void LogViewer_AddLine(const char *str);
 
+// where this thread's messages go instead, if set
+static thread_local LogCapture *tCapture;
+
 //
 // Open a file
 //
@@ -102,6 +105,12 @@ void Log::printf(EUR_FORMAT_STRING(const char *str), ...)
 	SString buffer = SString::vprintf(str, args);
 	va_end(args);
 
+	if (tCapture)
+	{
+		tCapture->mMessages.push_back(buffer);
+		return;
+	}
+
 	if (log_fp)
 	{
 		fputs(buffer.c_str(), log_fp);
@@ -156,6 +165,16 @@ void Log::debugPrintf(EUR_FORMAT_STRING(const char *str), ...)
 	}
 }
 
+LogCapture::LogCapture() : mPrevious(tCapture)
+{
+	tCapture = this;
+}
+
+LogCapture::~LogCapture()
+{
+	tCapture = mPrevious;
+}
+
 //
 // Save the log so far to another file
 //
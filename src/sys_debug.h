@@ -82,6 +82,33 @@ private:
 
 extern Log gLog;
 
+//
+// While one exists, whatever the current thread prints with gLog.printf()
+// is kept in it instead.  Jobs on worker threads use it, so that their
+// messages can be printed afterwards, in a fixed order.
+//
+class LogCapture
+{
+public:
+	LogCapture();
+	~LogCapture();
+
+	const std::vector<SString> &messages() const
+	{
+		return mMessages;
+	}
+
+private:
+	friend class Log;
+
+	std::vector<SString> mMessages;
+	LogCapture *mPrevious;
+
+	// deliberately don't implement these
+	LogCapture(const LogCapture &other);
+	LogCapture &operator = (const LogCapture &other);
+};
+
 // -------- assertion macros --------
 
 #ifdef NDEBUG
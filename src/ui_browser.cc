@@ -23,14 +23,17 @@
 
 #include "main.h"
 
+#include <algorithm>
 #include <map>
 #include <string>
+#include <unordered_map>
 
 #include "ui_window.h"
 #include "ui_browser.h"
 
 #include "im_img.h"
 #include "im_color.h"
+#include "lib_threads.h"
 #include "m_config.h"
 #include "m_game.h"
 #include "e_main.h"		// recent_xxx
@@ -46,6 +49,10 @@ bool config::browser_small_tex = false;
 bool config::browser_combine_tex = false;
 
 
+// how often to look whether the thumbnails are done (in seconds)
+#define THUMB_POLL_TIME  0.05
+
+
 // sort methods
 enum sort_method_e
 {
@@ -56,18 +63,19 @@ enum sort_method_e
 };
 
 
-bool Texture_MatchPattern(const char *tex, const char *pattern)
+//
+// converts a search pattern into the glob for fl_filename_match().
+// returns false when the pattern cannot match anything.
+//
+static bool PrepareMatchPattern(const char *pattern, SString &local_pat, bool &negated)
 {
-	// Note: an empty pattern matches NOTHING
-
-	SString local_pat;
-	local_pat.reserve(256);
+	local_pat.clear();
 
 
 	// add '*' to the start and end of the pattern
 	// (unless it uses the ^ or $ anchors)
 
-	bool negated = false;
+	negated = false;
 	if (pattern[0] == '!')
 	{
 		pattern++;
@@ -91,12 +99,47 @@ bool Texture_MatchPattern(const char *tex, const char *pattern)
 	else
 		local_pat += '*';
 
+	return true;
+}
+
+
+bool Texture_MatchPattern(const char *tex, const char *pattern)
+{
+	// Note: an empty pattern matches NOTHING
+
+	SString local_pat;
+	bool negated;
+
+	if (! PrepareMatchPattern(pattern, local_pat, negated))
+		return false;
+
 	bool result = !!fl_filename_match(tex, local_pat.c_str());
 
 	return negated ? !result : result;
 }
 
 
+//
+// checks whether everything matching 'cur' also matches 'old', true
+// when 'cur' merely extends a plain 'old' pattern.
+//
+static bool Pattern_IsNarrower(const SString &old, const SString &cur)
+{
+	if (old.empty())
+		return true;
+
+	if (! cur.startsWith(old.c_str()))
+		return false;
+
+	// negation, the end anchor and unfinished [..] or {..} groups
+	// can all make a longer pattern match more.
+	if (old[0] == '!' || old == "^" || old.back() == '$')
+		return false;
+
+	return old.find_first_of("[{\\") == SString::npos;
+}
+
+
 //
 // this sub-class of button prevents grabbing the keyboard focus,
 // which is mainly useful for the Find/Replace panel, as it needs
@@ -188,17 +231,13 @@ bool charMapsToSpecificBrowserMode(char c)
 
 /* text item */
 
-Browser_Item::Browser_Item(Instance &inst, int X, int Y, int W, int H,
-						   const SString &_desc, const SString &_realname,
-						   int _num, BrowserMode _kind, char _category) :
+Browser_Item::Browser_Item(Instance &inst, int X, int Y, int W, int H) :
 	Fl_Group(X, Y, W, H, ""),
-	desc(_desc), real_name(_realname),
-	number(_num), kind(_kind), category(_category),
 	inst(inst)
 {
 	end();
 
-	button = new Browser_Button(X + 4, Y + 1, W - 8, H - 2, desc.c_str());
+	button = new Browser_Button(X + 4, Y + 1, W - 8, H - 2, "");
 
 	button->align(FL_ALIGN_INSIDE | FL_ALIGN_LEFT);
   	button->labelfont(FL_COURIER);
@@ -211,25 +250,20 @@ Browser_Item::Browser_Item(Instance &inst, int X, int Y, int W, int H,
 
 /* image item */
 
-Browser_Item::Browser_Item(Instance &inst, int X, int Y, int W, int H,
-						   const SString &_desc, const SString &_realname,
-						   int _num, BrowserMode _kind, char _category,
-						   int pic_w, int pic_h, UI_Pic *_pic) :
+Browser_Item::Browser_Item(Instance &inst, int X, int Y, int W, int H, UI_Pic *_pic) :
 	Fl_Group(X, Y, W, H, ""),
-	desc(_desc), real_name(_realname),
-	number(_num), kind(_kind), category(_category),
 	pic(_pic), inst(inst)
 {
 	end();
 
 	add(pic);
 
-	Fl_Box *box = new Fl_Box(FL_NO_BOX, X + 4, Y + H - 28, W - 4, 24, desc.c_str());
-	box->align(FL_ALIGN_INSIDE | FL_ALIGN_CENTER);
-	box->labelcolor(FL_WHITE);
-	box->labelsize(12);
+	pic_label = new Fl_Box(FL_NO_BOX, X + 4, Y + H - 28, W - 4, 24, "");
+	pic_label->align(FL_ALIGN_INSIDE | FL_ALIGN_CENTER);
+	pic_label->labelcolor(FL_WHITE);
+	pic_label->labelsize(12);
 
-	add(box);
+	add(pic_label);
 
 	resizable(NULL);
 }
@@ -241,7 +275,86 @@ Browser_Item::~Browser_Item()
 }
 
 
-bool Browser_Item::MatchName(const char *name) const
+void Browser_Item::Place(const Browser_Entry &entry, int X, int Y)
+{
+	// the children are placed directly, scaling them would drift
+	Fl_Widget::resize(X, Y, entry.w, entry.h);
+
+	if (button)
+		button->resize(X + 4, Y + 1, entry.w - 8, entry.h - 2);
+
+	if (pic)
+	{
+		pic->resize(X + 8, Y + 4, entry.pic_w, entry.pic_h);
+		pic_label->resize(X + 4, Y + entry.h - 28, entry.w - 4, 24);
+	}
+
+	init_sizes();
+}
+
+
+void Browser_Item::Bind(const Browser_Entry &entry, const thumbnail_map_t &thumbs)
+{
+	entry_id = entry.id;
+
+	number = entry.number;
+	kind   = entry.kind;
+
+	if (button)
+	{
+		button->copy_label(entry.desc.c_str());
+
+		if (kind == BrowserMode::things)
+			button->callback(thing_callback, this);
+		else if (kind == BrowserMode::lineTypes)
+			button->callback(line_callback, this);
+		else
+			button->callback(sector_callback, this);
+
+		return;
+	}
+
+	pic_label->copy_label(entry.desc.c_str());
+
+	pic->Unhighlight();
+
+	if (kind != BrowserMode::flats && kind != BrowserMode::textures)
+	{
+		pic->GetSprite(number, FL_BLACK);
+		pic->callback(thing_callback, this);
+		return;
+	}
+
+	// a thumbnail made earlier is reused, otherwise it gets made once
+	// it has been drawn.
+	thumbnail_map_t::const_iterator thumb = thumbs.find(entry.id);
+
+	if (thumb == thumbs.end())
+	{
+		if (kind == BrowserMode::flats)
+			pic->DeferFlat(entry.real_name);
+		else
+			pic->DeferTex(entry.real_name);
+	}
+	else if (thumb->second)
+	{
+		pic->ShowRGB(thumb->second.get());
+	}
+	else
+	{
+		pic->MarkUnknown();
+	}
+
+	setPicCallbackString(entry.real_name);
+
+	if (kind == BrowserMode::flats)
+		pic->callback(flat_callback, this);
+	else
+		pic->callback(texture_callback, this);
+}
+
+
+bool Browser_Entry::MatchName(const char *name) const
 {
 	return (y_stricmp(real_name.c_str(), name) == 0);
 }
@@ -405,6 +518,8 @@ UI_Browser_Box::UI_Browser_Box(Instance &inst, int X, int Y, int W, int H, const
 	scroll = new UI_Scroll(X, cy, W, H-3 - top_H, -1 /* bar_side */);
 
 	scroll->box(FL_FLAT_BOX);
+	scroll->callback(scroll_callback, this);
+	scroll->Virtual_height(0, 0);
 
 	add(scroll);
 
@@ -417,6 +532,12 @@ UI_Browser_Box::UI_Browser_Box(Instance &inst, int X, int Y, int W, int H, const
 }
 
 
+UI_Browser_Box::~UI_Browser_Box()
+{
+	WaitThumbnails();
+}
+
+
 void UI_Browser_Box::resize(int X, int Y, int W, int H)
 {
 	Fl_Group::resize(X, Y, W, H);
@@ -425,11 +546,157 @@ void UI_Browser_Box::resize(int X, int Y, int W, int H)
 
 	rs_box->resize(X + W - 10, Y + rs_box->h(), 8, H - rs_box->h());
 
-	// rearrange images
-	if (pic_mode)
+	// rearrange the entries
+	Layout(false /* to_top */);
+}
+
+
+void UI_Browser_Box::draw()
+{
+	// the pictures are only made once they come into view
+	if (pic_mode && NeedThumbnails())
+		StartThumbnails();
+
+	Fl_Group::draw();
+}
+
+
+bool UI_Browser_Box::NeedThumbnails() const
+{
+	for (const Browser_Item *item : items)
+		if (item->visible() && item->pic && item->pic->Deferred())
+			return true;
+
+	return false;
+}
+
+
+void UI_Browser_Box::StartThumbnails()
+{
+	if (thumb_job.valid())
+		return;
+
+	// the widgets cover the next page too, so a little scrolling
+	// finds the pictures ready.
+	thumb_requests.clear();
+
+	for (Browser_Item *item : items)
 	{
-		Filter();
+		if (! (item->visible() && item->pic && item->pic->Deferred()))
+			continue;
+
+		const SString &name = item->mPicCallbackString;
+
+		// these have no image, and are quick to show
+		if (item->kind == BrowserMode::textures && (is_special_tex(name) || is_null_tex(name)))
+		{
+			item->pic->Resolve();
+			continue;
+		}
+
+		thumb_requests.push_back({ item->entry_id, item->kind, name, item->pic->w(), item->pic->h(), nullptr });
+	}
+
+	if (thumb_requests.empty())
+		return;
+
+	thumb_job = ThreadPool::shared().submit([this]()
+	{
+		LogCapture capture;
+
+		const ImageSet &images = inst.wad.images;
+		const Palette &pal = inst.wad.palette;
+
+		for (thumb_request_t &req : thumb_requests)
+		{
+			auto make = [&req, &pal](const Img_c *img)
+			{
+				if (img && img->width() >= 1 && img->height() >= 1)
+					req.rgb.reset(UI_Pic::TiledRGB(pal, img, req.w, req.h));
+			};
+
+			if (req.kind == BrowserMode::flats)
+				images.useFlat(inst.conf, req.name, make);
+			else
+				images.useTexture(inst.conf, req.name, make);
+		}
+
+		thumb_messages = capture.messages();
+	});
+
+	Fl::add_timeout(THUMB_POLL_TIME, thumbs_callback, this);
+}
+
+
+void UI_Browser_Box::thumbs_callback(void *data)
+{
+	UI_Browser_Box *that = (UI_Browser_Box *)data;
+
+	if (that->thumb_job.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+	{
+		Fl::repeat_timeout(THUMB_POLL_TIME, thumbs_callback, that);
+		return;
+	}
+
+	that->FinishThumbnails();
+
+	// more may have scrolled into view meanwhile
+	if (that->visible_r() && that->NeedThumbnails())
+		that->StartThumbnails();
+}
+
+
+void UI_Browser_Box::FinishThumbnails()
+{
+	try
+	{
+		thumb_job.get();
+	}
+	catch (const std::exception &e)
+	{
+		// the ones not made yet are shown as unknown
+		gLog.printf("Making thumbnails failed: %s\n", e.what());
+	}
+
+	for (const SString &message : thumb_messages)
+		gLog.printf("%s", message.c_str());
+
+	thumb_messages.clear();
+
+	for (thumb_request_t &req : thumb_requests)
+		thumbs[req.id] = std::move(req.rgb);
+
+	thumb_requests.clear();
+
+	// the widgets may be showing other entries by now
+	for (Browser_Item *item : items)
+	{
+		if (! (item->pic && item->pic->Deferred()))
+			continue;
+
+		thumbnail_map_t::const_iterator thumb = thumbs.find(item->entry_id);
+
+		if (thumb == thumbs.end())
+			continue;
+
+		if (thumb->second)
+			item->pic->ShowRGB(thumb->second.get());
+		else
+			item->pic->MarkUnknown();
 	}
+
+	scroll->redraw();
+}
+
+
+void UI_Browser_Box::WaitThumbnails()
+{
+	if (! thumb_job.valid())
+		return;
+
+	Fl::remove_timeout(thumbs_callback, this);
+
+	FinishThumbnails();
 }
 
 
@@ -474,82 +741,240 @@ void UI_Browser_Box::sort_callback(Fl_Widget *w, void *data)
 }
 
 
+void UI_Browser_Box::scroll_callback(Fl_Widget *w, void *data)
+{
+	UI_Browser_Box *that = (UI_Browser_Box *)data;
+
+	that->PlaceItems();
+}
+
+
 bool UI_Browser_Box::Filter(bool force_update)
 {
 	bool changes = false;
 
-	int left_X  = scroll->x() + SBAR_W;
-	int right_X = left_X + scroll->w() - SBAR_W;
+	// the search box is turned into a glob once, not per entry
+	SString glob;
+	bool negated = false;
 
-	// current position
-	int cx = left_X;
-	int cy = scroll->y();
+	bool can_match = PrepareMatchPattern(search->value(), glob, negated);
 
-	// the highest visible widget on the current line
-	int highest = 0;
+	// when the search text has only been extended, entries which did not
+	// match before cannot match now, so only earlier matches are tested.
+	int combine = (do_tex ? do_tex->value() * 2 : 0) + (do_flats ? do_flats->value() : 0);
 
-	for (int i = 0 ; i < scroll->Children() ; i++)
-	{
-		Browser_Item *item = (Browser_Item *)scroll->Child(i);
+	bool narrowing = !force_update &&
+		filter_category == category->value() &&
+		filter_combine  == combine &&
+		cat_letters[category->value()] != '^' &&
+		Pattern_IsNarrower(filter_pattern, search->value());
 
-		item->redraw();
+	filter_pattern  = search->value();
+	filter_category = category->value();
+	filter_combine  = combine;
 
-		bool keep = SearchMatch(item);
+	for (Browser_Entry &E : entries)
+	{
+		bool keep = false;
 
-		if (keep != (item->visible() ? true : false))
-		{
-			if (keep)
-				item->show();
-			else
-				item->hide();
+		if (E.shown || ! narrowing)
+			keep = SearchMatch(E, can_match ? glob.c_str() : NULL, negated);
 
+		if (keep != E.shown)
+		{
+			E.shown = keep;
 			changes = true;
 		}
+	}
 
-		if (! keep)
-		{
-			item->position(cx, cy);
+	Layout(true /* to_top */);
+
+	return changes;
+}
+
+
+void UI_Browser_Box::Layout(bool to_top)
+{
+	int list_W = scroll->w() - SBAR_W;
+
+	// current position, relative to the top of the list
+	int cx = 0;
+	int cy = 0;
+
+	// the highest entry on the current row
+	int highest = 0;
+
+	layout.clear();
+	layout_rows.clear();
+
+	for (int i = 0 ; i < (int)entries.size() ; i++)
+	{
+		Browser_Entry &E = entries[i];
+
+		if (! E.shown)
 			continue;
-		}
+
+		// text entries fill the width
+		if (! pic_mode)
+			E.w = list_W;
 
 		// can it fit on the current row?
-		if (pic_mode && (cx <= left_X || (cx + item->w()) <= right_X))
+		if (pic_mode && ! layout_rows.empty() && (cx + E.w) <= list_W)
 		{
 			// Yes
 		}
 		else
 		{
 			// No, move down to the next row
-			cx = left_X;
-
+			cx = 0;
 			cy += highest;
 
 			highest = 0;
+
+			layout_rows.push_back(layout_row_t { (int)layout.size(), cy, 0 });
 		}
 
-		// update position
-		item->position(cx, cy);
+		E.x = cx;
+		E.y = cy;
+
+		layout.push_back(i);
+
+		cx += E.w;
+
+		highest = std::max(highest, E.h);
+
+		layout_rows.back().h = highest;
+	}
+
+	int total_h = cy + highest;
+
+	scroll->Virtual_height(total_h, to_top ? 0 : scroll->Position());
+
+	PlaceItems();
+}
+
+
+void UI_Browser_Box::PlaceItems()
+{
+	// include the next page in picture mode, so a little scrolling
+	// finds the pictures ready.
+	int top    = scroll->Position();
+	int bottom = top + scroll->h() * (pic_mode ? 2 : 1);
+
+	// find the first row which reaches into the view
+	auto row = std::upper_bound(layout_rows.begin(), layout_rows.end(), top,
+		[](int pos, const layout_row_t &R)
+		{
+			return pos < R.y + R.h;
+		});
+
+	std::vector<int> wanted;
+
+	for ( ; row != layout_rows.end() && row->y < bottom ; row++)
+	{
+		int last = (row + 1 == layout_rows.end()) ? (int)layout.size() : (row + 1)->first;
+
+		for (int k = row->first ; k < last ; k++)
+			wanted.push_back(layout[k]);
+	}
+
+	// widgets already showing a wanted entry keep it (and its picture),
+	// the others are free to show something else.
+	std::unordered_map<int, Browser_Item *> by_id;
+
+	for (Browser_Item *item : items)
+		if (item->entry_id >= 0)
+			by_id[item->entry_id] = item;
+
+	std::vector<Browser_Item *> placed(wanted.size(), nullptr);
+
+	for (size_t k = 0 ; k < wanted.size() ; k++)
+	{
+		auto it = by_id.find(entries[wanted[k]].id);
+
+		if (it != by_id.end())
+		{
+			placed[k] = it->second;
+			by_id.erase(it);
+		}
+	}
+
+	std::vector<Browser_Item *> spare;
+
+	for (Browser_Item *item : items)
+		if (item->entry_id < 0 || by_id.count(item->entry_id) > 0)
+			spare.push_back(item);
+
+	int left_X = scroll->x() + SBAR_W;
+	int top_Y  = scroll->y() - top;
+
+	for (size_t k = 0 ; k < wanted.size() ; k++)
+	{
+		const Browser_Entry &E = entries[wanted[k]];
+
+		Browser_Item *item = placed[k];
 
-		cx += item->w();
+		if (item)
+		{
+			item->Place(E, left_X + E.x, top_Y + E.y);
+		}
+		else
+		{
+			if (spare.empty())
+			{
+				item = NewItem();
+			}
+			else
+			{
+				item = spare.back();
+				spare.pop_back();
+			}
 
-		highest = std::max(highest, item->h());
+			item->Place(E, left_X + E.x, top_Y + E.y);
+			item->Bind(E, thumbs);
+		}
+
+		item->show();
 	}
 
-	scroll->Init_sizes();
+	for (Browser_Item *item : spare)
+		item->hide();
+
 	scroll->redraw();
+}
 
-	return changes;
+
+Browser_Item * UI_Browser_Box::NewItem()
+{
+	Browser_Item *item;
+
+	if (pic_mode)
+	{
+		UI_Pic *pic = new UI_Pic(inst, 0, 0, 64, 64);
+
+		item = new Browser_Item(inst, 0, 0, 74, 100, pic);
+	}
+	else
+	{
+		item = new Browser_Item(inst, 0, 0, scroll->w() - SBAR_W, 24);
+	}
+
+	items.push_back(item);
+
+	scroll->Add(item);
+
+	return item;
 }
 
 
-bool UI_Browser_Box::SearchMatch(Browser_Item *item) const
+bool UI_Browser_Box::SearchMatch(const Browser_Entry &E, const char *pattern, bool negated) const
 {
 	if (config::browser_combine_tex && kind == BrowserMode::textures)
 	{
-		if (item->kind == BrowserMode::textures && !do_tex->value())
+		if (E.kind == BrowserMode::textures && !do_tex->value())
 			return false;
 
-		if (item->kind == BrowserMode::flats && !do_flats->value())
+		if (E.kind == BrowserMode::flats && !do_flats->value())
 			return false;
 	}
 
@@ -559,10 +984,10 @@ bool UI_Browser_Box::SearchMatch(Browser_Item *item) const
 
 		// special logic for RECENT category  [ignore search box]
 		if (cat == '^')
-			return (item->recent_idx >= 0);
+			return (E.recent_idx >= 0);
 
-		if (! (cat == tolower(item->category) ||
-			   (cat == 'X' && isupper(item->category))))
+		if (! (cat == tolower(E.category) ||
+			   (cat == 'X' && isupper(E.category))))
 			return false;
 	}
 
@@ -571,63 +996,65 @@ bool UI_Browser_Box::SearchMatch(Browser_Item *item) const
 	if (search->size() == 0)
 		return true;
 
-	const char *pattern = search->value();
+	if (! pattern)
+		return false;
 
-	if (isGraphicsMode(kind))
-		return Texture_MatchPattern(item->real_name.c_str(), pattern);
+	const char *name = isGraphicsMode(kind) ? E.real_name.c_str() : E.desc.c_str();
+
+	bool result = !!fl_filename_match(name, pattern);
 
-	return Texture_MatchPattern(item->desc.c_str(), pattern);
+	return negated ? !result : result;
 }
 
 
-bool UI_Browser_Box::Recent_UpdateItem(Browser_Item *item)
+bool UI_Browser_Box::Recent_UpdateItem(Browser_Entry &E)
 {
 	// returns true if the index changed
 
 	int new_idx = -1;
 
-	switch (item->kind)
+	switch (E.kind)
 	{
 		case BrowserMode::textures:
-			new_idx = inst.recent_textures.find(item->real_name);
+			new_idx = inst.recent_textures.find(E.real_name);
 			if (new_idx < 0)
-				new_idx = inst.recent_flats.find(item->real_name);
+				new_idx = inst.recent_flats.find(E.real_name);
 			break;
 
 		case BrowserMode::flats:
-			new_idx = inst.recent_flats.find(item->real_name);
+			new_idx = inst.recent_flats.find(E.real_name);
 			if (new_idx < 0)
-				new_idx = inst.recent_textures.find(item->real_name);
+				new_idx = inst.recent_textures.find(E.real_name);
 			break;
 
 		case BrowserMode::things:
-			new_idx = inst.recent_things.find_number(item->number);
+			new_idx = inst.recent_things.find_number(E.number);
 			break;
 
 		default:
 			return false;
 	}
 
-	if (item->recent_idx == new_idx)
+	if (E.recent_idx == new_idx)
 		return false;
 
-	item->recent_idx = new_idx;
+	E.recent_idx = new_idx;
 	return true;
 }
 
 
-static int SortCmp(const Browser_Item *A, const Browser_Item *B, sort_method_e method)
+static int SortCmp(const Browser_Entry &A, const Browser_Entry &B, sort_method_e method)
 {
-	const char *sa = A->desc.c_str();
-	const char *sb = B->desc.c_str();
+	const char *sa = A.desc.c_str();
+	const char *sb = B.desc.c_str();
 
 	if (method == SOM_Numeric)
 	{
-		return (A->number - B->number);
+		return (A.number - B.number);
 	}
 	else if (method == SOM_Recent)
 	{
-		return (A->recent_idx - B->recent_idx);
+		return (A.recent_idx - B.recent_idx);
 	}
 
 	if (strchr(sa, '/')) sa = strchr(sa, '/') + 1;
@@ -649,35 +1076,8 @@ static int SortCmp(const Browser_Item *A, const Browser_Item *B, sort_method_e m
 	return strcmp(sa, sb);
 }
 
-static void SortPass(std::vector< Browser_Item * >& ARR, int gap, int total, sort_method_e method)
-{
-	int i, k;
-
-	for (i = gap ; i < total ; i++)
-	{
-		Browser_Item * temp = ARR[i];
-
-		for (k = i ; k >= gap && SortCmp(ARR[k - gap], temp, method) > 0 ; k -= gap)
-			ARR[k] = ARR[k - gap];
-
-		ARR[k] = temp;
-	}
-}
-
 void UI_Browser_Box::Sort()
 {
-	int total = scroll->Children();
-
-	// transfer widgets to a local vector
-	std::vector< Browser_Item * > ARR;
-
-	for (int i = 0 ; i < total ; i++)
-	{
-		ARR.push_back( (Browser_Item *) scroll->Child(0));
-
-		scroll->Remove_first();
-	}
-
 	char cat = cat_letters[category->value()];
 
 	sort_method_e method = SOM_Alpha;
@@ -689,14 +1089,11 @@ void UI_Browser_Box::Sort()
 	else if (kind == BrowserMode::lineTypes)
 		method = SOM_AlphaSkip;
 
-	// shell sort
-	SortPass(ARR, 9, total, method);
-	SortPass(ARR, 4, total, method);
-	SortPass(ARR, 1, total, method);
-
-	// transfer them back to the scroll widget
-	for (int i = 0 ; i < total ; i++)
-		scroll->Add(ARR[i]);
+	std::stable_sort(entries.begin(), entries.end(),
+		[method](const Browser_Entry &A, const Browser_Entry &B)
+		{
+			return SortCmp(A, B, method) < 0;
+		});
 
 	// reposition them all
 	Filter(true);
@@ -728,20 +1125,16 @@ SString TidyLineDesc(const char *name)
 }
 
 
-void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString, Img_c *> & img_list)
+void UI_Browser_Box::Populate_Images(BrowserMode imkind, const image_map_t & img_list)
 {
-	/* Note: the side-by-side packing is done in Filter() method */
+	/* Note: the side-by-side packing is done in Layout() method */
 
 	pic_mode = true;
 
 	scroll->color(FL_BLACK, FL_BLACK);
-	scroll->resize_horiz(false);
 	scroll->Line_size(98);
 
-	std::map<SString, Img_c *>::const_iterator TI;
-
-	int cx = scroll->x() + SBAR_W;
-	int cy = scroll->y();
+	image_map_t::const_iterator TI;
 
 	char full_desc[256];
 
@@ -749,24 +1142,25 @@ void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString,
 	{
 		const SString &name = TI->first;
 
-		Img_c *image = TI->second;
+		// the size is known without decoding the image
+		const ImageEntry &image = TI->second;
 
 		if ((false)) /* NO PICS */
 			snprintf(full_desc, sizeof(full_desc), "%-8s : %3dx%d", name.c_str(),
-					 image->width(), image->height());
+					 image.width, image.height);
 		else
 			snprintf(full_desc, sizeof(full_desc), "%-8s", name.c_str());
 
-		int pic_w = (kind == BrowserMode::flats || image->width() <= 64) ? 64 : 128; // MIN(128, MAX(4, image->width()));
-		int pic_h = (kind == BrowserMode::flats) ? 64 : std::min(128, std::max(4, image->height()));
+		int pic_w = (kind == BrowserMode::flats || image.width <= 64) ? 64 : 128; // MIN(128, MAX(4, image.width));
+		int pic_h = (kind == BrowserMode::flats) ? 64 : std::min(128, std::max(4, image.height));
 
 		if (config::browser_small_tex && imkind == BrowserMode::textures)
 		{
 			pic_w = 64;
-			pic_h = std::min(64, std::max(4, image->height()));
+			pic_h = std::min(64, std::max(4, image.height));
 		}
 
-		if (image->width() >= 256 && image->height() == 128)
+		if (image.width >= 256 && image.height == 128)
 		{
 			pic_w = 128;
 			pic_h = 64;
@@ -777,51 +1171,38 @@ void UI_Browser_Box::Populate_Images(BrowserMode imkind, const std::map<SString,
 
 		char item_cat = 0;
 
-		UI_Pic *pic = new UI_Pic(inst, cx + 8, cy + 4, pic_w, pic_h);
-
 		if (imkind == BrowserMode::flats)
 			item_cat = inst.M_GetFlatType(name);
 		else if (imkind == BrowserMode::textures)
 			item_cat = inst.M_GetTextureType(name);
 
-		Browser_Item *item = new Browser_Item(inst, cx, cy, item_w, item_h,
-		                                      full_desc, name, 0 /* num */,
-											  imkind, item_cat,
-		                                      pic_w, pic_h, pic);
+		Browser_Entry E;
 
-		if(imkind == BrowserMode::flats)
-		{
-			pic->GetFlat(name);
-			item->setPicCallbackString(name);
-			pic->callback(Browser_Item::flat_callback, item);
-		}
-		else if(imkind == BrowserMode::textures)
-		{
-			pic->GetTex(name);
-			item->setPicCallbackString(name);
-			pic->callback(Browser_Item::texture_callback, item);
-		}
+		E.desc = full_desc;
+		E.real_name = name;
+		E.kind = imkind;
+		E.category = item_cat;
+		E.id = (int)entries.size();
+
+		E.pic_w = pic_w;  E.w = item_w;
+		E.pic_h = pic_h;  E.h = item_h;
 
-		scroll->Add(item);
+		entries.push_back(E);
 	}
 }
 
 
 void UI_Browser_Box::Populate_Sprites()
 {
-	/* Note: the side-by-side packing is done in Filter() method */
+	/* Note: the side-by-side packing is done in Layout() method */
 
 	pic_mode = true;
 
 	scroll->color(FL_BLACK, FL_BLACK);
-	scroll->resize_horiz(false);
 	scroll->Line_size(98);
 
 	std::map<int, thingtype_t>::iterator TI;
 
-	int cx = scroll->x() + SBAR_W;
-	int cy = scroll->y();
-
 	char full_desc[256];
 
 	for (TI = inst.conf.thing_types.begin() ; TI != inst.conf.thing_types.end() ; TI++)
@@ -843,18 +1224,18 @@ void UI_Browser_Box::Populate_Sprites()
 		int item_w = 8 + std::max(pic_w, 64) + 2;
 		int item_h = 4 + std::max(pic_h, 16) + 2 + 24 + 4;
 
-		UI_Pic *pic = new UI_Pic(inst, cx + 8, cy + 4, pic_w, pic_h);
-
-		pic->GetSprite(TI->first, FL_BLACK);
+		Browser_Entry E;
 
-		Browser_Item *item = new Browser_Item(inst, cx, cy, item_w, item_h,
-		                                      full_desc, "", TI->first,
-											  kind, info.group,
-		                                      pic_w, pic_h, pic);
+		E.desc = full_desc;
+		E.number = TI->first;
+		E.kind = kind;
+		E.category = info.group;
+		E.id = (int)entries.size();
 
-		pic->callback(Browser_Item::thing_callback, item);
+		E.pic_w = pic_w;  E.w = item_w;
+		E.pic_h = pic_h;  E.h = item_h;
 
-		scroll->Add(item);
+		entries.push_back(E);
 	}
 }
 
@@ -863,11 +1244,6 @@ void UI_Browser_Box::Populate_ThingTypes()
 {
 	std::map<int, thingtype_t>::iterator TI;
 
-	int y = scroll->y();
-
-	int mx = scroll->x() + SBAR_W;
-	int mw = scroll->w() - SBAR_W;
-
 	char full_desc[256];
 
 	for (TI = inst.conf.thing_types.begin() ; TI != inst.conf.thing_types.end() ; TI++)
@@ -876,12 +1252,16 @@ void UI_Browser_Box::Populate_ThingTypes()
 
 		snprintf(full_desc, sizeof(full_desc), "%4d/ %s", TI->first, info.desc.c_str());
 
-		Browser_Item *item = new Browser_Item(inst, mx, y, mw, 24, full_desc, "",
-											  TI->first, kind, info.group);
+		Browser_Entry E;
 
-		item->button->callback(Browser_Item::thing_callback, item);
+		E.desc = full_desc;
+		E.number = TI->first;
+		E.kind = kind;
+		E.category = info.group;
+		E.id = (int)entries.size();
+		E.h = 24;
 
-		scroll->Add(item);
+		entries.push_back(E);
 	}
 }
 
@@ -890,11 +1270,6 @@ void UI_Browser_Box::Populate_LineTypes()
 {
 	std::map<int, linetype_t>::iterator TI;
 
-	int y = scroll->y();
-
-	int mx = scroll->x() + SBAR_W;
-	int mw = scroll->w() - SBAR_W;
-
 	char full_desc[256];
 
 	for (TI = inst.conf.line_types.begin() ; TI != inst.conf.line_types.end() ; TI++)
@@ -904,12 +1279,16 @@ void UI_Browser_Box::Populate_LineTypes()
 		snprintf(full_desc, sizeof(full_desc), "%3d/ %s", TI->first,
 				 TidyLineDesc(info.desc.c_str()).c_str());
 
-		Browser_Item *item = new Browser_Item(inst, mx, y, mw, 24, full_desc, "",
-											  TI->first, kind, info.group);
+		Browser_Entry E;
 
-		item->button->callback(Browser_Item::line_callback, item);
+		E.desc = full_desc;
+		E.number = TI->first;
+		E.kind = kind;
+		E.category = info.group;
+		E.id = (int)entries.size();
+		E.h = 24;
 
-		scroll->Add(item);
+		entries.push_back(E);
 	}
 }
 
@@ -918,11 +1297,6 @@ void UI_Browser_Box::Populate_SectorTypes()
 {
 	std::map<int, sectortype_t>::iterator TI;
 
-	int y = scroll->y();
-
-	int mx = scroll->x() + SBAR_W;
-	int mw = scroll->w() - SBAR_W;
-
 	char full_desc[256];
 
 	for (TI = inst.conf.sector_types.begin() ; TI != inst.conf.sector_types.end() ; TI++)
@@ -931,24 +1305,35 @@ void UI_Browser_Box::Populate_SectorTypes()
 
 		snprintf(full_desc, sizeof(full_desc), "%3d/ %s", TI->first, info.desc.c_str());
 
-		Browser_Item *item = new Browser_Item(inst, mx, y, mw, 24, full_desc, "",
-											  TI->first, kind, 0 /* cat */);
+		Browser_Entry E;
 
-		item->button->callback(Browser_Item::sector_callback, item);
+		E.desc = full_desc;
+		E.number = TI->first;
+		E.kind = kind;
+		E.category = 0;
+		E.id = (int)entries.size();
+		E.h = 24;
 
-		scroll->Add(item);
+		entries.push_back(E);
 	}
 }
 
 
 void UI_Browser_Box::Populate()
 {
+	// the entries and their sizes may change
+	WaitThumbnails();
+
+	thumbs.clear();
+
 	// delete existing ones
 	scroll->Remove_all();
 
+	items.clear();
+	entries.clear();
+
 	// default background and scroll rate
 	scroll->color(WINDOW_BG, WINDOW_BG);
-	scroll->resize_horiz(true);
 	scroll->Line_size(24 * 2);
 
 	// handle changes to combine-tex preference
@@ -1004,7 +1389,7 @@ void UI_Browser_Box::Populate()
 
 	RecentUpdate();
 
-	// this calls Filter to reposition the widgets
+	// this calls Filter to lay out the entries
 	Sort();
 }
 
@@ -1017,6 +1402,9 @@ void UI_Browser_Box::SetCategories(const SString &cats, const SString &letters)
 	category->add(cats.c_str());
 	category->value(0);
 
+	// the letters may differ, so do a full filter next time
+	filter_category = -1;
+
 	redraw();
 }
 
@@ -1089,17 +1477,14 @@ void UI_Browser_Box::JumpToTex(const char *tex_name)
 	if (!isGraphicsMode(kind))
 		return;
 
-	for (int i = 0 ; i < scroll->Children() ; i++)
+	for (const Browser_Entry &E : entries)
 	{
-		Browser_Item *item = (Browser_Item *)scroll->Child(i);
-
-		// REVIEW THIS
-		if (! item->visible())
+		if (! E.shown)
 			continue;
 
-		if (item->MatchName(tex_name))
+		if (E.MatchName(tex_name))
 		{
-			scroll->JumpToChild(i);
+			scroll->JumpToPos(E.y);
 			break;
 		}
 	}
@@ -1111,17 +1496,14 @@ void UI_Browser_Box::JumpToValue(int value)
 	if (isGraphicsMode(kind))
 		return;
 
-	for (int i = 0 ; i < scroll->Children() ; i++)
+	for (const Browser_Entry &E : entries)
 	{
-		Browser_Item *item = (Browser_Item *)scroll->Child(i);
-
-		// REVIEW THIS
-		if (! item->visible())
+		if (! E.shown)
 			continue;
 
-		if (item->number == value)
+		if (E.number == value)
 		{
-			scroll->JumpToChild(i);
+			scroll->JumpToPos(E.y);
 			break;
 		}
 	}
@@ -1138,11 +1520,9 @@ void UI_Browser_Box::RecentUpdate()
 {
 	bool changes = false;
 
-	for (int i = 0 ; i < scroll->Children() ; i++)
+	for (Browser_Entry &E : entries)
 	{
-		Browser_Item *item = (Browser_Item *)scroll->Child(i);
-
-		if (Recent_UpdateItem(item))
+		if (Recent_UpdateItem(E))
 			changes = true;
 	}
 
@@ -1618,6 +1998,13 @@ UI_Browser::UI_Browser(Instance &inst, int X, int Y, int W, int H, const char *l
 }
 
 
+void UI_Browser::WaitThumbnails()
+{
+	for (int i = 0 ; i < 5 ; i++)
+		browsers[i]->WaitThumbnails();
+}
+
+
 void UI_Browser::Populate()
 {
 	for (int i = 0 ; i < 5 ; i++)
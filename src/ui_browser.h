@@ -21,11 +21,18 @@
 #ifndef __EUREKA_UI_BROWSER_H__
 #define __EUREKA_UI_BROWSER_H__
 
+#include "WadData.h"
+
+#include <future>
 #include <map>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 
 class Browser_Button;
+class Fl_Box;
 class Fl_Check_Button;
 class Fl_Choice;
 
@@ -43,43 +50,80 @@ enum class BrowserMode
 	toggle
 };
 
-class Browser_Item : public Fl_Group
+//
+// something which the browser can show.  only the entries in view
+// have a widget (a Browser_Item), which get reused when scrolling.
+//
+struct Browser_Entry
 {
-private:
-
-public:
 	SString desc;
 	SString real_name;	// for textures and flats only
 
-	int number;
+	int number = 0;
 
-	BrowserMode kind;  // generally matches browser kind: T/F/O/S/L
-	char category;
+	BrowserMode kind = BrowserMode::invalid;  // generally matches browser kind: T/F/O/S/L
+	char category = 0;
 
 	int recent_idx = -2;
 
+	// stays with the entry when sorting, it ties a widget to it
+	int id = 0;
+
+	// size of the picture, only used in picture mode
+	int pic_w = 0;
+	int pic_h = 0;
+
+	// whether it matches the search, and its place in the list
+	bool shown = false;
+
+	int x = 0, y = 0;
+	int w = 0, h = 0;
+
+	bool MatchName(const char *name) const;
+};
+
+
+// thumbnails of the picture entries by entry id, each the size of the
+// entry's picture.  A null one means the image could not be made.
+typedef std::unordered_map<int, std::unique_ptr<byte[]>> thumbnail_map_t;
+
+
+class Browser_Item : public Fl_Group
+{
+private:
+
+public:
+	int number = 0;
+
+	BrowserMode kind = BrowserMode::invalid;
+
+	// id of the entry being shown, -1 for none
+	int entry_id = -1;
+
 	Browser_Button * button = nullptr;
 
 	UI_Pic *pic = nullptr;
+	Fl_Box *pic_label = nullptr;
+
 	SString mPicCallbackString;	// optional, storage for callback data string
 
 	Instance &inst;
 
 public:
 	// this constructor makes a simple text button
-	Browser_Item(Instance &inst, int X, int Y, int W, int H,
-	             const SString &_desc, const SString &_realname,
-				 int _num, BrowserMode _kind, char _category);
+	Browser_Item(Instance &inst, int X, int Y, int W, int H);
 
 	// this constructor makes a picture with a text label below it
-	Browser_Item(Instance &inst, int X, int Y, int W, int H,
-				 const SString &_desc, const SString &_realname,
-				 int _num, BrowserMode _kind, char _category,
-	             int pic_w, int pic_h, UI_Pic *_pic);
+	Browser_Item(Instance &inst, int X, int Y, int W, int H, UI_Pic *_pic);
 
 	virtual ~Browser_Item();
 
-	bool MatchName(const char *name) const;
+	// moves the widget to the place of the entry
+	void Place(const Browser_Entry &entry, int X, int Y);
+
+	// makes the widget show the entry, Place() must be called first.
+	// pictures not in 'thumbs' are left to be made later.
+	void Bind(const Browser_Entry &entry, const thumbnail_map_t &thumbs);
 
 	//
 	// Assigns the given string and returns the pointer to it (can't be const due to void*)
@@ -117,15 +161,60 @@ private:
 
 	bool pic_mode;
 
+	// everything which can be shown, in the sorted order
+	std::vector<Browser_Entry> entries;
+
+	// the entries which match the search, in order, and the rows
+	// they are laid out in.  first is an index into 'layout'.
+	struct layout_row_t
+	{
+		int first;
+		int y, h;
+	};
+
+	std::vector<int> layout;
+	std::vector<layout_row_t> layout_rows;
+
+	// the widgets, only enough to cover the view (and a bit more)
+	std::vector<Browser_Item *> items;
+
+	// the thumbnails made so far, kept until the next Populate()
+	thumbnail_map_t thumbs;
+
+	// a thumbnail being made by the job on the worker threads
+	struct thumb_request_t
+	{
+		int id;
+		BrowserMode kind;
+		SString name;
+		int w, h;
+
+		std::unique_ptr<byte[]> rgb;
+	};
+
+	// only the job uses these while it runs
+	std::vector<thumb_request_t> thumb_requests;
+	std::vector<SString> thumb_messages;
+
+	std::future<void> thumb_job;
+
 	SString cat_letters;
 
+	// the search settings used by the last Filter(), so that a search
+	// which has only been extended can skip items which did not match.
+	SString filter_pattern;
+	int filter_category = -1;
+	int filter_combine  = -1;
+
 	Instance &inst;
 
 public:
 	UI_Browser_Box(Instance &inst, int X, int Y, int W, int H, const char *label, BrowserMode _kind);
+	virtual ~UI_Browser_Box();
 
-	/* FLTK method */
+	/* FLTK methods */
 	void resize(int X, int Y, int W, int H);
+	void draw();
 
 public:
 	void Populate();
@@ -139,6 +228,10 @@ public:
 
 	BrowserMode GetKind() const { return kind; }
 
+	// finishes making the thumbnails in progress.  Must be done before
+	// the textures and flats are loaded again.
+	void WaitThumbnails();
+
 	// ensure the given texture or type/special is visible
 	void JumpToTex(const char *tex_name);
 	void JumpToValue(int value);
@@ -149,22 +242,37 @@ public:
 	void WriteUser(std::ostream &os);
 
 private:
-	// adjust the widgets in the Fl_Scroll based on current search
+	// decide which entries are shown, based on current search
 	// parameters.  Returns true if something changed.
 	bool Filter(bool force_update = false);
 
+	// compute the place of each shown entry, then update the widgets.
+	void Layout(bool to_top);
+
+	// give the entries in (or near) the view a widget.
+	void PlaceItems();
+
+	Browser_Item *NewItem();
+
 	void Sort();
 
-	bool SearchMatch(Browser_Item *item) const;
+	// pattern is the prepared glob, NULL when nothing can match.
+	bool SearchMatch(const Browser_Entry &E, const char *pattern, bool negated) const;
 
-	void Populate_Images(BrowserMode imkind, const std::map<SString, Img_c *> & img_list);
+	// the deferred pictures of the widgets are made by a job on the
+	// worker threads once they are drawn, a timeout picks them up.
+	bool NeedThumbnails() const;
+	void StartThumbnails();
+	void FinishThumbnails();
+
+	void Populate_Images(BrowserMode imkind, const image_map_t & img_list);
 	void Populate_Sprites();
 
 	void Populate_ThingTypes();
 	void Populate_LineTypes();
 	void Populate_SectorTypes();
 
-	bool Recent_UpdateItem(Browser_Item *item);
+	bool Recent_UpdateItem(Browser_Entry &E);
 
 	bool CategoryByLetter(char letter);
 
@@ -174,6 +282,9 @@ private:
 	static void   hide_callback(Fl_Widget *w, void *data);
 	static void  repop_callback(Fl_Widget *w, void *data);
 	static void   sort_callback(Fl_Widget *w, void *data);
+	static void scroll_callback(Fl_Widget *w, void *data);
+
+	static void thumbs_callback(void *data);
 };
 
 
@@ -248,6 +359,9 @@ public:
 public:
 	void Populate();
 
+	// see UI_Browser_Box::WaitThumbnails()
+	void WaitThumbnails();
+
 	void SetActive(int new_active);
 
 	BrowserMode GetMode() const;
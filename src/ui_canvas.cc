@@ -420,6 +420,8 @@ void UI_Canvas::DrawMap()
 
 	if (inst.edit.sector_render_mode && ! inst.edit.error_mode)
 	{
+		prepared_flats = false;
+
 		for (int n = 0 ; n < inst.level.numSectors(); n++)
 			RenderSector(n);
 	}
@@ -1042,6 +1044,23 @@ void UI_Canvas::DrawThingSprites()
 }
 
 
+#ifdef NO_OPENGL
+//
+// which mip level of an image to draw with, when each screen pixel
+// covers 'step' texels.
+//
+static int MipLevelForStep(double step)
+{
+	int level = 0;
+
+	for (; step >= 2.0 && level < 6 ; step *= 0.5)
+		level++;
+
+	return level;
+}
+#endif
+
+
 void UI_Canvas::RenderSprite(int sx, int sy, float scale, Img_c *img)
 {
 	int W = img->width();
@@ -1072,6 +1091,12 @@ void UI_Canvas::RenderSprite(int sx, int sy, float scale, Img_c *img)
 	if (rx1 >= rx2 || ry1 >= ry2)
 		return;
 
+	// when shrinking a lot, sample a smaller copy of the sprite
+	const Img_c *mip = img->mip_level(inst.wad.palette, MipLevelForStep((double)W / (bx2 - bx1)));
+
+	W = mip->width();
+	H = mip->height();
+
 	for (int ry = ry1 ; ry <= ry2 ; ry++)
 	{
 		byte *dest = rgb_buf + 3 * (rx1 + ry * rgb_w);
@@ -1084,7 +1109,7 @@ void UI_Canvas::RenderSprite(int sx, int sy, float scale, Img_c *img)
 			ix = clamp(0, ix, W - 1);
 			iy = clamp(0, iy, H - 1);
 
-			img_pixel_t pix = img->buf()[iy * W + ix];
+			img_pixel_t pix = mip->buf()[iy * W + ix];
 
 			if (pix != TRANS_PIXEL)
 			{
@@ -2261,10 +2286,15 @@ void UI_Canvas::RenderSector(int num)
 	}
 
 #ifdef NO_OPENGL
-	int tw = img ? img->width()  : 1;
-	int th = img ? img->height() : 1;
+	// when zoomed out, sample a smaller copy of the flat
+	int mip_level = MipLevelForStep(1.0 / grid.Scale);
+
+	const Img_c *mip = img ? img->mip_level(inst.wad.palette, mip_level) : NULL;
 
-	const img_pixel_t *src_pix = img ? img->buf() : NULL;
+	int tw = mip ? mip->width()  : 1;
+	int th = mip ? mip->height() : 1;
+
+	const img_pixel_t *src_pix = mip ? mip->buf() : NULL;
 
 	for (unsigned int i = 0 ; i < subdiv->polygons.size() ; i++)
 	{
@@ -2341,7 +2371,7 @@ void UI_Canvas::RenderSector(int num)
 
 			// the logic here for non-64x64 textures matches the software
 			// 3D renderer, but is different than ZDoom (which scales them).
-			int ty = (0 - (int)MAPY(y)) & (th - 1);
+			int ty = ((0 - (int)MAPY(y)) >> mip_level) & (th - 1);
 
 			if (light_and_tex)
 			{
@@ -2351,7 +2381,7 @@ void UI_Canvas::RenderSector(int num)
 
 				for (; dest < dest_end ; dest += 3, x++)
 				{
-					int tx = (int)MAPX(x) & (tw - 1);
+					int tx = ((int)MAPX(x) >> mip_level) & (tw - 1);
 
 					img_pixel_t pix = src_pix[ty * tw + tx];
 
@@ -2366,7 +2396,7 @@ void UI_Canvas::RenderSector(int num)
 			{
 				for (; dest < dest_end ; dest += 3, x++)
 				{
-					int tx = (int)MAPX(x) & (tw - 1);
+					int tx = ((int)MAPX(x) >> mip_level) & (tw - 1);
 
 					img_pixel_t pix = src_pix[ty * tw + tx];
 
@@ -2389,6 +2419,14 @@ void UI_Canvas::RenderSector(int num)
 
 		glAlphaFunc(GL_GREATER, 0.5);
 
+		// upload all the flats together when the first is missing, which
+		// is quicker than one by one as they scroll into view
+		if (img->gl_texture() == 0 && ! prepared_flats)
+		{
+			prepared_flats = true;
+			IM_PrepareLevelImages(inst, false, true);
+		}
+
 		img->bind_gl(inst.wad);
 	}
 	else
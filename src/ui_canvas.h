@@ -61,6 +61,9 @@ private:
 
 	bitvec_c seen_sectors;
 
+	// whether the level's flats were uploaded to OpenGL in this DrawMap()
+	bool prepared_flats = false;
+
 	// a copy of x() and y() for software renderer, 0 for OpenGL
 	int xx, yy;
 
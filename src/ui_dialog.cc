@@ -267,6 +267,12 @@ void DLG_ShowError(bool fatal, EUR_FORMAT_STRING(const char *msg), ...)
 	SString dialog_buffer = SString::vprintf(msg, arg_pt);
 	va_end (arg_pt);
 
+	if (global::batch_mode)
+	{
+		gLog.printf("%s: %s\n", fatal ? "Fatal error" : "Error", dialog_buffer.c_str());
+		return;
+	}
+
 	// handle error messages with a hyperlink at the end
 	SString linkTitle;
 	SString linkURL;
@@ -286,6 +292,12 @@ void DLG_Notify(EUR_FORMAT_STRING(const char *msg), ...)
 	SString dialog_buffer = SString::vprintf(msg, arg_pt);
 	va_end (arg_pt);
 
+	if (global::batch_mode)
+	{
+		gLog.printf("Notification: %s\n", dialog_buffer.c_str());
+		return;
+	}
+
 	DialogShowAndRun(MessageBoxIcon::information, dialog_buffer, "Eureka - Notification");
 }
 
@@ -298,6 +310,14 @@ int DLG_Confirm(const std::vector<SString>& buttons, EUR_FORMAT_STRING(const cha
 	SString dialog_buffer = SString::vprintf(msg, arg_pt);
 	va_end (arg_pt);
 
+	// nobody to ask in batch mode, so take the first choice
+	if (global::batch_mode)
+	{
+		gLog.printf("Confirmation: %s\n--> %s\n", dialog_buffer.c_str(),
+					buttons.empty() ? "OK" : buttons[0].c_str());
+		return 0;
+	}
+
 	return DialogShowAndRun(MessageBoxIcon::question, dialog_buffer, "Eureka - Confirmation",
 							NULL, NULL, &buttons);
 }
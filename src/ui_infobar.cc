@@ -493,6 +493,14 @@ void UI_StatusBar::draw()
 		IB_Coord(cx, cy, "x", mx);
 		IB_Coord(cx, cy, "y", my);
 		cx += 10;
+
+		int problems = inst.level.checks.liveProblemCount();
+
+		if (problems >= 0)
+		{
+			IB_Number(cx, cy, "problems", problems, 3);
+			cx += 10;
+		}
 #if 0
 		IB_Number(cx, cy, "gamma", usegamma, 1);
 		cx += 10;
@@ -38,7 +38,7 @@
 //
 UI_Pic::UI_Pic(Instance &inst, int X, int Y, int W, int H, const char *L) :
 	Fl_Box(FL_BORDER_BOX, X, Y, W, H, ""),
-	rgb(NULL), special(SP_None),
+	rgb(NULL), special(SP_None), deferred_kind(0),
 	allow_hl(false),
 	highlighted(false),
 	selected(false), inst(inst)
@@ -60,6 +60,9 @@ void UI_Pic::Clear()
 {
 	special = SP_None;
 
+	deferred_name.clear();
+	deferred_kind = 0;
+
 	color(FL_DARK2);
 	labelcolor(what_color);
 	labelsize(16);
@@ -148,6 +151,51 @@ void UI_Pic::GetTex(const SString & tname)
 }
 
 
+void UI_Pic::DeferFlat(const SString & fname)
+{
+	Clear();
+
+	deferred_name = fname;
+	deferred_kind = 'F';
+}
+
+
+void UI_Pic::DeferTex(const SString & tname)
+{
+	Clear();
+
+	deferred_name = tname;
+	deferred_kind = 'T';
+}
+
+
+void UI_Pic::Resolve()
+{
+	if (! Deferred())
+		return;
+
+	SString name = deferred_name;
+
+	if (deferred_kind == 'F')
+		GetFlat(name);
+	else
+		GetTex(name);
+}
+
+
+void UI_Pic::ShowRGB(const byte *buf)
+{
+	Clear();
+
+	size_t size = (size_t)w() * (size_t)h() * 3;
+
+	byte *copy = new byte[size];
+	memcpy(copy, buf, size);
+
+	UploadRGB(copy, 3);
+}
+
+
 void UI_Pic::GetSprite(int type, Fl_Color back_color)
 {
 	Clear();
@@ -250,13 +298,15 @@ void UI_Pic::TiledImg(Img_c *img)
 		return;
 	}
 
+	UploadRGB(TiledRGB(inst.wad.palette, img, w(), h()), 3);
+}
+
 
+byte * UI_Pic::TiledRGB(const Palette &pal, const Img_c *img, int nw, int nh)
+{
 	int iw = img->width();
 	int ih = img->height();
 
-	int nw = w();
-	int nh = h();
-
 	int scale = 1;
 
 	while (nw*scale < iw || nh*scale < ih)
@@ -286,11 +336,11 @@ void UI_Pic::TiledImg(Img_c *img)
 		}
 		else
 		{
-			inst.wad.palette.decodePixelMedium(pix, dest[0], dest[1], dest[2]);
+			pal.decodePixelMedium(pix, dest[0], dest[1], dest[2]);
 		}
 	}
 
-	UploadRGB(buf, 3);
+	return buf;
 }
 
 
@@ -25,6 +25,7 @@
 #include "FL/Fl_Input.H"
 
 class Img_c;
+class Palette;
 
 
 class UI_Pic : public Fl_Box
@@ -42,6 +43,11 @@ private:
 
 	int special;
 
+	// name of a picture made later by Resolve(), and whether it is a
+	// flat ('F') or texture ('T'), 0 when nothing is deferred.
+	SString deferred_name;
+	char    deferred_kind;
+
 	bool allow_hl;
 
 	bool highlighted;
@@ -69,6 +75,21 @@ public:
 	void GetTex (const SString & tname);
 	void GetSprite(int type, Fl_Color back_color);
 
+	// like GetFlat() and GetTex(), but the picture is only made when
+	// Resolve() is called, e.g. once it has been scrolled into view.
+	void DeferFlat(const SString & fname);
+	void DeferTex (const SString & tname);
+
+	bool Deferred() const { return deferred_kind != 0; }
+	void Resolve();
+
+	// shows a copy of a thumbnail made by TiledRGB() for this size.
+	void ShowRGB(const byte *buf);
+
+	// makes a thumbnail of the image, tiled or shrunk to the given size.
+	// only reads the image and palette, so it is safe on a worker thread.
+	static byte *TiledRGB(const Palette &pal, const Img_c *img, int nw, int nh);
+
 	void AllowHighlight(bool enable) { allow_hl = enable; redraw(); }
 	bool Highlighted() const { return allow_hl && highlighted; }
 	void Unhighlight();
@@ -42,6 +42,7 @@ UI_Scroll::UI_Scroll(int X, int Y, int W, int H, int _bar_side) :
 		Fl_Group(X, Y, W, H, NULL),
 		bar_side(_bar_side),
 		resize_horiz_(false),
+		virtual_(false),
 		top_y(0), bottom_y(0)
 {
 	end();
@@ -90,7 +91,13 @@ void UI_Scroll::resize(int X, int Y, int W, int H)
 
 	int total_h = bottom_y - top_y;
 
-	scrollbar->value(0, h(), 0, std::max(h(), total_h));
+	// a virtual list keeps its place, the owner lays it out again
+	int pos = 0;
+
+	if (virtual_)
+		pos = std::max(0, std::min(scrollbar->value(), total_h - h()));
+
+	scrollbar->value(pos, h(), 0, std::max(h(), total_h));
 
 
 	if (ow != W && resize_horiz_)
@@ -135,6 +142,10 @@ void UI_Scroll::do_scroll()
 
 void UI_Scroll::calc_extents()
 {
+	// the extents were given to Virtual_height()
+	if (virtual_)
+		return;
+
 	if (Children() == 0)
 	{
 		top_y = bottom_y = 0;
@@ -159,6 +170,12 @@ void UI_Scroll::calc_extents()
 
 void UI_Scroll::reposition_all(int start_y)
 {
+	if (virtual_)
+	{
+		do_callback();
+		return;
+	}
+
 	for (int i = 0 ; i < Children() ; i++)
 	{
 		Fl_Widget * w = Child(i);
@@ -225,6 +242,31 @@ void UI_Scroll::JumpToChild(int i)
 }
 
 
+void UI_Scroll::Virtual_height(int total_h, int pos)
+{
+	virtual_ = true;
+
+	top_y    = 0;
+	bottom_y = total_h;
+
+	pos = std::max(0, std::min(pos, total_h - h()));
+
+	scrollbar->value(pos, h(), 0, std::max(h(), total_h));
+}
+
+
+int UI_Scroll::Position() const
+{
+	return scrollbar->value();
+}
+
+
+void UI_Scroll::JumpToPos(int pos)
+{
+	ScrollByPixels(pos - scrollbar->value());
+}
+
+
 //------------------------------------------------------------------------
 //
 //  PASS-THROUGHS
@@ -35,6 +35,10 @@ private:
 
 	bool resize_horiz_;
 
+	// in virtual mode the children are not moved when scrolling,
+	// the callback is done instead and the owner places them.
+	bool virtual_;
+
 	int top_y, bottom_y;
 
 public:
@@ -74,6 +78,16 @@ public:
 	// as possible.
 	void JumpToChild(int i);
 
+	// switches to virtual mode, where the list is total_h pixels high
+	// but only the widgets in view exist.  pos is the new position,
+	// it does not cause a callback.
+	void Virtual_height(int total_h, int pos);
+
+	// the current position, in pixels from the top of the list.
+	int Position() const;
+
+	void JumpToPos(int pos);
+
 private:
 	void ScrollByPixels(int pixels);
 
@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------
+//  IMAGE DISK CACHE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "Errors.h"
+#include "main.h"
+
+#include "SafeOutFile.h"
+#include "im_img.h"
+#include "w_imgcache.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+//
+// File layout, all values are little-endian:
+//
+//   header : magic (8 bytes), version, number of images
+//   index  : key low, key high, width, height, offset of the pixels
+//   pixels : width * height 16-bit pixels for each image
+//
+static const char CACHE_MAGIC[8] = { 'E','u','r','e','k','a','I','C' };
+static const u32_t CACHE_VERSION = 1;
+
+static const int HEADER_SIZE = 16;
+static const int INDEX_ENTRY_SIZE = 20;
+
+// larger ones are surely broken
+static const int MAX_IMAGE_SIZE = 8192;
+
+
+static u32_t ReadU32(const byte *p)
+{
+	return (u32_t)p[0] | ((u32_t)p[1] << 8) | ((u32_t)p[2] << 16) | ((u32_t)p[3] << 24);
+}
+
+static void WriteU32(byte *p, u32_t value)
+{
+	p[0] = (byte)value;
+	p[1] = (byte)(value >> 8);
+	p[2] = (byte)(value >> 16);
+	p[3] = (byte)(value >> 24);
+}
+
+
+void ImageDiskCache::open(const SString &filename)
+{
+	close();
+
+	mFilename = filename;
+
+	mFile = fopen(filename.c_str(), "rb");
+	if (! mFile)
+		return;
+
+	if (! readIndex())
+	{
+		gLog.printf("Ignoring broken image cache: %s\n", filename.c_str());
+		fclose(mFile);
+		mFile = nullptr;
+		mIndex.clear();
+		return;
+	}
+
+	gLog.printf("Image cache has %d images: %s\n", (int)mIndex.size(), filename.c_str());
+}
+
+
+void ImageDiskCache::close()
+{
+	if (mFile)
+	{
+		fclose(mFile);
+		mFile = nullptr;
+	}
+
+	mIndex.clear();
+	mFilename.clear();
+}
+
+
+bool ImageDiskCache::readIndex()
+{
+	if (fseek(mFile, 0, SEEK_END) != 0)
+		return false;
+
+	long file_size = ftell(mFile);
+
+	if (file_size < HEADER_SIZE || fseek(mFile, 0, SEEK_SET) != 0)
+		return false;
+
+	byte header[HEADER_SIZE];
+
+	if (fread(header, HEADER_SIZE, 1, mFile) != 1)
+		return false;
+
+	if (memcmp(header, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 ||
+		ReadU32(header + 8) != CACHE_VERSION)
+		return false;
+
+	u32_t count = ReadU32(header + 12);
+
+	if (count > (u32_t)(file_size - HEADER_SIZE) / INDEX_ENTRY_SIZE)
+		return false;
+
+	if (count == 0)
+		return true;
+
+	std::vector<byte> index((size_t)count * INDEX_ENTRY_SIZE);
+
+	if (fread(index.data(), index.size(), 1, mFile) != 1)
+		return false;
+
+	for (u32_t i = 0 ; i < count ; i++)
+	{
+		const byte *entry = index.data() + (size_t)i * INDEX_ENTRY_SIZE;
+
+		uint64_t key = ReadU32(entry) | ((uint64_t)ReadU32(entry + 4) << 32);
+
+		Record rec;
+		rec.width  = (int)ReadU32(entry + 8);
+		rec.height = (int)ReadU32(entry + 12);
+		rec.offset = ReadU32(entry + 16);
+
+		if (rec.width <= 0 || rec.width > MAX_IMAGE_SIZE ||
+			rec.height <= 0 || rec.height > MAX_IMAGE_SIZE)
+			return false;
+
+		long end = (long)rec.offset + (long)rec.width * rec.height * (long)sizeof(u16_t);
+
+		if (end > file_size)
+			return false;
+
+		mIndex[key] = rec;
+	}
+
+	return true;
+}
+
+
+Img_c *ImageDiskCache::find(uint64_t key) const
+{
+	auto it = mIndex.find(key);
+	if (it == mIndex.end())
+		return NULL;
+
+	const Record &rec = it->second;
+
+	std::vector<u16_t> raw((size_t)rec.width * rec.height);
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		if (! mFile || fseek(mFile, (long)rec.offset, SEEK_SET) != 0 ||
+			fread(raw.data(), sizeof(u16_t), raw.size(), mFile) != raw.size())
+		{
+			return NULL;
+		}
+	}
+
+	Img_c *img = new Img_c(rec.width, rec.height);
+
+	img_pixel_t *dest = img->wbuf();
+
+	for (size_t i = 0 ; i < raw.size() ; i++)
+		dest[i] = LE_U16(raw[i]);
+
+	return img;
+}
+
+
+void ImageDiskCache::save(const std::vector<std::pair<uint64_t, const Img_c *>> &images, size_t limit)
+{
+	if (! isOpen())
+		return;
+
+	// the offsets in the file are 32 bits
+	limit = std::min(limit, (size_t)0x7FFFFFFF);
+
+	struct Item
+	{
+		uint64_t key;
+		Record rec;
+		const Img_c *img;	// NULL when the pixels are in the old file
+	};
+
+	std::vector<Item> items;
+	std::unordered_set<uint64_t> keys;
+
+	size_t total = 0;
+
+	auto add = [&](uint64_t key, int width, int height, const Img_c *img)
+	{
+		size_t bytes = (size_t)width * height * sizeof(u16_t);
+
+		if (total + bytes > limit || ! keys.insert(key).second)
+			return false;
+
+		items.push_back({ key, { width, height, 0 }, img });
+		total += bytes;
+		return true;
+	};
+
+	for (const std::pair<uint64_t, const Img_c *> &P : images)
+		if (P.first != 0 && P.second)
+			add(P.first, P.second->width(), P.second->height(), P.second);
+
+	// then the previous ones, which were written the most recent first
+	std::vector<std::pair<uint64_t, Record>> old(mIndex.begin(), mIndex.end());
+
+	std::sort(old.begin(), old.end(),
+		[](const std::pair<uint64_t, Record> &A, const std::pair<uint64_t, Record> &B)
+		{
+			return A.second.offset < B.second.offset;
+		});
+
+	for (const std::pair<uint64_t, Record> &P : old)
+	{
+		if (keys.count(P.first))
+			continue;
+
+		if (! add(P.first, P.second.width, P.second.height, NULL))
+			break;
+
+		items.back().rec.offset = P.second.offset;
+	}
+
+	SafeOutFile sof(mFilename);
+
+	ReportedResult result = sof.openForWriting();
+
+	auto write = [&](const void *data, size_t size)
+	{
+		if (result.success)
+			result = sof.write(data, size);
+	};
+
+	byte header[HEADER_SIZE];
+
+	memcpy(header, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+	WriteU32(header + 8, CACHE_VERSION);
+	WriteU32(header + 12, (u32_t)items.size());
+
+	write(header, sizeof(header));
+
+	u32_t offset = HEADER_SIZE + (u32_t)items.size() * INDEX_ENTRY_SIZE;
+
+	for (const Item &item : items)
+	{
+		byte entry[INDEX_ENTRY_SIZE];
+
+		WriteU32(entry,      (u32_t)item.key);
+		WriteU32(entry + 4,  (u32_t)(item.key >> 32));
+		WriteU32(entry + 8,  (u32_t)item.rec.width);
+		WriteU32(entry + 12, (u32_t)item.rec.height);
+		WriteU32(entry + 16, offset);
+
+		write(entry, sizeof(entry));
+
+		offset += (u32_t)(item.rec.width * item.rec.height * sizeof(u16_t));
+	}
+
+	std::vector<u16_t> raw;
+
+	for (const Item &item : items)
+	{
+		raw.resize((size_t)item.rec.width * item.rec.height);
+
+		if (item.img)
+		{
+			const img_pixel_t *src = item.img->buf();
+
+			for (size_t i = 0 ; i < raw.size() ; i++)
+				raw[i] = LE_U16(src[i]);
+		}
+		else if (result.success)
+		{
+			if (fseek(mFile, (long)item.rec.offset, SEEK_SET) != 0 ||
+				fread(raw.data(), sizeof(u16_t), raw.size(), mFile) != raw.size())
+			{
+				result = { false, "could not read the old cache" };
+			}
+		}
+
+		write(raw.data(), raw.size() * sizeof(u16_t));
+	}
+
+	// the old file must be closed before it can be replaced
+	if (mFile)
+	{
+		fclose(mFile);
+		mFile = nullptr;
+	}
+
+	if (result.success)
+		result = sof.commit();
+
+	if (! result.success)
+		gLog.printf("Failed writing image cache '%s': %s\n", mFilename.c_str(), result.message.c_str());
+
+	close();
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
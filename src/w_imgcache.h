@@ -0,0 +1,96 @@
+//------------------------------------------------------------------------
+//  IMAGE DISK CACHE
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef __EUREKA_W_IMGCACHE_H__
+#define __EUREKA_W_IMGCACHE_H__
+
+#include "m_strings.h"
+#include "sys_type.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class Img_c;
+
+//
+// Decoded images kept in a file between runs, so that the textures which
+// are slow to make (composed from patches, or PNG and JPEG) only need to
+// be made once.
+//
+// Each image is stored under a key which is a checksum of everything its
+// pixels were made from, so stale ones are simply never asked for again.
+// The file is an index followed by the raw pixels, and only the index is
+// read when opening it.
+//
+class ImageDiskCache
+{
+public:
+	~ImageDiskCache()
+	{
+		if (mFile)
+			fclose(mFile);
+	}
+
+	// uses the given file, forgetting any previous one.  A missing or
+	// broken file just leaves the cache empty.
+	void open(const SString &filename);
+	void close();
+
+	bool isOpen() const
+	{
+		return ! mFilename.empty();
+	}
+
+	// reads the image stored under the key, NULL if there is none.
+	// Can be called by any thread.
+	Img_c *find(uint64_t key) const;
+
+	// rewrites the file with the given images, followed by the previously
+	// stored ones while the total fits in 'limit' bytes, then closes it.
+	void save(const std::vector<std::pair<uint64_t, const Img_c *>> &images, size_t limit);
+
+private:
+	struct Record
+	{
+		int width;
+		int height;
+		u32_t offset;	// of the pixels in the file
+	};
+
+	bool readIndex();
+
+	SString mFilename;
+	FILE *mFile = nullptr;
+
+	std::unordered_map<uint64_t, Record> mIndex;
+
+	// guards reading from mFile
+	mutable std::mutex mMutex;
+};
+
+#endif  /* __EUREKA_W_IMGCACHE_H__ */
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
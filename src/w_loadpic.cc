@@ -55,53 +55,115 @@ struct post_t
 #define P_SENTINEL  0xFF
 
 
-static void DrawColumn(const Palette &pal, const ConfigData &config,Img_c& img, const post_t *column, int x, int y)
+static int ReadS32(const byte *p)
 {
-	SYS_ASSERT(column);
+	return (s32_t)((u32_t)p[0] | ((u32_t)p[1] << 8) | ((u32_t)p[2] << 16) | ((u32_t)p[3] << 24));
+}
+
+
+std::unique_ptr<PatchImage> PatchImage::parse(Lump_c *lump, const SString &name)
+{
+	// this leaves the read position alone, so can be used by any thread
+	const byte *data = (const byte *)lump->getData();
+	int length = lump->Length();
+
+	std::unique_ptr<PatchImage> pic(new PatchImage);
 
-	int W = img.width();
-	int H = img.height();
+	pic->mWidth  = (s16_t)(data[0] | (data[1] << 8));
+	pic->mHeight = (s16_t)(data[2] | (data[3] << 8));
 
-	// clip horizontally
-	if (x < 0 || x >= W)
-		return;
+	pic->mColumns.reserve(pic->mWidth + 1);
 
-	while (column->topdelta != P_SENTINEL)
+	for (int x = 0 ; x < pic->mWidth ; x++)
 	{
-		int top = y + (int) column->topdelta;
-		int count = column->length;
+		int ofs_pos = 8 + 4 * x;
+		int offset  = (ofs_pos + 4 <= length) ? ReadS32(data + ofs_pos) : -1;
 
-		byte *src = (byte *) column + 3;
+		if (offset < 0 || offset >= length)
+		{
+			gLog.printf("WARNING: bad image offset 0x%08x in patch [%s]\n",
+			          offset, name.c_str());
+			pic->mBroken = true;
+			break;
+		}
 
-		img_pixel_t *dest = img.wbuf() + x;
+		pic->mColumns.push_back((int)pic->mPosts.size());
 
-		if (top < 0)
+		// a post which runs off the end of the lump ends the column
+		while (offset + 3 <= length && data[offset] != P_SENTINEL)
 		{
-			// The original DOOM did not honor negative y-offsets for
-			// patches but some ports like ZDoom do.
-			if (config.features.neg_patch_offsets)
-				src -= top;
-            count += top;
+			int count = data[offset + 1];
 
-			top = 0;
+			if (offset + 3 + count > length)
+				break;
+
+			pic->mPosts.push_back({ data[offset], count, (int)pic->mPixels.size() });
+			pic->mPixels.insert(pic->mPixels.end(), data + offset + 3, data + offset + 3 + count);
+
+			offset += count + 4;
 		}
+	}
 
-		if (top + count > H)
-			count = H - top;
+	pic->mColumns.push_back((int)pic->mPosts.size());
 
-		// copy the pixels, remapping any TRANS_PIXEL values
-		for (; count > 0; count--, top++)
+	return pic;
+}
+
+
+bool PatchImage::draw(const Palette &pal, const ConfigData &config, Img_c &dest, int x, int y) const
+{
+	int W = dest.width();
+	int H = dest.height();
+
+	byte trans = static_cast<byte>(pal.getTransReplace());
+
+	int num_columns = (int)mColumns.size() - 1;
+
+	for (int cx = 0 ; cx < num_columns ; cx++)
+	{
+		// clip horizontally
+		if (x + cx < 0 || x + cx >= W)
+			continue;
+
+		img_pixel_t *column = dest.wbuf() + x + cx;
+
+		for (int p = mColumns[cx] ; p < mColumns[cx + 1] ; p++)
 		{
-			byte pix = *src++;
+			const Post &post = mPosts[p];
 
-			if (pix == TRANS_PIXEL)
-				pix = static_cast<byte>(pal.getTransReplace());
+			int top   = y + post.top;
+			int count = post.length;
 
-			dest[top * W] = pix;
-		}
+			const byte *src = mPixels.data() + post.pixels;
+
+			if (top < 0)
+			{
+				// The original DOOM did not honor negative y-offsets for
+				// patches but some ports like ZDoom do.
+				if (config.features.neg_patch_offsets)
+					src -= top;
+				count += top;
 
-		column = (const post_t *) ((const byte *) column + column->length + 4);
+				top = 0;
+			}
+
+			if (top + count > H)
+				count = H - top;
+
+			// copy the pixels, remapping any TRANS_PIXEL values
+			for (; count > 0; count--, top++)
+			{
+				byte pix = *src++;
+
+				if (pix == TRANS_PIXEL)
+					pix = trans;
+
+				column[top * W] = pix;
+			}
+		}
 	}
+
+	return ! mBroken;
 }
 
 
@@ -262,60 +324,32 @@ bool LoadPicture(const Palette &pal, const ConfigData &config, Img_c& dest,
 
 	/* DOOM format */
 
-	std::vector<byte> raw_data;
-	W_LoadLumpData(lump, raw_data);
-
-	const patch_t *pat = (patch_t *) raw_data.data();
-
-	int width    = LE_S16(pat->width);
-	int height   = LE_S16(pat->height);
-//	int offset_x = LE_S16(pat->leftoffset);
-//	int offset_y = LE_S16(pat->topoffset);
+	std::unique_ptr<PatchImage> pic = PatchImage::parse(lump, pic_name);
 
 	// FIXME: validate values (in case we got flat data or so)
 
-	if (pic_width)  *pic_width  = width;
-	if (pic_height) *pic_height = height;
+	if (pic_width)  *pic_width  = pic->width();
+	if (pic_height) *pic_height = pic->height();
 
 	if (dest.is_null())
 	{
 		// our new image will be completely transparent
-		dest.resize (width, height);
-	}
-
-	for (int x = 0 ; x < width ; x++)
-	{
-		int offset = LE_S32(pat->columnofs[x]);
-
-		if (offset < 0 || offset >= lump->Length())
-		{
-			gLog.printf("WARNING: bad image offset 0x%08x in patch [%s]\n",
-			          offset, pic_name.c_str());
-			return false;
-		}
-
-		const post_t *column = (const post_t *) ((const byte *)pat + offset);
-
-		DrawColumn(pal, config, dest, column, pic_x_offset + x, pic_y_offset);
+		dest.resize (pic->width(), pic->height());
 	}
 
-	return true;
+	return pic->draw(pal, config, dest, pic_x_offset, pic_y_offset);
 }
 
 
 char W_DetectImageFormat(Lump_c *lump)
 {
-	byte header[20];
-
 	int length = lump->Length();
 
-	if (length < (int)sizeof(header))
+	if (length < 20)
 		return 0;
 
-	lump->Seek();
-
-	if (! lump->Read(header, (int)sizeof(header)))
-		return 0;
+	// this leaves the read position alone, so can be used by any thread
+	const byte *header = (const byte *)lump->getData();
 
 	// PNG is clearly marked in the header, so check it first.
 
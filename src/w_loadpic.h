@@ -30,6 +30,9 @@
 #include "im_img.h"
 #include "w_wad.h"
 
+#include <memory>
+#include <vector>
+
 
 // Determine the image format of the given wad lump.
 //
@@ -49,6 +52,43 @@ char W_DetectImageFormat(Lump_c *lump);
 Img_c *LoadImage_JPEG(Lump_c *lump, const SString &name);
 Img_c *LoadImage_PNG(Lump_c *lump, const SString &name);
 Img_c *LoadImage_TGA(Lump_c *lump, const SString &name);
+
+//
+// A DOOM format picture with its posts already parsed, so it can be
+// drawn many times without copying or walking the lump again.
+//
+class PatchImage
+{
+public:
+	// the lump must be in DOOM format (see W_DetectImageFormat)
+	static std::unique_ptr<PatchImage> parse(Lump_c *lump, const SString &name);
+
+	int width() const  { return mWidth; }
+	int height() const { return mHeight; }
+
+	// draws the picture into 'dest' with its top-left corner at (x, y).
+	// Returns false if some columns could not be read.
+	bool draw(const Palette &pal, const ConfigData &config, Img_c &dest, int x, int y) const;
+
+private:
+	struct Post
+	{
+		int top;
+		int length;
+		int pixels;   // index into mPixels
+	};
+
+	int mWidth = 0;
+	int mHeight = 0;
+
+	// posts of column x are mPosts[mColumns[x]] up to mPosts[mColumns[x+1]]
+	std::vector<int>  mColumns;
+	std::vector<Post> mPosts;
+	std::vector<byte> mPixels;
+
+	bool mBroken = false;
+};
+
 bool LoadPicture(const Palette &pal, const ConfigData &config, Img_c &dest, Lump_c *lump, const SString &pic_name, int pic_x_offset, int pic_y_offset, int *pic_width = nullptr, int *pic_height = nullptr);
 
 #endif  /* __EUREKA_W_LOADPIC_H__ */
@@ -30,27 +30,42 @@
 
 #include <map>
 #include <algorithm>
+#include <mutex>
 #include <string>
+#include <unordered_map>
 
+#include "lib_adler.h"
+#include "lib_threads.h"
+#include "m_config.h"
 #include "m_game.h"      /* yg_picture_format */
 #include "w_loadpic.h"
 #include "w_rawdef.h"
 #include "w_texture.h"
 
 
+// config item
+int config::image_cache_mb = 256;
+int config::image_disk_cache_mb = 128;
+
+
 //----------------------------------------------------------------------
 //    TEXTURE HANDLING
 //----------------------------------------------------------------------
 
 
-static void DeleteTex(const std::map<SString, Img_c *>::value_type& P)
+static size_t ImageBytes(const Img_c &img)
 {
-	delete P.second;
+	return (size_t)img.width() * (size_t)img.height() * sizeof(img_pixel_t);
 }
 
+
 void ImageSet::W_ClearTextures()
 {
-	std::for_each(textures.begin(), textures.end(), DeleteTex);
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	for (const image_map_t::value_type &P : textures)
+		if (P.second.img)
+			mDecodedBytes -= ImageBytes(*P.second.img);
 
 	textures.clear();
 
@@ -58,26 +73,289 @@ void ImageSet::W_ClearTextures()
 }
 
 
-void ImageSet::W_AddTexture(const SString &name, Img_c *img, bool is_medusa)
+void ImageSet::W_AddTexture(const SString &name, ImageEntry &&entry, bool is_medusa)
 {
-	// free any existing one with the same name
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
 
-	SString tex_str = name;
+	// replace any existing one with the same name
 
-	std::map<SString, Img_c *>::iterator P = textures.find(tex_str);
+	ImageEntry &dest = textures[name];
 
-	if (P != textures.end())
+	if (dest.img)
+		mDecodedBytes -= ImageBytes(*dest.img);
+
+	if (entry.img)
+		mDecodedBytes += ImageBytes(*entry.img);
+
+	dest = std::move(entry);
+
+	medusa_textures[name] = is_medusa ? 1 : 0;
+}
+
+
+//
+// Gets the pixels of a texture or flat, decoding them if needed
+//
+Img_c *ImageSet::decodeImage(const ConfigData &config, const ImageEntry &entry) const
+{
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	if (! entry.img && ! entry.failed && entry.decode)
 	{
-		delete P->second;
+		entry.img.reset(makeImage(config, entry, &entry.cacheKey));
 
-		P->second = img;
+		if (entry.img)
+			mDecodedBytes += ImageBytes(*entry.img);
+		else
+			entry.failed = true;
+	}
+
+	entry.lastUse = ++mUseClock;
+
+	return entry.img.get();
+}
+
+
+void ImageSet::decodeNamed(const ConfigData &config, const std::vector<SString> &tex_names,
+						   const std::vector<SString> &flat_names) const
+{
+	std::vector<const ImageEntry *> entries;
+
+	// same lookups as getTexture() and W_GetFlat()
+	auto add = [&](const image_map_t &list, const image_map_t &other, const SString &name)
+	{
+		image_map_t::const_iterator P = list.find(name);
+
+		if (P == list.end() && config.features.mix_textures_flats)
+		{
+			P = other.find(name);
+
+			if (P == other.end())
+				return;
+		}
+		else if (P == list.end())
+		{
+			return;
+		}
+
+		entries.push_back(&P->second);
+	};
+
+	for (const SString &name : tex_names)
+		add(textures, flats, name);
+
+	for (const SString &name : flat_names)
+		add(flats, textures, name);
+
+	decodeEntries(config, entries);
+}
+
+
+void ImageSet::decodeEntries(const ConfigData &config, const std::vector<const ImageEntry *> &entries) const
+{
+	std::vector<const ImageEntry *> todo;
+
+	{
+		std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+		for (const ImageEntry *entry : entries)
+			if (! entry->img && ! entry->failed && entry->decode)
+				todo.push_back(entry);
+	}
+
+	// the same image may have been asked for twice
+	std::sort(todo.begin(), todo.end());
+	todo.erase(std::unique(todo.begin(), todo.end()), todo.end());
+
+	if (todo.empty())
+		return;
+
+	// a few images per job, each job keeping its own messages
+	const int chunk_size = 32;
+	int num_chunks = ((int)todo.size() + chunk_size - 1) / chunk_size;
+
+	std::vector<std::unique_ptr<Img_c>> results(todo.size());
+	std::vector<uint64_t> keys(todo.size());
+	std::vector<std::vector<SString>> messages(num_chunks);
+
+	ThreadPool::shared().parallelFor(num_chunks, [&](int chunk)
+	{
+		LogCapture capture;
+
+		int last = std::min((int)todo.size(), (chunk + 1) * chunk_size);
+
+		for (int i = chunk * chunk_size ; i < last ; i++)
+			results[i].reset(makeImage(config, *todo[i], &keys[i]));
+
+		messages[chunk] = capture.messages();
+	});
+
+	// same order as decoding them one by one
+	for (const std::vector<SString> &chunk_messages : messages)
+		for (const SString &message : chunk_messages)
+			gLog.printf("%s", message.c_str());
+
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	for (size_t i = 0 ; i < todo.size() ; i++)
+		keepImage(*todo[i], std::move(results[i]), keys[i]);
+}
+
+
+void ImageSet::keepImage(const ImageEntry &entry, std::unique_ptr<Img_c> &&img, uint64_t key) const
+{
+	// another thread may have made it meanwhile
+	if (entry.img || entry.failed)
+		return;
+
+	if (img)
+	{
+		mDecodedBytes += ImageBytes(*img);
+		entry.img = std::move(img);
+		entry.cacheKey = key;
 	}
 	else
 	{
-		textures[tex_str] = img;
+		entry.failed = true;
+	}
+
+	entry.lastUse = ++mUseClock;
+}
+
+
+//
+// Like decodeImage(), but the image is made without holding the lock,
+// so it may be done on a worker thread.  The lock is held while 'func'
+// runs, so that trimDecodedImages() cannot drop the image meanwhile.
+//
+void ImageSet::useImage(const ConfigData &config, const ImageEntry *entry,
+						const std::function<void(const Img_c *img)> &func) const
+{
+	if (! entry)
+	{
+		func(NULL);
+		return;
+	}
+
+	bool need_decode;
+
+	{
+		std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+		need_decode = ! entry->img && ! entry->failed && entry->decode;
+	}
+
+	std::unique_ptr<Img_c> img;
+	uint64_t key = 0;
+
+	if (need_decode)
+		img.reset(makeImage(config, *entry, &key));
+
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	if (need_decode)
+		keepImage(*entry, std::move(img), key);
+
+	entry->lastUse = ++mUseClock;
+
+	func(entry->img.get());
+}
+
+
+Img_c *ImageSet::makeImage(const ConfigData &config, const ImageEntry &entry, uint64_t *key) const
+{
+	*key = 0;
+
+	if (entry.source && mDiskCache.isOpen())
+	{
+		crc32_c sum;
+		entry.source(config, sum);
+
+		*key = ((uint64_t)sum.extra << 32) | sum.raw;
+
+		Img_c *img = mDiskCache.find(*key);
+
+		// a different size means the checksums happened to collide
+		if (img && entry.width > 0 &&
+			(img->width() != entry.width || img->height() != entry.height))
+		{
+			delete img;
+			img = NULL;
+		}
+
+		if (img)
+			return img;
+
+		mDiskCacheChanged = true;
 	}
 
-	medusa_textures[tex_str] = is_medusa ? 1 : 0;
+	return entry.decode(config);
+}
+
+
+void ImageSet::openDiskCache(const SString &filename)
+{
+	mDiskCache.close();
+	mDiskCacheChanged = false;
+
+	if (config::image_disk_cache_mb > 0)
+		mDiskCache.open(filename);
+}
+
+
+void ImageSet::saveDiskCache()
+{
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	if (mDiskCacheChanged)
+	{
+		std::vector<std::pair<uint64_t, const Img_c *>> images;
+
+		for (const image_map_t *list : { &textures, &flats })
+			for (const image_map_t::value_type &P : *list)
+				if (P.second.img && P.second.cacheKey != 0)
+					images.emplace_back(P.second.cacheKey, P.second.img.get());
+
+		mDiskCache.save(images, (size_t)std::max(0, config::image_disk_cache_mb) << 20);
+	}
+
+	mDiskCache.close();
+	mDiskCacheChanged = false;
+}
+
+
+void ImageSet::trimDecodedImages() const
+{
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	size_t limit = (size_t)std::max(0, config::image_cache_mb) << 20;
+
+	if (mDecodedBytes <= limit)
+		return;
+
+	// the ones uploaded to OpenGL are kept, they get dropped along with
+	// their GL textures by W_UnloadAllTextures().
+	std::vector<const ImageEntry *> decoded;
+
+	for (const image_map_t *list : { &textures, &flats })
+		for (const image_map_t::value_type &P : *list)
+			if (P.second.img && P.second.decode && P.second.img->gl_texture() == 0)
+				decoded.push_back(&P.second);
+
+	std::sort(decoded.begin(), decoded.end(),
+		[](const ImageEntry *A, const ImageEntry *B)
+		{
+			return A->lastUse < B->lastUse;
+		});
+
+	for (const ImageEntry *entry : decoded)
+	{
+		if (mDecodedBytes <= limit)
+			break;
+
+		mDecodedBytes -= ImageBytes(*entry->img);
+		entry->img.reset();
+	}
 }
 
 
@@ -111,7 +389,212 @@ static bool CheckTexturesAreStrife(byte *tex_data, int tex_length, int num_tex,
 }
 
 
-static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, byte *tex_data, int tex_length, int offset,
+struct texture_patch_t
+{
+	SString name;
+	int x, y;
+};
+
+
+//
+// The patches used by the textures of one load, so that each one is
+// looked up, parsed and checksummed only once however many textures
+// share it.  It keeps the wads of that load open, since the textures
+// get composed later on, maybe after a wad has left the master dir.
+//
+class PatchCache
+{
+public:
+	explicit PatchCache(const std::vector<std::shared_ptr<Wad_file>> &wads) : mWads(wads)
+	{
+	}
+
+	// the lump of a patch, NULL if there is none
+	Lump_c *lookup(const SString &name);
+
+	// the parsed patch, NULL if it is not in DOOM format
+	const PatchImage *parse(Lump_c *lump, const SString &name);
+
+	// adds the contents of a patch to 'sum'
+	void addChecksum(const SString &name, crc32_c &sum);
+
+private:
+	// same order as the master dir, later ones tried first
+	const std::vector<std::shared_ptr<Wad_file>> mWads;
+
+	// textures get composed by several threads at once.  The work is done
+	// outside the lock, doing it twice in a race is harmless.
+	std::mutex mMutex;
+
+	std::unordered_map<SString, Lump_c *> mLumps;
+	std::unordered_map<const Lump_c *, std::shared_ptr<const PatchImage>> mImages;
+	std::unordered_map<const Lump_c *, crc32_c> mSums;
+};
+
+
+Lump_c *PatchCache::lookup(const SString &name)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto it = mLumps.find(name);
+		if (it != mLumps.end())
+			return it->second;
+	}
+
+	Lump_c *lump = NULL;
+
+	for (auto it = mWads.rbegin() ; it != mWads.rend() && ! lump ; ++it)
+		lump = (*it)->FindLumpInNamespace(name, WadNamespace::Global);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	return mLumps.emplace(name, lump).first->second;
+}
+
+
+const PatchImage *PatchCache::parse(Lump_c *lump, const SString &name)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto it = mImages.find(lump);
+		if (it != mImages.end())
+			return it->second.get();
+	}
+
+	std::shared_ptr<const PatchImage> image;
+
+	if (W_DetectImageFormat(lump) == 'd')
+		image = PatchImage::parse(lump, name);
+
+	std::lock_guard<std::mutex> lock(mMutex);
+
+	return mImages.emplace(lump, image).first->second.get();
+}
+
+
+void PatchCache::addChecksum(const SString &name, crc32_c &sum)
+{
+	Lump_c *lump = lookup(name);
+
+	if (! lump)
+	{
+		sum += (u8_t)0;
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		auto it = mSums.find(lump);
+		if (it != mSums.end())
+		{
+			sum += it->second.raw;
+			sum += it->second.extra;
+			return;
+		}
+	}
+
+	crc32_c lump_sum;
+	lump_sum.AddBlock((const u8_t *)lump->getData(), lump->Length());
+
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mSums.emplace(lump, lump_sum);
+	}
+
+	sum += lump_sum.raw;
+	sum += lump_sum.extra;
+}
+
+
+//
+// Adds the settings which change how pictures get decoded
+//
+static void AddDecodeSettings(const WadData &wad, const ConfigData &config, crc32_c &sum)
+{
+	sum += (u32_t)wad.palette.getTransReplace();
+	sum += (s32_t)config.features.neg_patch_offsets;
+}
+
+
+static Img_c *ComposeTexture(const WadData &wad, const ConfigData &config, PatchCache &cache,
+							 const SString &tex_name, int width, int height,
+							 const std::vector<texture_patch_t> &patches)
+{
+	Img_c *img = new Img_c(width, height, false);
+
+	for (const texture_patch_t &patch : patches)
+	{
+		Lump_c *lump = cache.lookup(patch.name);
+		const PatchImage *pic = lump ? cache.parse(lump, patch.name) : NULL;
+
+		bool ok;
+
+		if (pic)
+			ok = pic->draw(wad.palette, config, *img, patch.x, patch.y);
+		else
+			ok = lump && LoadPicture(wad.palette, config, *img, lump, patch.name, patch.x, patch.y);
+
+		if (! ok)
+		{
+			gLog.printf("texture '%s': patch '%s' not found.\n", tex_name.c_str(), patch.name.c_str());
+		}
+	}
+
+	return img;
+}
+
+
+//
+// Adds a texture made of patches, which get composed when it is used
+//
+static void AddPatchTexture(WadData &wad, const std::shared_ptr<PatchCache> &cache,
+							const char *raw_name, int width, int height,
+							std::vector<texture_patch_t> &&patches, bool is_medusa)
+{
+	char namebuf[16];
+	memcpy(namebuf, raw_name, 8);
+	namebuf[8] = 0;
+
+	SString tex_name = namebuf;
+
+	ImageEntry entry;
+	entry.width  = width;
+	entry.height = height;
+
+	const WadData *wad_p = &wad;
+
+	entry.decode = [wad_p, cache, tex_name, width, height, patches](const ConfigData &config)
+	{
+		return ComposeTexture(*wad_p, config, *cache, tex_name, width, height, patches);
+	};
+
+	entry.source = [wad_p, cache, tex_name, width, height, patches](const ConfigData &config, crc32_c &sum)
+	{
+		sum += "patches";
+		AddDecodeSettings(*wad_p, config, sum);
+
+		sum += tex_name;
+		sum += (u32_t)width;
+		sum += (u32_t)height;
+
+		for (const texture_patch_t &patch : patches)
+		{
+			sum += patch.name;
+			sum += (s32_t)patch.x;
+			sum += (s32_t)patch.y;
+
+			cache->addChecksum(patch.name, sum);
+		}
+	};
+
+	wad.images.W_AddTexture(tex_name, std::move(entry), is_medusa);
+}
+
+
+static void LoadTextureEntry_Strife(WadData &wad, const std::shared_ptr<PatchCache> &cache, byte *tex_data, int tex_length, int offset,
 									byte *pnames, int pname_size, bool skip_first)
 {
 	const raw_strife_texture_t *raw = (const raw_strife_texture_t *)(tex_data + offset);
@@ -125,7 +608,7 @@ static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, byte
 	if (width == 0 || height == 0)
 		FatalError("W_LoadTextures: Texture '%.8s' has zero size\n", raw->name);
 
-	Img_c *img = new Img_c(width, height, false);
+	std::vector<texture_patch_t> patches;
 	bool is_medusa = false;
 
 	// apply all the patches
@@ -158,25 +641,15 @@ static void LoadTextureEntry_Strife(WadData &wad, const ConfigData &config, byte
 		memcpy(picname, pnames + 8*pname_idx, 8);
 		picname[8] = 0;
 
-		Lump_c *lump = wad.master.W_FindGlobalLump(picname);
-
-		if (! lump ||
-			! LoadPicture(wad.palette, config, *img, lump, picname, xofs, yofs))
-		{
-			gLog.printf("texture '%.8s': patch '%.8s' not found.\n", raw->name, picname);
-		}
+		patches.push_back({ picname, xofs, yofs });
 	}
 
 	// store the new texture
-	char namebuf[16];
-	memcpy(namebuf, raw->name, 8);
-	namebuf[8] = 0;
-
-	wad.images.W_AddTexture(namebuf, img, is_medusa);
+	AddPatchTexture(wad, cache, raw->name, width, height, std::move(patches), is_medusa);
 }
 
 
-static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, byte *tex_data, int tex_length, int offset,
+static void LoadTextureEntry_DOOM(WadData &wad, const std::shared_ptr<PatchCache> &cache, byte *tex_data, int tex_length, int offset,
 									byte *pnames, int pname_size, bool skip_first)
 {
 	const raw_texture_t *raw = (const raw_texture_t *)(tex_data + offset);
@@ -190,7 +663,7 @@ static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, byte *
 	if (width == 0 || height == 0)
 		ThrowException("W_LoadTextures: Texture '%.8s' has zero size\n", raw->name);
 
-	Img_c *img = new Img_c(width, height, false);
+	std::vector<texture_patch_t> patches;
 	bool is_medusa = false;
 
 	// apply all the patches
@@ -225,25 +698,15 @@ static void LoadTextureEntry_DOOM(WadData &wad, const ConfigData &config, byte *
 		picname[8] = 0;
 
 //gLog.debugPrintf("-- %d patch [%s]\n", j, picname);
-		Lump_c *lump = wad.master.W_FindGlobalLump(picname);
-
-		if (! lump ||
-			! LoadPicture(wad.palette, config, *img, lump, picname, xofs, yofs))
-		{
-			gLog.printf("texture '%.8s': patch '%.8s' not found.\n", raw->name, picname);
-		}
+		patches.push_back({ picname, xofs, yofs });
 	}
 
 	// store the new texture
-	char namebuf[16];
-	memcpy(namebuf, raw->name, 8);
-	namebuf[8] = 0;
-
-	wad.images.W_AddTexture(namebuf, img, is_medusa);
+	AddPatchTexture(wad, cache, raw->name, width, height, std::move(patches), is_medusa);
 }
 
 
-static void LoadTexturesLump(WadData &wad, const ConfigData &config, Lump_c *lump, byte *pnames, int pname_size,
+static void LoadTexturesLump(WadData &wad, const std::shared_ptr<PatchCache> &cache, Lump_c *lump, byte *pnames, int pname_size,
                              bool skip_first)
 {
 	// TODO : verify size word at front of PNAMES ??
@@ -285,14 +748,88 @@ static void LoadTexturesLump(WadData &wad, const ConfigData &config, Lump_c *lum
 			FatalError("W_LoadTextures: TEXTURE1/2 lump is corrupt, bad offset.\n");
 
 		if (is_strife)
-			LoadTextureEntry_Strife(wad, config, tex_data.data(), tex_length, offset, pnames, pname_size, skip_first);
+			LoadTextureEntry_Strife(wad, cache, tex_data.data(), tex_length, offset, pnames, pname_size, skip_first);
 		else
-			LoadTextureEntry_DOOM(wad, config, tex_data.data(), tex_length, offset, pnames, pname_size, skip_first);
+			LoadTextureEntry_DOOM(wad, cache, tex_data.data(), tex_length, offset, pnames, pname_size, skip_first);
+	}
+}
+
+
+static Img_c *LoadTextureLump(const WadData &wad, const ConfigData &config, Lump_c *lump, char img_fmt)
+{
+	const SString &name = lump->Name();
+	Img_c *img = NULL;
+
+	switch (img_fmt)
+	{
+		case 'd': /* Doom patch */
+			img = new Img_c;
+			if (! LoadPicture(wad.palette, config, *img, lump, name, 0, 0))
+			{
+				delete img;
+				img = NULL;
+			}
+			break;
+
+		case 'p': /* PNG */
+			img = LoadImage_PNG(lump, name);
+			break;
+
+		case 't': /* TGA */
+			img = LoadImage_TGA(lump, name);
+			break;
+
+		case 'j': /* JPEG */
+			img = LoadImage_JPEG(lump, name);
+			break;
+	}
+
+	return img;
+}
+
+
+//
+// Reads the size of an image from its header, without decoding it.
+// Returns false if it cannot tell (e.g. for JPEG).
+//
+static bool ProbeImageSize(Lump_c *lump, char img_fmt, int *width, int *height)
+{
+	int length = lump->Length();
+
+	const byte *header = (const byte *)lump->getData();
+
+	switch (img_fmt)
+	{
+		case 'd': /* Doom patch */
+			if (length < 4)
+				return false;
+			*width  = header[0] | (header[1] << 8);
+			*height = header[2] | (header[3] << 8);
+			break;
+
+		case 'p': /* PNG : from the IHDR chunk */
+			if (length < 24)
+				return false;
+			*width  = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+			*height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+			break;
+
+		case 't': /* TGA */
+			if (length < 16)
+				return false;
+			*width  = header[12] | (header[13] << 8);
+			*height = header[14] | (header[15] << 8);
+			break;
+
+		default:
+			return false;
 	}
+
+	return (*width > 0 && *height > 0);
 }
 
 
-static void W_LoadTextures_TX_START(WadData &wad, const ConfigData &config, const Wad_file *wf)
+static void W_LoadTextures_TX_START(WadData &wad, const ConfigData &config, const std::shared_ptr<Wad_file> &wf)
 {
 	for(const LumpRef &lumpRef : wf->getDir())
 	{
@@ -302,45 +839,53 @@ static void W_LoadTextures_TX_START(WadData &wad, const ConfigData &config, cons
 
 		char img_fmt = W_DetectImageFormat(lump);
 		const SString &name = lump->Name();
-		Img_c *img = NULL;
 
 		switch (img_fmt)
 		{
-			case 'd': /* Doom patch */
-				img = new Img_c;
-				if (! LoadPicture(wad.palette, config, *img, lump, name, 0, 0))
-				{
-					delete img;
-					img = NULL;
-				}
-				break;
-
-			case 'p': /* PNG */
-				img = LoadImage_PNG(lump, name);
-				break;
-
-			case 't': /* TGA */
-				img = LoadImage_TGA(lump, name);
-				break;
-
-			case 'j': /* JPEG */
-				img = LoadImage_JPEG(lump, name);
+			case 'd': case 'p': case 't': case 'j':
 				break;
 
 			case 0:
 				gLog.printf("Unknown texture format in '%s' lump\n", name.c_str());
-				break;
+				continue;
 
 			default:
 				gLog.printf("Unsupported texture format in '%s' lump\n", lump->Name().c_str());
-				break;
+				continue;
 		}
 
-		// if we successfully loaded the texture, add it
-		if (img)
+		ImageEntry entry;
+
+		// the wad is kept open while the texture may need it
+		const WadData *wad_p = &wad;
+
+		entry.decode = [wad_p, wf, lump, img_fmt](const ConfigData &config)
+		{
+			return LoadTextureLump(*wad_p, config, lump, img_fmt);
+		};
+
+		entry.source = [wad_p, wf, lump, img_fmt](const ConfigData &config, crc32_c &sum)
 		{
-			wad.images.W_AddTexture(name, img, false /* is_medusa */);
+			sum += "lump";
+			AddDecodeSettings(*wad_p, config, sum);
+
+			sum += (u8_t)img_fmt;
+			sum.AddBlock((const u8_t *)lump->getData(), lump->Length());
+		};
+
+		// when the size is not in an easy spot, make it right away
+		if (! ProbeImageSize(lump, img_fmt, &entry.width, &entry.height))
+		{
+			entry.img.reset(wad.images.makeImage(config, entry, &entry.cacheKey));
+
+			if (! entry.img)
+				continue;
+
+			entry.width  = entry.img->width();
+			entry.height = entry.img->height();
 		}
+
+		wad.images.W_AddTexture(name, std::move(entry), false /* is_medusa */);
 	}
 }
 
@@ -349,6 +894,9 @@ void WadData::W_LoadTextures(const ConfigData &config)
 {
 	images.W_ClearTextures();
 
+	// shared by all the patch textures, and freed along with them
+	auto cache = std::make_shared<PatchCache>(master.dir);
+
 	for (int i = 0 ; i < (int)master.dir.size() ; i++)
 	{
 		gLog.printf("Loading Textures from WAD #%d\n", i+1);
@@ -370,21 +918,21 @@ void WadData::W_LoadTextures(const ConfigData &config)
 			int pname_size = W_LoadLumpData(pnames, pname_data);
 
 			if (texture1)
-				LoadTexturesLump(*this, config, texture1, pname_data.data(), pname_size, true);
+				LoadTexturesLump(*this, cache, texture1, pname_data.data(), pname_size, true);
 
 			if (texture2)
-				LoadTexturesLump(*this, config, texture2, pname_data.data(), pname_size, false);
+				LoadTexturesLump(*this, cache, texture2, pname_data.data(), pname_size, false);
 		}
 
 		if (config.features.tx_start)
 		{
-			W_LoadTextures_TX_START(*this, config, master.dir[i].get());
+			W_LoadTextures_TX_START(*this, config, master.dir[i]);
 		}
 	}
 }
 
 
-Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+const ImageEntry * ImageSet::findTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
 {
 	if (is_null_tex(name))
 		return NULL;
@@ -393,36 +941,63 @@ Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool
 		return NULL;
 
 	SString t_str = name;
-	std::map<SString, Img_c *>::const_iterator P = textures.find(t_str);
+	image_map_t::const_iterator P = textures.find(t_str);
 
 	if (P != textures.end())
-		return P->second;
+		return &P->second;
 
 	if (try_uppercase)
 	{
-		return getTexture(config, NormalizeTex(name), false);
+		return findTexture(config, NormalizeTex(name), false);
 	}
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c *>::const_iterator P = flats.find(t_str);
+		image_map_t::const_iterator P = flats.find(t_str);
 
 		if (P != flats.end())
-			return P->second;
+			return &P->second;
 	}
 
 	return NULL;
 }
 
 
-int ImageSet::W_GetTextureHeight(const ConfigData &config, const SString &name) const
+Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	const ImageEntry *entry = findTexture(config, name, try_uppercase);
+
+	return entry ? decodeImage(config, *entry) : NULL;
+}
+
+
+void ImageSet::useTexture(const ConfigData &config, const SString &name,
+						  const std::function<void(const Img_c *img)> &func) const
 {
-	Img_c *img = getTexture(config, name);
+	useImage(config, findTexture(config, name, false), func);
+}
+
 
-	if (! img)
+int ImageSet::W_GetTextureHeight(const ConfigData &config, const SString &name) const
+{
+	// the size is known without decoding it
+	if (is_null_tex(name) || name.empty())
 		return 128;
 
-	return img->height();
+	image_map_t::const_iterator P = textures.find(name);
+
+	if (P != textures.end())
+		return P->second.height;
+
+	if (config.features.mix_textures_flats)
+	{
+		P = flats.find(name);
+
+		if (P != flats.end())
+			return P->second.height;
+	}
+
+	return 128;
 }
 
 // accepts "-", "#xxxx" or an existing texture name
@@ -434,14 +1009,14 @@ bool ImageSet::W_TextureIsKnown(const ConfigData &config, const SString &name) c
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c *>::const_iterator P = textures.find(name);
+	image_map_t::const_iterator P = textures.find(name);
 
 	if (P != textures.end())
 		return true;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c *>::const_iterator P = flats.find(name);
+		image_map_t::const_iterator P = flats.find(name);
 
 		if (P != flats.end())
 			return true;
@@ -485,38 +1060,33 @@ SString NormalizeTex(const SString &name)
 //    FLAT HANDLING
 //----------------------------------------------------------------------
 
-static void DeleteFlat(const std::map<SString, Img_c *>::value_type& P)
-{
-	delete P.second;
-}
-
-
 void ImageSet::W_ClearFlats()
 {
-	std::for_each(flats.begin(), flats.end(), DeleteFlat);
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	for (const image_map_t::value_type &P : flats)
+		if (P.second.img)
+			mDecodedBytes -= ImageBytes(*P.second.img);
 
 	flats.clear();
 }
 
 
-void ImageSet::W_AddFlat(const SString &name, Img_c *img)
+void ImageSet::W_AddFlat(const SString &name, ImageEntry &&entry)
 {
-	// find any existing one with same name, and free it
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
 
-	SString flat_str = name;
+	// replace any existing one with same name
 
-	std::map<SString, Img_c *>::iterator P = flats.find(flat_str);
+	ImageEntry &dest = flats[name];
 
-	if (P != flats.end())
-	{
-		delete P->second;
+	if (dest.img)
+		mDecodedBytes -= ImageBytes(*dest.img);
 
-		P->second = img;
-	}
-	else
-	{
-		flats[flat_str] = img;
-	}
+	if (entry.img)
+		mDecodedBytes += ImageBytes(*entry.img);
+
+	dest = std::move(entry);
 }
 
 
@@ -530,14 +1100,21 @@ static Img_c * LoadFlatImage(const WadData &wad, const SString &name, Lump_c *lu
 
 	byte *raw = new byte[size];
 
-	lump->Seek();
-	if (! lump->Read(raw, size))
+	// not using Read(), so that several threads can load flats
+	if (lump->Length() >= size)
+	{
+		memcpy(raw, lump->getData(), size);
+	}
+	else
 	{
 		gLog.printf("%s: flat '%s' is too small, should be at least %d.\n",
 					__func__, name.c_str(), size);
 		int smallsize = lump->Length();
 		if(smallsize > 0)
+		{
+			memcpy(raw, lump->getData(), smallsize);
 			memset(raw + smallsize, raw[smallsize - 1], size - smallsize);
+		}
 		else
 			memset(raw, 0, size);
 	}
@@ -566,7 +1143,7 @@ void WadData::W_LoadFlats()
 	{
 		gLog.printf("Loading Flats from WAD #%d\n", i+1);
 
-		const Wad_file *wf = master.dir[i].get();
+		const std::shared_ptr<Wad_file> &wf = master.dir[i];
 
 		for(const LumpRef &lumpRef : wf->getDir())
 		{
@@ -574,39 +1151,63 @@ void WadData::W_LoadFlats()
 				continue;
 			Lump_c *lump = lumpRef.lump.get();
 
-			Img_c * img = LoadFlatImage(*this, lump->Name(), lump);
+			ImageEntry entry;
+			entry.width  = 64;
+			entry.height = 64;
+
+			// the wad is kept open while the flat may need it
+			const WadData *wad_p = this;
 
-			if (img)
-				images.W_AddFlat(lump->Name(), img);
+			entry.decode = [wad_p, wf, lump](const ConfigData &config)
+			{
+				return LoadFlatImage(*wad_p, lump->Name(), lump);
+			};
+
+			images.W_AddFlat(lump->Name(), std::move(entry));
 		}
 	}
 }
 
 
-Img_c * ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const
+const ImageEntry * ImageSet::findFlat(const ConfigData &config, const SString &name, bool try_uppercase) const
 {
-	std::map<SString, Img_c *>::const_iterator P = flats.find(name);
+	image_map_t::const_iterator P = flats.find(name);
 
 	if (P != flats.end())
-		return P->second;
+		return &P->second;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c *>::const_iterator P = textures.find(name);
+		image_map_t::const_iterator P = textures.find(name);
 
 		if (P != textures.end())
-			return P->second;
+			return &P->second;
 	}
 
 	if (try_uppercase)
 	{
-		return W_GetFlat(config, NormalizeTex(name), false);
+		return findFlat(config, NormalizeTex(name), false);
 	}
 
 	return NULL;
 }
 
 
+Img_c * ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	const ImageEntry *entry = findFlat(config, name, try_uppercase);
+
+	return entry ? decodeImage(config, *entry) : NULL;
+}
+
+
+void ImageSet::useFlat(const ConfigData &config, const SString &name,
+					   const std::function<void(const Img_c *img)> &func) const
+{
+	useImage(config, findFlat(config, name, false), func);
+}
+
+
 bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) const
 {
 	// sectors do not support "-" (but our code can make it)
@@ -616,14 +1217,14 @@ bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) cons
 	if (name.empty())
 		return false;
 
-	std::map<SString, Img_c *>::const_iterator P = flats.find(name);
+	image_map_t::const_iterator P = flats.find(name);
 
 	if (P != flats.end())
 		return true;
 
 	if (config.features.mix_textures_flats)
 	{
-		std::map<SString, Img_c *>::const_iterator P = textures.find(name);
+		image_map_t::const_iterator P = textures.find(name);
 
 		if (P != textures.end())
 			return true;
@@ -825,16 +1426,10 @@ Img_c *WadData::W_GetSprite(const ConfigData &config, int type)
 
 //----------------------------------------------------------------------
 
-static void UnloadTex(const std::map<SString, Img_c *>::value_type& P)
+static void UnloadImage(const image_map_t::value_type& P)
 {
-	if (P.second != NULL)
-		P.second->unload_gl(false);
-}
-
-static void UnloadFlat(const std::map<SString, Img_c *>::value_type& P)
-{
-	if (P.second != NULL)
-		P.second->unload_gl(false);
+	if (P.second.img)
+		P.second.img->unload_gl(false);
 }
 
 static void UnloadSprite(const sprite_map_t::value_type& P)
@@ -845,8 +1440,10 @@ static void UnloadSprite(const sprite_map_t::value_type& P)
 
 void ImageSet::W_UnloadAllTextures() const
 {
-	std::for_each(textures.begin(), textures.end(), UnloadTex);
-	std::for_each(flats.begin(),    flats.end(), UnloadFlat);
+	std::lock_guard<std::mutex> lock(mDecodeMutex);
+
+	std::for_each(textures.begin(), textures.end(), UnloadImage);
+	std::for_each(flats.begin(),    flats.end(), UnloadImage);
 	std::for_each(sprites.begin(), sprites.end(), UnloadSprite);
 
 	IM_UnloadDummyTextures();
@@ -131,11 +131,28 @@ bool Lump_c::GetLine(SString &string) noexcept
 
 void Lump_c::Write(const void *vdata, int len)
 {
+	if(len <= 0)
+		return;
 	auto data = static_cast<const byte *>(vdata);
-	mData.insert(mData.begin() + mPos, data, data + len);
+
+	// the savers only ever append, and inserting at the end already
+	// grows the vector geometrically.
+	if(mPos == (int)mData.size())
+		mData.insert(mData.end(), data, data + len);
+	else
+		mData.insert(mData.begin() + mPos, data, data + len);
 	mPos += len;
 }
 
+//
+// Size hint: preallocate room for "total" bytes of lump data
+//
+void Lump_c::reserve(int total)
+{
+	if(total > 0 && (size_t)total > mData.capacity())
+		mData.reserve(total);
+}
+
 
 void Lump_c::Printf(EUR_FORMAT_STRING(const char *msg), ...)
 {
@@ -155,7 +172,12 @@ void Lump_c::Printf(EUR_FORMAT_STRING(const char *msg), ...)
 //
 size_t Lump_c::writeData(FILE *f, int len)
 {
-	mData.insert(mData.begin() + mPos, len, 0);
+	if(len <= 0)
+		return 0;
+	if(mPos == (int)mData.size())
+		mData.insert(mData.end(), len, 0);
+	else
+		mData.insert(mData.begin() + mPos, len, 0);
 	size_t actualRead = fread(mData.data() + mPos, 1, len, f);
 	if((int)actualRead < len)
 	{
@@ -509,6 +531,14 @@ MapFormat Wad_file::LevelFormat(int lev_num) const noexcept
 
 Lump_c * Wad_file::FindLumpInNamespace(const SString &name, WadNamespace group) const noexcept
 {
+	// sprites are looked up often (once per thing type), so use the index
+	if (group == WadNamespace::Sprites)
+	{
+		auto it = sprite_index.find(name.asUpper());
+
+		return (it != sprite_index.end()) ? it->second : nullptr;
+	}
+
 	for(const LumpRef &lumpRef : directory)
 	{
 		if(lumpRef.ns != group || !lumpRef.lump->name.noCaseEqual(name))
@@ -783,6 +813,12 @@ void Wad_file::ProcessNamespaces()
 
 	if (active != WadNamespace::Global)
 		gLog.printf("WARNING: Missing %s_END marker (at EOF)\n", WadNamespaceString(active));
+
+	sprite_index.clear();
+
+	for (const LumpRef &lumpRef : directory)
+		if (lumpRef.ns == WadNamespace::Sprites)
+			sprite_index.emplace(lumpRef.lump->name.asUpper(), lumpRef.lump.get());
 }
 
 
@@ -817,6 +853,10 @@ void Wad_file::RenameLump(int index, const char *new_name)
 	SYS_ASSERT(lump);
 
 	lump->Rename(new_name);
+
+	// keep the sprite index in step
+	if (directory[index].ns == WadNamespace::Sprites)
+		ProcessNamespaces();
 }
 
 
@@ -1087,12 +1127,10 @@ int W_LoadLumpData(Lump_c *lump, std::vector<byte> &buffer)
 	// include an extra byte, used to NUL-terminate a text buffer
 	buffer.resize(lump->Length() + 1);
 
+	// this leaves the read position alone, so that several threads can
+	// load the same lump.
 	if (lump->Length() > 0)
-	{
-		lump->Seek();
-		if (! lump->Read(buffer.data(), lump->Length()))
-			ThrowException("W_LoadLumpData: read error loading lump.\n");
-	}
+		memcpy(buffer.data(), lump->getData(), lump->Length());
 
 	buffer[lump->Length()] = 0;
 
@@ -31,6 +31,7 @@
 #include "main.h"
 
 #include <memory>
+#include <unordered_map>
 
 class Wad_file;
 
@@ -112,6 +113,10 @@ public:
 	// written to.
 	void Write(const void *data, int len);
 
+	// size hint: preallocate room for "total" bytes, so that a series of
+	// Write() calls appending to the lump doesn't keep reallocating.
+	void reserve(int total);
+
 	// write some text to the lump
 	void Printf(EUR_FORMAT_STRING(const char *msg), ...) EUR_PRINTF(2, 3);
 
@@ -164,6 +169,10 @@ private:
 
 	std::vector<LumpRef> directory;
 
+	// the lumps of the sprite namespace by uppercase name, the earliest
+	// one for each name.  Rebuilt by ProcessNamespaces().
+	std::unordered_map<SString, Lump_c *> sprite_index;
+
 	// these are lump indices (into 'directory' vector)
 	std::vector<int> levels;
 
@@ -0,0 +1,273 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "e_basis.h"
+
+#include "e_cutpaste.h"
+#include "e_hover.h"
+#include "r_render.h"
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+ChecksModule::~ChecksModule()
+{
+}
+
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
+{
+}
+
+void ChecksModule::liveReset()
+{
+}
+
+void ChecksModule::liveWait()
+{
+}
+
+void Clipboard_ClearLocals()
+{
+}
+
+void Clipboard_NotifyDelete(ObjType type, int objnum)
+{
+}
+
+void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
+{
+}
+
+DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
+{
+}
+
+void Hover::invalidateSectorLocator()
+{
+}
+
+void Hover::notifyChanges(const ChangeSet &changes)
+{
+}
+
+Img_c::~Img_c()
+{
+}
+
+void Instance::MapStuff_NotifyBegin()
+{
+}
+
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::ObjectBox_NotifyBegin()
+{
+}
+
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::RedrawMap()
+{
+}
+
+void Instance::Selection_NotifyBegin()
+{
+}
+
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::Status_Set(const char *fmt, ...) const
+{
+}
+
+void LiveChecks::wait()
+{
+}
+
+void Recently_used::insert(const SString &name)
+{
+}
+
+void Recently_used::insert_number(int val)
+{
+}
+
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
+{
+}
+
+void SectorModule::invalidateGraph()
+{
+}
+
+void SectorModule::notifyChanges(const ChangeSet &changes)
+{
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+//
+// Builds an entry the way the edit units record it
+//
+static ChangeSet::Entry MakeEntry(const std::vector<int> &inserted, const std::vector<int> &deleted)
+{
+	ChangeSet changes;
+
+	for (int n : inserted)
+		changes.recordInsert(ObjType::things, n);
+	for (int n : deleted)
+		changes.recordDelete(ObjType::things, n);
+
+	return changes[ObjType::things];
+}
+
+TEST(ChangeSet, RenumberNothing)
+{
+	std::vector<int> old_to_new;
+	std::vector<byte> is_new;
+
+	ASSERT_TRUE(MakeEntry({}, {}).calcRenumbering(3, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, 1, 2 }));
+	ASSERT_EQ(is_new, (std::vector<byte>{ 0, 0, 0 }));
+
+	ASSERT_TRUE(MakeEntry({}, {}).calcRenumbering(0, old_to_new, is_new));
+	ASSERT_TRUE(old_to_new.empty());
+	ASSERT_TRUE(is_new.empty());
+}
+
+TEST(ChangeSet, RenumberInserts)
+{
+	std::vector<int> old_to_new;
+	std::vector<byte> is_new;
+
+	// at the end, the usual way of adding objects
+	ASSERT_TRUE(MakeEntry({ 2, 3 }, {}).calcRenumbering(4, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, 1 }));
+	ASSERT_EQ(is_new, (std::vector<byte>{ 0, 0, 1, 1 }));
+
+	// into an empty level
+	ASSERT_TRUE(MakeEntry({ 0, 1 }, {}).calcRenumbering(2, old_to_new, is_new));
+	ASSERT_TRUE(old_to_new.empty());
+	ASSERT_EQ(is_new, (std::vector<byte>{ 1, 1 }));
+
+	// in the middle then at the end, each number being the one at the
+	// time of the insert
+	ASSERT_TRUE(MakeEntry({ 1, 4 }, {}).calcRenumbering(5, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, 2, 3 }));
+	ASSERT_EQ(is_new, (std::vector<byte>{ 0, 1, 0, 0, 1 }));
+
+	// past the end
+	ASSERT_FALSE(MakeEntry({ 3 }, {}).calcRenumbering(2, old_to_new, is_new));
+	// more inserts than objects
+	ASSERT_FALSE(MakeEntry({ 0, 1, 2 }, {}).calcRenumbering(2, old_to_new, is_new));
+}
+
+TEST(ChangeSet, RenumberDeletes)
+{
+	std::vector<int> old_to_new;
+	std::vector<byte> is_new;
+
+	// from the top down
+	ASSERT_TRUE(MakeEntry({}, { 3, 1 }).calcRenumbering(3, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, -1, 1, -1, 2 }));
+	ASSERT_EQ(is_new, (std::vector<byte>{ 0, 0, 0 }));
+
+	// unsorted: the second number is after the first delete
+	ASSERT_TRUE(MakeEntry({}, { 1, 2 }).calcRenumbering(3, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, -1, 1, -1, 2 }));
+
+	// the same number twice takes two objects
+	ASSERT_TRUE(MakeEntry({}, { 0, 0 }).calcRenumbering(3, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ -1, -1, 0, 1, 2 }));
+
+	// the last one, repeatedly
+	ASSERT_TRUE(MakeEntry({}, { 4, 3, 2 }).calcRenumbering(2, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ 0, 1, -1, -1, -1 }));
+
+	// everything
+	ASSERT_TRUE(MakeEntry({}, { 1, 0 }).calcRenumbering(0, old_to_new, is_new));
+	ASSERT_EQ(old_to_new, (std::vector<int>{ -1, -1 }));
+	ASSERT_TRUE(is_new.empty());
+
+	// out of range, sorted or not
+	ASSERT_FALSE(MakeEntry({}, { 5 }).calcRenumbering(4, old_to_new, is_new));
+	ASSERT_FALSE(MakeEntry({}, { 1, 4 }).calcRenumbering(3, old_to_new, is_new));
+	ASSERT_FALSE(MakeEntry({}, { 0, -1 }).calcRenumbering(3, old_to_new, is_new));
+}
+
+TEST(ChangeSet, RenumberMixed)
+{
+	std::vector<int> old_to_new;
+	std::vector<byte> is_new;
+
+	// the order of inserts and deletes is not kept
+	ASSERT_FALSE(MakeEntry({ 2 }, { 0 }).calcRenumbering(3, old_to_new, is_new));
+}
+
+TEST(ChangeSet, ChangedNumbersValid)
+{
+	// changed after the inserts: the numbers are the new ones
+	ChangeSet changes;
+	changes.recordInsert(ObjType::things, 0);
+	changes.recordChange(ObjType::things, 5, 0);
+	ASSERT_FALSE(changes[ObjType::things].renumbered);
+	ASSERT_TRUE(changes[ObjType::things].changedNumbersValid());
+
+	// changed below the insert
+	changes.clear();
+	changes.recordChange(ObjType::things, 4, 0);
+	changes.recordInsert(ObjType::things, 5);
+	ASSERT_TRUE(changes[ObjType::things].renumbered);
+	ASSERT_TRUE(changes[ObjType::things].changedNumbersValid());
+
+	// right at the insert, which moved it up
+	changes.recordChange(ObjType::things, 5, 0);
+	ASSERT_FALSE(changes[ObjType::things].changedNumbersValid());
+
+	// the lowest insert or delete counts
+	changes.clear();
+	changes.recordChange(ObjType::things, 2, 0);
+	changes.recordChange(ObjType::things, 0, 0);
+	changes.recordDelete(ObjType::things, 8);
+	changes.recordInsert(ObjType::things, 3);
+	ASSERT_TRUE(changes[ObjType::things].changedNumbersValid());
+	changes.recordDelete(ObjType::things, 2);
+	ASSERT_FALSE(changes[ObjType::things].changedNumbersValid());
+
+	// the other kinds of objects are apart
+	ASSERT_TRUE(changes[ObjType::linedefs].changedNumbersValid());
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -22,11 +22,23 @@
 
 #include "e_basis.h"
 #include "e_hover.h"
+#include "e_linedef.h"
 #include "Instance.h"
 #include "LineDef.h"
+#include "m_config.h"
 #include "m_select.h"
 #include "Sector.h"
+#include "Thing.h"
 #include "ui_window.h"
+#include "Vertex.h"
+#include "testUtils/TestMap.hpp"
+
+#include <chrono>
+#include <functional>
+#include <random>
+
+// things of this type and above are unknown
+static const int UNKNOWN_THING = 30000;
 
 //==============================================================================
 //
@@ -38,22 +50,10 @@ void Clipboard_ClearLocals()
 {
 }
 
-void Clipboard_NotifyBegin()
-{
-}
-
-void Clipboard_NotifyChange(ObjType type, int objnum, int field)
-{
-}
-
 void Clipboard_NotifyDelete(ObjType type, int objnum)
 {
 }
 
-void Clipboard_NotifyEnd()
-{
-}
-
 void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
 {
 }
@@ -80,28 +80,21 @@ DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
 {
 }
 
-void Hover::fastOpposite_begin()
-{
-}
-
-void Hover::fastOpposite_finish()
+int Grid_State_c::ForceSnapX(double map_x) const
 {
+	return 0;
 }
 
-Objid hover::getNearbyObject(ObjType type, const Document &doc, const ConfigData &config,
-							 const Grid_State_c &grid, const v2double_t &pos)
+void Grid_State_c::RatioSnapXY(v2double_t &var, const v2double_t &start) const
 {
-	return Objid();
 }
 
-Objid hover::getNearestSector(const Document &doc, const v2double_t &pos)
+void SectorModule::invalidateGraph()
 {
-	return Objid();
 }
 
-int Hover::getOppositeSector(int ld, Side ld_side) const
+void SectorModule::notifyChanges(const ChangeSet &changes)
 {
-	return 0;
 }
 
 bool Img_c::has_transparent() const
@@ -113,27 +106,24 @@ void Instance::Beep(const char *fmt, ...)
 {
 }
 
-void Instance::Editor_ChangeMode(char mode_char)
-{
-}
-
-void Instance::MapStuff_NotifyBegin()
+void Instance::CalculateLevelBounds()
 {
 }
 
-void Instance::MapStuff_NotifyChange(ObjType type, int objnum, int field)
+bool Instance::Exec_HasFlag(const char *flag) const
 {
+	return false;
 }
 
-void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
+void Instance::Editor_ChangeMode(char mode_char)
 {
 }
 
-void Instance::MapStuff_NotifyEnd()
+void Instance::MapStuff_NotifyBegin()
 {
 }
 
-void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
 {
 }
 
@@ -151,8 +141,11 @@ const sectortype_t &Instance::M_GetSectorType(int type) const
 
 const thingtype_t &M_GetThingType(const ConfigData &config, int type)
 {
-	static thingtype_t thingtype;
-	return thingtype;
+	// every thing is a small monster, except for the unknown ones
+	static thingtype_t thingtype = { 'm', 0, 20 };
+	static thingtype_t unknown = { '?', 0, 16, 1.0f, "UNKNOWN TYPE" };
+
+	return (type >= UNKNOWN_THING) ? unknown : thingtype;
 }
 
 void Instance::GoToErrors()
@@ -168,19 +161,7 @@ void Instance::ObjectBox_NotifyBegin()
 {
 }
 
-void Instance::ObjectBox_NotifyChange(ObjType type, int objnum, int field)
-{
-}
-
-void Instance::ObjectBox_NotifyDelete(ObjType type, int objnum)
-{
-}
-
-void Instance::ObjectBox_NotifyEnd() const
-{
-}
-
-void Instance::ObjectBox_NotifyInsert(ObjType type, int objnum)
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
 {
 }
 
@@ -196,30 +177,35 @@ void Instance::Selection_NotifyBegin()
 {
 }
 
-void Instance::Selection_NotifyDelete(ObjType type, int objnum)
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
 {
 }
 
-void Instance::Selection_NotifyEnd()
+SelectHighlight Editor_State_t::SelectionOrHighlight()
 {
+	return SelectHighlight::ok;
 }
 
-void Instance::Selection_NotifyInsert(ObjType type, int objnum)
+void Editor_State_t::Selection_AddHighlighted()
 {
 }
 
-SelectHighlight Editor_State_t::SelectionOrHighlight()
+void Instance::Status_Set(const char *fmt, ...) const
 {
-	return SelectHighlight::ok;
 }
 
-void Instance::Status_Set(const char *fmt, ...) const
+Img_c::~Img_c()
+{
+}
+
+void ImageSet::decodeNamed(const ConfigData &config, const std::vector<SString> &tex_names,
+						   const std::vector<SString> &flat_names) const
 {
 }
 
 bool ImageSet::W_FlatIsKnown(const ConfigData &config, const SString &name) const
 {
-	return false;
+	return ! name.startsWith("BAD");
 }
 
 Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
@@ -232,14 +218,19 @@ bool ImageSet::W_TextureCausesMedusa(const SString &name) const
 	return false;
 }
 
+int ImageSet::W_GetTextureHeight(const ConfigData &config, const SString &name) const
+{
+	return 128;
+}
+
 bool ImageSet::W_TextureIsKnown(const ConfigData &config, const SString &name) const
 {
-	return false;
+	return ! name.startsWith("BAD");
 }
 
 bool is_null_tex(const SString &tex)
 {
-	return false;
+	return tex == "-";
 }
 
 bool is_special_tex(const SString &tex)
@@ -260,47 +251,41 @@ bool ObjectsModule::lineTouchesBox(int ld, double x0, double y0, double x1, doub
 	return false;
 }
 
-void Recently_used::insert(const SString &name)
-{
-}
-
-void Recently_used::insert_number(int val)
+void ObjectsModule::calcBBox(const selection_c &list, v2double_t &pos1, v2double_t &pos2) const
 {
 }
 
-void Render3D_NotifyBegin()
+v2double_t ObjectsModule::calcMiddle(const selection_c &list) const
 {
+	return {};
 }
 
-void Render3D_NotifyChange(ObjType type, int objnum, int field)
+void Recently_used::insert(const SString &name)
 {
 }
 
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum)
+void Recently_used::insert_number(int val)
 {
 }
 
-void Render3D_NotifyEnd(Instance &inst)
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
 {
 }
 
-void Render3D_NotifyInsert(ObjType type, int objnum)
+int UI_Escapable_Window::handle(int event)
 {
+	return 0;
 }
 
-void Selection_NotifyChange(ObjType type, int objnum, int field)
+void UnusedVertices(const Document &doc, const selection_c &lines, selection_c &result)
 {
 }
 
-int UI_Escapable_Window::handle(int event)
+int vertex_radius(double scale)
 {
 	return 0;
 }
 
-void UnusedVertices(const Document &doc, const selection_c &lines, selection_c &result)
-{
-}
-
 //==============================================================================
 //
 // Tests
@@ -536,3 +521,690 @@ TEST(EChecks, TagsApplyNewValue)
 
 	ASSERT_EQ(inst.level.checks.mLastTag, 1);	// changed again
 }
+
+//
+// Times the stuck things check on a slaughter map sized level
+//
+TEST(EChecks, FindStuckiesSlaughterMap)
+{
+	Instance inst;
+	inst.loaded.levelFormat = MapFormat::doom;
+
+	// a 110x110 lattice of monsters far enough apart, plus a twin close
+	// to every 50th one.  The twins come last, so the lattice monster is
+	// the one which gets marked.
+	const int side = 110;
+	const int spacing = 48;
+
+	std::vector<Thing> things(side * side);
+	std::vector<int> expected;
+
+	for (int n = 0 ; n < side * side ; n++)
+	{
+		things[n].raw_x = FFixedPoint((n % side) * spacing);
+		things[n].raw_y = FFixedPoint((n / side) * spacing);
+		things[n].options = 7;
+
+		if (n % 50 == 0)
+			expected.push_back(n);
+	}
+
+	for (int n : expected)
+	{
+		Thing twin = things[n];
+		twin.raw_x += FFixedPoint(8);
+		twin.raw_y += FFixedPoint(8);
+		things.push_back(twin);
+	}
+
+	for (Thing &thing : things)
+		inst.level.things.push_back(&thing);
+
+	// a solid box around them, which nobody touches
+	std::vector<Vertex> vertices(4);
+	std::vector<LineDef> lines(4);
+
+	int far = side * spacing + 64;
+
+	vertices[0].raw_x = FFixedPoint(-64);  vertices[0].raw_y = FFixedPoint(-64);
+	vertices[1].raw_x = FFixedPoint(-64);  vertices[1].raw_y = FFixedPoint(far);
+	vertices[2].raw_x = FFixedPoint(far);  vertices[2].raw_y = FFixedPoint(far);
+	vertices[3].raw_x = FFixedPoint(far);  vertices[3].raw_y = FFixedPoint(-64);
+
+	for (int n = 0 ; n < 4 ; n++)
+	{
+		inst.level.vertices.push_back(&vertices[n]);
+
+		lines[n].start = n;
+		lines[n].end = (n + 1) % 4;
+		lines[n].right = 0;
+		inst.level.linedefs.push_back(&lines[n]);
+	}
+
+	ASSERT_GE(inst.level.numThings(), 12000);
+
+	selection_c list(ObjType::things);
+
+	auto start = std::chrono::steady_clock::now();
+
+	Things_FindStuckies(list, inst);
+
+	double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+	printf("Things_FindStuckies: %d things in %.1f ms\n", inst.level.numThings(), ms);
+
+	std::vector<int> found;
+	for (sel_iter_c it(list) ; !it.done() ; it.next())
+		found.push_back(*it);
+
+	ASSERT_EQ(found, expected);
+}
+
+static std::vector<int> SelectedNumbers(const selection_c &list)
+{
+	std::vector<int> result;
+
+	for (sel_iter_c it(list) ; !it.done() ; it.next())
+		result.push_back(*it);
+
+	// small selections keep the order the objects were added in
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+//
+// Random lines, many of them touching in the ways which the crossing
+// check cares about.  The coordinates are even, so middles are exact.
+//
+static void BuildTangledLines(TestMap &map, std::mt19937 &rng)
+{
+	std::uniform_int_distribution<int> coord(0, 1000);
+	std::uniform_int_distribution<int> shortLen(-60, 60);
+	std::uniform_int_distribution<int> pick(0, 99);
+
+	auto even = [](int v) { return v & ~1; };
+
+	for (int n = 0 ; n < 400 ; n++)
+	{
+		int kind = pick(rng);
+
+		int x1 = even(coord(rng)) * 2;
+		int y1 = even(coord(rng)) * 2;
+		int x2, y2;
+
+		if (kind < 10)
+		{
+			// long lines, spanning many blocks
+			x2 = even(coord(rng)) * 2;
+			y2 = even(coord(rng)) * 2;
+		}
+		else if (kind < 25)
+		{
+			// collinear pieces, along a few shared lines
+			int along1 = even(coord(rng)) * 2;
+			int along2 = along1 + even(coord(rng) / 4) + 2;
+
+			switch (pick(rng) % 3)
+			{
+				case 0:  x1 = along1; x2 = along2; y1 = y2 = 600;  break;
+				case 1:  y1 = along1; y2 = along2; x1 = x2 = 900;  break;
+				default: x1 = y1 = along1; x2 = y2 = along2;  break;
+			}
+		}
+		else if (kind < 40 && map.doc.numLinedefs() > 0)
+		{
+			// a T-junction, starting at the middle of another line
+			std::uniform_int_distribution<int> other(0, map.doc.numLinedefs() - 1);
+			const LineDef *L = map.doc.linedefs[other(rng)];
+
+			x1 = even(static_cast<int>(L->Start(map.doc)->x() + L->End(map.doc)->x()) / 2);
+			y1 = even(static_cast<int>(L->Start(map.doc)->y() + L->End(map.doc)->y()) / 2);
+			x2 = x1 + even(shortLen(rng));
+			y2 = y1 + even(shortLen(rng));
+		}
+		else
+		{
+			x2 = x1 + even(shortLen(rng));
+			y2 = y1 + even(shortLen(rng));
+		}
+
+		int v1 = map.addVertex(x1, y1);
+
+		// sometimes share an end point with an earlier line
+		if (kind % 4 == 0 && map.doc.numLinedefs() > 0)
+		{
+			std::uniform_int_distribution<int> other(0, map.doc.numLinedefs() - 1);
+			v1 = map.doc.linedefs[other(rng)]->end;
+		}
+
+		int v2 = map.addVertex(x2, y2);
+
+		map.addLine(v1, v2, -1);
+	}
+}
+
+TEST(EChecks, BoxPairsMatchAllPairs)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	std::mt19937 rng(2021);
+	BuildTangledLines(map, rng);
+
+	const Document &doc = inst.level;
+
+	std::vector<std::pair<int, int>> found;
+
+	linemod::forEachOverlappingBoxPair(doc, [&found](int A, int B)
+	{
+		found.emplace_back(A, B);
+	});
+
+	// each pair once, the lower number first
+	for (const auto &pair : found)
+		ASSERT_LT(pair.first, pair.second);
+
+	std::sort(found.begin(), found.end());
+	ASSERT_EQ(std::adjacent_find(found.begin(), found.end()), found.end());
+
+	std::vector<std::pair<int, int>> expected;
+
+	for (int A = 0 ; A < doc.numLinedefs() ; A++)
+		for (int B = A + 1 ; B < doc.numLinedefs() ; B++)
+		{
+			const Vertex *A1 = doc.linedefs[A]->Start(doc);
+			const Vertex *A2 = doc.linedefs[A]->End(doc);
+			const Vertex *B1 = doc.linedefs[B]->Start(doc);
+			const Vertex *B2 = doc.linedefs[B]->End(doc);
+
+			// touching counts too
+			if (std::max(A1->x(), A2->x()) < std::min(B1->x(), B2->x()) ||
+				std::max(B1->x(), B2->x()) < std::min(A1->x(), A2->x()) ||
+				std::max(A1->y(), A2->y()) < std::min(B1->y(), B2->y()) ||
+				std::max(B1->y(), B2->y()) < std::min(A1->y(), A2->y()))
+			{
+				continue;
+			}
+
+			expected.emplace_back(A, B);
+		}
+
+	ASSERT_GT(expected.size(), 400u);
+	ASSERT_EQ(found, expected);
+}
+
+TEST(EChecks, LineCrossingsMatchAllPairs)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	std::mt19937 rng(77);
+	BuildTangledLines(map, rng);
+
+	const Document &doc = inst.level;
+
+	selection_c found;
+	LineDefs_FindCrossings(found, doc);
+
+	selection_c expected(ObjType::linedefs);
+
+	for (int A = 0 ; A < doc.numLinedefs() ; A++)
+		for (int B = A + 1 ; B < doc.numLinedefs() ; B++)
+			if (CheckLinesCross(A, B, doc))
+			{
+				expected.set(A);
+				expected.set(B);
+			}
+
+	ASSERT_EQ(found.what_type(), ObjType::linedefs);
+	ASSERT_GT(expected.count_obj(), 50);
+	ASSERT_EQ(SelectedNumbers(found), SelectedNumbers(expected));
+}
+
+TEST(EChecks, LineCrossingsKinds)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	auto line = [&map](int x1, int y1, int x2, int y2)
+	{
+		return map.addLine(map.addVertex(x1, y1), map.addVertex(x2, y2), -1);
+	};
+
+	// a long line over many blocks, crossed near its far end
+	int longLine = line(0, 0, 3000, 30);
+	int crossing = line(2900, -50, 2910, 100);
+
+	// collinear and partially overlapping, then only touching
+	int collinear1 = line(0, 500, 300, 500);
+	int collinear2 = line(200, 500, 600, 500);
+	int touching = line(600, 500, 900, 500);
+
+	// a T-junction
+	int stem = line(1000, 1000, 1000, 1200);
+	int bar = line(900, 1200, 1100, 1200);
+
+	// sharing an end point, at an angle
+	int v = map.addVertex(2000, 2000);
+	int corner1 = map.addLine(v, map.addVertex(2100, 2000), -1);
+	int corner2 = map.addLine(v, map.addVertex(2000, 2100), -1);
+
+	ASSERT_EQ(CheckLinesCross(longLine, crossing, inst.level), 3);
+	ASSERT_EQ(CheckLinesCross(collinear1, collinear2, inst.level), 4);
+	ASSERT_EQ(CheckLinesCross(collinear2, touching, inst.level), 0);
+	ASSERT_EQ(CheckLinesCross(bar, stem, inst.level), 1);
+	ASSERT_EQ(CheckLinesCross(stem, bar, inst.level), 2);
+	ASSERT_EQ(CheckLinesCross(corner1, corner2, inst.level), 0);
+
+	selection_c found;
+	LineDefs_FindCrossings(found, inst.level);
+
+	ASSERT_EQ(SelectedNumbers(found),
+			  (std::vector<int>{ longLine, crossing, collinear1, collinear2, stem, bar }));
+}
+
+static bool SamePlace(const Vertex *A, const Vertex *B)
+{
+	return A->raw_x.raw() == B->raw_x.raw() && A->raw_y.raw() == B->raw_y.raw();
+}
+
+TEST(EChecks, VertexOverlapsMatchAllPairs)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	// few places for many vertices, either side of zero and off the grid
+	std::mt19937 rng(5);
+	std::uniform_int_distribution<int> coord(-6, 6);
+
+	for (int n = 0 ; n < 300 ; n++)
+		map.addVertex(coord(rng) * 16.5, coord(rng) * -8.25);
+
+	const Document &doc = inst.level;
+
+	selection_c found;
+	std::vector<int> bases;
+
+	doc.vertmod.findOverlaps(found, &bases);
+
+	ASSERT_EQ(found.what_type(), ObjType::vertices);
+	ASSERT_EQ(static_cast<int>(bases.size()), doc.numVertices());
+
+	int overlapping = 0;
+
+	for (int n = 0 ; n < doc.numVertices() ; n++)
+	{
+		// the base is the first vertex at the same place
+		int first = -1;
+
+		for (int m = 0 ; m < n && first < 0 ; m++)
+			if (SamePlace(doc.vertices[m], doc.vertices[n]))
+				first = m;
+
+		ASSERT_EQ(found.get(n), first >= 0) << "vertex " << n;
+		ASSERT_EQ(bases[n], first) << "vertex " << n;
+
+		if (first >= 0)
+			overlapping++;
+	}
+
+	ASSERT_GT(overlapping, 100);
+	ASSERT_EQ(found.count_obj(), overlapping);
+
+	// without the bases, the same are found
+	selection_c again;
+	doc.vertmod.findOverlaps(again);
+
+	ASSERT_EQ(SelectedNumbers(again), SelectedNumbers(found));
+}
+
+TEST(EChecks, VertexOverlapsNone)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	map.addVertex(0, 0);
+	map.addVertex(0, 1);
+	map.addVertex(1, 0);
+	map.addVertex(-1, 0);
+
+	selection_c found;
+	std::vector<int> bases;
+
+	inst.level.vertmod.findOverlaps(found, &bases);
+
+	ASSERT_TRUE(found.empty());
+	ASSERT_EQ(bases, (std::vector<int>{ -1, -1, -1, -1 }));
+}
+
+TEST(EChecks, LineOverlapsMatchAllPairs)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	// separate vertices sharing a few places, so duplicate lines can use
+	// other vertices at the same spots, either way round
+	std::mt19937 rng(11);
+	std::uniform_int_distribution<int> coord(0, 3);
+
+	for (int n = 0 ; n < 60 ; n++)
+		map.addVertex(coord(rng) * 64, coord(rng) * 64);
+
+	std::uniform_int_distribution<int> vertex(0, inst.level.numVertices() - 1);
+
+	for (int n = 0 ; n < 200 ; n++)
+		map.addLine(vertex(rng), vertex(rng), -1);
+
+	const Document &doc = inst.level;
+
+	selection_c found;
+	doc.linemod.findOverlaps(found);
+
+	ASSERT_EQ(found.what_type(), ObjType::linedefs);
+
+	int overlapping = 0;
+
+	for (int n = 0 ; n < doc.numLinedefs() ; n++)
+	{
+		const Vertex *V1 = doc.linedefs[n]->Start(doc);
+		const Vertex *V2 = doc.linedefs[n]->End(doc);
+
+		bool expected = false;
+
+		// zero-length lines are never overlapping
+		if (! SamePlace(V1, V2))
+		{
+			for (int m = 0 ; m < n && ! expected ; m++)
+			{
+				const Vertex *W1 = doc.linedefs[m]->Start(doc);
+				const Vertex *W2 = doc.linedefs[m]->End(doc);
+
+				expected = (SamePlace(V1, W1) && SamePlace(V2, W2)) ||
+						   (SamePlace(V1, W2) && SamePlace(V2, W1));
+			}
+		}
+
+		ASSERT_EQ(found.get(n), expected) << "linedef " << n;
+
+		if (expected)
+			overlapping++;
+	}
+
+	ASSERT_GT(overlapping, 50);
+}
+
+TEST(EChecks, LineOverlapsKinds)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	int a = map.addVertex(0, 0);
+	int b = map.addVertex(100, 50);
+	int c = map.addVertex(100, 50);	// on top of b
+	int d = map.addVertex(0, 0);	// on top of a
+	int e = map.addVertex(0, 100);
+
+	int first = map.addLine(a, b, -1);
+	int reversed = map.addLine(b, a, -1);
+	int moved = map.addLine(d, c, -1);
+	int other = map.addLine(a, e, -1);
+	int point1 = map.addLine(a, d, -1);
+	int point2 = map.addLine(d, a, -1);
+
+	selection_c found;
+	inst.level.linemod.findOverlaps(found);
+
+	// the first one of each place stays, zero-length ones are left alone
+	ASSERT_FALSE(found.get(first));
+	ASSERT_FALSE(found.get(other));
+	ASSERT_FALSE(found.get(point1));
+	ASSERT_FALSE(found.get(point2));
+
+	ASSERT_EQ(SelectedNumbers(found), (std::vector<int>{ reversed, moved }));
+}
+
+//
+// The number of problems the live checks look for, as found by the full
+// map checks.  The checks counting names see each name once, so each
+// unknown name here is only used once.
+//
+static int FullCheckProblems(const Instance &inst)
+{
+	static const CheckId live_ids[] =
+	{
+		CheckId::lineZeroLen, CheckId::lineMissingRight,
+		CheckId::textureMissing, CheckId::textureUnknown,
+		CheckId::sectorUnclosed, CheckId::sectorBadCeil,
+		CheckId::flatUnknown, CheckId::thingUnknown
+	};
+
+	std::vector<CheckFinding> list;
+	inst.level.checks.collectFindings(list);
+
+	int total = 0;
+
+	for (const CheckFinding &finding : list)
+	{
+		if (std::find(std::begin(live_ids), std::end(live_ids), finding.id) == std::end(live_ids))
+			continue;
+
+		if (finding.severity > 0)
+			total += atoi(finding.message.c_str());
+	}
+
+	return total;
+}
+
+//
+// A grid of square sectors with two-sided lines between them, and a
+// thing in each one.  Sector numbers go along the rows.
+//
+static void BuildLiveMap(TestMap &map, int columns, int rows)
+{
+	const int size = 128;
+
+	for (int j = 0 ; j <= rows ; j++)
+		for (int i = 0 ; i <= columns ; i++)
+			map.addVertex(i * size, j * size);
+
+	for (int s = 0 ; s < columns * rows ; s++)
+		map.addSector();
+
+	auto vertex = [columns](int i, int j) { return j * (columns + 1) + i; };
+
+	for (int j = 0 ; j <= rows ; j++)
+		for (int i = 0 ; i < columns ; i++)
+		{
+			int below = (j > 0) ? (j - 1) * columns + i : -1;
+			int above = (j < rows) ? j * columns + i : -1;
+
+			if (below >= 0)
+				map.addLine(vertex(i, j), vertex(i + 1, j), below, above);
+			else
+				map.addLine(vertex(i + 1, j), vertex(i, j), above);
+		}
+
+	for (int j = 0 ; j < rows ; j++)
+		for (int i = 0 ; i <= columns ; i++)
+		{
+			int west = (i > 0) ? j * columns + i - 1 : -1;
+			int east = (i < columns) ? j * columns + i : -1;
+
+			if (east >= 0)
+				map.addLine(vertex(i, j), vertex(i, j + 1), east, west);
+			else
+				map.addLine(vertex(i, j + 1), vertex(i, j), west);
+		}
+
+	for (int j = 0 ; j < rows ; j++)
+		for (int i = 0 ; i < columns ; i++)
+			map.addThing(i * size + size / 2, j * size + size / 2);
+}
+
+TEST(LiveChecks, MatchFullChecksWhileEditing)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	BuildLiveMap(map, 4, 3);
+
+	Document &doc = inst.level;
+
+	// the live checks only run with a window, which they never use
+	inst.main_win = reinterpret_cast<UI_MainWindow *>(&inst);
+	config::live_map_checks = true;
+
+	ASSERT_EQ(doc.checks.liveProblemCount(), -1);
+
+	doc.checks.liveRecheckAll();
+	doc.checks.liveWait();
+
+	ASSERT_TRUE(doc.checks.livePoll());
+	ASSERT_FALSE(doc.checks.livePoll());
+	ASSERT_EQ(doc.checks.liveProblemCount(), 0);
+	ASSERT_EQ(FullCheckProblems(inst), 0);
+
+	// each edit goes through the Basis, which starts checking the objects
+	// it touched, and waits for that before the next one.
+	auto edit = [&doc](const std::function<void(EditOperation &)> &func)
+	{
+		{
+			EditOperation op(doc.basis);
+			op.setMessage("test");
+			func(op);
+		}
+
+		doc.checks.liveWait();
+	};
+
+	// ceiling below the floor
+	edit([](EditOperation &op)
+	{
+		op.changeSector(5, Sector::F_CEILH, -16);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), 1);
+	ASSERT_EQ(FullCheckProblems(inst), 1);
+
+	// unknown flats, two on one sector still count once
+	edit([](EditOperation &op)
+	{
+		op.changeSector(0, Sector::F_FLOOR_TEX, BA_InternaliseString("BADFLAT"));
+		op.changeSector(5, Sector::F_CEIL_TEX, BA_InternaliseString("BADCEIL"));
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), 3);
+	ASSERT_EQ(FullCheckProblems(inst), 3);
+
+	// outer walls, one with a missing texture and one with an unknown one
+	edit([&doc](EditOperation &op)
+	{
+		op.changeSidedef(doc.linedefs[0]->right, SideDef::F_MID_TEX, BA_InternaliseString("-"));
+		op.changeSidedef(doc.linedefs[1]->right, SideDef::F_MID_TEX, BA_InternaliseString("BADWALL"));
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), 5);
+	ASSERT_EQ(FullCheckProblems(inst), 5);
+
+	// a sidedef moved to another sector leaves both unclosed
+	ASSERT_GE(doc.linedefs[6]->left, 0);
+
+	edit([&doc](EditOperation &op)
+	{
+		op.changeSidedef(doc.linedefs[6]->right, SideDef::F_SECTOR, 11);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), 7);
+	ASSERT_EQ(FullCheckProblems(inst), 7);
+
+	// a vertex moved onto its neighbour makes a zero-length line
+	edit([&doc](EditOperation &op)
+	{
+		op.changeVertex(7, Vertex::F_X, doc.vertices[6]->raw_x.raw());
+	});
+	ASSERT_GT(doc.checks.liveProblemCount(), 7);
+	ASSERT_EQ(doc.checks.liveProblemCount(), FullCheckProblems(inst));
+
+	// unknown things, then one known again
+	edit([](EditOperation &op)
+	{
+		op.changeThing(2, Thing::F_TYPE, UNKNOWN_THING);
+		op.changeThing(9, Thing::F_TYPE, UNKNOWN_THING + 1);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), FullCheckProblems(inst));
+
+	int before = doc.checks.liveProblemCount();
+
+	edit([](EditOperation &op)
+	{
+		op.changeThing(9, Thing::F_TYPE, 1);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), before - 1);
+	ASSERT_EQ(FullCheckProblems(inst), before - 1);
+
+	// a line losing its only side
+	edit([](EditOperation &op)
+	{
+		op.changeLinedef(2, LineDef::F_RIGHT, -1);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), FullCheckProblems(inst));
+
+	// adding objects makes everything of that kind get checked again
+	edit([](EditOperation &op)
+	{
+		int th = op.addNew(ObjType::things);
+		op.changeThing(th, Thing::F_TYPE, UNKNOWN_THING + 2);
+	});
+	ASSERT_EQ(doc.checks.liveProblemCount(), FullCheckProblems(inst));
+
+	// undo all of it, back to no problems at all
+	while (doc.basis.undo())
+	{
+		doc.checks.liveWait();
+		ASSERT_EQ(doc.checks.liveProblemCount(), FullCheckProblems(inst));
+	}
+
+	ASSERT_EQ(doc.checks.liveProblemCount(), 0);
+
+	inst.main_win = nullptr;
+}
+
+TEST(LiveChecks, OffWithoutWindow)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	BuildLiveMap(map, 2, 2);
+
+	config::live_map_checks = true;
+
+	inst.level.checks.liveRecheckAll();
+	inst.level.checks.liveWait();
+
+	ASSERT_EQ(inst.level.checks.liveProblemCount(), -1);
+}
+
+TEST(LiveChecks, ResetWhenClearing)
+{
+	Instance inst;
+	Document &doc = inst.level;
+
+	inst.main_win = reinterpret_cast<UI_MainWindow *>(&inst);
+	config::live_map_checks = true;
+
+	// the Basis owns these objects, so it can clear them
+	{
+		EditOperation op(doc.basis);
+		op.setMessage("add");
+
+		int th = op.addNew(ObjType::things);
+		op.changeThing(th, Thing::F_TYPE, UNKNOWN_THING);
+	}
+
+	doc.checks.liveRecheckAll();
+	doc.checks.liveWait();
+
+	ASSERT_EQ(doc.checks.liveProblemCount(), 1);
+
+	doc.basis.clearAll();
+
+	ASSERT_EQ(doc.checks.liveProblemCount(), -1);
+
+	inst.main_win = nullptr;
+}
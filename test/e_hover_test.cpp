@@ -0,0 +1,403 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "e_hover.h"
+
+#include "e_cutpaste.h"
+#include "e_linedef.h"
+#include "e_main.h"
+#include "m_game.h"
+#include "r_grid.h"
+#include "testUtils/TestMap.hpp"
+
+#include <random>
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+ChecksModule::~ChecksModule()
+{
+}
+
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
+{
+}
+
+void ChecksModule::liveReset()
+{
+}
+
+void ChecksModule::liveWait()
+{
+}
+
+void Clipboard_ClearLocals()
+{
+}
+
+void Clipboard_NotifyDelete(ObjType type, int objnum)
+{
+}
+
+void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
+{
+}
+
+DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
+{
+}
+
+int Grid_State_c::ForceSnapX(double map_x) const
+{
+	return 0;
+}
+
+void Grid_State_c::RatioSnapXY(v2double_t &var, const v2double_t &start) const
+{
+}
+
+Img_c::~Img_c()
+{
+}
+
+void Instance::CalculateLevelBounds()
+{
+}
+
+void Instance::MapStuff_NotifyBegin()
+{
+}
+
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::ObjectBox_NotifyBegin()
+{
+}
+
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::RedrawMap()
+{
+}
+
+void Instance::Selection_NotifyBegin()
+{
+}
+
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::Status_Set(const char *fmt, ...) const
+{
+}
+
+int LinedefModule::splitLinedefAtVertex(EditOperation &op, int ld, int v_idx) const
+{
+	return -1;
+}
+
+void linemod::moveCoordOntoLinedef(const Document &doc, int ld, v2double_t &v)
+{
+}
+
+void LiveChecks::wait()
+{
+}
+
+const thingtype_t &M_GetThingType(const ConfigData &config, int type)
+{
+	static thingtype_t info = {};
+	return info;
+}
+
+void Recently_used::insert(const SString &name)
+{
+}
+
+void Recently_used::insert_number(int val)
+{
+}
+
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
+{
+}
+
+void SectorModule::invalidateGraph()
+{
+}
+
+void SectorModule::notifyChanges(const ChangeSet &changes)
+{
+}
+
+int vertex_radius(double scale)
+{
+	return 0;
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+static const int CELL = 96;
+static const int COLUMNS = 8;
+static const int ROWS = 6;
+
+//
+// A grid of square sectors sharing two-sided lines.  The corners of the
+// upper rows are moved about so their lines are diagonal, the lower two
+// rows stay square, so points in their middle are as far from the lines
+// on either side.  A separate room further right leaves empty blocks to
+// cast through.
+//
+static void BuildSectorMap(TestMap &map, std::mt19937 &rng)
+{
+	std::uniform_real_distribution<double> jitter(-30, 30);
+
+	for (int j = 0 ; j <= ROWS ; j++)
+		for (int i = 0 ; i <= COLUMNS ; i++)
+		{
+			double x = i * CELL;
+			double y = j * CELL;
+
+			bool inner = i > 0 && i < COLUMNS && j < ROWS;
+
+			if (inner && j >= 2)
+			{
+				x += round(jitter(rng));
+				y += round(jitter(rng));
+			}
+
+			map.addVertex(x, y);
+		}
+
+	for (int j = 0 ; j < ROWS ; j++)
+		for (int i = 0 ; i < COLUMNS ; i++)
+			map.addSector(8 * i, 128 + 8 * j);
+
+	auto vertex = [](int i, int j) { return j * (COLUMNS + 1) + i; };
+	auto sector = [](int i, int j) { return j * COLUMNS + i; };
+
+	// horizontal lines go east, so the cell below is on the right
+	for (int j = 0 ; j <= ROWS ; j++)
+		for (int i = 0 ; i < COLUMNS ; i++)
+		{
+			int below = (j > 0) ? sector(i, j - 1) : -1;
+			int above = (j < ROWS) ? sector(i, j) : -1;
+
+			if (below >= 0)
+				map.addLine(vertex(i, j), vertex(i + 1, j), below, above);
+			else
+				map.addLine(vertex(i + 1, j), vertex(i, j), above);
+		}
+
+	// vertical lines go north, so the cell on the east is on the right
+	for (int j = 0 ; j < ROWS ; j++)
+		for (int i = 0 ; i <= COLUMNS ; i++)
+		{
+			int west = (i > 0) ? sector(i - 1, j) : -1;
+			int east = (i < COLUMNS) ? sector(i, j) : -1;
+
+			if (east >= 0)
+				map.addLine(vertex(i, j), vertex(i, j + 1), east, west);
+			else
+				map.addLine(vertex(i, j + 1), vertex(i, j), west);
+		}
+
+	// an octagon, clockwise so its lines face inwards
+	map.addRoom({ { 1300, 100 }, { 1200, 200 }, { 1200, 300 }, { 1300, 400 },
+				  { 1400, 400 }, { 1500, 300 }, { 1500, 200 }, { 1400, 100 } });
+}
+
+static void ExpectSameSector(const Document &doc, const SectorLocator &locator, const v2double_t &pos)
+{
+	Objid expected = hover::getNearestSector(doc, pos);
+	Objid result = locator.locate(pos);
+
+	EXPECT_EQ(result.num, expected.num) << "at (" << pos.x << ", " << pos.y << ")";
+
+	if (expected.valid())
+		EXPECT_EQ(result.type, ObjType::sectors);
+}
+
+TEST(SectorLocator, MatchesNearestSectorAtRandom)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	std::mt19937 rng(1234);
+	BuildSectorMap(map, rng);
+
+	SectorLocator locator(inst.level);
+
+	// includes points well outside of the map, which the grid clamps
+	std::uniform_real_distribution<double> xs(-300, 1800);
+	std::uniform_real_distribution<double> ys(-300, ROWS * CELL + 300);
+
+	std::vector<v2double_t> points;
+
+	for (int i = 0 ; i < 5000 ; i++)
+	{
+		v2double_t pos = { xs(rng), ys(rng) };
+
+		// the integral ones hit vertices and lie on lines
+		if (i % 2 == 0)
+			pos = { round(pos.x), round(pos.y) };
+
+		points.push_back(pos);
+		ExpectSameSector(inst.level, locator, pos);
+	}
+
+	// locating many points at once gives the same
+	std::vector<int> sectors;
+	locator.locate(points, sectors);
+
+	ASSERT_EQ(sectors.size(), points.size());
+
+	for (size_t i = 0 ; i < points.size() ; i++)
+		ASSERT_EQ(sectors[i], hover::getNearestSector(inst.level, points[i]).num);
+}
+
+TEST(SectorLocator, MatchesNearestSectorOnBlockEdges)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	std::mt19937 rng(99);
+	BuildSectorMap(map, rng);
+
+	SectorLocator locator(inst.level);
+
+	// the map starts at (0, 0), so the blocks start at each 128 units
+	std::uniform_real_distribution<double> along(-200, 1700);
+
+	for (int edge = -1 ; edge <= 13 ; edge++)
+	{
+		for (int i = 0 ; i < 60 ; i++)
+		{
+			double other = round(along(rng));
+
+			ExpectSameSector(inst.level, locator, { edge * 128.0, other });
+			ExpectSameSector(inst.level, locator, { other, edge * 128.0 });
+
+			// the rays are offset, so also be just before the edge
+			ExpectSameSector(inst.level, locator, { edge * 128.0 - 0.04, other });
+			ExpectSameSector(inst.level, locator, { other, edge * 128.0 - 0.04 });
+		}
+	}
+}
+
+TEST(SectorLocator, MatchesNearestSectorOnTies)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	std::mt19937 rng(7);
+	BuildSectorMap(map, rng);
+
+	SectorLocator locator(inst.level);
+
+	// the middle of a square cell is as far from its lines on the left and
+	// on the right, and (in the middle row) from those above and below.
+	for (int j = 0 ; j < 2 ; j++)
+		for (int i = 0 ; i < COLUMNS ; i++)
+		{
+			double mid_x = i * CELL + CELL / 2;
+			double mid_y = j * CELL + CELL / 2;
+
+			ExpectSameSector(inst.level, locator, { mid_x, mid_y });
+			ExpectSameSector(inst.level, locator, { mid_x, j * CELL + 10.0 });
+			ExpectSameSector(inst.level, locator, { i * CELL + 10.0, mid_y });
+
+			// whichever line wins, it faces the cell itself
+			Objid result = locator.locate({ mid_x, mid_y });
+			ASSERT_EQ(result.num, j * COLUMNS + i);
+		}
+
+	// the middle of the octagon is a tie in both directions
+	ExpectSameSector(inst.level, locator, { 1350, 250 });
+	ASSERT_EQ(locator.locate({ 1350, 250 }).num, ROWS * COLUMNS);
+}
+
+//
+// In a proper map the lines tied for nearest lead to the same sector, so
+// this one has unclosed sectors: each line has its own on both sides.
+// The tied lines are in different blocks, and the one found first has
+// the higher number.
+//
+TEST(SectorLocator, MatchesNearestSectorOnTiesOfBrokenSectors)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	// the blocks start here
+	map.addVertex(0, 0);
+
+	for (int i = 0 ; i < 8 ; i++)
+		map.addSector();
+
+	// vertical lines at x=100 and x=156, either side of x=128
+	int v1 = map.addVertex(100, 0);
+	int v2 = map.addVertex(100, 100);
+	int v3 = map.addVertex(156, 0);
+	int v4 = map.addVertex(156, 100);
+
+	map.addLine(v1, v2, 0, 1);
+	map.addLine(v3, v4, 2, 3);
+
+	// horizontal lines at y=256 and y=200, the first on a block edge
+	int v5 = map.addVertex(300, 256);
+	int v6 = map.addVertex(400, 256);
+	int v7 = map.addVertex(300, 200);
+	int v8 = map.addVertex(400, 200);
+
+	map.addLine(v5, v6, 4, 5);
+	map.addLine(v7, v8, 6, 7);
+
+	SectorLocator locator(inst.level);
+
+	// the first line wins in both
+	ExpectSameSector(inst.level, locator, { 128, 50 });
+	ASSERT_EQ(locator.locate({ 128, 50 }).num, 0);
+
+	ExpectSameSector(inst.level, locator, { 350, 228 });
+	ASSERT_EQ(locator.locate({ 350, 228 }).num, 4);
+}
+
+TEST(SectorLocator, EmptyMap)
+{
+	Instance inst;
+
+	SectorLocator locator(inst.level);
+
+	ASSERT_FALSE(locator.locate({ 0, 0 }).valid());
+	ASSERT_FALSE(locator.locate({ -1000, 5000 }).valid());
+}
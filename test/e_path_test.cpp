@@ -0,0 +1,495 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "e_path.h"
+
+#include "e_cutpaste.h"
+#include "e_hover.h"
+#include "e_linedef.h"
+#include "e_main.h"
+#include "e_objects.h"
+#include "e_vertex.h"
+#include "r_render.h"
+#include "ui_canvas.h"
+#include "ui_misc.h"
+#include "ui_window.h"
+#include "testUtils/TestMap.hpp"
+
+#include <random>
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+ChecksModule::~ChecksModule()
+{
+}
+
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
+{
+}
+
+void ChecksModule::liveReset()
+{
+}
+
+void ChecksModule::liveWait()
+{
+}
+
+void Clipboard_ClearLocals()
+{
+}
+
+void Clipboard_NotifyDelete(ObjType type, int objnum)
+{
+}
+
+void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
+{
+}
+
+void DeleteObjects_WithUnused(EditOperation &op, const Document &doc, const selection_c &list, bool keep_things,
+							  bool keep_verts, bool keep_lines)
+{
+}
+
+int Document::numObjects(ObjType type) const
+{
+	return 0;
+}
+
+DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
+{
+}
+
+SelectHighlight Editor_State_t::SelectionOrHighlight()
+{
+	return SelectHighlight::ok;
+}
+
+void Editor_State_t::Selection_AddHighlighted()
+{
+}
+
+void Grid_State_c::AdjustScale(int delta)
+{
+}
+
+void Grid_State_c::MoveTo(const v2double_t &newpos)
+{
+}
+
+int Hover::getOppositeLinedef(int ld, Side ld_side, Side *result_side, const bitvec_c *ignore_lines) const
+{
+	return -1;
+}
+
+void Hover::invalidateSectorLocator()
+{
+}
+
+void Hover::notifyChanges(const ChangeSet &changes)
+{
+}
+
+int hover::getClosestLine_CastingHoriz(const Document &doc, v2double_t pos, Side *side)
+{
+	return -1;
+}
+
+Img_c::~Img_c()
+{
+}
+
+void Instance::Beep(const char *fmt, ...)
+{
+}
+
+bool Instance::Exec_HasFlag(const char *flag) const
+{
+	return false;
+}
+
+void Instance::Editor_ClearErrorMode()
+{
+}
+
+void Instance::MapStuff_NotifyBegin()
+{
+}
+
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::ObjectBox_NotifyBegin()
+{
+}
+
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::RedrawMap()
+{
+}
+
+void Instance::Selection_Clear(bool no_save)
+{
+}
+
+void Instance::Selection_NotifyBegin()
+{
+}
+
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::Status_Set(const char *fmt, ...) const
+{
+}
+
+void LiveChecks::wait()
+{
+}
+
+void LinedefModule::addSecondSidedef(EditOperation &op, int ld, int new_sd, int other_sd) const
+{
+}
+
+double LinedefModule::angleBetweenLines(int A, int B, int C) const
+{
+	return 0;
+}
+
+void LinedefModule::flipLinedefGroup(EditOperation &op, const selection_c *flip) const
+{
+}
+
+void ObjectsModule::calcBBox(const selection_c &list, v2double_t &pos1, v2double_t &pos2) const
+{
+}
+
+void ObjectsModule::del(EditOperation &op, const selection_c &list) const
+{
+}
+
+void Recently_used::insert(const SString &name)
+{
+}
+
+void Recently_used::insert_number(int val)
+{
+}
+
+void Render3D_Enable(Instance &inst, bool _enable)
+{
+}
+
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
+{
+}
+
+int UI_Canvas::ApproxBoxSize(int mx1, int my1, int mx2, int my2)
+{
+	return 0;
+}
+
+int UI_Escapable_Window::handle(int event)
+{
+	return 0;
+}
+
+UI_JumpToDialog::UI_JumpToDialog(const char *_objname, int _limit) : UI_Escapable_Window(0, 0)
+{
+}
+
+std::vector<int> UI_JumpToDialog::Run()
+{
+	return {};
+}
+
+void UI_SectorBox::UpdateField(int field)
+{
+}
+
+VertexLinks::VertexLinks(const Document &doc)
+{
+}
+
+const VertexLinks &VertexModule::links() const
+{
+	static VertexLinks links(doc);
+	return links;
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+//
+// The sound levels of each sector, the way they were found before the
+// sector graph: sweep over all the lines until nothing changes.
+//
+static std::vector<int> OldPropagation(const Document &doc, int start, bool ignore_doors)
+{
+	std::vector<int> vec(doc.numSectors(), 0);
+
+	vec[start] = 2;
+
+	bool changes;
+
+	do
+	{
+		changes = false;
+
+		for (const LineDef *L : doc.linedefs)
+		{
+			if (! L->TwoSided())
+				continue;
+
+			int sec1 = L->WhatSector(Side::right, doc);
+			int sec2 = L->WhatSector(Side::left, doc);
+
+			if (sec1 < 0 || sec2 < 0)
+				continue;
+
+			// check for doors
+			if (!ignore_doors &&
+				(std::min(doc.sectors[sec1]->ceilh, doc.sectors[sec2]->ceilh) <=
+				 std::max(doc.sectors[sec1]->floorh, doc.sectors[sec2]->floorh)))
+			{
+				continue;
+			}
+
+			int val1 = vec[sec1];
+			int val2 = vec[sec2];
+
+			int new_val = std::max(val1, val2);
+
+			if (L->flags & MLF_SoundBlock)
+				new_val -= 1;
+
+			if (new_val > val1 || new_val > val2)
+			{
+				if (new_val > val1)
+					vec[sec1] = new_val;
+				if (new_val > val2)
+					vec[sec2] = new_val;
+
+				changes = true;
+			}
+		}
+
+	} while (changes);
+
+	return vec;
+}
+
+//
+// Both passes combined: through closed doors or not
+//
+static std::vector<int> OldSoundPropagation(const Document &doc, int start)
+{
+	std::vector<int> closed = OldPropagation(doc, start, false);
+	std::vector<int> open   = OldPropagation(doc, start, true);
+
+	std::vector<int> result(doc.numSectors());
+
+	for (int s = 0 ; s < doc.numSectors() ; s++)
+	{
+		int t1 = closed[s];
+		int t2 = open[s];
+
+		if (t1 != t2 && (t1 == 0 || t2 == 0))
+		{
+			result[s] = PGL_Maybe;
+			continue;
+		}
+
+		switch (std::min(t1, t2))
+		{
+			case 0:  result[s] = PGL_Never;   break;
+			case 1:  result[s] = PGL_Level_1; break;
+			default: result[s] = PGL_Level_2; break;
+		}
+	}
+
+	return result;
+}
+
+static std::vector<int> SoundLevels(Instance &inst, int start)
+{
+	const byte *levels = inst.SoundPropagation(start);
+
+	return std::vector<int>(levels, levels + inst.level.numSectors());
+}
+
+static void SetSoundBlock(Document &doc, int line)
+{
+	doc.linedefs[line]->flags |= MLF_SoundBlock;
+}
+
+TEST(SoundPropagation, BlockingLines)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	// the graph only looks at the sides, so the lines can all be points
+	map.addVertex(0, 0);
+
+	for (int s = 0 ; s < 5 ; s++)
+		map.addSector();
+
+	// a row 0-1-2-3, with sound blocking lines between 1-2 and 2-3
+	map.addLine(0, 0, 0, 1);
+	SetSoundBlock(inst.level, map.addLine(0, 0, 1, 2));
+	SetSoundBlock(inst.level, map.addLine(0, 0, 3, 2));
+
+	// sector 4 is only reached through a one-sided line
+	map.addLine(0, 0, 4);
+
+	ASSERT_EQ(SoundLevels(inst, 0),
+			  (std::vector<int>{ PGL_Level_2, PGL_Level_2, PGL_Level_1, PGL_Never, PGL_Never }));
+
+	ASSERT_EQ(SoundLevels(inst, 3),
+			  (std::vector<int>{ PGL_Never, PGL_Never, PGL_Level_1, PGL_Level_2, PGL_Never }));
+
+	ASSERT_EQ(SoundLevels(inst, 4),
+			  (std::vector<int>{ PGL_Never, PGL_Never, PGL_Never, PGL_Never, PGL_Level_2 }));
+}
+
+//
+// The first way found to a sector crosses a blocking line, but a longer
+// way round does not
+//
+TEST(SoundPropagation, LongerWayWithoutBlocking)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	map.addVertex(0, 0);
+
+	for (int s = 0 ; s < 6 ; s++)
+		map.addSector();
+
+	SetSoundBlock(inst.level, map.addLine(0, 0, 0, 5));
+	map.addLine(0, 0, 0, 1);
+	map.addLine(0, 0, 2, 1);
+	map.addLine(0, 0, 2, 3);
+	map.addLine(0, 0, 4, 3);
+	map.addLine(0, 0, 4, 5);
+
+	ASSERT_EQ(SoundLevels(inst, 0), std::vector<int>(6, PGL_Level_2));
+	ASSERT_EQ(SoundLevels(inst, 0), OldSoundPropagation(inst.level, 0));
+}
+
+TEST(SoundPropagation, ClosedDoors)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	map.addVertex(0, 0);
+
+	map.addSector(0, 128);
+	map.addSector(0, 0);		// a closed door
+	map.addSector(0, 128);
+	map.addSector(0, 128);
+
+	// 0 - door - 2, then 2-3 across a blocking line
+	map.addLine(0, 0, 0, 1);
+	map.addLine(0, 0, 1, 2);
+	SetSoundBlock(inst.level, map.addLine(0, 0, 2, 3));
+
+	// the door and everything past it are heard only if it opens
+	ASSERT_EQ(SoundLevels(inst, 0),
+			  (std::vector<int>{ PGL_Level_2, PGL_Maybe, PGL_Maybe, PGL_Maybe }));
+
+	ASSERT_EQ(SoundLevels(inst, 0), OldSoundPropagation(inst.level, 0));
+
+	// the sector being edited makes it recompute
+	inst.level.sectors[1]->ceilh = 64;
+	inst.sound_propagation_invalid = true;
+
+	ASSERT_EQ(SoundLevels(inst, 0),
+			  (std::vector<int>{ PGL_Level_2, PGL_Level_2, PGL_Level_2, PGL_Level_1 }));
+}
+
+TEST(SoundPropagation, MatchesOldSweepAtRandom)
+{
+	std::mt19937 rng(4321);
+
+	for (int round = 0 ; round < 20 ; round++)
+	{
+		Instance inst;
+		TestMap map(inst.level);
+
+		map.addVertex(0, 0);
+
+		const int num_sectors = 40;
+
+		std::uniform_int_distribution<int> sector(0, num_sectors - 1);
+		std::uniform_int_distribution<int> height(0, 4);
+		std::uniform_int_distribution<int> pick(0, 99);
+
+		// many of the sectors are closed, like doors
+		for (int s = 0 ; s < num_sectors ; s++)
+		{
+			int floorh = height(rng) * 8;
+			int ceilh  = (pick(rng) < 25) ? floorh : floorh + height(rng) * 32 + 8;
+
+			map.addSector(floorh, ceilh);
+		}
+
+		for (int n = 0 ; n < 70 ; n++)
+		{
+			int kind = pick(rng);
+
+			int line;
+
+			if (kind < 5)
+				line = map.addLine(0, 0, sector(rng));		// one-sided
+			else if (kind < 10)
+			{
+				int sec = sector(rng);
+				line = map.addLine(0, 0, sec, sec);			// self-referencing
+			}
+			else
+				line = map.addLine(0, 0, sector(rng), sector(rng));
+
+			if (pick(rng) < 35)
+				SetSoundBlock(inst.level, line);
+		}
+
+		for (int start = 0 ; start < num_sectors ; start++)
+		{
+			ASSERT_EQ(SoundLevels(inst, start), OldSoundPropagation(inst.level, start))
+				<< "round " << round << ", starting in sector " << start;
+		}
+	}
+}
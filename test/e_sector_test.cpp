@@ -0,0 +1,966 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "e_sector.h"
+
+#include "e_cutpaste.h"
+#include "e_hover.h"
+#include "e_linedef.h"
+#include "e_main.h"
+#include "e_objects.h"
+#include "e_vertex.h"
+#include "LineDef.h"
+#include "m_select.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "ui_window.h"
+#include "testUtils/TestMap.hpp"
+
+#include <algorithm>
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+ChecksModule::~ChecksModule()
+{
+}
+
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
+{
+}
+
+void ChecksModule::liveReset()
+{
+}
+
+void ChecksModule::liveWait()
+{
+}
+
+void Clipboard_ClearLocals()
+{
+}
+
+void Clipboard_NotifyDelete(ObjType type, int objnum)
+{
+}
+
+void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
+{
+}
+
+void ConvertSelection(const Document &doc, const selection_c & src, selection_c & dest)
+{
+}
+
+void DeleteObjects_WithUnused(EditOperation &op, const Document &doc, const selection_c &list, bool keep_things,
+							  bool keep_verts, bool keep_lines)
+{
+}
+
+DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
+{
+}
+
+int Grid_State_c::ForceSnapX(double map_x) const
+{
+	return 0;
+}
+
+void Grid_State_c::RatioSnapXY(v2double_t &var, const v2double_t &start) const
+{
+}
+
+SelectHighlight Editor_State_t::SelectionOrHighlight()
+{
+	return SelectHighlight::ok;
+}
+
+void Editor_State_t::Selection_AddHighlighted()
+{
+}
+
+Img_c::~Img_c()
+{
+}
+
+Img_c * ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	return nullptr;
+}
+
+int ImageSet::W_GetTextureHeight(const ConfigData &config, const SString &name) const
+{
+	return 128;
+}
+
+void Instance::Beep(const char *fmt, ...)
+{
+}
+
+void Instance::CalculateLevelBounds()
+{
+}
+
+bool Instance::Exec_HasFlag(const char *flag) const
+{
+	return false;
+}
+
+bool Instance::is_sky(const SString &flat) const
+{
+	return false;
+}
+
+bool is_null_tex(const SString &tex)
+{
+	return false;
+}
+
+void Instance::MapStuff_NotifyBegin()
+{
+}
+
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::ObjectBox_NotifyBegin()
+{
+}
+
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::RedrawMap()
+{
+}
+
+void Instance::Selection_Clear(bool no_save)
+{
+}
+
+void Instance::Selection_NotifyBegin()
+{
+}
+
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
+{
+}
+
+void Instance::Status_Set(const char *fmt, ...) const
+{
+}
+
+void LiveChecks::wait()
+{
+}
+
+const thingtype_t &M_GetThingType(const ConfigData &config, int type)
+{
+	static thingtype_t thingtype = {};
+	return thingtype;
+}
+
+void ObjectsModule::calcBBox(const selection_c &list, v2double_t &pos1, v2double_t &pos2) const
+{
+}
+
+v2double_t ObjectsModule::calcMiddle(const selection_c &list) const
+{
+	return {};
+}
+
+void ObjectsModule::del(EditOperation &op, const selection_c &list) const
+{
+}
+
+void Recently_used::insert(const SString &name)
+{
+}
+
+void Recently_used::insert_number(int val)
+{
+}
+
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
+{
+}
+
+void UI_SectorBox::UpdateField(int field)
+{
+}
+
+int vertex_radius(double scale)
+{
+	return 0;
+}
+
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+//
+// A small map for the sector graph, with its objects kept in place
+//
+class SectorGraphMap
+{
+public:
+	SectorGraphMap(Instance &inst, int num_sectors) : inst(inst), sectors(num_sectors)
+	{
+		// keep the addresses stable
+		lines.reserve(64);
+		sides.reserve(128);
+
+		for (Sector &sector : sectors)
+			inst.level.sectors.push_back(&sector);
+	}
+
+	// adds a line with the given sectors on each side (-1 for no side)
+	void addLine(int right_sec, int left_sec)
+	{
+		LineDef line;
+		line.right = addSide(right_sec);
+		line.left = addSide(left_sec);
+
+		lines.push_back(line);
+		inst.level.linedefs.push_back(&lines.back());
+	}
+
+private:
+	int addSide(int sec)
+	{
+		if (sec < 0)
+			return -1;
+
+		SideDef side;
+		side.sector = sec;
+
+		sides.push_back(side);
+		inst.level.sidedefs.push_back(&sides.back());
+
+		return static_cast<int>(sides.size()) - 1;
+	}
+
+	Instance &inst;
+
+	std::vector<Sector> sectors;
+	std::vector<LineDef> lines;
+	std::vector<SideDef> sides;
+};
+
+static std::vector<int> SelectedNumbers(const selection_c &list)
+{
+	std::vector<int> result;
+
+	for (sel_iter_c it(list) ; !it.done() ; it.next())
+		result.push_back(*it);
+
+	// small selections keep the order the objects were added in
+	std::sort(result.begin(), result.end());
+	return result;
+}
+
+//
+// Sectors 0-1-2 in a row, 3-4 apart from them, 5 alone
+//
+static void BuildSampleMap(SectorGraphMap &map)
+{
+	map.addLine(0, 1);		// 0: several lines between 0 and 1...
+	map.addLine(0, 1);		// 1
+	map.addLine(1, 0);		// 2: ...also facing the other way
+	map.addLine(1, 2);		// 3
+	map.addLine(2, 2);		// 4: self-referencing
+	map.addLine(3, -1);		// 5: one-sided
+	map.addLine(-1, 3);		// 6: only a left side
+	map.addLine(3, 4);		// 7
+}
+
+TEST(SectorGraph, Edges)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	ASSERT_EQ(graph.numSectors(), 6);
+
+	// the edges come in linedef order
+	std::vector<std::pair<int, int>> edges;
+	for (const SectorGraph::Edge &edge : graph.edges(0))
+		edges.emplace_back(edge.line, edge.sector);
+	ASSERT_EQ(edges, (std::vector<std::pair<int, int>>{ { 0, 1 }, { 1, 1 }, { 2, 1 } }));
+
+	edges.clear();
+	for (const SectorGraph::Edge &edge : graph.edges(2))
+		edges.emplace_back(edge.line, edge.sector);
+	ASSERT_EQ(edges, (std::vector<std::pair<int, int>>{ { 3, 1 } }));
+
+	// the lines missing a side take no part
+	edges.clear();
+	for (const SectorGraph::Edge &edge : graph.edges(3))
+		edges.emplace_back(edge.line, edge.sector);
+	ASSERT_EQ(edges, (std::vector<std::pair<int, int>>{ { 7, 4 } }));
+
+	ASSERT_TRUE(graph.edges(5).empty());
+}
+
+TEST(SectorGraph, AreNeighbors)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	ASSERT_TRUE(graph.areNeighbors(0, 1));
+	ASSERT_TRUE(graph.areNeighbors(1, 0));
+	ASSERT_TRUE(graph.areNeighbors(1, 2));
+	ASSERT_TRUE(graph.areNeighbors(3, 4));
+
+	ASSERT_FALSE(graph.areNeighbors(0, 2));
+	ASSERT_FALSE(graph.areNeighbors(2, 2));		// only through its own line
+	ASSERT_FALSE(graph.areNeighbors(3, 3));
+	ASSERT_FALSE(graph.areNeighbors(2, 3));
+	ASSERT_FALSE(graph.areNeighbors(5, 0));
+}
+
+TEST(SectorGraph, LinesBetween)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	selection_c lines(ObjType::linedefs);
+	graph.linesBetween(lines, 0, 1);
+	ASSERT_EQ(SelectedNumbers(lines), (std::vector<int>{ 0, 1, 2 }));
+
+	lines.clear_all();
+	graph.linesBetween(lines, 1, 0);
+	ASSERT_EQ(SelectedNumbers(lines), (std::vector<int>{ 0, 1, 2 }));
+
+	lines.clear_all();
+	graph.linesBetween(lines, 2, 2);
+	graph.linesBetween(lines, 3, 3);
+	graph.linesBetween(lines, 0, 2);
+	ASSERT_TRUE(lines.empty());
+
+	// it adds to what is already there
+	lines.set(5);
+	graph.linesBetween(lines, 4, 3);
+	ASSERT_EQ(SelectedNumbers(lines), (std::vector<int>{ 5, 7 }));
+}
+
+TEST(SectorGraph, LinesWithin)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	selection_c secs(ObjType::sectors);
+	secs.set(0);
+	secs.set(1);
+	secs.set(2);
+
+	selection_c lines(ObjType::linedefs);
+	graph.linesWithin(lines, secs);
+	ASSERT_EQ(SelectedNumbers(lines), (std::vector<int>{ 0, 1, 2, 3 }));
+
+	// a single sector has nothing within, not even its own lines
+	secs.clear_all();
+	secs.set(2);
+	lines.clear_all();
+	graph.linesWithin(lines, secs);
+	ASSERT_TRUE(lines.empty());
+
+	secs.clear_all();
+	secs.set(3);
+	graph.linesWithin(lines, secs);
+	ASSERT_TRUE(lines.empty());
+}
+
+TEST(SectorGraph, GrowGroup)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	selection_c secs(ObjType::sectors);
+	secs.set(0);
+	graph.growGroup(secs);
+	ASSERT_EQ(SelectedNumbers(secs), (std::vector<int>{ 0, 1, 2 }));
+
+	secs.clear_all();
+	secs.set(4);
+	graph.growGroup(secs);
+	ASSERT_EQ(SelectedNumbers(secs), (std::vector<int>{ 3, 4 }));
+
+	secs.clear_all();
+	secs.set(5);
+	graph.growGroup(secs);
+	ASSERT_EQ(SelectedNumbers(secs), (std::vector<int>{ 5 }));
+
+	// stop at line 3, and check what the filter gets
+	std::vector<std::pair<int, int>> crossed;
+	auto filter = [&crossed](int line, int sec1, int sec2)
+	{
+		if (line == 3)
+			return false;
+		crossed.emplace_back(sec1, sec2);
+		return true;
+	};
+
+	secs.clear_all();
+	secs.set(0);
+	graph.growGroup(secs, filter);
+	ASSERT_EQ(SelectedNumbers(secs), (std::vector<int>{ 0, 1 }));
+	ASSERT_EQ(crossed, (std::vector<std::pair<int, int>>{ { 0, 1 } }));
+
+	// several starting sectors
+	secs.clear_all();
+	secs.set(2);
+	secs.set(3);
+	graph.growGroup(secs, filter);
+	ASSERT_EQ(SelectedNumbers(secs), (std::vector<int>{ 2, 3, 4 }));
+}
+
+TEST(SectorGraph, FindComponents)
+{
+	Instance inst;
+	SectorGraphMap map(inst, 6);
+	BuildSampleMap(map);
+
+	SectorGraph graph(inst.level);
+
+	std::vector<int> comp;
+	ASSERT_EQ(graph.findComponents(comp), 3);
+	ASSERT_EQ(comp, (std::vector<int>{ 0, 0, 0, 1, 1, 2 }));
+
+	auto filter = [](int line, int sec1, int sec2)
+	{
+		return line != 7;
+	};
+	ASSERT_EQ(graph.findComponents(comp, filter), 4);
+	ASSERT_EQ(comp, (std::vector<int>{ 0, 0, 0, 1, 2, 3 }));
+
+	// the lines between 0 and 1 must all be blocked to split them
+	auto filter2 = [](int line, int sec1, int sec2)
+	{
+		return line != 0 && line != 1;
+	};
+	ASSERT_EQ(graph.findComponents(comp, filter2), 3);
+	ASSERT_EQ(comp, (std::vector<int>{ 0, 0, 0, 1, 1, 2 }));
+}
+
+TEST(SectorGraph, EmptyMap)
+{
+	Instance inst;
+	SectorGraph graph(inst.level);
+
+	ASSERT_EQ(graph.numSectors(), 0);
+
+	std::vector<int> comp;
+	ASSERT_EQ(graph.findComponents(comp), 0);
+	ASSERT_TRUE(comp.empty());
+
+	// only lines missing a side or with the same sector on both
+	SectorGraphMap map(inst, 2);
+	map.addLine(0, 0);
+	map.addLine(1, -1);
+	map.addLine(-1, -1);
+
+	SectorGraph graph2(inst.level);
+
+	ASSERT_EQ(graph2.numSectors(), 2);
+	ASSERT_TRUE(graph2.edges(0).empty());
+	ASSERT_TRUE(graph2.edges(1).empty());
+	ASSERT_EQ(graph2.findComponents(comp), 2);
+	ASSERT_EQ(comp, (std::vector<int>{ 0, 1 }));
+}
+
+//
+// The number of lines at a vertex, before the vertex links
+//
+static int OldHowManyLinedefs(const Document &doc, int v_num)
+{
+	int count = 0;
+
+	for (const LineDef *L : doc.linedefs)
+		if (L->start == v_num || L->end == v_num)
+			count++;
+
+	return count;
+}
+
+//
+// Traces a line loop the way it was done before the vertex links: each
+// step scans all the linedefs for the ones at the current vertex, and
+// searches the loop for the line/sides already in it.
+//
+static bool OldTraceLineLoop(const Document &doc, int ld, Side side, lineloop_c &loop,
+							 bool ignore_bare = false)
+{
+	int start_ld = ld;
+	Side start_side = side;
+
+	loop.clear();
+
+	int cur_vert  = (side == Side::right) ? doc.linedefs[ld]->end   : doc.linedefs[ld]->start;
+	int prev_vert = (side == Side::right) ? doc.linedefs[ld]->start : doc.linedefs[ld]->end;
+
+	if (OldHowManyLinedefs(doc, cur_vert) == 1 && OldHowManyLinedefs(doc, prev_vert) == 1)
+		return false;
+
+	double average_angle = 0;
+
+	for (;;)
+	{
+		loop.push_back(ld, side);
+
+		int next_line = -1;
+		int next_vert = -1;
+		Side next_side = Side::neither;
+
+		double best_angle = 9999;
+
+		for (int n = 0 ; n < doc.numLinedefs() ; n++)
+		{
+			const LineDef *N = doc.linedefs[n];
+
+			if (! N->TouchesVertex(cur_vert))
+				continue;
+
+			if (ignore_bare && !N->Left(doc) && !N->Right(doc))
+				continue;
+
+			int other_vert = (N->start == cur_vert) ? N->end : N->start;
+			Side which_side = (N->start == cur_vert) ? Side::right : Side::left;
+
+			double angle;
+
+			if (n == ld)
+				angle = 361.0;
+			else
+				angle = doc.linemod.angleBetweenLines(prev_vert, cur_vert, other_vert);
+
+			if (next_line < 0 || angle < best_angle)
+			{
+				next_line = n;
+				next_vert = other_vert;
+				next_side = which_side;
+
+				best_angle = angle;
+			}
+		}
+
+		if (next_line < 0)
+			return false;
+
+		if (next_line == start_ld && next_side == start_side)
+			break;
+
+		if (loop.get(next_line, next_side))
+			return false;
+
+		ld   = next_line;
+		side = next_side;
+
+		prev_vert = cur_vert;
+		cur_vert  = next_vert;
+
+		average_angle += best_angle;
+	}
+
+	if (loop.lines.size() < 3)
+		return false;
+
+	loop.faces_outward = (average_angle / (double)loop.lines.size() >= 180.0);
+
+	return true;
+}
+
+//
+// Finds the islands the way it was done before: checking whether the
+// lines are in the loop by searching it and its islands.
+//
+static void OldFindIslands(const Document &doc, lineloop_c &loop)
+{
+	for (int pass = 0 ; pass < 200 ; pass++)
+	{
+		double bbox_x1 = +9e9, bbox_y1 = +9e9;
+		double bbox_x2 = -9e9, bbox_y2 = -9e9;
+
+		for (int ld : loop.lines)
+		{
+			const LineDef *L = doc.linedefs[ld];
+
+			bbox_x1 = std::min(bbox_x1, std::min(L->Start(doc)->x(), L->End(doc)->x()));
+			bbox_y1 = std::min(bbox_y1, std::min(L->Start(doc)->y(), L->End(doc)->y()));
+			bbox_x2 = std::max(bbox_x2, std::max(L->Start(doc)->x(), L->End(doc)->x()));
+			bbox_y2 = std::max(bbox_y2, std::max(L->Start(doc)->y(), L->End(doc)->y()));
+		}
+
+		int count = 0;
+
+		for (int ld = 0 ; ld < doc.numLinedefs() ; ld++)
+		{
+			const LineDef *L = doc.linedefs[ld];
+
+			double x1 = L->Start(doc)->x();
+			double y1 = L->Start(doc)->y();
+			double x2 = L->End(doc)->x();
+			double y2 = L->End(doc)->y();
+
+			if (std::max(x1, x2) < bbox_x1 || std::min(x1, x2) > bbox_x2 ||
+				std::max(y1, y2) < bbox_y1 || std::min(y1, y2) > bbox_y2)
+				continue;
+
+			for (int where = 0 ; where < 2 ; where++)
+			{
+				Side ld_side = where ? Side::right : Side::left;
+
+				Side opp_side;
+				int opp = doc.hover.getOppositeLinedef(ld, ld_side, &opp_side, nullptr);
+
+				if (opp < 0)
+					continue;
+
+				bool  ld_in_path = loop.get(ld, ld_side);
+				bool opp_in_path = loop.get(opp, opp_side);
+
+				if (ld_in_path == opp_in_path)
+					continue;
+
+				lineloop_c *island = new lineloop_c(doc);
+
+				if (! ld_in_path &&
+					OldHowManyLinedefs(doc, L->start) == 1 &&
+					OldHowManyLinedefs(doc, L->end) == 1)
+				{
+					island->push_back(ld, Side::right);
+					island->push_back(ld, Side::left);
+
+					loop.islands.push_back(island);
+					count++;
+					continue;
+				}
+
+				bool ok;
+
+				if (ld_in_path)
+					ok = OldTraceLineLoop(doc, opp, opp_side, *island);
+				else
+					ok = OldTraceLineLoop(doc, ld, ld_side, *island);
+
+				if (ok && island->faces_outward)
+				{
+					loop.islands.push_back(island);
+					count++;
+				}
+				else
+				{
+					delete island;
+				}
+			}
+		}
+
+		if (count == 0)
+			break;
+	}
+}
+
+static void ExpectSameLoop(const lineloop_c &loop, const lineloop_c &expected, const char *what)
+{
+	EXPECT_EQ(loop.lines, expected.lines) << what;
+	EXPECT_EQ(loop.sides, expected.sides) << what;
+	EXPECT_EQ(loop.faces_outward, expected.faces_outward) << what;
+
+	ASSERT_EQ(loop.islands.size(), expected.islands.size()) << what;
+
+	for (size_t i = 0 ; i < loop.islands.size() ; i++)
+		ExpectSameLoop(*loop.islands[i], *expected.islands[i], what);
+}
+
+//
+// A big room (sector 0) holding:
+//   - a square pillar and a triangular one,
+//   - a pentagon split into triangles (sectors 1 to 5) by lines meeting
+//     at a vertex in its middle,
+//   - a line sticking out of the east wall, and a line on its own.
+// A second room (sector 6) stands further east, and past it a triangle
+// (sector 7) with two of its walls on top of each other.
+//
+struct LoopMapLines
+{
+	int first_rim;		// the pentagon lines come in rim/spoke pairs
+	int sticking;
+	int alone;
+	int other_room;
+};
+
+static LoopMapLines BuildLoopMap(TestMap &map)
+{
+	LoopMapLines result;
+
+	map.addSector();
+
+	// the outer walls, with a vertex half way along the east wall
+	map.addRoom({ { 0, 0 }, { 0, 1024 }, { 1024, 1024 }, { 1024, 512 }, { 1024, 0 } });
+
+	// the pillars, going anti-clockwise so the room is on the right
+	auto pillar = [&map](const std::vector<v2double_t> &corners)
+	{
+		int first = map.doc.numVertices();
+
+		for (const v2double_t &corner : corners)
+			map.addVertex(corner.x, corner.y);
+
+		int count = static_cast<int>(corners.size());
+
+		for (int i = 0 ; i < count ; i++)
+			map.addLine(first + i, first + (i + 1) % count, 0);
+	};
+
+	pillar({ { 200, 200 }, { 400, 200 }, { 400, 400 }, { 200, 400 } });
+	pillar({ { 600, 150 }, { 800, 150 }, { 700, 350 } });
+
+	// the pentagon, with five lines meeting at its middle
+	int middle = map.addVertex(500, 700);
+	int rim = map.doc.numVertices();
+
+	const v2double_t points[5] = { { 500, 900 }, { 690, 760 }, { 620, 540 }, { 380, 540 }, { 310, 760 } };
+
+	for (const v2double_t &point : points)
+		map.addVertex(point.x, point.y);
+
+	for (int i = 0 ; i < 5 ; i++)
+		map.addSector();
+
+	result.first_rim = map.doc.numLinedefs();
+
+	for (int i = 0 ; i < 5 ; i++)
+	{
+		// clockwise around the pentagon, triangle i is on the right
+		map.addLine(rim + (i + 1) % 5, rim + i, 0, 1 + i);
+
+		// the spokes, going out from the middle
+		map.addLine(middle, rim + i, 1 + i, 1 + (i + 4) % 5);
+	}
+
+	// sticking out of the east wall (its second corner)
+	int tip = map.addVertex(800, 512);
+	result.sticking = map.addLine(3, tip, 0, 0);
+
+	// on its own
+	result.alone = map.addLine(map.addVertex(100, 900), map.addVertex(150, 950), 0, 0);
+
+	result.other_room = map.doc.numLinedefs();
+
+	map.addRoom({ { 1500, 0 }, { 1500, 300 }, { 1800, 300 }, { 1800, 0 } });
+
+	// the overlapping walls are at the same angle from either end, so the
+	// lower numbered one gets taken
+	int triangle = map.doc.numLinedefs();
+
+	map.addRoom({ { 2000, 0 }, { 2100, 200 }, { 2200, 0 } });
+	map.addLine(map.doc.linedefs[triangle]->start, map.doc.linedefs[triangle]->end, 7);
+
+	return result;
+}
+
+static void ExpectTracesMatchOldScan(const Document &doc)
+{
+	for (int ld = 0 ; ld < doc.numLinedefs() ; ld++)
+		for (Side side : { Side::right, Side::left })
+			for (bool ignore_bare : { false, true })
+			{
+				lineloop_c loop(doc);
+				lineloop_c expected(doc);
+
+				bool ok = doc.secmod.traceLineLoop(ld, side, loop, ignore_bare);
+				bool expected_ok = OldTraceLineLoop(doc, ld, side, expected, ignore_bare);
+
+				ASSERT_EQ(ok, expected_ok) << "line " << ld << " side " << (int)side;
+
+				// also the same way up to where it failed
+				if (ok)
+					ExpectSameLoop(loop, expected, "traced loop");
+				else
+					EXPECT_EQ(loop.lines, expected.lines) << "failed loop";
+			}
+}
+
+TEST(LineLoop, TraceMatchesOldScan)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	BuildLoopMap(map);
+
+	ExpectTracesMatchOldScan(inst.level);
+}
+
+TEST(LineLoop, TraceAroundVertexWithManyLines)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	LoopMapLines lines = BuildLoopMap(map);
+
+	const Document &doc = inst.level;
+
+	// the rim line of the first triangle, then the spokes on either side
+	int first_rim = lines.first_rim;
+	lineloop_c loop(doc);
+
+	ASSERT_TRUE(doc.secmod.traceLineLoop(first_rim, Side::left, loop));
+	ASSERT_FALSE(loop.faces_outward);
+	ASSERT_EQ(loop.lines, (std::vector<int>{ first_rim, first_rim + 3, first_rim + 1 }));
+
+	int sec;
+	ASSERT_TRUE(loop.SameSector(&sec));
+	ASSERT_EQ(sec, 1);
+
+	// the outside of the pentagon is one island
+	ASSERT_TRUE(doc.secmod.traceLineLoop(first_rim, Side::right, loop));
+	ASSERT_TRUE(loop.faces_outward);
+	ASSERT_EQ(loop.lines.size(), 5u);
+
+	// the line on its own is no loop
+	ASSERT_FALSE(doc.secmod.traceLineLoop(lines.alone, Side::right, loop));
+}
+
+TEST(LineLoop, IslandsMatchOldScan)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	LoopMapLines lines = BuildLoopMap(map);
+
+	const Document &doc = inst.level;
+
+	lineloop_c loop(doc);
+	lineloop_c expected(doc);
+
+	ASSERT_TRUE(doc.secmod.traceLineLoop(0, Side::right, loop));
+	ASSERT_TRUE(OldTraceLineLoop(doc, 0, Side::right, expected));
+
+	ASSERT_FALSE(loop.faces_outward);
+
+	// the line sticking out goes there and back
+	ASSERT_TRUE(loop.get(lines.sticking, Side::right));
+	ASSERT_TRUE(loop.get(lines.sticking, Side::left));
+	ASSERT_EQ(loop.lines.size(), 7u);
+
+	loop.FindIslands();
+	OldFindIslands(doc, expected);
+
+	ExpectSameLoop(loop, expected, "room with islands");
+
+	// the two pillars, the pentagon and the line on its own
+	ASSERT_EQ(loop.islands.size(), 4u);
+
+	int found_alone = 0;
+
+	for (const lineloop_c *island : loop.islands)
+	{
+		if (island->get_just_line(lines.alone))
+		{
+			ASSERT_EQ(island->lines, (std::vector<int>{ lines.alone, lines.alone }));
+			found_alone++;
+		}
+		else
+		{
+			ASSERT_TRUE(island->faces_outward);
+		}
+	}
+
+	ASSERT_EQ(found_alone, 1);
+
+	// the other room has none
+	lineloop_c other(doc);
+
+	ASSERT_TRUE(doc.secmod.traceLineLoop(lines.other_room, Side::right, other));
+	other.FindIslands();
+	ASSERT_TRUE(other.islands.empty());
+}
+
+//
+// The lines at each vertex are kept until the lines get connected
+// differently, which goes through the Basis
+//
+TEST(LineLoop, TraceAfterReconnecting)
+{
+	Instance inst;
+	TestMap map(inst.level);
+
+	LoopMapLines lines = BuildLoopMap(map);
+
+	Document &doc = inst.level;
+
+	ExpectTracesMatchOldScan(doc);
+
+	// the line sticking out now reaches the square pillar
+	{
+		EditOperation op(doc.basis);
+		op.setMessage("reconnect");
+		op.changeLinedef(lines.sticking, LineDef::F_END, 7);
+	}
+
+	ExpectTracesMatchOldScan(doc);
+
+	lineloop_c loop(doc);
+	ASSERT_TRUE(doc.secmod.traceLineLoop(0, Side::right, loop));
+
+	// the pillar is part of the room's loop now
+	ASSERT_TRUE(loop.get_just_line(5));
+	ASSERT_EQ(loop.lines.size(), 5u + 2u + 4u);
+
+	// a new line joins the line on its own to the outer wall
+	{
+		EditOperation op(doc.basis);
+		op.setMessage("join");
+
+		int ld = op.addNew(ObjType::linedefs);
+
+		op.changeLinedef(ld, LineDef::F_START, 1);
+		op.changeLinedef(ld, LineDef::F_END, doc.linedefs[lines.alone]->start);
+	}
+
+	ExpectTracesMatchOldScan(doc);
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "im_img.h"
+#include "gtest/gtest.h"
+
+#include "testUtils/ImgLoops.hpp"
+
+#include <chrono>
+
+static double ElapsedMs(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+//
+// Times the old and new loops on texture sized images.  The results are
+// printed, not checked, since they depend on the machine and compiler.
+//
+TEST(ImgPixels, Benchmark)
+{
+	std::mt19937 rng(777);
+
+	// a 256x128 texture made of 64x128 patches, some hanging over the edges
+	const int W = 256;
+	const int H = 128;
+	const int PW = 64;
+	const int PH = 128;
+	const int rounds = 2000;
+
+	std::vector<img_pixel_t> patch = MakePatch(rng, PW, PH, 20);
+	std::vector<img_pixel_t> old_img(W * H, TRANS_PIXEL);
+	std::vector<img_pixel_t> new_img(W * H, TRANS_PIXEL);
+
+	auto start = std::chrono::steady_clock::now();
+	for (int r = 0 ; r < rounds ; r++)
+		for (int x = -32 ; x < W ; x += PW)
+			OldCompose(old_img.data(), W, H, patch.data(), PW, PH, x, r % 3 - 1);
+	double old_ms = ElapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int r = 0 ; r < rounds ; r++)
+		for (int x = -32 ; x < W ; x += PW)
+			NewCompose(new_img.data(), W, H, patch.data(), PW, PH, x, r % 3 - 1);
+	double new_ms = ElapsedMs(start);
+
+	ASSERT_EQ(old_img, new_img);
+
+	printf("compose: old %.1f ms, new %.1f ms (%d rounds of %dx%d)\n", old_ms, new_ms, rounds, W, H);
+
+	// the worst case of the transparency check: no transparent pixel
+	std::vector<img_pixel_t> solid(W * H, 4);
+	int old_found = 0;
+	int new_found = 0;
+
+	start = std::chrono::steady_clock::now();
+	for (int r = 0 ; r < rounds ; r++)
+	{
+		solid[r % solid.size()] = static_cast<img_pixel_t>(r & 0xfe);
+		old_found += OldHasTransparent(solid.data(), W, H);
+	}
+	old_ms = ElapsedMs(start);
+
+	start = std::chrono::steady_clock::now();
+	for (int r = 0 ; r < rounds ; r++)
+	{
+		solid[r % solid.size()] = static_cast<img_pixel_t>(r & 0xfe);
+		new_found += IM_HasTransPixel(solid.data(), W * H);
+	}
+	new_ms = ElapsedMs(start);
+
+	ASSERT_EQ(old_found, new_found);
+
+	printf("has_transparent: old %.1f ms, new %.1f ms (%d rounds of %dx%d)\n", old_ms, new_ms, rounds, W, H);
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,267 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "im_img.h"
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "testUtils/ImgLoops.hpp"
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+bool global::use_npot_textures;
+
+void ImageSet::decodeNamed(const ConfigData &config, const std::vector<SString> &tex_names,
+						   const std::vector<SString> &flat_names) const
+{
+}
+
+Img_c *ImageSet::getTexture(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	return nullptr;
+}
+
+Img_c *ImageSet::W_GetFlat(const ConfigData &config, const SString &name, bool try_uppercase) const
+{
+	return nullptr;
+}
+
+byte Palette::findPaletteColor(int r, int g, int b) const
+{
+	return 0;
+}
+
+SString Sector::CeilTex() const
+{
+	return SString();
+}
+
+SString Sector::FloorTex() const
+{
+	return SString();
+}
+
+SString SideDef::LowerTex() const
+{
+	return SString();
+}
+
+SString SideDef::MidTex() const
+{
+	return SString();
+}
+
+SString SideDef::UpperTex() const
+{
+	return SString();
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+TEST(ImgPixels, ComposeMatchesOldLoop)
+{
+	std::mt19937 rng(12345);
+
+	const int W = 64;
+	const int H = 48;
+
+	for (int trans : { 0, 30, 100 })
+	{
+		std::vector<img_pixel_t> patch = MakePatch(rng, 24, 20, trans);
+
+		// inside, across every edge, and fully outside
+		for (int y = -25 ; y <= 50 ; y += 5)
+		for (int x = -30 ; x <= 70 ; x += 7)
+		{
+			std::vector<img_pixel_t> old_img = MakePatch(rng, W, H, 50);
+			std::vector<img_pixel_t> new_img = old_img;
+
+			OldCompose(old_img.data(), W, H, patch.data(), 24, 20, x, y);
+			NewCompose(new_img.data(), W, H, patch.data(), 24, 20, x, y);
+
+			ASSERT_EQ(old_img, new_img) << "at " << x << "," << y;
+		}
+	}
+}
+
+TEST(ImgPixels, HasTransPixel)
+{
+	std::vector<img_pixel_t> pixels(1000, 7);
+
+	ASSERT_FALSE(IM_HasTransPixel(pixels.data(), (int)pixels.size()));
+	ASSERT_FALSE(IM_HasTransPixel(pixels.data(), 0));
+
+	pixels.back() = TRANS_PIXEL;
+	ASSERT_TRUE(IM_HasTransPixel(pixels.data(), (int)pixels.size()));
+	ASSERT_FALSE(IM_HasTransPixel(pixels.data(), (int)pixels.size() - 1));
+
+	// RGB pixels with the same low bits are not transparent
+	pixels.back() = IS_RGB_PIXEL | TRANS_PIXEL;
+	ASSERT_FALSE(IM_HasTransPixel(pixels.data(), (int)pixels.size()));
+	ASSERT_EQ(IM_HasTransPixel(pixels.data(), (int)pixels.size()),
+			  OldHasTransparent(pixels.data(), 10, 100));
+}
+
+static img_pixel_t RGBPixel(int r, int g, int b)
+{
+	return static_cast<img_pixel_t>(IMG_PIXEL_MAKE_RGB(r, g, b));
+}
+
+// fills the image from the rows given, top row first
+static void SetPixels(Img_c &img, const std::vector<img_pixel_t> &rows)
+{
+	ASSERT_EQ((int)rows.size(), img.width() * img.height());
+	std::copy(rows.begin(), rows.end(), img.wbuf());
+}
+
+static void ExpectPixels(const Img_c *img, int width, int height,
+						 const std::vector<img_pixel_t> &rows)
+{
+	ASSERT_NE(img, nullptr);
+	ASSERT_EQ(img->width(), width);
+	ASSERT_EQ(img->height(), height);
+
+	for (int i = 0 ; i < width * height ; i++)
+		ASSERT_EQ(img->buf()[i], rows[i]) << "pixel " << i;
+}
+
+TEST(ImgMipLevels, OddSizesKeepTheirEdges)
+{
+	Palette pal;
+
+	// the odd last column is averaged on its own
+	Img_c row(3, 1);
+	SetPixels(row, { RGBPixel(4, 0, 0), RGBPixel(8, 0, 0), RGBPixel(0, 0, 30) });
+
+	ExpectPixels(row.mip_level(pal, 1), 2, 1, { RGBPixel(6, 0, 0), RGBPixel(0, 0, 30) });
+
+	// and the odd last row, and the corner on its own
+	Img_c img(3, 3);
+	SetPixels(img, {
+		RGBPixel(2, 0, 0), RGBPixel(4, 0, 0), RGBPixel(0, 1, 0),
+		RGBPixel(6, 0, 0), RGBPixel(8, 0, 0), RGBPixel(0, 3, 0),
+		RGBPixel(0, 0, 5), RGBPixel(0, 0, 7), RGBPixel(9, 9, 9) });
+
+	ExpectPixels(img.mip_level(pal, 1), 2, 2, {
+		RGBPixel(5, 0, 0), RGBPixel(0, 2, 0),
+		RGBPixel(0, 0, 6), RGBPixel(9, 9, 9) });
+
+	// a tall one keeps its single column
+	Img_c column(1, 4);
+	SetPixels(column, { RGBPixel(1, 0, 0), RGBPixel(3, 0, 0),
+						RGBPixel(0, 10, 0), RGBPixel(0, 20, 0) });
+
+	ExpectPixels(column.mip_level(pal, 1), 1, 2, { RGBPixel(2, 0, 0), RGBPixel(0, 15, 0) });
+}
+
+TEST(ImgMipLevels, MostlyTransparentStaysTransparent)
+{
+	Palette pal;
+
+	const img_pixel_t T = TRANS_PIXEL;
+
+	Img_c img(7, 2);
+	SetPixels(img, {
+		T, T,  RGBPixel(4, 0, 0), T,  RGBPixel(2, 0, 0), RGBPixel(6, 0, 0),  T,
+		RGBPixel(9, 0, 0), T,  RGBPixel(8, 0, 0), T,  RGBPixel(4, 0, 0), T,  RGBPixel(0, 5, 0) });
+
+	// one opaque pixel of four is transparent, two of four are averaged,
+	// so are three of four, and one of two at the edge
+	ExpectPixels(img.mip_level(pal, 1), 4, 1, {
+		T, RGBPixel(6, 0, 0), RGBPixel(4, 0, 0), RGBPixel(0, 5, 0) });
+
+	// a lone transparent pixel at the edge stays transparent
+	Img_c row(3, 1);
+	SetPixels(row, { RGBPixel(1, 1, 1), RGBPixel(3, 3, 3), T });
+
+	ExpectPixels(row.mip_level(pal, 1), 2, 1, { RGBPixel(2, 2, 2), T });
+}
+
+TEST(ImgMipLevels, StopsAtOnePixel)
+{
+	Palette pal;
+
+	Img_c img(5, 3);
+	std::fill(img.wbuf(), img.wbuf() + 15, RGBPixel(3, 6, 9));
+
+	ASSERT_EQ(img.mip_level(pal, 0), &img);
+
+	// 5x3, 3x2, 2x1, 1x1
+	const int sizes[][2] = { { 3, 2 }, { 2, 1 }, { 1, 1 } };
+
+	for (int level = 1 ; level <= 3 ; level++)
+	{
+		const Img_c *mip = img.mip_level(pal, level);
+
+		ASSERT_EQ(mip->width(), sizes[level - 1][0]) << "level " << level;
+		ASSERT_EQ(mip->height(), sizes[level - 1][1]) << "level " << level;
+		ASSERT_EQ(mip->buf()[0], RGBPixel(3, 6, 9)) << "level " << level;
+	}
+
+	// deeper levels are the single pixel, and the copies are kept
+	const Img_c *last = img.mip_level(pal, 3);
+
+	ASSERT_EQ(img.mip_level(pal, 4), last);
+	ASSERT_EQ(img.mip_level(pal, 30), last);
+	ASSERT_EQ(img.mip_level(pal, 1), img.mip_level(pal, 1));
+
+	// a single pixel is never halved
+	Img_c dot(1, 1);
+	dot.wbuf()[0] = RGBPixel(1, 2, 3);
+
+	ASSERT_EQ(dot.mip_level(pal, 5), &dot);
+}
+
+TEST(ImgMipLevels, ChangesDropTheCopies)
+{
+	Palette pal;
+
+	Img_c img(4, 2);
+	std::fill(img.wbuf(), img.wbuf() + 8, RGBPixel(2, 2, 2));
+
+	ExpectPixels(img.mip_level(pal, 1), 2, 1, { RGBPixel(2, 2, 2), RGBPixel(2, 2, 2) });
+
+	// the pixels written through wbuf()
+	img_pixel_t *pixels = img.wbuf();
+	for (int i = 0 ; i < 8 ; i++)
+		pixels[i] = RGBPixel(20, 0, 0);
+
+	ExpectPixels(img.mip_level(pal, 1), 2, 1, { RGBPixel(20, 0, 0), RGBPixel(20, 0, 0) });
+
+	img.clear();
+
+	ExpectPixels(img.mip_level(pal, 1), 2, 1, { TRANS_PIXEL, TRANS_PIXEL });
+
+	// the new size is halved, not the old one
+	img.resize(6, 6);
+
+	ExpectPixels(img.mip_level(pal, 1), 3, 3, std::vector<img_pixel_t>(9, TRANS_PIXEL));
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
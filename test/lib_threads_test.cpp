@@ -0,0 +1,74 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "lib_threads.h"
+#include "gtest/gtest.h"
+
+#include <atomic>
+#include <stdexcept>
+
+TEST(ThreadPool, ParallelForRunsEveryIndexOnce)
+{
+	ThreadPool pool(4);
+	ASSERT_EQ(pool.numThreads(), 4);
+
+	std::vector<int> hits(100);
+	pool.parallelFor((int)hits.size(), [&hits](int i)
+	{
+		hits[i]++;
+	});
+
+	for (int count : hits)
+		ASSERT_EQ(count, 1);
+
+	// nothing to do
+	pool.parallelFor(0, [](int)
+	{
+		FAIL();
+	});
+}
+
+TEST(ThreadPool, ParallelForRethrows)
+{
+	ThreadPool pool(3);
+	std::atomic<int> done(0);
+
+	ASSERT_THROW(pool.parallelFor(10, [&done](int i)
+	{
+		if (i == 5)
+			throw std::runtime_error("job failed");
+		done++;
+	}), std::runtime_error);
+
+	// the other jobs were all waited for
+	ASSERT_EQ(done, 9);
+}
+
+TEST(ThreadPool, Submit)
+{
+	ThreadPool pool(2);
+	std::atomic<int> value(0);
+
+	std::future<void> result = pool.submit([&value]()
+	{
+		value = 42;
+	});
+	result.get();
+
+	ASSERT_EQ(value, 42);
+}
@@ -0,0 +1,105 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "m_blockgrid.h"
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <random>
+
+TEST(BlockGrid, Size)
+{
+	BlockGrid grid(-64, -64, 1000, 200);
+	ASSERT_EQ(grid.width(), 9);
+	ASSERT_EQ(grid.height(), 3);
+
+	ASSERT_EQ(grid.blockX(-64), 0);
+	ASSERT_EQ(grid.blockX(63.9), 0);
+	ASSERT_EQ(grid.blockX(64), 1);
+	ASSERT_EQ(grid.blockX(99999), 8);	// clamped
+	ASSERT_EQ(grid.blockY(-99999), 0);
+	ASSERT_EQ(grid.blockLeft(2), 192);
+	ASSERT_EQ(grid.blockBottom(1), 64);
+
+	// huge maps get bigger blocks
+	BlockGrid huge(-32768, -32768, 32767, 32767, 1);
+	ASSERT_LE(huge.width() * huge.height(), 1 << 20);
+}
+
+TEST(BlockGrid, QueryBoxes)
+{
+	BlockGrid grid(0, 0, 1024, 1024);
+
+	grid.insertBox(1, 10, 10, 900, 20);		// spans many blocks
+	grid.insertBox(2, 500, 500, 510, 510);
+	grid.insertPoint(3, 700, 700);
+	grid.insertPoint(4, -5000, 5000);		// clamped into the corner block
+
+	std::vector<int> result;
+	grid.query(0, 0, 1024, 1024, result);
+	ASSERT_EQ(result, std::vector<int>({ 1, 2, 3, 4 }));
+
+	result.clear();
+	grid.query(400, 0, 450, 50, result);
+	ASSERT_EQ(result, std::vector<int>({ 1 }));
+
+	// appends to what's there already
+	grid.query(-100, 1000, 0, 1100, result);
+	ASSERT_EQ(result, std::vector<int>({ 1, 4 }));
+}
+
+//
+// Check against testing everything with everything, on a slaughter map
+// sized set of things
+//
+TEST(BlockGrid, ManyPoints)
+{
+	std::mt19937 random(1234);
+	std::uniform_real_distribution<double> coord(-4096, 4096);
+
+	std::vector<double> xs, ys;
+	for (int i = 0 ; i < 12000 ; i++)
+	{
+		xs.push_back(coord(random));
+		ys.push_back(coord(random));
+	}
+
+	BlockGrid grid(-4096, -4096, 4096, 4096);
+	for (int i = 0 ; i < (int)xs.size() ; i++)
+		grid.insertPoint(i, xs[i], ys[i]);
+
+	const double dist = 40;
+
+	std::vector<int> nearby;
+
+	for (int i = 0 ; i < (int)xs.size() ; i += 7)
+	{
+		nearby.clear();
+		grid.query(xs[i] - dist, ys[i] - dist, xs[i] + dist, ys[i] + dist, nearby);
+
+		for (int k = 0 ; k < (int)xs.size() ; k++)
+		{
+			bool close = fabs(xs[k] - xs[i]) <= dist && fabs(ys[k] - ys[i]) <= dist;
+
+			if (close)
+			{
+				ASSERT_TRUE(std::binary_search(nearby.begin(), nearby.end(), k));
+			}
+		}
+	}
+}
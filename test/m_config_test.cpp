@@ -16,6 +16,7 @@
 //
 //------------------------------------------------------------------------
 
+#include "m_batch.h"
 #include "m_config.h"
 
 #include "testUtils/FatalHandler.hpp"
@@ -368,6 +369,23 @@ TEST(MConfigArgs, MParseCommandLine)
 	ASSERT_EQ(gInstance.loaded.resourceList[2], "res3");
 	global::Pwad_list.clear();
 	gInstance.loaded.resourceList.clear();
+
+	// Check the batch mode options
+	argv = { "pipeline.wad", "--batch", "-nodes", "--check", "major",
+		"-report", "report.txt" };
+	M_ParseCommandLine(7, argv.data(), CommandLinePass::early);
+	ASSERT_FALSE(global::batch_mode);
+	M_ParseCommandLine(7, argv.data(), CommandLinePass::normal);
+	ASSERT_EQ(global::Pwad_list.size(), 1);
+	ASSERT_EQ(global::Pwad_list[0], "pipeline.wad");
+	ASSERT_TRUE(global::batch_mode);
+	ASSERT_TRUE(global::batch_nodes);
+	ASSERT_EQ(global::batch_check, "major");
+	ASSERT_EQ(global::batch_report, "report.txt");
+	global::Pwad_list.clear();
+	global::batch_mode = global::batch_nodes = false;
+	global::batch_check.clear();
+	global::batch_report.clear();
 }
 
 // M_PrintCommandLineOptions is tested in system testing
@@ -543,7 +561,10 @@ bool config::render_high_detail    = false;
 bool config::browser_combine_tex = false;
 bool config::grid_snap_indicator = true;
 int config::highlight_line_info = (int)LINFO_Length;
+int config::image_cache_mb = 256;
+int config::image_disk_cache_mb = 128;
 bool config::leave_offsets_alone = true;
+bool config::live_map_checks = true;
 int config::minimum_drag_pixels = 5;
 bool config::render_lock_gravity   = false;
 int  config::render_pixel_aspect = 83;  //  100 * width / height
@@ -566,6 +587,10 @@ SString global::log_file;
 std::vector<SString> global::Pwad_list;
 SString global::cache_dir;
 int global::show_help     = 0;
+bool global::batch_mode = false;
+bool global::batch_nodes;
+SString global::batch_check;
+SString global::batch_report;
 
 Instance gInstance;
 
@@ -695,6 +720,18 @@ DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
 {
 }
 
+ChecksModule::~ChecksModule()
+{
+}
+
+void LiveChecks::wait()
+{
+}
+
+Img_c::~Img_c()
+{
+}
+
 void Basis::EditUnit::destroy()
 {
 }
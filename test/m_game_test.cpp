@@ -36,22 +36,10 @@ void Clipboard_ClearLocals()
 {
 }
 
-void Clipboard_NotifyBegin()
-{
-}
-
-void Clipboard_NotifyChange(ObjType type, int objnum, int field)
-{
-}
-
 void Clipboard_NotifyDelete(ObjType type, int objnum)
 {
 }
 
-void Clipboard_NotifyEnd()
-{
-}
-
 void Clipboard_NotifyInsert(const Document &doc, ObjType type, int objnum)
 {
 }
@@ -60,73 +48,73 @@ DocumentModule::DocumentModule(Document &doc) : inst(doc.inst), doc(doc)
 {
 }
 
-void Instance::MapStuff_NotifyBegin()
+ChecksModule::~ChecksModule()
 {
 }
 
-void Instance::MapStuff_NotifyChange(ObjType type, int objnum, int field)
+void LiveChecks::wait()
 {
 }
 
-void Instance::MapStuff_NotifyDelete(ObjType type, int objnum)
+Img_c::~Img_c()
 {
 }
 
-void Instance::MapStuff_NotifyEnd()
+void ChecksModule::liveNotifyChanges(const ChangeSet &changes)
 {
 }
 
-void Instance::MapStuff_NotifyInsert(ObjType type, int objnum)
+void ChecksModule::liveReset()
 {
 }
 
-void Instance::ObjectBox_NotifyBegin()
+void ChecksModule::liveWait()
 {
 }
 
-void Instance::ObjectBox_NotifyChange(ObjType type, int objnum, int field)
+void Instance::MapStuff_NotifyBegin()
 {
 }
 
-void Instance::ObjectBox_NotifyDelete(ObjType type, int objnum)
+void Instance::MapStuff_NotifyEnd(const ChangeSet &changes)
 {
 }
 
-void Instance::ObjectBox_NotifyEnd() const
+void Instance::ObjectBox_NotifyBegin()
 {
 }
 
-void Instance::ObjectBox_NotifyInsert(ObjType type, int objnum)
+void Instance::ObjectBox_NotifyEnd(const ChangeSet &changes)
 {
 }
 
-void Instance::RedrawMap()
+void Hover::invalidateSectorLocator()
 {
 }
 
-rgb_color_t ParseColor(const SString &cstr)
+void Hover::notifyChanges(const ChangeSet &changes)
 {
-    // Use some independent example
-    return (rgb_color_t)strtol(cstr.c_str(), nullptr, 16) << 8;
 }
 
-void Render3D_NotifyBegin()
+void SectorModule::invalidateGraph()
 {
 }
 
-void Render3D_NotifyChange(ObjType type, int objnum, int field)
+void SectorModule::notifyChanges(const ChangeSet &changes)
 {
 }
 
-void Render3D_NotifyDelete(const Document &doc, ObjType type, int objnum)
+void Instance::RedrawMap()
 {
 }
 
-void Render3D_NotifyEnd(Instance &inst)
+rgb_color_t ParseColor(const SString &cstr)
 {
+    // Use some independent example
+    return (rgb_color_t)strtol(cstr.c_str(), nullptr, 16) << 8;
 }
 
-void Render3D_NotifyInsert(ObjType type, int objnum)
+void Render3D_NotifyEnd(Instance &inst, const ChangeSet &changes)
 {
 }
 
@@ -139,20 +127,7 @@ void Instance::Selection_NotifyBegin()
 {
 }
 
-void Selection_NotifyChange(ObjType type, int objnum, int field)
-{
-    // field changes never affect the current selection
-}
-
-void Instance::Selection_NotifyDelete(ObjType type, int objnum)
-{
-}
-
-void Instance::Selection_NotifyEnd()
-{
-}
-
-void Instance::Selection_NotifyInsert(ObjType type, int objnum)
+void Instance::Selection_NotifyEnd(const ChangeSet &changes)
 {
 }
 
@@ -0,0 +1,150 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "m_udmf.h"
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+static FFixedPoint FromRaw(int raw)
+{
+	// exact, since kFracUnit is a power of two
+	return FFixedPoint(raw / kFracUnitD);
+}
+
+static std::vector<std::string> Tokenize(const std::string &text)
+{
+	Udmf_Parser parser(text.data(), text.size());
+
+	std::vector<std::string> result;
+
+	for (;;)
+	{
+		Udmf_Token tok = parser.Next();
+		if (tok.IsEOF())
+			break;
+
+		result.emplace_back(tok.View());
+	}
+	return result;
+}
+
+static std::string WriteNumber(FFixedPoint value)
+{
+	Udmf_Writer out;
+	out.Number(value);
+
+	return std::string(out.Text().begin(), out.Text().end());
+}
+
+TEST(Udmf, Tokenizer)
+{
+	std::string text =
+		"namespace = \"doom\";  // comment\n"
+		"thing /* block\n comment */ {\n"
+		"x = -12.5;\ttype=+3001;\n"
+		"tex = \"A\\\"B\";\n"
+		"}";
+
+	ASSERT_EQ(Tokenize(text), std::vector<std::string>({
+		"namespace", "=", "\"doom\"", ";",
+		"thing", "{",
+		"x", "=", "-12.5", ";", "type", "=", "+3001", ";",
+		"tex", "=", "\"A\\\"B\"", ";",
+		"}" }));
+
+	// an unfinished comment runs to the end
+	ASSERT_EQ(Tokenize("a /* b"), std::vector<std::string>({ "a" }));
+
+	// stray bytes become tokens of their own
+	ASSERT_EQ(Tokenize("\xC3= 1;"), std::vector<std::string>({ "\xC3", "=", "1", ";" }));
+}
+
+TEST(Udmf, TokenChecks)
+{
+	ASSERT_TRUE(Udmf_Token("_skill1").IsIdentifier());
+	ASSERT_FALSE(Udmf_Token("1abc").IsIdentifier());
+	ASSERT_FALSE(Udmf_Token("\xC3").IsIdentifier());
+	ASSERT_TRUE(Udmf_Token("\"x\"").IsString());
+	ASSERT_TRUE(Udmf_Token("TwoSided").Match("twosided"));
+	ASSERT_FALSE(Udmf_Token("twosided2").Match("twosided"));
+	ASSERT_EQ(Udmf_Token("\"abc\"").DecodeString(), "abc");
+}
+
+TEST(Udmf, DecodeNumbers)
+{
+	ASSERT_EQ(Udmf_Token("42").DecodeInt(), 42);
+	ASSERT_EQ(Udmf_Token("-42").DecodeInt(), -42);
+	ASSERT_EQ(Udmf_Token("+7").DecodeInt(), 7);
+	ASSERT_EQ(Udmf_Token("12.75").DecodeInt(), 12);
+	ASSERT_EQ(Udmf_Token("junk").DecodeInt(), 0);
+
+	// the token is not NUL-terminated, so only its own text counts
+	std::string_view text("123456");
+	ASSERT_EQ(Udmf_Token(text.substr(0, 3)).DecodeInt(), 123);
+	ASSERT_EQ(Udmf_Token(text.substr(0, 2)).DecodeFloat(), 12.0);
+
+	ASSERT_EQ(Udmf_Token("-1.25e1").DecodeFloat(), -12.5);
+	ASSERT_EQ(Udmf_Token("0.0625").DecodeCoord().raw(), 256);
+}
+
+TEST(Udmf, WriteCoordTies)
+{
+	// exact ties round half to even, as printf() does
+	ASSERT_EQ(WriteNumber(FromRaw(256)), "0.062");
+	ASSERT_EQ(WriteNumber(FromRaw(768)), "0.188");
+	ASSERT_EQ(WriteNumber(FromRaw(-256)), "-0.062");
+	ASSERT_EQ(WriteNumber(FromRaw(-768)), "-0.188");
+
+	ASSERT_EQ(WriteNumber(FFixedPoint(0)), "0.000");
+	ASSERT_EQ(WriteNumber(FromRaw(-1)), "-0.000");	// like printf
+	ASSERT_EQ(WriteNumber(FFixedPoint(-32768)), "-32768.000");
+	ASSERT_EQ(WriteNumber(FFixedPoint(123.25)), "123.250");
+}
+
+TEST(Udmf, WriteCoordMatchesPrintf)
+{
+	char buffer[64];
+
+	for (int raw = -70000 ; raw <= 70000 ; raw += 3)
+	{
+		FFixedPoint value = FromRaw(raw);
+
+		snprintf(buffer, sizeof(buffer), "%1.3f", static_cast<double>(value));
+
+		ASSERT_EQ(WriteNumber(value), buffer) << "raw " << raw;
+	}
+}
+
+TEST(Udmf, CoordRoundTrip)
+{
+	for (int raw : { 0, 1, 3, -3, 256, -256, 4095, -4095, 12345, -12345, 134217727, -134217727 })
+	{
+		FFixedPoint value = FromRaw(raw);
+
+		std::string text = WriteNumber(value);
+		FFixedPoint back = Udmf_Token(text).DecodeCoord();
+
+		// half a thousandth is about two raw units
+		ASSERT_LE(abs(back.raw() - raw), 2) << text;
+
+		// and writing it again gives the same text
+		ASSERT_EQ(WriteNumber(back), text);
+	}
+}
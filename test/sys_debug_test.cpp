@@ -21,6 +21,7 @@
 #include "m_streams.h"
 #include "testUtils/TempDirContext.hpp"
 #include "gtest/gtest.h"
+#include <thread>
 
 //
 // Temporary directory
@@ -200,3 +201,42 @@ TEST_F(SysDebugTempDir, LifeCycle)
     ASSERT_EQ(localWindowMessages[0], "Extra stuff one\n");
     ASSERT_EQ(localWindowMessages[1], "Extra stuff two\n");
 }
+
+TEST(SysDebug, LogCapture)
+{
+    std::vector<SString> localWindowMessages;
+
+    Log log;
+    log.openWindow([](const SString &text, void *userData)
+                   {
+        auto localWindowMessages = static_cast<std::vector<SString> *>(userData);
+        localWindowMessages->push_back(text);
+    }, &localWindowMessages);
+
+    log.printf("Before\n");
+    {
+        LogCapture capture;
+        log.printf("Kept one\n");
+        {
+            LogCapture inner;
+            log.printf("Kept inside\n");
+            ASSERT_EQ(inner.messages().size(), 1);
+            ASSERT_EQ(inner.messages()[0], "Kept inside\n");
+        }
+        log.printf("Kept two\n");
+
+        // other threads still print normally
+        std::thread([&log]() { log.printf("From thread\n"); }).join();
+
+        ASSERT_EQ(capture.messages().size(), 2);
+        ASSERT_EQ(capture.messages()[0], "Kept one\n");
+        ASSERT_EQ(capture.messages()[1], "Kept two\n");
+    }
+    log.printf("After\n");
+    log.close();
+
+    ASSERT_EQ(localWindowMessages.size(), 3);
+    ASSERT_EQ(localWindowMessages[0], "Before\n");
+    ASSERT_EQ(localWindowMessages[1], "From thread\n");
+    ASSERT_EQ(localWindowMessages[2], "After\n");
+}
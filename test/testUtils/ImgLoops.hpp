@@ -0,0 +1,108 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef ImgLoops_hpp
+#define ImgLoops_hpp
+
+#include "im_img.h"
+
+#include <random>
+#include <vector>
+
+//
+// The loops as they were before IM_ComposeRow() and IM_HasTransPixel(),
+// kept to compare the results and the speed
+//
+inline void OldCompose(img_pixel_t *pixels, int W, int H,
+					   const img_pixel_t *other, int OW, int OH, int x, int y)
+{
+	for (int oy = 0 ; oy < OH ; oy++)
+	{
+		int iy = y + oy;
+		if (iy < 0 || iy >= H)
+			continue;
+
+		const img_pixel_t *src = other + oy * OW;
+		img_pixel_t *dest = pixels + iy * W;
+
+		for (int ox = 0 ; ox < OW ; ox++, src++)
+		{
+			int ix = x + ox;
+			if (ix < 0 || ix >= W)
+				continue;
+
+			if (*src != TRANS_PIXEL)
+				dest[ix] = *src;
+		}
+	}
+}
+
+inline bool OldHasTransparent(const img_pixel_t *src, int W, int H)
+{
+	for (int y = 0 ; y < H ; y++)
+	for (int x = 0 ; x < W ; x++)
+	{
+		if (src[y * W + x] == TRANS_PIXEL)
+			return true;
+	}
+
+	return false;
+}
+
+//
+// Same clipping as Img_c::compose()
+//
+inline void NewCompose(img_pixel_t *pixels, int W, int H,
+					   const img_pixel_t *other, int OW, int OH, int x, int y)
+{
+	int ox1 = std::max(0, -x);
+	int ox2 = std::min(OW, W - x);
+
+	if (ox1 >= ox2)
+		return;
+
+	for (int oy = 0 ; oy < OH ; oy++)
+	{
+		int iy = y + oy;
+		if (iy < 0 || iy >= H)
+			continue;
+
+		IM_ComposeRow(pixels + iy * W + x + ox1, other + oy * OW + ox1, ox2 - ox1);
+	}
+}
+
+//
+// A patch with columns of transparent pixels here and there, like the
+// ones of the DOOM textures
+//
+inline std::vector<img_pixel_t> MakePatch(std::mt19937 &rng, int W, int H, int trans_percent)
+{
+	std::vector<img_pixel_t> patch(W * H);
+
+	for (img_pixel_t &pix : patch)
+	{
+		pix = static_cast<img_pixel_t>(rng() % 255);
+
+		if ((int)(rng() % 100) < trans_percent)
+			pix = TRANS_PIXEL;
+	}
+
+	return patch;
+}
+
+#endif /* ImgLoops_hpp */
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#ifndef TestMap_hpp
+#define TestMap_hpp
+
+#include "Document.h"
+#include "LineDef.h"
+#include "Sector.h"
+#include "SideDef.h"
+#include "Thing.h"
+#include "Vertex.h"
+#include "w_rawdef.h"
+
+#include <deque>
+
+//
+// Builds a level directly into a document, for the tests of the editing
+// modules.  The objects live here (a deque keeps their addresses), so the
+// map must outlive any use of the document.
+//
+class TestMap
+{
+public:
+	explicit TestMap(Document &doc) : doc(doc)
+	{
+	}
+
+	int addVertex(double x, double y)
+	{
+		Vertex &vertex = vertices.emplace_back();
+		vertex.raw_x = FFixedPoint(x);
+		vertex.raw_y = FFixedPoint(y);
+
+		doc.vertices.push_back(&vertex);
+		return doc.numVertices() - 1;
+	}
+
+	int addSector(int floorh = 0, int ceilh = 128)
+	{
+		Sector &sector = sectors.emplace_back();
+		sector.floorh = floorh;
+		sector.ceilh = ceilh;
+
+		doc.sectors.push_back(&sector);
+		return doc.numSectors() - 1;
+	}
+
+	// adds a sidedef facing the given sector, -1 gives no sidedef
+	int addSide(int sec)
+	{
+		if (sec < 0)
+			return -1;
+
+		SideDef &side = sides.emplace_back();
+		side.sector = sec;
+
+		doc.sidedefs.push_back(&side);
+		return doc.numSidedefs() - 1;
+	}
+
+	// adds a line from v1 to v2 with the given sectors on each side
+	int addLine(int v1, int v2, int right_sec, int left_sec = -1)
+	{
+		LineDef &line = lines.emplace_back();
+		line.start = v1;
+		line.end = v2;
+		line.right = addSide(right_sec);
+		line.left = addSide(left_sec);
+
+		if (line.left >= 0)
+			line.flags |= MLF_TwoSided;
+		else
+			line.flags |= MLF_Blocking;
+
+		doc.linedefs.push_back(&line);
+		return doc.numLinedefs() - 1;
+	}
+
+	int addThing(double x, double y, int type = 1)
+	{
+		Thing &thing = things.emplace_back();
+		thing.raw_x = FFixedPoint(x);
+		thing.raw_y = FFixedPoint(y);
+		thing.type = type;
+
+		doc.things.push_back(&thing);
+		return doc.numThings() - 1;
+	}
+
+	//
+	// Adds a closed polygon of one-sided lines facing into a new sector,
+	// going clockwise so the right sides are inside.  Returns the sector.
+	//
+	int addRoom(const std::vector<v2double_t> &corners, int floorh = 0, int ceilh = 128)
+	{
+		int sec = addSector(floorh, ceilh);
+		int first = doc.numVertices();
+
+		for (const v2double_t &corner : corners)
+			addVertex(corner.x, corner.y);
+
+		int count = static_cast<int>(corners.size());
+
+		for (int i = 0 ; i < count ; i++)
+			addLine(first + i, first + (i + 1) % count, sec);
+
+		return sec;
+	}
+
+	Document &doc;
+
+	std::deque<Vertex> vertices;
+	std::deque<Sector> sectors;
+	std::deque<SideDef> sides;
+	std::deque<LineDef> lines;
+	std::deque<Thing> things;
+};
+
+#endif /* TestMap_hpp */
@@ -0,0 +1,359 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "w_imgcache.h"
+
+#include "im_img.h"
+#include "testUtils/TempDirContext.hpp"
+
+#include <memory>
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+Img_c::Img_c(int width, int height, bool _dummy) : w(width), h(height)
+{
+	pixels = new img_pixel_t[w * h];
+}
+
+Img_c::~Img_c()
+{
+	delete[] pixels;
+}
+
+const img_pixel_t *Img_c::buf() const
+{
+	return pixels;
+}
+
+img_pixel_t *Img_c::wbuf()
+{
+	return pixels;
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+class ImageDiskCacheTest : public TempDirContext
+{
+protected:
+	void SetUp() override
+	{
+		TempDirContext::SetUp();
+		mPath = getChildPath("images.cache");
+	}
+
+	// saves the images into a new cache file
+	void saveNew(const std::vector<std::pair<uint64_t, const Img_c *>> &images,
+				 size_t limit = 1 << 20)
+	{
+		ImageDiskCache cache;
+		cache.open(mPath);
+		cache.save(images, limit);
+
+		if (! mSaved)
+		{
+			mDeleteList.push(mPath);
+			mSaved = true;
+		}
+	}
+
+	std::vector<uint8_t> readFile();
+	void writeFile(const std::vector<uint8_t> &data);
+
+	SString mPath;
+	bool mSaved = false;
+};
+
+std::vector<uint8_t> ImageDiskCacheTest::readFile()
+{
+	std::vector<uint8_t> data;
+
+	FILE *f = fopen(mPath.c_str(), "rb");
+	EXPECT_NE(f, nullptr);
+	if (! f)
+		return data;
+
+	uint8_t buffer[4096];
+	size_t n;
+
+	while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0)
+		data.insert(data.end(), buffer, buffer + n);
+
+	fclose(f);
+	return data;
+}
+
+void ImageDiskCacheTest::writeFile(const std::vector<uint8_t> &data)
+{
+	FILE *f = fopen(mPath.c_str(), "wb");
+	ASSERT_NE(f, nullptr);
+	ASSERT_EQ(fwrite(data.data(), 1, data.size(), f), data.size());
+	ASSERT_EQ(fclose(f), 0);
+}
+
+//
+// An image whose pixels all depend on the seed, including the
+// transparent one and values over 255.
+//
+static std::unique_ptr<Img_c> MakeImage(int width, int height, int seed)
+{
+	std::unique_ptr<Img_c> img(new Img_c(width, height));
+
+	for (int i = 0 ; i < width * height ; i++)
+		img->wbuf()[i] = static_cast<img_pixel_t>(seed * 977 + i * 31);
+
+	img->wbuf()[0] = TRANS_PIXEL;
+	return img;
+}
+
+static void ExpectSameImage(const Img_c *img, const Img_c &expected)
+{
+	ASSERT_NE(img, nullptr);
+	ASSERT_EQ(img->width(), expected.width());
+	ASSERT_EQ(img->height(), expected.height());
+
+	for (int i = 0 ; i < img->width() * img->height() ; i++)
+		ASSERT_EQ(img->buf()[i], expected.buf()[i]) << "pixel " << i;
+}
+
+// the key with the upper half set too, both halves are stored
+static const uint64_t KEY_A = 0x123456789abcdef0ull;
+static const uint64_t KEY_B = 0x00000001ull;
+static const uint64_t KEY_C = 0xfedcba9800000000ull;
+
+// the offset of the number of images, right after the magic and version
+static const int COUNT_OFFSET = 12;
+
+TEST_F(ImageDiskCacheTest, SaveAndFind)
+{
+	std::unique_ptr<Img_c> a = MakeImage(64, 64, 1);
+	std::unique_ptr<Img_c> b = MakeImage(3, 17, 2);
+
+	saveNew({ { KEY_A, a.get() }, { KEY_B, b.get() } });
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+	ASSERT_TRUE(cache.isOpen());
+
+	std::unique_ptr<Img_c> found_a(cache.find(KEY_A));
+	std::unique_ptr<Img_c> found_b(cache.find(KEY_B));
+
+	ExpectSameImage(found_a.get(), *a);
+	ExpectSameImage(found_b.get(), *b);
+
+	// and found again
+	std::unique_ptr<Img_c> again(cache.find(KEY_A));
+	ExpectSameImage(again.get(), *a);
+}
+
+TEST_F(ImageDiskCacheTest, MissingKeys)
+{
+	std::unique_ptr<Img_c> a = MakeImage(8, 8, 1);
+
+	// zero keys and missing images are not stored, nor a key twice
+	std::unique_ptr<Img_c> other = MakeImage(4, 4, 5);
+	saveNew({ { KEY_A, a.get() }, { 0, other.get() }, { KEY_B, nullptr },
+			  { KEY_A, other.get() } });
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found(cache.find(KEY_A));
+	ExpectSameImage(found.get(), *a);
+
+	ASSERT_EQ(cache.find(KEY_B), nullptr);
+	ASSERT_EQ(cache.find(0), nullptr);
+
+	// only one half of a key matching is not enough
+	ASSERT_EQ(cache.find(KEY_A & 0xffffffffull), nullptr);
+	ASSERT_EQ(cache.find(KEY_A >> 32), nullptr);
+
+	// the header and the one index entry and image
+	ASSERT_EQ(readFile().size(), 16u + 20u + 8 * 8 * 2);
+}
+
+TEST_F(ImageDiskCacheTest, MissingFile)
+{
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	// still usable to save into
+	ASSERT_TRUE(cache.isOpen());
+	ASSERT_EQ(cache.find(KEY_A), nullptr);
+
+	cache.close();
+	ASSERT_FALSE(cache.isOpen());
+	ASSERT_EQ(cache.find(KEY_A), nullptr);
+}
+
+TEST_F(ImageDiskCacheTest, WrongMagicOrVersion)
+{
+	std::unique_ptr<Img_c> a = MakeImage(8, 8, 1);
+
+	saveNew({ { KEY_A, a.get() } });
+
+	const std::vector<uint8_t> good = readFile();
+	ASSERT_GT(good.size(), 16u);
+	ASSERT_EQ(memcmp(good.data(), "EurekaIC", 8), 0);
+
+	// each of the magic and version bytes
+	for (int pos = 0 ; pos < COUNT_OFFSET ; pos++)
+	{
+		std::vector<uint8_t> data = good;
+		data[pos] ^= 0x40;
+		writeFile(data);
+
+		ImageDiskCache cache;
+		cache.open(mPath);
+
+		ASSERT_EQ(cache.find(KEY_A), nullptr) << "byte " << pos;
+	}
+
+	// and the good one works again
+	writeFile(good);
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found(cache.find(KEY_A));
+	ExpectSameImage(found.get(), *a);
+}
+
+TEST_F(ImageDiskCacheTest, TruncatedFile)
+{
+	std::unique_ptr<Img_c> a = MakeImage(8, 8, 1);
+	std::unique_ptr<Img_c> b = MakeImage(16, 4, 2);
+
+	saveNew({ { KEY_A, a.get() }, { KEY_B, b.get() } });
+
+	const std::vector<uint8_t> good = readFile();
+
+	// the last image is cut short, so its offset and size run past the
+	// end, or the index or header itself is cut.
+	for (size_t size : { good.size() - 1, good.size() - 8 * 8 * 2, (size_t)16 + 20,
+						 (size_t)16 + 20 + 5, (size_t)16, (size_t)10, (size_t)0 })
+	{
+		writeFile(std::vector<uint8_t>(good.begin(), good.begin() + size));
+
+		ImageDiskCache cache;
+		cache.open(mPath);
+
+		// the whole file is ignored, even the images still in it
+		ASSERT_EQ(cache.find(KEY_A), nullptr) << "size " << size;
+		ASSERT_EQ(cache.find(KEY_B), nullptr) << "size " << size;
+	}
+
+	// an image count too large for the file
+	std::vector<uint8_t> data = good;
+	data[COUNT_OFFSET + 1] = 1;
+	writeFile(data);
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	ASSERT_EQ(cache.find(KEY_A), nullptr);
+}
+
+TEST_F(ImageDiskCacheTest, SaveCopiesOldImages)
+{
+	std::unique_ptr<Img_c> a = MakeImage(8, 8, 1);
+	std::unique_ptr<Img_c> b = MakeImage(5, 3, 2);
+	std::unique_ptr<Img_c> c = MakeImage(16, 16, 3);
+
+	saveNew({ { KEY_A, a.get() }, { KEY_B, b.get() } });
+
+	// only the new one is given, the old ones come from the file
+	{
+		ImageDiskCache cache;
+		cache.open(mPath);
+		cache.save({ { KEY_C, c.get() } }, 1 << 20);
+
+		ASSERT_FALSE(cache.isOpen());
+	}
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found_a(cache.find(KEY_A));
+	std::unique_ptr<Img_c> found_b(cache.find(KEY_B));
+	std::unique_ptr<Img_c> found_c(cache.find(KEY_C));
+
+	ExpectSameImage(found_a.get(), *a);
+	ExpectSameImage(found_b.get(), *b);
+	ExpectSameImage(found_c.get(), *c);
+
+	// a newer image under an old key replaces it, the rest stay
+	std::unique_ptr<Img_c> newer = MakeImage(2, 2, 4);
+	cache.save({ { KEY_A, newer.get() } }, 1 << 20);
+
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found_newer(cache.find(KEY_A));
+	ExpectSameImage(found_newer.get(), *newer);
+
+	found_b.reset(cache.find(KEY_B));
+	found_c.reset(cache.find(KEY_C));
+
+	ExpectSameImage(found_b.get(), *b);
+	ExpectSameImage(found_c.get(), *c);
+}
+
+TEST_F(ImageDiskCacheTest, SaveKeepsWithinLimit)
+{
+	std::unique_ptr<Img_c> a = MakeImage(8, 8, 1);
+	std::unique_ptr<Img_c> b = MakeImage(8, 8, 2);
+	std::unique_ptr<Img_c> c = MakeImage(8, 8, 3);
+
+	const size_t image_bytes = 8 * 8 * 2;
+
+	saveNew({ { KEY_A, a.get() }, { KEY_B, b.get() } });
+
+	// room for the new one and one old, the first one written
+	{
+		ImageDiskCache cache;
+		cache.open(mPath);
+		cache.save({ { KEY_C, c.get() } }, 2 * image_bytes);
+	}
+
+	ImageDiskCache cache;
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found_c(cache.find(KEY_C));
+	std::unique_ptr<Img_c> found_a(cache.find(KEY_A));
+
+	ExpectSameImage(found_c.get(), *c);
+	ExpectSameImage(found_a.get(), *a);
+	ASSERT_EQ(cache.find(KEY_B), nullptr);
+
+	// not even the new ones are kept over the limit
+	cache.save({ { KEY_B, b.get() }, { KEY_C, c.get() } }, image_bytes + 1);
+
+	cache.open(mPath);
+
+	std::unique_ptr<Img_c> found_b(cache.find(KEY_B));
+	ExpectSameImage(found_b.get(), *b);
+	ASSERT_EQ(cache.find(KEY_C), nullptr);
+	ASSERT_EQ(cache.find(KEY_A), nullptr);
+}
@@ -0,0 +1,496 @@
+//------------------------------------------------------------------------
+//
+//  Eureka DOOM Editor
+//
+//  Copyright (C) 2021 The Eureka Team
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 2
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//------------------------------------------------------------------------
+
+#include "gtest/gtest.h"
+
+#include "Instance.h"
+#include "main.h"
+#include "m_config.h"
+#include "lib_threads.h"
+#include "m_game.h"
+#include "w_loadpic.h"
+
+#include <stdexcept>
+
+//==============================================================================
+//
+// Mock-ups
+//
+//==============================================================================
+
+void FatalError(const char *fmt, ...)
+{
+	throw std::runtime_error(fmt);
+}
+
+Img_c *IM_CreateDogSprite(const Palette &pal)
+{
+	return nullptr;
+}
+
+Img_c *IM_CreateLightSprite(const Palette &palette)
+{
+	return nullptr;
+}
+
+Img_c *IM_CreateMapSpotSprite(const Palette &pal, int base_r, int base_g, int base_b)
+{
+	return nullptr;
+}
+
+void ImageSet::IM_UnloadDummyTextures() const
+{
+}
+
+Img_c::Img_c(int width, int height, bool _dummy) : w(width), h(height)
+{
+	pixels = new img_pixel_t[w * h];
+}
+
+Img_c::~Img_c()
+{
+	delete[] pixels;
+}
+
+const img_pixel_t *Img_c::buf() const
+{
+	return pixels;
+}
+
+Img_c *Img_c::color_remap(int src1, int src2, int targ1, int targ2) const
+{
+	return nullptr;
+}
+
+void Img_c::unload_gl(bool can_delete)
+{
+	gl_tex = 0;
+}
+
+// no OpenGL here, this just marks the image as uploaded
+void Img_c::upload_gl(const std::vector<u32_t> &rgba, int tw, int th)
+{
+	gl_tex = 1;
+}
+
+img_pixel_t *Img_c::wbuf()
+{
+	return pixels;
+}
+
+bool is_null_tex(const SString &tex)
+{
+	return tex == "-";
+}
+
+bool is_special_tex(const SString &tex)
+{
+	return tex.startsWith("#");
+}
+
+Img_c *LoadImage_JPEG(Lump_c *lump, const SString &name)
+{
+	return nullptr;
+}
+
+Img_c *LoadImage_PNG(Lump_c *lump, const SString &name)
+{
+	return nullptr;
+}
+
+Img_c *LoadImage_TGA(Lump_c *lump, const SString &name)
+{
+	return nullptr;
+}
+
+bool LoadPicture(const Palette &pal, const ConfigData &config, Img_c &dest, Lump_c *lump, const SString &pic_name, int pic_x_offset, int pic_y_offset, int *pic_width, int *pic_height)
+{
+	return false;
+}
+
+const thingtype_t &M_GetThingType(const ConfigData &config, int type)
+{
+	static thingtype_t info = {};
+	return info;
+}
+
+Lump_c *MasterDir::W_FindGlobalLump(const SString &name) const
+{
+	return nullptr;
+}
+
+Lump_c *MasterDir::W_FindSpriteLump(const SString &name) const
+{
+	return nullptr;
+}
+
+bool PatchImage::draw(const Palette &pal, const ConfigData &config, Img_c &dest, int x, int y) const
+{
+	return false;
+}
+
+std::unique_ptr<PatchImage> PatchImage::parse(Lump_c *lump, const SString &name)
+{
+	return nullptr;
+}
+
+char W_DetectImageFormat(Lump_c *lump)
+{
+	return 0;
+}
+
+int W_LoadLumpData(Lump_c *lump, std::vector<byte> &buffer)
+{
+	return 0;
+}
+
+Lump_c *Wad_file::FindLumpInNamespace(const SString &name, WadNamespace group) const noexcept
+{
+	return nullptr;
+}
+
+//==============================================================================
+//
+// Tests
+//
+//==============================================================================
+
+static const int SIZE = 256;
+static const size_t IMAGE_BYTES = SIZE * SIZE * sizeof(img_pixel_t);
+
+//
+// An entry decoding to a SIZE x SIZE image, counting how many times it
+// got decoded.  A null counter gives an entry which fails to decode.
+//
+static ImageEntry CountedEntry(int *count)
+{
+	ImageEntry entry;
+	entry.width = SIZE;
+	entry.height = SIZE;
+
+	entry.decode = [count](const ConfigData &config) -> Img_c *
+	{
+		if (! count)
+			return nullptr;
+
+		++*count;
+		return new Img_c(SIZE, SIZE);
+	};
+
+	return entry;
+}
+
+static SString Name(const char *prefix, int i)
+{
+	return SString::printf("%s%d", prefix, i);
+}
+
+class ImageCacheLimit : public ::testing::Test
+{
+protected:
+	void SetUp() override
+	{
+		saved_limit = config::image_cache_mb;
+	}
+
+	void TearDown() override
+	{
+		config::image_cache_mb = saved_limit;
+	}
+
+	int saved_limit = 0;
+};
+
+TEST(ImageSet, DecodesOnFirstUse)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	int tex_count = 0;
+	int flat_count = 0;
+
+	images.W_AddTexture("WALL", CountedEntry(&tex_count), false);
+	images.W_AddFlat("FLOOR", CountedEntry(&flat_count));
+	images.W_AddTexture("BROKEN", CountedEntry(nullptr), false);
+
+	// nothing is decoded while loading
+	ASSERT_EQ(tex_count, 0);
+	ASSERT_EQ(flat_count, 0);
+	ASSERT_EQ(images.decodedBytes(), 0u);
+
+	Img_c *wall = images.getTexture(config, "WALL");
+
+	ASSERT_NE(wall, nullptr);
+	ASSERT_EQ(wall->width(), SIZE);
+	ASSERT_EQ(tex_count, 1);
+	ASSERT_EQ(flat_count, 0);
+	ASSERT_EQ(images.decodedBytes(), IMAGE_BYTES);
+
+	// the second time it is the same image
+	ASSERT_EQ(images.getTexture(config, "WALL"), wall);
+	ASSERT_EQ(tex_count, 1);
+
+	ASSERT_NE(images.W_GetFlat(config, "FLOOR"), nullptr);
+	ASSERT_EQ(flat_count, 1);
+	ASSERT_EQ(images.decodedBytes(), 2 * IMAGE_BYTES);
+
+	// a failed one is not tried again, nor counted
+	ASSERT_EQ(images.getTexture(config, "BROKEN"), nullptr);
+	ASSERT_EQ(images.getTexture(config, "BROKEN"), nullptr);
+	ASSERT_TRUE(images.getTextures().at("BROKEN").failed);
+	ASSERT_EQ(images.decodedBytes(), 2 * IMAGE_BYTES);
+
+	// unknown names decode nothing
+	ASSERT_EQ(images.getTexture(config, "FLOOR"), nullptr);
+	ASSERT_EQ(images.W_GetFlat(config, "WALL"), nullptr);
+	ASSERT_EQ(tex_count, 1);
+	ASSERT_EQ(flat_count, 1);
+}
+
+TEST(ImageSet, DecodeNamedDecodesEachOnce)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	// more than a single job's worth
+	const int num_flats = 100;
+	std::vector<int> counts(num_flats);
+	std::vector<SString> names;
+
+	for (int i = 0 ; i < num_flats ; i++)
+	{
+		images.W_AddFlat(Name("FLAT", i), CountedEntry(&counts[i]));
+		names.push_back(Name("FLAT", i));
+	}
+
+	int tex_count = 0;
+	images.W_AddTexture("WALL", CountedEntry(&tex_count), false);
+
+	// asked twice, along with unknown and wrong kind names
+	names.push_back("FLAT7");
+	names.push_back("NOTHING");
+	names.push_back("WALL");
+
+	images.decodeNamed(config, { "WALL", "WALL", "FLAT3" }, names);
+
+	ASSERT_EQ(tex_count, 1);
+
+	for (int i = 0 ; i < num_flats ; i++)
+		ASSERT_EQ(counts[i], 1) << "flat " << i;
+
+	ASSERT_EQ(images.decodedBytes(), (num_flats + 1) * IMAGE_BYTES);
+
+	// using them afterwards does not decode them again
+	ASSERT_NE(images.W_GetFlat(config, "FLAT50"), nullptr);
+	ASSERT_NE(images.getTexture(config, "WALL"), nullptr);
+	ASSERT_EQ(counts[50], 1);
+	ASSERT_EQ(tex_count, 1);
+
+	images.decodeNamed(config, { "WALL" }, names);
+	ASSERT_EQ(tex_count, 1);
+	ASSERT_EQ(images.decodedBytes(), (num_flats + 1) * IMAGE_BYTES);
+}
+
+TEST(ImageSet, UseFromWorkerThreads)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	const int num_flats = 50;
+	std::vector<int> counts(num_flats);
+
+	for (int i = 0 ; i < num_flats ; i++)
+		images.W_AddFlat(Name("FLAT", i), CountedEntry(&counts[i]));
+
+	int tex_count = 0;
+	images.W_AddTexture("WALL", CountedEntry(&tex_count), false);
+
+	std::vector<int> widths(num_flats);
+
+	ThreadPool::shared().parallelFor(num_flats, [&](int i)
+	{
+		images.useFlat(config, Name("FLAT", i), [&](const Img_c *img)
+		{
+			widths[i] = img ? img->width() : -1;
+		});
+	});
+
+	for (int i = 0 ; i < num_flats ; i++)
+		ASSERT_EQ(widths[i], SIZE) << "flat " << i;
+
+	// made once each, and kept like getTexture() does
+	for (int i = 0 ; i < num_flats ; i++)
+		ASSERT_EQ(counts[i], 1) << "flat " << i;
+
+	ASSERT_EQ(images.decodedBytes(), num_flats * IMAGE_BYTES);
+	ASSERT_NE(images.W_GetFlat(config, "FLAT0"), nullptr);
+	ASSERT_EQ(counts[0], 1);
+
+	const Img_c *seen = nullptr;
+	images.useTexture(config, "WALL", [&](const Img_c *img) { seen = img; });
+
+	ASSERT_EQ(seen, images.getTexture(config, "WALL"));
+	ASSERT_EQ(tex_count, 1);
+
+	// unknown ones, and the wrong kind, give NULL
+	seen = images.getTexture(config, "WALL");
+	images.useTexture(config, "FLAT0", [&](const Img_c *img) { seen = img; });
+	ASSERT_EQ(seen, nullptr);
+
+	seen = images.getTexture(config, "WALL");
+	images.useFlat(config, "NOTHING", [&](const Img_c *img) { seen = img; });
+	ASSERT_EQ(seen, nullptr);
+}
+
+TEST_F(ImageCacheLimit, TrimDropsLeastRecentlyUsed)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	config::image_cache_mb = 1;
+
+	const size_t fitting = (1u << 20) / IMAGE_BYTES;
+	const int num_flats = static_cast<int>(fitting) + 4;
+
+	std::vector<int> counts(num_flats);
+
+	for (int i = 0 ; i < num_flats ; i++)
+		images.W_AddFlat(Name("FLAT", i), CountedEntry(&counts[i]));
+
+	// one made when loading, which cannot be decoded again
+	ImageEntry loaded;
+	loaded.img.reset(new Img_c(SIZE, SIZE));
+	images.W_AddTexture("LOADED", std::move(loaded), false);
+
+	// used from the last to the first, then the oldest is uploaded
+	for (int i = num_flats - 1 ; i >= 0 ; i--)
+		images.W_GetFlat(config, Name("FLAT", i));
+
+	images.W_GetFlat(config, Name("FLAT", num_flats - 1))->upload_gl({}, 1, 1);
+
+	ASSERT_EQ(images.decodedBytes(), (num_flats + 1) * IMAGE_BYTES);
+
+	images.trimDecodedImages();
+
+	ASSERT_LE(images.decodedBytes(), 1u << 20);
+	ASSERT_EQ(images.decodedBytes(), fitting * IMAGE_BYTES);
+
+	// the uploaded one was used last, the loaded one is kept
+	ASSERT_TRUE(images.getTextures().at("LOADED").img);
+	ASSERT_TRUE(images.getFlats().at(Name("FLAT", num_flats - 1)).img);
+
+	// the rest are the most recently used ones
+	const int kept = static_cast<int>(fitting) - 2;
+
+	for (int i = 0 ; i < num_flats - 1 ; i++)
+	{
+		bool has_img = images.getFlats().at(Name("FLAT", i)).img != nullptr;
+		ASSERT_EQ(has_img, i < kept) << "flat " << i;
+	}
+
+	// a dropped one gets decoded again when used
+	ASSERT_NE(images.W_GetFlat(config, Name("FLAT", num_flats - 2)), nullptr);
+	ASSERT_EQ(counts[num_flats - 2], 2);
+	ASSERT_EQ(counts[0], 1);
+
+	// nothing is dropped while under the limit
+	images.W_GetFlat(config, Name("FLAT", 0));
+	images.trimDecodedImages();
+	images.trimDecodedImages();
+
+	ASSERT_EQ(images.decodedBytes(), fitting * IMAGE_BYTES);
+	ASSERT_TRUE(images.getFlats().at(Name("FLAT", num_flats - 2)).img);
+	ASSERT_TRUE(images.getFlats().at(Name("FLAT", 0)).img);
+}
+
+TEST_F(ImageCacheLimit, TrimKeepsUploadedOverLimit)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	config::image_cache_mb = 0;
+
+	int count_a = 0;
+	int count_b = 0;
+
+	images.W_AddTexture("A", CountedEntry(&count_a), false);
+	images.W_AddFlat("B", CountedEntry(&count_b));
+
+	images.getTexture(config, "A")->upload_gl({}, 1, 1);
+	images.W_GetFlat(config, "B");
+
+	images.trimDecodedImages();
+
+	ASSERT_TRUE(images.getTextures().at("A").img);
+	ASSERT_FALSE(images.getFlats().at("B").img);
+	ASSERT_EQ(images.decodedBytes(), IMAGE_BYTES);
+
+	// once unloaded from OpenGL it can go too
+	images.W_UnloadAllTextures();
+	images.trimDecodedImages();
+
+	ASSERT_FALSE(images.getTextures().at("A").img);
+	ASSERT_EQ(images.decodedBytes(), 0u);
+}
+
+TEST(ImageSet, BytesBackToZeroWhenCleared)
+{
+	ImageSet images;
+	ConfigData config = {};
+
+	int count = 0;
+
+	for (int i = 0 ; i < 5 ; i++)
+	{
+		images.W_AddTexture(Name("TEX", i), CountedEntry(&count), false);
+		images.W_AddFlat(Name("FLAT", i), CountedEntry(&count));
+	}
+
+	// some not decoded, one added already decoded
+	ImageEntry loaded;
+	loaded.img.reset(new Img_c(SIZE, SIZE));
+	images.W_AddFlat("LOADED", std::move(loaded));
+
+	for (int i = 0 ; i < 3 ; i++)
+	{
+		images.getTexture(config, Name("TEX", i));
+		images.W_GetFlat(config, Name("FLAT", i));
+	}
+
+	ASSERT_EQ(images.decodedBytes(), 7 * IMAGE_BYTES);
+
+	// replacing a decoded one forgets its bytes
+	images.W_AddFlat("FLAT0", CountedEntry(&count));
+	images.W_AddTexture("TEX0", CountedEntry(&count), false);
+
+	ASSERT_EQ(images.decodedBytes(), 5 * IMAGE_BYTES);
+
+	images.W_ClearFlats();
+
+	ASSERT_EQ(images.decodedBytes(), 2 * IMAGE_BYTES);
+
+	images.W_ClearTextures();
+
+	ASSERT_EQ(images.decodedBytes(), 0u);
+
+	// and it counts again from there
+	images.W_AddFlat("FLOOR", CountedEntry(&count));
+	images.W_GetFlat(config, "FLOOR");
+
+	ASSERT_EQ(images.decodedBytes(), IMAGE_BYTES);
+}
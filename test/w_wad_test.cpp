@@ -312,6 +312,9 @@ TEST_F(WadFileTest, FindLumpInNamespace)
 			  wad->GetLump(13));
 	ASSERT_EQ(wad->FindLumpInNamespace("LUMP3", WadNamespace::Sprites),
 			  wad->GetLump(16));
+	ASSERT_EQ(wad->FindLumpInNamespace("lump2", WadNamespace::Sprites),
+			  wad->GetLump(13));
+	ASSERT_EQ(wad->FindLumpInNamespace("LUMP4", WadNamespace::Sprites), nullptr);
 	ASSERT_EQ(wad->FindLumpInNamespace("LUMP", WadNamespace::TextureLumps),
 			  wad->GetLump(19));
 }
@@ -497,6 +500,39 @@ TEST_F(WadFileTest, LumpIO)
 	ASSERT_FALSE(lump2->GetLine(line));
 }
 
+TEST_F(WadFileTest, LumpAppendAndInsert)
+{
+	auto wad = Wad_file::Open("dummy.wad", WadOpenMode::write);
+	Lump_c *lump = wad->AddLump("LUMP");
+	ASSERT_TRUE(lump);
+
+	// Appending after a size hint
+	lump->reserve(4);
+	lump->Write("abc", 3);
+	lump->Write("", 0);
+	lump->Write("defgh", 5);
+	ASSERT_EQ(lump->Length(), 8);
+	ASSERT_FALSE(memcmp(lump->getData(), "abcdefgh", 8));
+
+	// Writing before the end still inserts
+	lump->Seek(3);
+	lump->Write("XY", 2);
+	ASSERT_EQ(lump->Length(), 10);
+	ASSERT_FALSE(memcmp(lump->getData(), "abcXYdefgh", 10));
+
+	// Many small appends
+	lump->clearData();
+	for(int i = 0; i < 1000; ++i)
+	{
+		byte b = (byte)i;
+		lump->Write(&b, 1);
+	}
+	ASSERT_EQ(lump->Length(), 1000);
+	auto data = static_cast<const byte *>(lump->getData());
+	for(int i = 0; i < 1000; ++i)
+		ASSERT_EQ(data[i], (byte)i);
+}
+
 TEST_F(WadFileTest, LumpFromFile)
 {
 	SString path = getChildPath("wad.wad");